@@ -72,6 +72,12 @@ static const uint MAX_PATCHBAY_PLUGINS = 255;
  */
 static const uint MAX_DEFAULT_PARAMETERS = 200;
 
+/*!
+ * Number of in-memory state snapshot slots per plugin.
+ * @see carla_save_snapshot()
+ */
+static const uint MAX_SNAPSHOTS = 16;
+
 /*!
  * The "plugin Id" for the global Carla instance.
  * Currently only used for audio peaks.
@@ -267,6 +273,29 @@ static const uint PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200;
  */
 static const uint PLUGIN_OPTION_SKIP_SENDING_NOTES = 0x400;
 
+/*!
+ * Stop processing the plugin while it is idle.
+ * After its audio inputs and outputs have been silent for a while (and no events arrived) the plugin is put to sleep,
+ * its processing is skipped and it outputs silence until new audio or events arrive.
+ * Transport changes (play/stop, relocation, tempo) also wake it up,
+ * and plugins without audio inputs never sleep while the transport is rolling.
+ * @see ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT
+ */
+static const uint PLUGIN_OPTION_SLEEP_ON_SILENCE = 0x800;
+
+/*!
+ * Keep processing the plugin in patchbay mode even if none of its outputs reach the engine outputs.
+ * By default such plugins are left out of the patchbay rendering sequence, enable this for plugins like recorders.
+ * @see ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED
+ */
+static const uint PLUGIN_OPTION_ALWAYS_PROCESS = 0x1000;
+
+/*!
+ * Render the plugin voices using multiple CPU cores.
+ * Only used by plugins that can split their own rendering, like FluidSynth, and applied when the plugin is loaded.
+ */
+static const uint PLUGIN_OPTION_MULTI_CORE = 0x2000;
+
 /*!
  * Special flag to indicate that plugin options are not yet set.
  * This flag exists because 0x0 as an option value is a valid one, so we need something else to indicate "null-ness".
@@ -1101,6 +1130,7 @@ typedef enum {
 
     /*!
      * A cancelable action has been started or stopped.
+     * Sending "started" again while an action is running updates its name, as a way to report progress.
      * @a pluginId Plugin Id the action relates to, -1 for none
      * @a value1   1 for action started, 0 for stopped
      * @a valueStr Action name
@@ -1203,7 +1233,27 @@ typedef enum {
      * @a value1   New width
      * @a value2   New height
      */
-    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48,
+
+    /*!
+     * A patchbay client has been added to or removed from the rendering sequence.
+     * Clients whose outputs do not reach the engine outputs are not processed.
+     * @a pluginId Client Id
+     * @a value1   1 if the client is not being processed, 0 otherwise
+     * @see PLUGIN_OPTION_ALWAYS_PROCESS
+     */
+    ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED = 49,
+
+    /*!
+     * An asynchronous plugin add, remove or replace request has finished.
+     * On success this is sent after the matching plugin added, removed or reload-all callback.
+     * @a pluginId Plugin Id
+     * @a value1   Request Id
+     * @a value2   1 if the request succeeded, 0 otherwise
+     * @a valueStr Error message, if the request failed
+     * @see carla_add_plugin_async()
+     */
+    ENGINE_CALLBACK_PLUGIN_ASYNC_DONE = 50
 
 } EngineCallbackOpcode;
 
@@ -1480,7 +1530,30 @@ typedef enum {
      * Mostly useful for JACK multi-client mode.
      * @note MUST include at least one "." (dot).
      */
-    ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
+    ENGINE_OPTION_CLIENT_NAME_PREFIX = 34,
+
+    /*!
+     * Save plugin chunks as binary files next to the project file, instead of as base64 text inside it.
+     * Chunk files are named after their contents and only written when they change.
+     * Default is false.
+     */
+    ENGINE_OPTION_PROJECT_CHUNK_FILES = 35,
+
+    /*!
+     * Time in milliseconds a plugin needs to be silent before it is put to sleep.
+     * Only applies to plugins with PLUGIN_OPTION_SLEEP_ON_SILENCE enabled.
+     * Default is 2000.
+     */
+    ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT = 36,
+
+    /*!
+     * Bridge process pooling, maximum number of bridged plugins hosted by a single bridge process.
+     * Only plugins using the same bridge binary, architecture and wine prefix are grouped together.
+     * This only shares the process and its runtime, each plugin still does its own real-time round-trip per block.
+     * Set to 0 or 1 to use one process per bridged plugin.
+     * Default is 0.
+     */
+    ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE = 37
 
 } EngineOption;
 
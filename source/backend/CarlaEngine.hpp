@@ -23,11 +23,12 @@
 
 namespace water {
 class MemoryOutputStream;
-class XmlDocument;
 }
 
 CARLA_BACKEND_START_NAMESPACE
 
+class CarlaStateChunkFiles;
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -276,6 +277,9 @@ struct CARLA_API EngineOptions {
     const char* clientNamePrefix;
 
     bool preventBadBehaviour;
+    bool projectChunkFiles;
+    uint pluginSleepTimeout;
+    uint bridgeProcessPoolSize;
     uintptr_t frontendWinId;
 
 #ifndef CARLA_OS_WIN
@@ -1015,6 +1019,52 @@ public:
      * Switch plugins with id @a idA and @a idB.
      */
     virtual bool switchPlugins(uint idA, uint idB) noexcept;
+
+    /*!
+     * Capture the state of all plugins into in-memory snapshot @a slot.
+     * @see CarlaPlugin::saveSnapshot()
+     */
+    bool saveSnapshot(uint slot);
+
+    /*!
+     * Restore the state of all plugins from in-memory snapshot @a slot.
+     * Parameter changes of all plugins are applied together, at the start of the same processing cycle.
+     * @see CarlaPlugin::loadSnapshot()
+     */
+    bool loadSnapshot(uint slot);
+
+    /*!
+     * Clear in-memory snapshot @a slot of all plugins.
+     */
+    void clearSnapshot(uint slot) noexcept;
+
+    /*!
+     * Add new plugin without blocking the caller.
+     * The plugin is created and activated on a separate thread, then handed to the audio thread between processing cycles.
+     * Returns a request Id, or 0 if the request could not be queued.
+     * @note Only string values for @a extra are supported.
+     * @see ENGINE_CALLBACK_PLUGIN_ASYNC_DONE
+     */
+    uint addPluginAsync(BinaryType btype, PluginType ptype,
+                        const char* filename, const char* name, const char* label, int64_t uniqueId,
+                        const char* extra, uint options = PLUGIN_OPTIONS_NULL);
+
+    /*!
+     * Remove plugin with id @a id without blocking the caller.
+     * Returns a request Id, or 0 if the request could not be queued.
+     * @see ENGINE_CALLBACK_PLUGIN_ASYNC_DONE
+     */
+    uint removePluginAsync(uint id);
+
+    /*!
+     * Replace plugin with id @a id by a new plugin, without blocking the caller.
+     * The old plugin keeps running until the new one is ready.
+     * Returns a request Id, or 0 if the request could not be queued.
+     * @see ENGINE_CALLBACK_PLUGIN_ASYNC_DONE
+     */
+    uint replacePluginAsync(uint id, BinaryType btype, PluginType ptype,
+                            const char* filename, const char* name, const char* label, int64_t uniqueId,
+                            const char* extra, uint options = PLUGIN_OPTIONS_NULL);
 #endif
 
     /*!
@@ -1054,7 +1104,9 @@ public:
 
     /*!
      * Load a project file.
+     * Plugins are loaded while the file is read, incomplete files are rejected before that starts.
      * @note Already loaded plugins are not removed; call removeAllPlugins() first if needed.
+     * @note If the file is malformed further on, loading stops there and the plugins loaded so far are kept.
      */
     bool loadProject(const char* filename, bool setAsCurrentProject);
 
@@ -1187,6 +1239,12 @@ public:
     virtual bool patchbaySetGroupPos(bool sendHost, bool sendOSC, bool external,
                                      uint groupId, int x1, int y1, int x2, int y2);
 
+    /*!
+     * Keep processing a group even if none of its outputs reach the engine outputs.
+     * Only used in patchbay mode with the internal graph, does nothing otherwise.
+     */
+    bool patchbaySetGroupAlwaysProcessed(uint groupId, bool alwaysProcessed);
+
     /*!
      * Force the engine to resend all patchbay clients, ports and connections again.
      */
@@ -1306,6 +1364,7 @@ protected:
     friend class CarlaEngineOsc;
     friend class CarlaEngineThread;
     friend class CarlaPluginInstance;
+    friend class EngineAsyncLoader;
     friend class EngineInternalGraph;
     friend class PendingRtEventsRunner;
     friend class ScopedActionLock;
@@ -1318,6 +1377,14 @@ protected:
     // -------------------------------------------------------------------
     // Internal stuff
 
+    /*!
+     * Create and initialize a new plugin with id @a id, without adding it to the engine.
+     * Returns null and sets the last error on failure.
+     */
+    CarlaPluginPtr createPlugin(uint id, BinaryType btype, PluginType ptype,
+                                const char* filename, const char* name, const char* label, int64_t uniqueId,
+                                const void* extra, uint options);
+
     /*!
      * Report to all plugins about buffer size change.
      */
@@ -1343,12 +1410,14 @@ protected:
     /*!
      * Common save project function for main engine and plugin.
      */
-    void saveProjectInternal(water::MemoryOutputStream& outStrm) const;
+    void saveProjectInternal(water::MemoryOutputStream& outStrm, CarlaStateChunkFiles* chunkFiles = nullptr) const;
 
     /*!
      * Common load project function for main engine and plugin.
+     * @a xmlData is parsed in-place, and thus modified.
+     * @a projectFilename is needed to load plugin chunks stored as files.
      */
-    bool loadProjectInternal(water::XmlDocument& xmlDoc, bool alwaysLoadConnections);
+    bool loadProjectInternal(char* xmlData, std::size_t xmlSize, bool alwaysLoadConnections, const char* projectFilename = nullptr);
 
     // -------------------------------------------------------------------
     // Helper functions
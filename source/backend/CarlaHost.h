@@ -516,7 +516,9 @@ CARLA_EXPORT bool carla_load_file(CarlaHostHandle handle, const char* filename);
 
 /*!
  * Load a Carla project file.
+ * Incomplete files are rejected before any plugin is loaded.
  * @note Currently loaded plugins are not removed; call carla_remove_all_plugins() first if needed.
+ * @note If the file is malformed further on, this returns false but the plugins loaded before that point are kept.
  */
 CARLA_EXPORT bool carla_load_project(CarlaHostHandle handle, const char* filename);
 
@@ -675,6 +677,40 @@ CARLA_EXPORT bool carla_replace_plugin(CarlaHostHandle handle, uint pluginId);
  * @param pluginIdB Plugin B
  */
 CARLA_EXPORT bool carla_switch_plugins(CarlaHostHandle handle, uint pluginIdA, uint pluginIdB);
+
+/*!
+ * Add a new plugin without blocking the caller.
+ * The plugin is created and activated on a separate thread, and starts processing on a later audio cycle.
+ * Requests are processed in order, and plugin ids are resolved when each request is processed.
+ * Completion is reported through ENGINE_CALLBACK_PLUGIN_ASYNC_DONE, during carla_engine_idle().
+ * Returns a request Id, or 0 on failure.
+ * @param extra Extra string, defined per plugin type (only "true" for 16-output SoundFonts is used)
+ * @see carla_add_plugin()
+ */
+CARLA_EXPORT uint carla_add_plugin_async(CarlaHostHandle handle,
+                                         BinaryType btype, PluginType ptype,
+                                         const char* filename, const char* name, const char* label, int64_t uniqueId,
+                                         const char* extra, uint options);
+
+/*!
+ * Remove one plugin without blocking the caller.
+ * Returns a request Id, or 0 on failure.
+ * @param pluginId Plugin to remove
+ * @see carla_add_plugin_async()
+ */
+CARLA_EXPORT uint carla_remove_plugin_async(CarlaHostHandle handle, uint pluginId);
+
+/*!
+ * Replace a plugin without blocking the caller.
+ * The current plugin keeps processing until the new one is ready.
+ * Returns a request Id, or 0 on failure.
+ * @param pluginId Plugin to replace
+ * @see carla_add_plugin_async()
+ */
+CARLA_EXPORT uint carla_replace_plugin_async(CarlaHostHandle handle, uint pluginId,
+                                             BinaryType btype, PluginType ptype,
+                                             const char* filename, const char* name, const char* label, int64_t uniqueId,
+                                             const char* extra, uint options);
 #endif
 
 /*!
@@ -693,6 +729,50 @@ CARLA_EXPORT bool carla_load_plugin_state(CarlaHostHandle handle, uint pluginId,
  */
 CARLA_EXPORT bool carla_save_plugin_state(CarlaHostHandle handle, uint pluginId, const char* filename);
 
+#ifndef BUILD_BRIDGE
+/*!
+ * Capture a plugin state into an in-memory snapshot.
+ * Snapshots keep parameter values, programs and chunk data ready to use, for fast switching.
+ * @param pluginId Plugin
+ * @param slot     Snapshot slot, must be lower than MAX_SNAPSHOTS
+ * @see carla_load_plugin_snapshot()
+ */
+CARLA_EXPORT bool carla_save_plugin_snapshot(CarlaHostHandle handle, uint pluginId, uint slot);
+
+/*!
+ * Restore a plugin state from an in-memory snapshot.
+ * Parameter changes are applied by the audio thread at the start of the next processing cycle.
+ * Plugins that save their state as a chunk get it restored synchronously by this call instead.
+ * @param pluginId Plugin
+ * @param slot     Snapshot slot
+ * @see carla_save_plugin_snapshot()
+ */
+CARLA_EXPORT bool carla_load_plugin_snapshot(CarlaHostHandle handle, uint pluginId, uint slot);
+
+/*!
+ * Capture the state of all plugins into an in-memory snapshot.
+ * @param slot Snapshot slot, must be lower than MAX_SNAPSHOTS
+ * @see carla_load_snapshot()
+ */
+CARLA_EXPORT bool carla_save_snapshot(CarlaHostHandle handle, uint slot);
+
+/*!
+ * Restore the state of all plugins from an in-memory snapshot.
+ * Parameter changes of all plugins are applied at the start of the same processing cycle.
+ * Chunks are not part of that, they are restored synchronously on the calling thread one plugin at a time,
+ * so chunk-based plugins switch before the others.
+ * @param slot Snapshot slot
+ * @see carla_save_snapshot()
+ */
+CARLA_EXPORT bool carla_load_snapshot(CarlaHostHandle handle, uint slot);
+
+/*!
+ * Clear an in-memory snapshot of all plugins.
+ * @param slot Snapshot slot
+ */
+CARLA_EXPORT void carla_clear_snapshot(CarlaHostHandle handle, uint slot);
+#endif
+
 /*!
  * Export plugin as LV2.
  * @param pluginId Plugin
@@ -915,6 +995,63 @@ CARLA_EXPORT float carla_get_input_peak_value(CarlaHostHandle handle, uint plugi
  */
 CARLA_EXPORT float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool isLeft);
 
+/*!
+ * Get the parameter data of all parameters of a plugin.
+ * Unlike carla_get_parameter_data() this writes into a caller-provided buffer, so it is reentrant.
+ * @param pluginId Plugin
+ * @param data     Buffer to write into
+ * @param count    Size of @a data, usually carla_get_parameter_count()
+ * Returns the number of parameters written.
+ */
+CARLA_EXPORT uint32_t carla_get_all_parameter_data(CarlaHostHandle handle, uint pluginId,
+                                                   ParameterData* data, uint32_t count);
+
+/*!
+ * Get the parameter ranges of all parameters of a plugin.
+ * Unlike carla_get_parameter_ranges() this writes into a caller-provided buffer, so it is reentrant.
+ * @param pluginId Plugin
+ * @param ranges   Buffer to write into
+ * @param count    Size of @a ranges, usually carla_get_parameter_count()
+ * Returns the number of parameters written.
+ */
+CARLA_EXPORT uint32_t carla_get_all_parameter_ranges(CarlaHostHandle handle, uint pluginId,
+                                                     ParameterRanges* ranges, uint32_t count);
+
+/*!
+ * Get the current values of all parameters of a plugin.
+ * @param pluginId Plugin
+ * @param values   Buffer to write into
+ * @param count    Size of @a values, usually carla_get_parameter_count()
+ * Returns the number of values written.
+ */
+CARLA_EXPORT uint32_t carla_get_current_parameter_values(CarlaHostHandle handle, uint pluginId,
+                                                         float* values, uint32_t count);
+
+/*!
+ * Get the parameters of a plugin that changed since the last call.
+ * Changes done from the host, the plugin UI, MIDI or automation are all tracked.
+ * Output parameters are not always reported, read those with carla_get_current_parameter_values() instead.
+ * This does not lock the plugin, so it can be polled often without holding up audio processing.
+ * @param pluginId Plugin
+ * @param sequence Sequence number from the previous call, use 0 to get all parameters.
+ *                 Updated on return, unless @a count was too small to hold all changes.
+ * @param indexes  Buffer to write changed parameter indexes into
+ * @param values   Buffer to write the matching current values into
+ * @param count    Size of @a indexes and @a values, usually carla_get_parameter_count()
+ * Returns the number of changed parameters written.
+ */
+CARLA_EXPORT uint32_t carla_get_changed_parameter_values(CarlaHostHandle handle, uint pluginId, uint32_t* sequence,
+                                                         uint32_t* indexes, float* values, uint32_t count);
+
+/*!
+ * Get the peak values of all plugins.
+ * Writes 4 values per plugin (input left/mono, input right, output left/mono, output right), in plugin order.
+ * @param peaks Buffer to write into, must hold 4 * @a count values
+ * @param count Maximum number of plugins to write, usually carla_get_current_plugin_count()
+ * Returns the number of plugins written.
+ */
+CARLA_EXPORT uint carla_get_all_peak_values(CarlaHostHandle handle, float* peaks, uint count);
+
 /*!
  * Render a plugin's inline display.
  * @param pluginId Plugin
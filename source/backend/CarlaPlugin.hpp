@@ -51,6 +51,7 @@ class CarlaEngineEventPort;
 class CarlaEngineCVSourcePorts;
 class CarlaEngineBridge;
 struct CarlaStateSave;
+class CarlaStateChunkFiles;
 struct EngineEvent;
 
 // -----------------------------------------------------------------------
@@ -291,6 +292,15 @@ public:
      */
     virtual float getParameterValue(uint32_t parameterId) const noexcept;
 
+    /*!
+     * Get the parameters that changed since @a sequence, from any thread.
+     * Writes up to @a count parameter indexes and current values, returning how many were written.
+     * On return @a sequence is set to the value to pass next time, unless not all changes fit.
+     * A @a sequence of 0 gets all parameters.
+     * Does not lock the plugin, must not be called while the plugin is being reloaded.
+     */
+    uint32_t getChangedParameterValues(uint32_t& sequence, uint32_t* indexes, float* values, uint32_t count) const noexcept;
+
     /*!
      * Get the scalepoint @a scalePointId value of the parameter @a parameterId.
      */
@@ -420,10 +430,11 @@ public:
     /*!
      * Get the plugin's save state.
      * The plugin will automatically call prepareForSave() if requested.
+     * If @a chunkFiles is set the plugin chunk is stored there, instead of as base64 text.
      *
      * @see loadStateSave()
      */
-    const CarlaStateSave& getStateSave(bool callPrepareForSave = true);
+    const CarlaStateSave& getStateSave(bool callPrepareForSave = true, CarlaStateChunkFiles* chunkFiles = nullptr);
 
     /*!
      * Get the plugin's save state.
@@ -451,6 +462,31 @@ public:
      */
     bool exportAsLV2(const char* lv2path);
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    /*!
+     * Capture the current plugin state into in-memory snapshot @a slot.
+     * Snapshots hold parameter values, current programs, internal values and the raw plugin chunk.
+     * Custom data is not included.
+     *
+     * @see loadSnapshot()
+     */
+    bool saveSnapshot(uint slot);
+
+    /*!
+     * Restore the plugin state from in-memory snapshot @a slot.
+     * The chunk (if any) is set right away, everything else is applied in one go
+     * by the audio thread at the start of the next processing cycle.
+     *
+     * @see saveSnapshot()
+     */
+    bool loadSnapshot(uint slot);
+
+    /*!
+     * Clear in-memory snapshot @a slot.
+     */
+    void clearSnapshot(uint slot) noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Set data (internal stuff)
 
@@ -725,6 +761,28 @@ public:
      */
     virtual void offlineModeChanged(bool isOffline);
 
+    /*!
+     * Check if the plugin is sleeping, see PLUGIN_OPTION_SLEEP_ON_SILENCE.
+     * Must be called after initBuffers() and before process(), with the plugin locked.
+     * When this returns true the caller must skip process() and treat the plugin outputs as silent.
+     * @param audioIn     Audio inputs of the plugin, only scanned if @a inputSilent is false
+     * @param inputSilent Audio inputs are already known to be silent
+     */
+    bool isSleepingRT(const float* const* audioIn, bool inputSilent, uint32_t frames) noexcept;
+
+    /*!
+     * Update the sleep state after a process() call, see isSleepingRT().
+     */
+    void updateSleepStateRT(const float* const* audioOut, uint32_t frames) noexcept;
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    /*!
+     * Apply the snapshot requested by loadSnapshot(), if any.
+     * Called by the engine at the start of each processing cycle, with the plugin unlocked.
+     */
+    void applyPendingSnapshotRT() noexcept;
+#endif
+
     // -------------------------------------------------------------------
     // Misc
 
@@ -1058,6 +1116,7 @@ protected:
 
     friend class CarlaEngine;
     friend class CarlaEngineBridge;
+    friend class EngineAsyncLoader;
     CARLA_DECLARE_NON_COPY_CLASS(CarlaPlugin)
 };
 
@@ -388,6 +388,10 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
 # endif
 
     engine->setOption(CB::ENGINE_OPTION_CLIENT_NAME_PREFIX, 0, standalone.engineOptions.clientNamePrefix);
+
+    engine->setOption(CB::ENGINE_OPTION_PROJECT_CHUNK_FILES, standalone.engineOptions.projectChunkFiles ? 1 : 0, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT, static_cast<int>(standalone.engineOptions.pluginSleepTimeout), nullptr);
+    engine->setOption(CB::ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE, static_cast<int>(standalone.engineOptions.bridgeProcessPoolSize), nullptr);
 #endif // BUILD_BRIDGE
 }
 
@@ -986,6 +990,21 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
                                                    ? carla_strdup_safe(valueStr)
                                                    : nullptr;
             break;
+
+        case CB::ENGINE_OPTION_PROJECT_CHUNK_FILES:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.projectChunkFiles = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.pluginSleepTimeout = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.bridgeProcessPoolSize = static_cast<uint>(value);
+            break;
         }
     }
 
@@ -1283,6 +1302,47 @@ bool carla_switch_plugins(CarlaHostHandle handle, uint pluginIdA, uint pluginIdB
 
     return handle->engine->switchPlugins(pluginIdA, pluginIdB);
 }
+
+uint carla_add_plugin_async(CarlaHostHandle handle,
+                            BinaryType btype, PluginType ptype,
+                            const char* filename, const char* name, const char* label, int64_t uniqueId,
+                            const char* extra, uint options)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", 0);
+
+    carla_debug("carla_add_plugin_async(%p, %i:%s, %i:%s, \"%s\", \"%s\", \"%s\", " P_INT64 ", \"%s\", %u)",
+                handle,
+                btype, CB::BinaryType2Str(btype),
+                ptype, CB::PluginType2Str(ptype),
+                filename, name, label, uniqueId, extra, options);
+
+    return handle->engine->addPluginAsync(btype, ptype, filename, name, label, uniqueId, extra, options);
+}
+
+uint carla_remove_plugin_async(CarlaHostHandle handle, uint pluginId)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", 0);
+
+    carla_debug("carla_remove_plugin_async(%p, %i)", handle, pluginId);
+
+    return handle->engine->removePluginAsync(pluginId);
+}
+
+uint carla_replace_plugin_async(CarlaHostHandle handle, uint pluginId,
+                                BinaryType btype, PluginType ptype,
+                                const char* filename, const char* name, const char* label, int64_t uniqueId,
+                                const char* extra, uint options)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", 0);
+
+    carla_debug("carla_replace_plugin_async(%p, %i, %i:%s, %i:%s, \"%s\", \"%s\", \"%s\", " P_INT64 ", \"%s\", %u)",
+                handle, pluginId,
+                btype, CB::BinaryType2Str(btype),
+                ptype, CB::PluginType2Str(ptype),
+                filename, name, label, uniqueId, extra, options);
+
+    return handle->engine->replacePluginAsync(pluginId, btype, ptype, filename, name, label, uniqueId, extra, options);
+}
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -1310,6 +1370,59 @@ bool carla_save_plugin_state(CarlaHostHandle handle, uint pluginId, const char*
     return false;
 }
 
+#ifndef BUILD_BRIDGE
+bool carla_save_plugin_snapshot(CarlaHostHandle handle, uint pluginId, uint slot)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_save_plugin_snapshot(%p, %i, %i)", handle, pluginId, slot);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->saveSnapshot(slot);
+
+    return false;
+}
+
+bool carla_load_plugin_snapshot(CarlaHostHandle handle, uint pluginId, uint slot)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_load_plugin_snapshot(%p, %i, %i)", handle, pluginId, slot);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->loadSnapshot(slot);
+
+    return false;
+}
+
+bool carla_save_snapshot(CarlaHostHandle handle, uint slot)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_save_snapshot(%p, %i)", handle, slot);
+
+    return handle->engine->saveSnapshot(slot);
+}
+
+bool carla_load_snapshot(CarlaHostHandle handle, uint slot)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_load_snapshot(%p, %i)", handle, slot);
+
+    return handle->engine->loadSnapshot(slot);
+}
+
+void carla_clear_snapshot(CarlaHostHandle handle, uint slot)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
+
+    carla_debug("carla_clear_snapshot(%p, %i)", handle, slot);
+
+    handle->engine->clearSnapshot(slot);
+}
+#endif
+
 bool carla_export_plugin_lv2(CarlaHostHandle handle, uint pluginId, const char* lv2path)
 {
     CARLA_SAFE_ASSERT_RETURN(lv2path != nullptr && lv2path[0] != '\0', false);
@@ -1974,6 +2087,87 @@ float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool is
 
 // --------------------------------------------------------------------------------------------------------------------
 
+uint32_t carla_get_all_parameter_data(CarlaHostHandle handle, uint pluginId, ParameterData* data, uint32_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+    {
+        count = std::min(count, plugin->getParameterCount());
+
+        for (uint32_t i=0; i < count; ++i)
+            data[i] = plugin->getParameterData(i);
+
+        return count;
+    }
+
+    return 0;
+}
+
+uint32_t carla_get_all_parameter_ranges(CarlaHostHandle handle, uint pluginId, ParameterRanges* ranges, uint32_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(ranges != nullptr, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+    {
+        count = std::min(count, plugin->getParameterCount());
+
+        for (uint32_t i=0; i < count; ++i)
+            ranges[i] = plugin->getParameterRanges(i);
+
+        return count;
+    }
+
+    return 0;
+}
+
+uint32_t carla_get_current_parameter_values(CarlaHostHandle handle, uint pluginId, float* values, uint32_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+    {
+        count = std::min(count, plugin->getParameterCount());
+
+        for (uint32_t i=0; i < count; ++i)
+            values[i] = plugin->getParameterValue(i);
+
+        return count;
+    }
+
+    return 0;
+}
+
+uint32_t carla_get_changed_parameter_values(CarlaHostHandle handle, uint pluginId, uint32_t* sequence,
+                                            uint32_t* indexes, float* values, uint32_t count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(sequence != nullptr, 0);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        return plugin->getChangedParameterValues(*sequence, indexes, values, count);
+
+    return 0;
+}
+
+uint carla_get_all_peak_values(CarlaHostHandle handle, float* peaks, uint count)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(peaks != nullptr, 0);
+
+    count = std::min(count, handle->engine->getCurrentPluginCount());
+
+    for (uint i=0; i < count; ++i)
+        carla_copyFloats(peaks + i*4, handle->engine->getPeaks(i), 4);
+
+    return count;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 CARLA_BACKEND_START_NAMESPACE
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
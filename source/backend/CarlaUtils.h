@@ -145,6 +145,7 @@ typedef struct _CarlaCachedPluginInfo {
  * Get how many cached plugins are available.
  * Internal and LV2 plugin formats are cached and need to be discovered via this function.
  * Do not call this for any other plugin formats.
+ * LV2 plugins are listed from the on-disk RDF cache when no bundle in @a pluginPath changed since the last call.
  *
  * @note if this carla build uses JUCE, then you must call carla_juce_init beforehand
  */
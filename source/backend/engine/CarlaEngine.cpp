@@ -35,13 +35,14 @@
 #include "CarlaProcessUtils.hpp"
 #include "CarlaScopeUtils.hpp"
 #include "CarlaStateUtils.hpp"
+#include "CarlaXmlUtils.hpp"
 #include "CarlaMIDI.h"
 
 #include "jackbridge/JackBridge.hpp"
 
 #include "water/files/File.h"
 #include "water/streams/MemoryOutputStream.h"
-#include "water/xml/XmlDocument.h"
+#include "water/memory/MemoryBlock.h"
 #include "water/xml/XmlElement.h"
 
 #ifdef CARLA_OS_MAC
@@ -59,10 +60,10 @@
 using water::Array;
 using water::CharPointer_UTF8;
 using water::File;
+using water::MemoryBlock;
 using water::MemoryOutputStream;
 using water::String;
 using water::StringArray;
-using water::XmlDocument;
 using water::XmlElement;
 
 // #define SFZ_FILES_USING_SFIZZ
@@ -350,6 +351,10 @@ bool CarlaEngine::close()
 {
     carla_debug("CarlaEngine::close()");
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->asyncLoader.clear();
+#endif
+
     if (pData->curPluginCount != 0)
     {
         pData->aboutToClose = true;
@@ -410,6 +415,11 @@ void CarlaEngine::idle() noexcept
     pData->osc.idle();
 #endif
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->asyncLoader.idle();
+    pData->graph.idle();
+#endif
+
     pData->deletePluginsAsNeeded();
 }
 
@@ -474,6 +484,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->asyncLoader.isBusy(), "An asynchronous plugin operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId <= pData->maxPluginNumber, "Invalid engine internal data");
 #endif
@@ -520,6 +531,73 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
 #endif
     }
 
+    const CarlaPluginPtr plugin = createPlugin(id, btype, ptype, filename, name, label, uniqueId, extra, options);
+
+    if (plugin.get() == nullptr)
+        return false;
+
+    EnginePluginData& pluginData(pData->plugins[id]);
+    pluginData.plugin = plugin;
+    carla_zeroFloats(pluginData.peaks, 4);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (oldPlugin.get() != nullptr)
+    {
+        CARLA_SAFE_ASSERT(! pData->loadingProject);
+
+        const ScopedThreadStopper sts(this);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.replacePlugin(oldPlugin, plugin);
+
+        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
+        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
+        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
+
+        oldPlugin->prepareForDeletion();
+        pData->pluginsToDelete.push_back(oldPlugin);
+
+        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
+            plugin->setDryWet(oldDryWet, true, true);
+
+        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
+            plugin->setVolume(oldVolume, true, true);
+
+        plugin->setActive(wasActive, true, true);
+        plugin->setEnabled(true);
+
+        callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
+    }
+    else if (! pData->loadingProject)
+#endif
+    {
+        plugin->setEnabled(true);
+
+        ++pData->curPluginCount;
+        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0, 0.0f, plugin->getName());
+
+        if (getType() != kEngineTypeBridge)
+            plugin->setActive(true, true, true);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.addPlugin(plugin);
+#endif
+    }
+
+    return true;
+}
+
+CarlaPluginPtr CarlaEngine::createPlugin(const uint id,
+                                         const BinaryType btype,
+                                         const PluginType ptype,
+                                         const char* const filename,
+                                         const char* const name,
+                                         const char* const label,
+                                         const int64_t uniqueId,
+                                         const void* const extra,
+                                         const uint options)
+{
     CarlaPlugin::Initializer initializer = {
         this,
         id,
@@ -647,7 +725,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
         else
         {
             setLastError("This Carla build cannot handle this binary");
-            return false;
+            return CarlaPluginPtr();
         }
     }
     else
@@ -738,7 +816,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
     }
 
     if (plugin.get() == nullptr)
-        return false;
+        return plugin;
 
     plugin->reload();
 
@@ -767,59 +845,10 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
 
     if (! canRun)
     {
-        return false;
-    }
-
-    EnginePluginData& pluginData(pData->plugins[id]);
-    pluginData.plugin = plugin;
-    carla_zeroFloats(pluginData.peaks, 4);
-
-#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    if (oldPlugin.get() != nullptr)
-    {
-        CARLA_SAFE_ASSERT(! pData->loadingProject);
-
-        const ScopedThreadStopper sts(this);
-
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.replacePlugin(oldPlugin, plugin);
-
-        const bool  wasActive = oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f;
-        const float oldDryWet = oldPlugin->getInternalParameterValue(PARAMETER_DRYWET);
-        const float oldVolume = oldPlugin->getInternalParameterValue(PARAMETER_VOLUME);
-
-        oldPlugin->prepareForDeletion();
-        pData->pluginsToDelete.push_back(oldPlugin);
-
-        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
-            plugin->setDryWet(oldDryWet, true, true);
-
-        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
-            plugin->setVolume(oldVolume, true, true);
-
-        plugin->setActive(wasActive, true, true);
-        plugin->setEnabled(true);
-
-        callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
-    }
-    else if (! pData->loadingProject)
-#endif
-    {
-        plugin->setEnabled(true);
-
-        ++pData->curPluginCount;
-        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, id, 0, 0, 0, 0.0f, plugin->getName());
-
-        if (getType() != kEngineTypeBridge)
-            plugin->setActive(true, true, true);
-
-#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
-            pData->graph.addPlugin(plugin);
-#endif
+        return CarlaPluginPtr();
     }
 
-    return true;
+    return plugin;
 }
 
 bool CarlaEngine::addPlugin(const PluginType ptype,
@@ -836,6 +865,7 @@ bool CarlaEngine::removePlugin(const uint id)
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->asyncLoader.isBusy(), "An asynchronous plugin operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
 #else
@@ -889,6 +919,11 @@ bool CarlaEngine::removeAllPlugins()
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     carla_debug("CarlaEngine::removeAllPlugins()");
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // pending asynchronous requests are finished or cancelled first
+    pData->asyncLoader.clear();
+#endif
+
     if (pData->curPluginCount == 0)
         return true;
 
@@ -928,6 +963,7 @@ bool CarlaEngine::renamePlugin(const uint id, const char* const newName)
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->asyncLoader.isBusy(), "An asynchronous plugin operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
@@ -994,6 +1030,7 @@ bool CarlaEngine::replacePlugin(const uint id) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->asyncLoader.isBusy(), "An asynchronous plugin operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount != 0, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     carla_debug("CarlaEngine::replacePlugin(%i)", id);
@@ -1021,6 +1058,7 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(! pData->asyncLoader.isBusy(), "An asynchronous plugin operation is still being processed, please wait for it to finish");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->curPluginCount >= 2, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
     CARLA_SAFE_ASSERT_RETURN_ERR(idA != idB, "Invalid operation, cannot switch plugin with itself");
@@ -1054,6 +1092,137 @@ bool CarlaEngine::switchPlugins(const uint idA, const uint idB) noexcept
 
     return true;
 }
+
+bool CarlaEngine::saveSnapshot(const uint slot)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(slot < MAX_SNAPSHOTS, "Invalid snapshot slot");
+    carla_debug("CarlaEngine::saveSnapshot(%u)", slot);
+
+    for (uint i=0; i < pData->curPluginCount; ++i)
+    {
+        if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+        {
+            if (plugin->isEnabled() && ! plugin->saveSnapshot(slot))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool CarlaEngine::loadSnapshot(const uint slot)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(slot < MAX_SNAPSHOTS, "Invalid snapshot slot");
+    carla_debug("CarlaEngine::loadSnapshot(%u)", slot);
+
+    // the audio thread skips snapshots while this is locked, so all plugins change on the same cycle
+    const CarlaMutexLocker cml(pData->snapshotMutex);
+
+    bool ok = true;
+
+    for (uint i=0; i < pData->curPluginCount; ++i)
+    {
+        if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+        {
+            // keep going, so a single mismatching plugin does not block the rest
+            if (plugin->isEnabled() && ! plugin->loadSnapshot(slot))
+                ok = false;
+        }
+    }
+
+    return ok;
+}
+
+void CarlaEngine::clearSnapshot(const uint slot) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(pData->plugins != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(slot < MAX_SNAPSHOTS,);
+    carla_debug("CarlaEngine::clearSnapshot(%u)", slot);
+
+    for (uint i=0; i < pData->curPluginCount; ++i)
+    {
+        if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+            plugin->clearSnapshot(slot);
+    }
+}
+
+uint CarlaEngine::addPluginAsync(const BinaryType btype,
+                                 const PluginType ptype,
+                                 const char* const filename,
+                                 const char* const name,
+                                 const char* const label,
+                                 const int64_t uniqueId,
+                                 const char* const extra,
+                                 const uint options)
+{
+    return replacePluginAsync(pData->maxPluginNumber, btype, ptype, filename, name, label, uniqueId, extra, options);
+}
+
+uint CarlaEngine::removePluginAsync(const uint id)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId == pData->maxPluginNumber, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->maxPluginNumber, "Invalid plugin Id");
+    carla_debug("CarlaEngine::removePluginAsync(%i)", id);
+
+    EngineAsyncRequest* request;
+
+    try {
+        request = new EngineAsyncRequest();
+    } CARLA_SAFE_EXCEPTION_RETURN_ERR("new EngineAsyncRequest", "Failed to allocate request");
+
+    request->action   = kEngineAsyncActionRemove;
+    request->pluginId = id;
+
+    return pData->asyncLoader.queue(request);
+}
+
+uint CarlaEngine::replacePluginAsync(const uint id,
+                                     const BinaryType btype,
+                                     const PluginType ptype,
+                                     const char* const filename,
+                                     const char* const name,
+                                     const char* const label,
+                                     const int64_t uniqueId,
+                                     const char* const extra,
+                                     const uint options)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextPluginId == pData->maxPluginNumber, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id <= pData->maxPluginNumber, "Invalid plugin Id");
+    CARLA_SAFE_ASSERT_RETURN_ERR(btype != BINARY_NONE, "Invalid plugin binary mode");
+    CARLA_SAFE_ASSERT_RETURN_ERR(ptype != PLUGIN_NONE, "Invalid plugin type");
+    CARLA_SAFE_ASSERT_RETURN_ERR((filename != nullptr && filename[0] != '\0') || (label != nullptr && label[0] != '\0'), "Invalid plugin filename and label");
+    carla_debug("CarlaEngine::replacePluginAsync(%i, %i:%s, %i:%s, \"%s\", \"%s\", \"%s\", " P_INT64 ", \"%s\", %u)",
+                id, btype, BinaryType2Str(btype), ptype, PluginType2Str(ptype), filename, name, label, uniqueId, extra, options);
+
+#ifndef CARLA_OS_WIN
+    if (ptype != PLUGIN_JACK && ptype != PLUGIN_LV2 && filename != nullptr && filename[0] != '\0') {
+        CARLA_SAFE_ASSERT_RETURN_ERR(filename[0] == CARLA_OS_SEP || filename[0] == '.' || filename[0] == '~', "Invalid plugin filename");
+    }
+#endif
+
+    EngineAsyncRequest* request;
+
+    try {
+        request = new EngineAsyncRequest();
+    } CARLA_SAFE_EXCEPTION_RETURN_ERR("new EngineAsyncRequest", "Failed to allocate request");
+
+    request->action   = id == pData->maxPluginNumber ? kEngineAsyncActionAdd : kEngineAsyncActionReplace;
+    request->pluginId = id == pData->maxPluginNumber ? 0 : id;
+    request->btype    = btype;
+    request->ptype    = ptype;
+    request->filename = filename;
+    request->name     = name;
+    request->label    = label;
+    request->extra    = extra;
+    request->uniqueId = uniqueId;
+    request->options  = options;
+
+    return pData->asyncLoader.queue(request);
+}
 #endif
 
 void CarlaEngine::touchPluginParameter(const uint, const uint32_t, const bool) noexcept
@@ -1364,8 +1533,10 @@ bool CarlaEngine::loadProject(const char* const filename, const bool setAsCurren
 #endif
     }
 
-    XmlDocument xml(file);
-    return loadProjectInternal(xml, !setAsCurrentProject);
+    MemoryBlock data;
+    CARLA_SAFE_ASSERT_RETURN_ERR(file.loadFileAsData(data), "Failed to read project file");
+
+    return loadProjectInternal(static_cast<char*>(data.getData()), data.getSize(), !setAsCurrentProject, filename);
 }
 
 bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurrentProject)
@@ -1396,14 +1567,23 @@ bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurren
 #endif
     }
 
+    const bool useChunkFiles = pData->options.projectChunkFiles;
+    CarlaStateChunkFiles chunkFiles(filename);
+
     MemoryOutputStream out;
-    saveProjectInternal(out);
+    saveProjectInternal(out, useChunkFiles ? &chunkFiles : nullptr);
 
     const String jfilename = String(CharPointer_UTF8(filename));
     File file(jfilename);
 
     if (file.replaceWithData(out.getData(), out.getDataSize()))
+    {
+        // only now it is safe to remove chunks from previous saves,
+        // or the whole chunks folder if this save did not use it
+        chunkFiles.removeUnused();
+
         return true;
+    }
 
     setLastError("Failed to write file");
     return false;
@@ -1736,6 +1916,12 @@ const char* CarlaEngine::getLastError() const noexcept
 
 void CarlaEngine::setLastError(const char* const error) const noexcept
 {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // plugins created asynchronously report errors through their request, lastError belongs to the main thread
+    if (pData->asyncLoader.isLoaderThread())
+        return pData->asyncLoader.setLoadError(error);
+#endif
+
     pData->lastError = error;
 }
 
@@ -2127,6 +2313,21 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
                                         ? carla_strdup_safe(valueStr)
                                         : nullptr;
         break;
+
+    case ENGINE_OPTION_PROJECT_CHUNK_FILES:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.projectChunkFiles = (value != 0);
+        break;
+
+    case ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.pluginSleepTimeout = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.bridgeProcessPoolSize = static_cast<uint>(value);
+        break;
     }
 }
 
@@ -2253,7 +2454,7 @@ void CarlaEngine::setPluginPeaksRT(const uint pluginId, float const inPeaks[2],
     pluginData.peaks[3] = outPeaks[1];
 }
 
-void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) const
+void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream, CarlaStateChunkFiles* const chunkFiles) const
 {
     // send initial prepareForSave first, giving time for bridges to act
     for (uint i=0; i < pData->curPluginCount; ++i)
@@ -2335,7 +2536,7 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
             if (plugin->isEnabled())
             {
                 MemoryOutputStream outPlugin(4096), streamPlugin;
-                plugin->getStateSave(false).dumpToMemoryStream(streamPlugin);
+                plugin->getStateSave(false, chunkFiles).dumpToMemoryStream(streamPlugin);
 
                 outPlugin << "\n";
 
@@ -2576,11 +2777,45 @@ static String findBinaryInCustomPath(const char* const searchPath, const char* c
     return String();
 }
 
-bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alwaysLoadConnections)
+// reads project elements until the next plugin, everything else is kept in 'xmlElement'
+// returns false at the end of the project, or on error
+static bool readProjectUntilNextPlugin(CarlaXmlReader& reader, XmlElement* const xmlElement)
 {
-    carla_debug("CarlaEngine::loadProjectInternal(%p, %s) - START", &xmlDoc, bool2str(alwaysLoadConnections));
+    for (;;)
+    {
+        switch (reader.next())
+        {
+        case CarlaXmlReader::kTokenStartElement:
+            if (std::strcmp(reader.getName(), "Plugin") == 0)
+                return true;
+
+            if (XmlElement* const elem = reader.readElementAsXml())
+            {
+                xmlElement->addChildElement(elem);
+                break;
+            }
+            return false;
+
+        default:
+            // end of project, or error
+            return false;
+        }
+    }
+}
+
+bool CarlaEngine::loadProjectInternal(char* const xmlData, const std::size_t xmlSize, const bool alwaysLoadConnections,
+                                      const char* const projectFilename)
+{
+    carla_debug("CarlaEngine::loadProjectInternal(%p, " P_SIZE ", %s) - START", xmlData, xmlSize, bool2str(alwaysLoadConnections));
+
+    CARLA_SAFE_ASSERT_RETURN_ERR(xmlData != nullptr && xmlSize != 0, "Failed to parse project file");
 
-    CarlaScopedPointer<XmlElement> xmlElement(xmlDoc.getDocumentElement(true));
+    // project is read as we go, plugins are loaded as soon as their state is read
+    // everything else is small, and kept as XML elements inside the main one
+    CarlaXmlReader reader(xmlData, xmlSize);
+    CARLA_SAFE_ASSERT_RETURN_ERR(reader.next() == CarlaXmlReader::kTokenStartElement, "Failed to parse project file");
+
+    CarlaScopedPointer<XmlElement> xmlElement(reader.createXmlElement());
     CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement != nullptr, "Failed to parse project file");
 
     const String& xmlType(xmlElement->getTagName());
@@ -2593,6 +2828,15 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
         return false;
     }
 
+    // reject truncated files before loading anything.
+    // other parse errors are only found when reached, plugins loaded before that point are kept.
+    if (! reader.endsWithRootEndTag())
+    {
+        callback(true, true, ENGINE_CALLBACK_PROJECT_LOAD_FINISHED, 0, 0, 0, 0, 0.0f, nullptr);
+        setLastError("Failed to parse project file, it is incomplete");
+        return false;
+    }
+
     pData->actionCanceled = false;
     callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 1, 0, 0, 0.0f, "Loading project");
 
@@ -2611,9 +2855,8 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
     const CarlaScopedValueSetter<bool> csvs(pData->loadingProject, true, false);
 #endif
 
-    // completely load file
-    xmlElement = xmlDoc.getDocumentElement(false);
-    CARLA_SAFE_ASSERT_RETURN_ERR(xmlElement != nullptr, "Failed to completely parse project file");
+    // read everything before the first plugin, engine settings and transport are there
+    bool hasPlugin = isPreset || readProjectUntilNextPlugin(reader, xmlElement);
 
     if (pData->aboutToClose)
         return true;
@@ -2778,285 +3021,296 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
     }
 
     // and we handle plugins
-    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    for (; hasPlugin; hasPlugin = readProjectUntilNextPlugin(reader, xmlElement))
     {
-        const String& tagName(elem->getTagName());
+        CarlaStateSave stateSave;
 
-        if (isPreset || tagName == "Plugin")
+        if (! stateSave.fillFromXmlReader(reader))
+            break;
+
+        // chunk files are stored relative to the project file
+        if (stateSave.chunkFile != nullptr)
         {
-            CarlaStateSave stateSave;
-            stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
+            const String chunkFile(projectFilename != nullptr
+                                   ? CarlaStateChunkFiles::getFullPath(projectFilename, stateSave.chunkFile)
+                                   : String());
 
-            if (pData->aboutToClose)
-                return true;
+            delete[] stateSave.chunkFile;
+            stateSave.chunkFile = chunkFile.isNotEmpty() ? carla_strdup(chunkFile.toRawUTF8()) : nullptr;
 
-            if (pData->actionCanceled)
-            {
-                setLastError("Project load canceled");
-                return false;
-            }
+            if (projectFilename == nullptr)
+                carla_stderr2("CarlaEngine::loadProjectInternal() - Plugin chunk file cannot be used without a project file");
+        }
+
+        if (pData->aboutToClose)
+            return true;
+
+        if (pData->actionCanceled)
+        {
+            setLastError("Project load canceled");
+            return false;
+        }
 
-            CARLA_SAFE_ASSERT_CONTINUE(stateSave.type != nullptr);
+        CARLA_SAFE_ASSERT_CONTINUE(stateSave.type != nullptr);
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-            // compatibility code to load projects with GIG files
-            // FIXME Remove on 2.1 release
-            if (std::strcmp(stateSave.type, "GIG") == 0)
+        // compatibility code to load projects with GIG files
+        // FIXME Remove on 2.1 release
+        if (std::strcmp(stateSave.type, "GIG") == 0)
+        {
+            if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://linuxsampler.org/plugins/linuxsampler", 0, nullptr))
             {
-                if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://linuxsampler.org/plugins/linuxsampler", 0, nullptr))
+                const uint pluginId = pData->curPluginCount;
+
+                if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
                 {
-                    const uint pluginId = pData->curPluginCount;
+                    if (pData->aboutToClose)
+                        return true;
 
-                    if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
+                    if (pData->actionCanceled)
                     {
-                        if (pData->aboutToClose)
-                            return true;
+                        setLastError("Project load canceled");
+                        return false;
+                    }
 
-                        if (pData->actionCanceled)
-                        {
-                            setLastError("Project load canceled");
-                            return false;
-                        }
+                    String lsState;
+                    lsState << "0.35\n";
+                    lsState << "18 0 Chromatic\n";
+                    lsState << "18 1 Drum Kits\n";
+                    lsState << "20 0\n";
+                    lsState << "0 1 " << stateSave.binary << "\n";
+                    lsState << "0 0 0 0 1 0 GIG\n";
+
+                    plugin->setCustomData(LV2_ATOM__String, "http://linuxsampler.org/schema#state-string", lsState.toRawUTF8(), true);
+                    plugin->restoreLV2State(true);
+
+                    plugin->setDryWet(stateSave.dryWet, true, true);
+                    plugin->setVolume(stateSave.volume, true, true);
+                    plugin->setBalanceLeft(stateSave.balanceLeft, true, true);
+                    plugin->setBalanceRight(stateSave.balanceRight, true, true);
+                    plugin->setPanning(stateSave.panning, true, true);
+                    plugin->setCtrlChannel(stateSave.ctrlChannel, true, true);
+                    plugin->setActive(stateSave.active, true, true);
+                    plugin->setEnabled(true);
 
-                        String lsState;
-                        lsState << "0.35\n";
-                        lsState << "18 0 Chromatic\n";
-                        lsState << "18 1 Drum Kits\n";
-                        lsState << "20 0\n";
-                        lsState << "0 1 " << stateSave.binary << "\n";
-                        lsState << "0 0 0 0 1 0 GIG\n";
-
-                        plugin->setCustomData(LV2_ATOM__String, "http://linuxsampler.org/schema#state-string", lsState.toRawUTF8(), true);
-                        plugin->restoreLV2State(true);
-
-                        plugin->setDryWet(stateSave.dryWet, true, true);
-                        plugin->setVolume(stateSave.volume, true, true);
-                        plugin->setBalanceLeft(stateSave.balanceLeft, true, true);
-                        plugin->setBalanceRight(stateSave.balanceRight, true, true);
-                        plugin->setPanning(stateSave.panning, true, true);
-                        plugin->setCtrlChannel(stateSave.ctrlChannel, true, true);
-                        plugin->setActive(stateSave.active, true, true);
-                        plugin->setEnabled(true);
-
-                        ++pData->curPluginCount;
-                        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
-
-                        if (isPatchbay)
-                            pData->graph.addPlugin(plugin);
-                    }
-                    else
-                    {
-                        carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
-                    }
+                    ++pData->curPluginCount;
+                    callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
+
+                    if (isPatchbay)
+                        pData->graph.addPlugin(plugin);
                 }
                 else
                 {
-                    carla_stderr2("Failed to load a linuxsampler LV2 plugin, GIG file won't be loaded");
+                    carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
                 }
-
-                callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
-                continue;
             }
+            else
+            {
+                carla_stderr2("Failed to load a linuxsampler LV2 plugin, GIG file won't be loaded");
+            }
+
+            callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+            continue;
+        }
 # ifdef SFZ_FILES_USING_SFIZZ
-            if (std::strcmp(stateSave.type, "SFZ") == 0)
+        if (std::strcmp(stateSave.type, "SFZ") == 0)
+        {
+            if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://sfztools.github.io/sfizz", 0, nullptr))
             {
-                if (addPlugin(PLUGIN_LV2, "", stateSave.name, "http://sfztools.github.io/sfizz", 0, nullptr))
+                const uint pluginId = pData->curPluginCount;
+
+                if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
                 {
-                    const uint pluginId = pData->curPluginCount;
+                    if (pData->aboutToClose)
+                        return true;
 
-                    if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
+                    if (pData->actionCanceled)
                     {
-                        if (pData->aboutToClose)
-                            return true;
-
-                        if (pData->actionCanceled)
-                        {
-                            setLastError("Project load canceled");
-                            return false;
-                        }
+                        setLastError("Project load canceled");
+                        return false;
+                    }
 
-                        plugin->setCustomData(LV2_ATOM__Path,
-                                              "http://sfztools.github.io/sfizz:sfzfile",
-                                              stateSave.binary,
-                                              false);
+                    plugin->setCustomData(LV2_ATOM__Path,
+                                          "http://sfztools.github.io/sfizz:sfzfile",
+                                          stateSave.binary,
+                                          false);
 
-                        plugin->restoreLV2State(true);
+                    plugin->restoreLV2State(true);
 
-                        plugin->setDryWet(stateSave.dryWet, true, true);
-                        plugin->setVolume(stateSave.volume, true, true);
-                        plugin->setBalanceLeft(stateSave.balanceLeft, true, true);
-                        plugin->setBalanceRight(stateSave.balanceRight, true, true);
-                        plugin->setPanning(stateSave.panning, true, true);
-                        plugin->setCtrlChannel(stateSave.ctrlChannel, true, true);
-                        plugin->setActive(stateSave.active, true, true);
-                        plugin->setEnabled(true);
+                    plugin->setDryWet(stateSave.dryWet, true, true);
+                    plugin->setVolume(stateSave.volume, true, true);
+                    plugin->setBalanceLeft(stateSave.balanceLeft, true, true);
+                    plugin->setBalanceRight(stateSave.balanceRight, true, true);
+                    plugin->setPanning(stateSave.panning, true, true);
+                    plugin->setCtrlChannel(stateSave.ctrlChannel, true, true);
+                    plugin->setActive(stateSave.active, true, true);
+                    plugin->setEnabled(true);
 
-                        ++pData->curPluginCount;
-                        callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
+                    ++pData->curPluginCount;
+                    callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
 
-                        if (isPatchbay)
-                            pData->graph.addPlugin(plugin);
-                    }
-                    else
-                    {
-                        carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
-                    }
+                    if (isPatchbay)
+                        pData->graph.addPlugin(plugin);
                 }
                 else
                 {
-                    carla_stderr2("Failed to load a sfizz LV2 plugin, SFZ file won't be loaded");
+                    carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
                 }
-
-                callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
-                continue;
             }
+            else
+            {
+                carla_stderr2("Failed to load a sfizz LV2 plugin, SFZ file won't be loaded");
+            }
+
+            callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+            continue;
+        }
 # endif
 #endif
 
-            const void* extraStuff    = nullptr;
-            static const char kTrue[] = "true";
+        const void* extraStuff    = nullptr;
+        static const char kTrue[] = "true";
 
-            const PluginType ptype(getPluginTypeFromString(stateSave.type));
+        const PluginType ptype(getPluginTypeFromString(stateSave.type));
 
-            switch (ptype)
+        switch (ptype)
+        {
+        case PLUGIN_SF2:
+            if (CarlaString(stateSave.label).endsWith(" (16 outs)"))
+                extraStuff = kTrue;
+            // fall through
+        case PLUGIN_LADSPA:
+        case PLUGIN_DSSI:
+        case PLUGIN_VST2:
+        case PLUGIN_VST3:
+        case PLUGIN_SFZ:
+            if (stateSave.binary != nullptr && stateSave.binary[0] != '\0' &&
+                ! (File::isAbsolutePath(stateSave.binary) && File(stateSave.binary).exists()))
             {
-            case PLUGIN_SF2:
-                if (CarlaString(stateSave.label).endsWith(" (16 outs)"))
-                    extraStuff = kTrue;
-                // fall through
-            case PLUGIN_LADSPA:
-            case PLUGIN_DSSI:
-            case PLUGIN_VST2:
-            case PLUGIN_VST3:
-            case PLUGIN_SFZ:
-                if (stateSave.binary != nullptr && stateSave.binary[0] != '\0' &&
-                    ! (File::isAbsolutePath(stateSave.binary) && File(stateSave.binary).exists()))
-                {
-                    const char* searchPath;
+                const char* searchPath;
 
-                    switch (ptype)
-                    {
-                    case PLUGIN_LADSPA: searchPath = pData->options.pathLADSPA; break;
-                    case PLUGIN_DSSI:   searchPath = pData->options.pathDSSI;   break;
-                    case PLUGIN_VST2:   searchPath = pData->options.pathVST2;   break;
-                    case PLUGIN_VST3:   searchPath = pData->options.pathVST3;   break;
-                    case PLUGIN_SF2:    searchPath = pData->options.pathSF2;    break;
-                    case PLUGIN_SFZ:    searchPath = pData->options.pathSFZ;    break;
-                    default:            searchPath = nullptr;                   break;
-                    }
+                switch (ptype)
+                {
+                case PLUGIN_LADSPA: searchPath = pData->options.pathLADSPA; break;
+                case PLUGIN_DSSI:   searchPath = pData->options.pathDSSI;   break;
+                case PLUGIN_VST2:   searchPath = pData->options.pathVST2;   break;
+                case PLUGIN_VST3:   searchPath = pData->options.pathVST3;   break;
+                case PLUGIN_SF2:    searchPath = pData->options.pathSF2;    break;
+                case PLUGIN_SFZ:    searchPath = pData->options.pathSFZ;    break;
+                default:            searchPath = nullptr;                   break;
+                }
 
-                    if (searchPath != nullptr && searchPath[0] != '\0')
-                    {
-                        carla_stderr("Plugin binary '%s' doesn't exist on this filesystem, let's look for it...",
-                                     stateSave.binary);
+                if (searchPath != nullptr && searchPath[0] != '\0')
+                {
+                    carla_stderr("Plugin binary '%s' doesn't exist on this filesystem, let's look for it...",
+                                 stateSave.binary);
 
-                        String result = findBinaryInCustomPath(searchPath, stateSave.binary);
+                    String result = findBinaryInCustomPath(searchPath, stateSave.binary);
 
-                        if (result.isEmpty())
+                    if (result.isEmpty())
+                    {
+                        switch (ptype)
                         {
-                            switch (ptype)
-                            {
-                            case PLUGIN_LADSPA: searchPath = std::getenv("LADSPA_PATH"); break;
-                            case PLUGIN_DSSI:   searchPath = std::getenv("DSSI_PATH");   break;
-                            case PLUGIN_VST2:   searchPath = std::getenv("VST_PATH");    break;
-                            case PLUGIN_VST3:   searchPath = std::getenv("VST3_PATH");   break;
-                            case PLUGIN_SF2:    searchPath = std::getenv("SF2_PATH");    break;
-                            case PLUGIN_SFZ:    searchPath = std::getenv("SFZ_PATH");    break;
-                            default:            searchPath = nullptr;                    break;
-                            }
-
-                            if (searchPath != nullptr && searchPath[0] != '\0')
-                                result = findBinaryInCustomPath(searchPath, stateSave.binary);
+                        case PLUGIN_LADSPA: searchPath = std::getenv("LADSPA_PATH"); break;
+                        case PLUGIN_DSSI:   searchPath = std::getenv("DSSI_PATH");   break;
+                        case PLUGIN_VST2:   searchPath = std::getenv("VST_PATH");    break;
+                        case PLUGIN_VST3:   searchPath = std::getenv("VST3_PATH");   break;
+                        case PLUGIN_SF2:    searchPath = std::getenv("SF2_PATH");    break;
+                        case PLUGIN_SFZ:    searchPath = std::getenv("SFZ_PATH");    break;
+                        default:            searchPath = nullptr;                    break;
                         }
 
-                        if (result.isNotEmpty())
-                        {
-                            delete[] stateSave.binary;
-                            stateSave.binary = carla_strdup(result.toRawUTF8());
-                            carla_stderr("Found it! :)");
-                        }
-                        else
-                        {
-                            carla_stderr("Damn, we failed... :(");
-                        }
+                        if (searchPath != nullptr && searchPath[0] != '\0')
+                            result = findBinaryInCustomPath(searchPath, stateSave.binary);
+                    }
 
-                        callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+                    if (result.isNotEmpty())
+                    {
+                        delete[] stateSave.binary;
+                        stateSave.binary = carla_strdup(result.toRawUTF8());
+                        carla_stderr("Found it! :)");
+                    }
+                    else
+                    {
+                        carla_stderr("Damn, we failed... :(");
                     }
+
+                    callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
                 }
-                break;
-            default:
-                break;
             }
+            break;
+        default:
+            break;
+        }
 
-            BinaryType btype;
+        BinaryType btype;
 
-            switch (ptype)
-            {
-            case PLUGIN_LADSPA:
-            case PLUGIN_DSSI:
-            case PLUGIN_LV2:
-            case PLUGIN_VST2:
-            case PLUGIN_VST3:
-                btype = getBinaryTypeFromFile(stateSave.binary);
-                break;
-            default:
-                btype = BINARY_NATIVE;
-                break;
-            }
+        switch (ptype)
+        {
+        case PLUGIN_LADSPA:
+        case PLUGIN_DSSI:
+        case PLUGIN_LV2:
+        case PLUGIN_VST2:
+        case PLUGIN_VST3:
+            btype = getBinaryTypeFromFile(stateSave.binary);
+            break;
+        default:
+            btype = BINARY_NATIVE;
+            break;
+        }
 
-            if (addPlugin(btype, ptype, stateSave.binary,
-                          stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
-            {
+        if (addPlugin(btype, ptype, stateSave.binary,
+                      stateSave.name, stateSave.label, stateSave.uniqueId, extraStuff, stateSave.options))
+        {
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                const uint pluginId = pData->curPluginCount;
+            const uint pluginId = pData->curPluginCount;
 #else
-                const uint pluginId = 0;
+            const uint pluginId = 0;
 #endif
 
-                if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
-                {
-                    if (pData->aboutToClose)
-                        return true;
+            if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
+            {
+                if (pData->aboutToClose)
+                    return true;
 
-                    if (pData->actionCanceled)
-                    {
-                        setLastError("Project load canceled");
-                        return false;
-                    }
+                if (pData->actionCanceled)
+                {
+                    setLastError("Project load canceled");
+                    return false;
+                }
 
-                    // deactivate bridge client-side ping check, since some plugins block during load
-                    if ((plugin->getHints() & PLUGIN_IS_BRIDGE) != 0 && ! isPreset)
-                        plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
+                // deactivate bridge client-side ping check, since some plugins block during load
+                if ((plugin->getHints() & PLUGIN_IS_BRIDGE) != 0 && ! isPreset)
+                    plugin->setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaPingOnOff__", "false", false);
 
-                    plugin->loadStateSave(stateSave);
+                plugin->loadStateSave(stateSave);
 
-                    /* NOTE: The following code is the same as the end of addPlugin().
-                     *       When project is loading we do not enable the plugin right away,
-                     *        as we want to load state first.
-                     */
-                    plugin->setEnabled(true);
+                /* NOTE: The following code is the same as the end of addPlugin().
+                 *       When project is loading we do not enable the plugin right away,
+                 *        as we want to load state first.
+                 */
+                plugin->setEnabled(true);
 
-                    ++pData->curPluginCount;
-                    callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
+                ++pData->curPluginCount;
+                callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, pluginId, 0, 0, 0, 0.0f, plugin->getName());
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                    if (isPatchbay)
-                        pData->graph.addPlugin(plugin);
+                if (isPatchbay)
+                    pData->graph.addPlugin(plugin);
 #endif
-                }
-                else
-                {
-                    carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
-                }
             }
             else
             {
-                carla_stderr2("Failed to load a plugin '%s', error was:\n%s", stateSave.name, getLastError());
+                carla_stderr2("Failed to get new plugin, state will not be restored correctly\n");
             }
-
-            if (! isPreset)
-                callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
         }
+        else
+        {
+            carla_stderr2("Failed to load a plugin '%s', error was:\n%s", stateSave.name, getLastError());
+        }
+
+        if (! isPreset)
+            callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
 
         if (isPreset)
         {
@@ -3066,6 +3320,13 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
         }
     }
 
+    if (reader.hasError())
+    {
+        carla_stderr2("CarlaEngine::loadProjectInternal() - Failed to parse project file: %s", reader.getError());
+        setLastError("Failed to parse project file");
+        return false;
+    }
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     // tell bridges we're done loading
     for (uint i=0; i < pData->curPluginCount; ++i)
@@ -3452,7 +3713,7 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
     callback(true, true, ENGINE_CALLBACK_PROJECT_LOAD_FINISHED, 0, 0, 0, 0, 0.0f, nullptr);
     callback(true, true, ENGINE_CALLBACK_CANCELABLE_ACTION, 0, 0, 0, 0, 0.0f, "Loading project");
 
-    carla_debug("CarlaEngine::loadProjectInternal(%p, %s) - END", &xmlDoc, bool2str(alwaysLoadConnections));
+    carla_debug("CarlaEngine::loadProjectInternal(%p, " P_SIZE ", %s) - END", xmlData, xmlSize, bool2str(alwaysLoadConnections));
     return true;
 
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -241,6 +241,9 @@ EngineOptions::EngineOptions() noexcept
       resourceDir(nullptr),
       clientNamePrefix(nullptr),
       preventBadBehaviour(false),
+      projectChunkFiles(false),
+      pluginSleepTimeout(2000),
+      bridgeProcessPoolSize(0),
       frontendWinId(0)
 #ifndef CARLA_OS_WIN
       , wine()
@@ -228,7 +228,7 @@ bool ExternalGraph::connect(const bool sendHost, const bool sendOSC,
     kEngine->callback(sendHost, sendOSC,
                       ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED, connectionToId.id, 0, 0, 0, 0.0f, strBuf);
 
-    connections.list.append(connectionToId);
+    connections.add(connectionToId);
     return true;
 }
 
@@ -309,7 +309,7 @@ bool ExternalGraph::disconnect(const bool sendHost, const bool sendOSC,
         kEngine->callback(sendHost, sendOSC,
                           ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED, connectionToId.id, 0, 0, 0, 0.0f, nullptr);
 
-        connections.list.remove(it);
+        connections.remove(connectionId);
         return true;
     }
 
@@ -863,7 +863,7 @@ void RackGraph::refresh(const bool sendHost, const bool sendOSC, const bool, con
                           0, 0, 0, 0.0f,
                           strBuf);
 
-        extGraph.connections.list.append(connectionToId);
+        extGraph.connections.add(connectionToId);
     }
 
     for (LinkedList<uint>::Itenerator it = audioBuffers.connectedIn2.begin2(); it.valid(); it.next())
@@ -883,7 +883,7 @@ void RackGraph::refresh(const bool sendHost, const bool sendOSC, const bool, con
                           0, 0, 0, 0.0f,
                           strBuf);
 
-        extGraph.connections.list.append(connectionToId);
+        extGraph.connections.add(connectionToId);
     }
 
     for (LinkedList<uint>::Itenerator it = audioBuffers.connectedOut1.begin2(); it.valid(); it.next())
@@ -903,7 +903,7 @@ void RackGraph::refresh(const bool sendHost, const bool sendOSC, const bool, con
                           0, 0, 0, 0.0f,
                           strBuf);
 
-        extGraph.connections.list.append(connectionToId);
+        extGraph.connections.add(connectionToId);
     }
 
     for (LinkedList<uint>::Itenerator it = audioBuffers.connectedOut2.begin2(); it.valid(); it.next())
@@ -923,7 +923,7 @@ void RackGraph::refresh(const bool sendHost, const bool sendOSC, const bool, con
                           0, 0, 0, 0.0f,
                           strBuf);
 
-        extGraph.connections.list.append(connectionToId);
+        extGraph.connections.add(connectionToId);
     }
 }
 
@@ -964,6 +964,10 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     uint32_t oldMidiOutCount  = 0;
     bool processed = false;
 
+    // audio inputs are known to be silent, only after a sleeping plugin
+    bool inSilent  = false;
+    bool outSilent = false;
+
     // process plugins
     for (uint i=0; i < data->curPluginCount; ++i)
     {
@@ -977,6 +981,7 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
             // initialize audio inputs (from previous outputs)
             carla_copyFloats(inBuf0, outBufReal[0], frames);
             carla_copyFloats(inBuf1, outBufReal[1], frames);
+            inSilent = outSilent;
 
             // initialize audio outputs (zero)
             carla_zeroFloats(outBufReal[0], frames);
@@ -1035,7 +1040,19 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
 
         // process
         plugin->initBuffers();
-        plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+
+        if (plugin->isSleepingRT(inBuf, inSilent, frames))
+        {
+            // outputs are already zero
+            outSilent = true;
+        }
+        else
+        {
+            plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+            plugin->updateSleepStateRT(outBuf, frames);
+            outSilent = false;
+        }
+
         plugin->unlock();
 
         // if plugin has no audio inputs, add input buffer
@@ -1043,6 +1060,7 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
         {
             carla_addFloats(outBufReal[0], inBuf0, frames);
             carla_addFloats(outBufReal[1], inBuf1, frames);
+            outSilent = outSilent && inSilent;
         }
 
         // if plugin only has 1 output, copy it to the 2nd
@@ -1544,6 +1562,7 @@ public:
         {
             // processing audio, include code for peaks
             const uint32_t numChan2 = jmin(numAudioChan, 2U);
+            const bool inputSilent  = fPlugin->getAudioInCount() == 0 || areInputsSilent();
 
             if (fPlugin->getAudioInCount() == 0)
                 audio.clear();
@@ -1562,15 +1581,27 @@ public:
             float inPeaks[2] = { 0.0f };
             float outPeaks[2] = { 0.0f };
 
-            for (uint32_t i=0, count=jmin(fPlugin->getAudioInCount(), numChan2); i<count; ++i)
-                inPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+            if (fPlugin->isSleepingRT(const_cast<const float**>(audioBuffers), inputSilent, numSamples))
+            {
+                // sleeping, let the graph know our outputs are silent
+                audio.clear();
+                cvOut.clear();
+                setOutputsSilent(true);
+            }
+            else
+            {
+                for (uint32_t i=0, count=jmin(fPlugin->getAudioInCount(), numChan2); i<count; ++i)
+                    inPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
 
-            fPlugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
-                             cvInBuffers, cvOutBuffers,
-                             numSamples);
+                fPlugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
+                                 cvInBuffers, cvOutBuffers,
+                                 numSamples);
+
+                fPlugin->updateSleepStateRT(const_cast<const float**>(audioBuffers), numSamples);
 
-            for (uint32_t i=0, count=jmin(fPlugin->getAudioOutCount(), numChan2); i<count; ++i)
-                outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+                for (uint32_t i=0, count=jmin(fPlugin->getAudioOutCount(), numChan2); i<count; ++i)
+                    outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+            }
 
             kEngine->setPluginPeaksRT(fPlugin->getId(), inPeaks, outPeaks);
         }
@@ -1709,7 +1740,8 @@ PatchbayGraph::PatchbayGraph(CarlaEngine* const engine,
       usingExternalHost(false),
       usingExternalOSC(false),
       extGraph(engine),
-      kEngine(engine)
+      kEngine(engine),
+      fPrunedGroupsChanged(false)
 {
     const uint32_t bufferSize(engine->getBufferSize());
     const double   sampleRate(engine->getSampleRate());
@@ -1880,6 +1912,7 @@ void PatchbayGraph::addPlugin(const CarlaPluginPtr plugin)
     const bool sendOSC  = !usingExternalOSC;
 
     plugin->setPatchbayNodeId(node->nodeId);
+    graph.setNodeAlwaysProcessed(node->nodeId, plugin->getOptionsEnabled() & PLUGIN_OPTION_ALWAYS_PROCESS);
 
     node->properties.set("isPlugin", true);
     node->properties.set("pluginId", static_cast<int>(plugin->getId()));
@@ -1912,6 +1945,7 @@ void PatchbayGraph::replacePlugin(const CarlaPluginPtr oldPlugin, const CarlaPlu
     CARLA_SAFE_ASSERT_RETURN(node != nullptr,);
 
     newPlugin->setPatchbayNodeId(node->nodeId);
+    graph.setNodeAlwaysProcessed(node->nodeId, newPlugin->getOptionsEnabled() & PLUGIN_OPTION_ALWAYS_PROCESS);
 
     node->properties.set("isPlugin", true);
     node->properties.set("pluginId", static_cast<int>(newPlugin->getId()));
@@ -1979,6 +2013,8 @@ void PatchbayGraph::reconfigureForCV(const CarlaPluginPtr plugin, const uint por
         graph.buildRenderingSequence();
     }
 
+    sendPrunedGroups(sendHost, sendOSC, false);
+
     const uint newCvIn = proc->getTotalNumInputChannels(AudioProcessor::ChannelTypeCV);
     // const uint newCvOut = proc->getTotalNumOutputChannels(AudioProcessor::ChannelTypeCV);
 
@@ -2098,7 +2134,7 @@ bool PatchbayGraph::connect(const bool external,
                       0, 0, 0, 0.0f,
                       strBuf);
 
-    connections.list.append(connectionToId);
+    connections.add(connectionToId);
     return true;
 }
 
@@ -2107,56 +2143,50 @@ bool PatchbayGraph::disconnect(const bool external, const uint connectionId)
     if (external)
         return extGraph.disconnect(usingExternalHost, usingExternalOSC, connectionId);
 
-    for (LinkedList<ConnectionToId>::Itenerator it=connections.list.begin2(); it.valid(); it.next())
-    {
-        static const ConnectionToId fallback = { 0, 0, 0, 0, 0 };
-
-        const ConnectionToId& connectionToId(it.getValue(fallback));
-        CARLA_SAFE_ASSERT_CONTINUE(connectionToId.id > 0);
+    const ConnectionToId& connectionToId(connections.getConnection(connectionId));
 
-        if (connectionToId.id != connectionId)
-            continue;
+    if (connectionToId.id == 0)
+    {
+        kEngine->setLastError("Failed to find connection");
+        return false;
+    }
 
-        uint adjustedPortA = connectionToId.portA;
-        uint adjustedPortB = connectionToId.portB;
+    uint adjustedPortA = connectionToId.portA;
+    uint adjustedPortB = connectionToId.portB;
 
-        AudioProcessor::ChannelType channelType;
-        if (! adjustPatchbayPortIdForWater(channelType, adjustedPortA))
-            return false;
-        if (! adjustPatchbayPortIdForWater(channelType, adjustedPortB))
-            return false;
-
-        if (! graph.removeConnection(channelType,
-                                     connectionToId.groupA, adjustedPortA,
-                                     connectionToId.groupB, adjustedPortB))
-            return false;
+    AudioProcessor::ChannelType channelType;
+    if (! adjustPatchbayPortIdForWater(channelType, adjustedPortA))
+        return false;
+    if (! adjustPatchbayPortIdForWater(channelType, adjustedPortB))
+        return false;
 
-        kEngine->callback(!usingExternalHost, !usingExternalOSC,
-                          ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED,
-                          connectionToId.id,
-                          0, 0, 0, 0.0f,
-                          nullptr);
+    if (! graph.removeConnection(channelType,
+                                 connectionToId.groupA, adjustedPortA,
+                                 connectionToId.groupB, adjustedPortB))
+        return false;
 
-        connections.list.remove(it);
-        return true;
-    }
+    kEngine->callback(!usingExternalHost, !usingExternalOSC,
+                      ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED,
+                      connectionToId.id,
+                      0, 0, 0, 0.0f,
+                      nullptr);
 
-    kEngine->setLastError("Failed to find connection");
-    return false;
+    connections.remove(connectionId);
+    return true;
 }
 
 void PatchbayGraph::disconnectInternalGroup(const uint groupId) noexcept
 {
-    for (LinkedList<ConnectionToId>::Itenerator it=connections.list.begin2(); it.valid(); it.next())
+    LinkedList<ConnectionToId> removed;
+    connections.removeGroup(groupId, &removed);
+
+    for (LinkedList<ConnectionToId>::Itenerator it=removed.begin2(); it.valid(); it.next())
     {
         static const ConnectionToId fallback = { 0, 0, 0, 0, 0 };
 
         const ConnectionToId& connectionToId(it.getValue(fallback));
         CARLA_SAFE_ASSERT_CONTINUE(connectionToId.id > 0);
 
-        if (connectionToId.groupA != groupId && connectionToId.groupB != groupId)
-            continue;
-
         /*
         uint adjustedPortA = connectionToId.portA;
         uint adjustedPortB = connectionToId.portB;
@@ -2176,9 +2206,9 @@ void PatchbayGraph::disconnectInternalGroup(const uint groupId) noexcept
                           connectionToId.id,
                           0, 0, 0, 0.0f,
                           nullptr);
-
-        connections.list.remove(it);
     }
+
+    removed.clear();
 }
 
 void PatchbayGraph::setGroupPos(const bool sendHost, const bool sendOSC, const bool external,
@@ -2201,6 +2231,15 @@ void PatchbayGraph::setGroupPos(const bool sendHost, const bool sendOSC, const b
                       nullptr);
 }
 
+void PatchbayGraph::setGroupAlwaysProcessed(const uint groupId, const bool alwaysProcessed)
+{
+    // plugins not yet added to the graph will get the flag from their options later
+    if (graph.getNodeForId(groupId) == nullptr)
+        return;
+
+    graph.setNodeAlwaysProcessed(groupId, alwaysProcessed);
+}
+
 void PatchbayGraph::refresh(const bool sendHost, const bool sendOSC, const bool external, const char* const deviceName)
 {
     if (external)
@@ -2228,6 +2267,8 @@ void PatchbayGraph::refresh(const bool sendHost, const bool sendOSC, const bool
         addNodeToPatchbay(sendHost, sendOSC, kEngine, node, pluginId, proc);
     }
 
+    sendPrunedGroups(sendHost, sendOSC, true);
+
     char strBuf[STR_MAX+1];
     strBuf[STR_MAX] = '\0';
 
@@ -2269,7 +2310,7 @@ void PatchbayGraph::refresh(const bool sendHost, const bool sendOSC, const bool
                           0, 0, 0, 0.0f,
                           strBuf);
 
-        connections.list.append(connectionToId);
+        connections.add(connectionToId);
     }
 }
 
@@ -2583,7 +2624,47 @@ void PatchbayGraph::run()
     while (! shouldThreadExit())
     {
         carla_msleep(100);
-        graph.reorderNowIfNeeded();
+
+        // callbacks must not be triggered from this thread, idle() sends them from the main thread
+        if (graph.reorderNowIfNeeded())
+            fPrunedGroupsChanged = true;
+    }
+}
+
+void PatchbayGraph::idle()
+{
+    if (! fPrunedGroupsChanged)
+        return;
+
+    fPrunedGroupsChanged = false;
+    sendPrunedGroups(!usingExternalHost, !usingExternalOSC, false);
+}
+
+void PatchbayGraph::sendPrunedGroups(const bool sendHost, const bool sendOSC, const bool force)
+{
+    const CarlaRecursiveMutexLocker cml(graph.getReorderMutex());
+
+    for (int i=0, count=graph.getNumNodes(); i<count; ++i)
+    {
+        AudioProcessorGraph::Node* const node(graph.getNode(i));
+        CARLA_SAFE_ASSERT_CONTINUE(node != nullptr);
+
+        const bool pruned = node->isPruned();
+
+        if (! force && node->properties.getWithDefault("isPruned", false) == water::var(pruned))
+            continue;
+
+        node->properties.set("isPruned", pruned);
+
+        // only report pruned clients on refresh
+        if (force && ! pruned)
+            continue;
+
+        kEngine->callback(sendHost, sendOSC,
+                          ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED,
+                          node->nodeId,
+                          pruned ? 1 : 0,
+                          0, 0, 0.0f, nullptr);
     }
 }
 
@@ -2737,6 +2818,12 @@ void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, co
 // -----------------------------------------------------------------------
 // used for internal patchbay mode
 
+void EngineInternalGraph::idle()
+{
+    if (fIsReady && ! fIsRack && fPatchbay != nullptr)
+        fPatchbay->idle();
+}
+
 void EngineInternalGraph::addPlugin(const CarlaPluginPtr plugin)
 {
     CARLA_SAFE_ASSERT_RETURN(fPatchbay != nullptr,);
@@ -2877,6 +2964,20 @@ bool CarlaEngine::patchbaySetGroupPos(const bool sendHost, const bool sendOSC, c
     }
 }
 
+bool CarlaEngine::patchbaySetGroupAlwaysProcessed(const uint groupId, const bool alwaysProcessed)
+{
+    carla_debug("CarlaEngine::patchbaySetGroupAlwaysProcessed(%u, %s)", groupId, bool2str(alwaysProcessed));
+
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY || ! pData->graph.isReady())
+        return false;
+
+    PatchbayGraph* const graph = pData->graph.getPatchbayGraph();
+    CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
+
+    graph->setGroupAlwaysProcessed(groupId, alwaysProcessed);
+    return true;
+}
+
 bool CarlaEngine::patchbayRefresh(const bool sendHost, const bool sendOSC, const bool external)
 {
     // subclasses should handle this
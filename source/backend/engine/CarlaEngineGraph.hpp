@@ -203,6 +203,7 @@ public:
     bool disconnect(bool external, uint connectionId);
     void disconnectInternalGroup(uint groupId) noexcept;
     void setGroupPos(bool sendHost, bool sendOsc, bool external, uint groupId, int x1, int y1, int x2, int y2);
+    void setGroupAlwaysProcessed(uint groupId, bool alwaysProcessed);
     void refresh(bool sendHost, bool sendOsc, bool external, const char* deviceName);
 
     const char* const* getConnections(bool external) const;
@@ -215,10 +216,17 @@ public:
                  float* const* outBuf,
                  uint32_t frames);
 
+    // sends pending pruned state changes, must be called from the main thread
+    void idle();
+
 private:
     void run() override;
+    void sendPrunedGroups(bool sendHost, bool sendOsc, bool force);
 
     CarlaEngine* const kEngine;
+
+    // set by the graph thread after reordering nodes
+    volatile bool fPrunedGroupsChanged;
     CARLA_DECLARE_NON_COPY_CLASS(PatchbayGraph)
 };
 
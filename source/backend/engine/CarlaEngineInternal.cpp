@@ -19,6 +19,8 @@
 #include "CarlaPlugin.hpp"
 #include "CarlaSemUtils.hpp"
 
+#include "water/misc/Time.h"
+
 #include "jackbridge/JackBridge.hpp"
 
 #include <ctime>
@@ -362,6 +364,467 @@ void EngineNextAction::clearAndReset() noexcept
     mutex.unlock();
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -----------------------------------------------------------------------
+// AsyncLoader
+
+EngineAsyncRequest::EngineAsyncRequest() noexcept
+    : requestId(0),
+      action(kEngineAsyncActionAdd),
+      pluginId(0),
+      btype(BINARY_NONE),
+      ptype(PLUGIN_NONE),
+      filename(),
+      name(),
+      label(),
+      extra(),
+      uniqueId(0),
+      options(0x0),
+      plugin(),
+      oldPlugin(),
+      error() {}
+
+EngineAsyncLoader::EngineAsyncLoader(CarlaEngine* const engine) noexcept
+    : CarlaThread("CarlaEngineAsyncLoader"),
+      listMutex(),
+      nextPlugins(nullptr),
+      nextPluginCount(0),
+      prevPlugins(nullptr),
+      kEngine(engine),
+      fMutex(),
+      fQueue(),
+      fCurrent(nullptr),
+      fCurrentLoaded(false),
+      fPublishing(false),
+      fLastRequestId(0),
+      fNextPluginId(0),
+      fLoadError(),
+      fRetired() {}
+
+EngineAsyncLoader::~EngineAsyncLoader() noexcept
+{
+    CARLA_SAFE_ASSERT(! isThreadRunning());
+    CARLA_SAFE_ASSERT(fCurrent == nullptr);
+    CARLA_SAFE_ASSERT(fQueue.isEmpty());
+    CARLA_SAFE_ASSERT(nextPlugins == nullptr);
+    CARLA_SAFE_ASSERT(prevPlugins == nullptr);
+    CARLA_SAFE_ASSERT(fRetired.isEmpty());
+}
+
+uint EngineAsyncLoader::queue(EngineAsyncRequest* const request) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(request != nullptr, 0);
+
+    uint requestId;
+
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        if (++fLastRequestId == 0)
+            fLastRequestId = 1;
+
+        requestId = request->requestId = fLastRequestId;
+
+        if (fCurrent == nullptr)
+            fNextPluginId = kEngine->pData->curPluginCount;
+
+        if (! fQueue.append(request))
+        {
+            delete request;
+            return 0;
+        }
+    }
+
+    if (! isThreadRunning())
+        startThread();
+
+    return requestId;
+}
+
+bool EngineAsyncLoader::isBusy() const noexcept
+{
+    const CarlaMutexLocker cml(fMutex);
+
+    return fCurrent != nullptr || fQueue.isNotEmpty();
+}
+
+void EngineAsyncLoader::idle() noexcept
+{
+    freeRetiredPlugins(false);
+    process(false);
+}
+
+void EngineAsyncLoader::clear() noexcept
+{
+    // a request being loaded is always finished before the thread stops
+    stopThread(-1);
+
+    // give the audio thread some time to pick up the last plugin list
+    for (int i = 100; --i >= 0;)
+    {
+        process(i == 0);
+
+        {
+            const CarlaMutexLocker cml(fMutex);
+
+            if (fCurrent == nullptr)
+                break;
+        }
+
+        carla_msleep(10);
+    }
+
+    for (EngineAsyncRequest* request;;)
+    {
+        {
+            const CarlaMutexLocker cml(fMutex);
+
+            if (fQueue.isEmpty())
+                break;
+
+            request = nullptr;
+            request = fQueue.getFirst(request, true);
+            fCurrent = request;
+        }
+
+        CARLA_SAFE_ASSERT_CONTINUE(request != nullptr);
+
+        request->error = "Engine was closed before the request could be processed";
+        done(request, false);
+    }
+}
+
+bool EngineAsyncLoader::isLoaderThread() const noexcept
+{
+    return isThreadRunning() && pthread_equal(getThreadId(), pthread_self());
+}
+
+void EngineAsyncLoader::setLoadError(const char* const error) noexcept
+{
+    fLoadError = error;
+}
+
+void EngineAsyncLoader::freeRetiredPlugins(const bool force) noexcept
+{
+    // readers only keep a list for a short moment, like while getting a plugin or peaks out of it
+    static const uint32_t kGracePeriodMs = 2000;
+
+    const uint32_t now = water::Time::getMillisecondCounter();
+
+    for (LinkedList<RetiredPlugins>::Itenerator it = fRetired.begin2(); it.valid(); it.next())
+    {
+        static const RetiredPlugins kRetiredFallback = { nullptr, 0 };
+        const RetiredPlugins& retired(it.getValue(kRetiredFallback));
+
+        if (! force && now - retired.time < kGracePeriodMs)
+            continue;
+
+        delete[] retired.plugins;
+        fRetired.remove(it);
+    }
+}
+
+void EngineAsyncLoader::run() noexcept
+{
+    for (; ! shouldThreadExit();)
+    {
+        EngineAsyncRequest* request = nullptr;
+
+        {
+            const CarlaMutexLocker cml(fMutex);
+
+            if (fCurrent == nullptr && fQueue.isNotEmpty())
+            {
+                request = fQueue.getFirst(request, true);
+                fCurrent = request;
+
+                if (request->action == kEngineAsyncActionAdd)
+                    request->pluginId = fNextPluginId;
+            }
+        }
+
+        if (request == nullptr)
+        {
+            carla_msleep(20);
+            continue;
+        }
+
+        load(request);
+
+        const CarlaMutexLocker cml(fMutex);
+        fCurrentLoaded = true;
+    }
+}
+
+void EngineAsyncLoader::load(EngineAsyncRequest* const request) noexcept
+{
+    if (request->action == kEngineAsyncActionRemove)
+        return;
+
+    // errors are redirected to fLoadError while on this thread, see CarlaEngine::setLastError()
+    fLoadError.clear();
+
+    // final id of added plugins is set when the plugin list is published
+    try {
+        request->plugin = kEngine->createPlugin(request->pluginId, request->btype, request->ptype,
+                                                request->filename.isNotEmpty() ? request->filename.buffer() : nullptr,
+                                                request->name.isNotEmpty() ? request->name.buffer() : nullptr,
+                                                request->label.isNotEmpty() ? request->label.buffer() : nullptr,
+                                                request->uniqueId,
+                                                request->extra.isNotEmpty() ? request->extra.buffer() : nullptr,
+                                                request->options);
+    } CARLA_SAFE_EXCEPTION("EngineAsyncLoader createPlugin");
+
+    const CarlaPluginPtr plugin = request->plugin;
+
+    if (plugin.get() == nullptr)
+    {
+        request->error = fLoadError.isNotEmpty() ? fLoadError.buffer() : "Failed to load plugin";
+        return;
+    }
+
+    // not visible to the audio thread yet, activated on the main thread when published
+    plugin->setEnabled(true);
+}
+
+bool EngineAsyncLoader::publish(EngineAsyncRequest* const request) noexcept
+{
+    CarlaEngine::ProtectedData* const pData = kEngine->pData;
+
+    const uint curPluginCount = pData->curPluginCount;
+    const uint maxPluginNumber = pData->maxPluginNumber;
+
+    if (request->action != kEngineAsyncActionRemove && request->plugin.get() == nullptr)
+        return false;
+
+    switch (request->action)
+    {
+    case kEngineAsyncActionAdd:
+        if (curPluginCount == maxPluginNumber)
+        {
+            request->error = "Maximum number of plugins reached";
+            return false;
+        }
+        request->pluginId = curPluginCount;
+        break;
+
+    case kEngineAsyncActionRemove:
+    case kEngineAsyncActionReplace:
+        if (request->pluginId >= curPluginCount)
+        {
+            request->error = "Invalid plugin Id";
+            return false;
+        }
+        request->oldPlugin = pData->plugins[request->pluginId].plugin;
+        CARLA_SAFE_ASSERT_RETURN(request->oldPlugin.get() != nullptr, false);
+        break;
+    }
+
+    EnginePluginData* newPlugins;
+
+    try {
+        newPlugins = new EnginePluginData[maxPluginNumber];
+    } CARLA_SAFE_EXCEPTION_RETURN("EngineAsyncLoader publish", false);
+
+    uint newPluginCount = 0;
+
+    for (uint i=0; i < curPluginCount; ++i)
+    {
+        if (request->action == kEngineAsyncActionRemove && i == request->pluginId)
+            continue;
+
+        EnginePluginData& pluginData(newPlugins[newPluginCount++]);
+
+        if (request->action == kEngineAsyncActionReplace && i == request->pluginId)
+        {
+            pluginData.plugin = request->plugin;
+        }
+        else
+        {
+            pluginData.plugin = pData->plugins[i].plugin;
+            carla_copyFloats(pluginData.peaks, pData->plugins[i].peaks, 4);
+        }
+    }
+
+    if (request->action == kEngineAsyncActionAdd)
+        newPlugins[newPluginCount++].plugin = request->plugin;
+
+    // ids are only changed here, never from the audio thread.
+    // the engine thread stays stopped until finish(), as the current list does not match the new ids.
+    for (uint i=0; i < newPluginCount; ++i)
+    {
+        CarlaPlugin* const plugin = newPlugins[i].plugin.get();
+        CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+        if (plugin->getId() == i)
+            continue;
+
+        if (pData->thread.isThreadRunning())
+            pData->thread.stopThread(500);
+
+        plugin->setId(i);
+    }
+
+    switch (request->action)
+    {
+    case kEngineAsyncActionAdd:
+        // not visible to the audio thread yet
+        // the host gets the active state together with the plugin added callback
+        if (kEngine->getType() != kEngineTypeBridge)
+            request->plugin->setActive(true, true, false);
+        break;
+
+    case kEngineAsyncActionRemove:
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.removePlugin(request->oldPlugin);
+        break;
+
+    case kEngineAsyncActionReplace: {
+        const CarlaPluginPtr& oldPlugin(request->oldPlugin);
+        const CarlaPluginPtr& plugin(request->plugin);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.replacePlugin(oldPlugin, plugin);
+
+        // host is told about these with the reload-all callback
+        if (plugin->getHints() & PLUGIN_CAN_DRYWET)
+            plugin->setDryWet(oldPlugin->getInternalParameterValue(PARAMETER_DRYWET), true, false);
+
+        if (plugin->getHints() & PLUGIN_CAN_VOLUME)
+            plugin->setVolume(oldPlugin->getInternalParameterValue(PARAMETER_VOLUME), true, false);
+
+        plugin->setActive(oldPlugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f, true, false);
+    }   break;
+    }
+
+    const CarlaMutexLocker cml(listMutex);
+    CARLA_SAFE_ASSERT(nextPlugins == nullptr);
+
+    nextPlugins     = newPlugins;
+    nextPluginCount = newPluginCount;
+    return true;
+}
+
+void EngineAsyncLoader::finish(EngineAsyncRequest* const request) noexcept
+{
+    CarlaEngine::ProtectedData* const pData = kEngine->pData;
+
+    EnginePluginData* oldPlugins;
+
+    {
+        const CarlaMutexLocker cml(listMutex);
+        oldPlugins  = prevPlugins;
+        prevPlugins = nullptr;
+    }
+
+    const ScopedThreadStopper sts(kEngine);
+
+    if (oldPlugins != nullptr)
+    {
+        const RetiredPlugins retired = { oldPlugins, water::Time::getMillisecondCounter() };
+
+        if (! fRetired.append(retired))
+            delete[] oldPlugins;
+    }
+
+    switch (request->action)
+    {
+    case kEngineAsyncActionAdd:
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            pData->graph.addPlugin(request->plugin);
+
+        kEngine->callback(true, true, ENGINE_CALLBACK_PLUGIN_ADDED, request->pluginId, 0, 0, 0, 0.0f,
+                          request->plugin->getName());
+        break;
+
+    case kEngineAsyncActionRemove:
+        request->oldPlugin->prepareForDeletion();
+        pData->pluginsToDelete.push_back(request->oldPlugin);
+        request->oldPlugin.reset();
+
+        kEngine->callback(true, true, ENGINE_CALLBACK_PLUGIN_REMOVED, request->pluginId, 0, 0, 0, 0.0f, nullptr);
+        break;
+
+    case kEngineAsyncActionReplace:
+        request->oldPlugin->prepareForDeletion();
+        pData->pluginsToDelete.push_back(request->oldPlugin);
+        request->oldPlugin.reset();
+
+        kEngine->callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, request->pluginId, 0, 0, 0, 0.0f, nullptr);
+        break;
+    }
+}
+
+void EngineAsyncLoader::done(EngineAsyncRequest* const request, const bool ok) noexcept
+{
+    // plugins that never made it into the engine
+    if (! ok && request->plugin.get() != nullptr)
+    {
+        request->plugin->prepareForDeletion();
+        kEngine->pData->pluginsToDelete.push_back(request->plugin);
+        request->plugin.reset();
+    }
+
+    kEngine->callback(true, false, ENGINE_CALLBACK_PLUGIN_ASYNC_DONE, request->pluginId,
+                      static_cast<int>(request->requestId), ok ? 1 : 0, 0, 0.0f,
+                      ok ? nullptr : request->error.buffer());
+
+    {
+        const CarlaMutexLocker cml(fMutex);
+        CARLA_SAFE_ASSERT(fCurrent == request);
+
+        fCurrent = nullptr;
+        fCurrentLoaded = false;
+        fNextPluginId = kEngine->pData->curPluginCount;
+    }
+
+    delete request;
+}
+
+void EngineAsyncLoader::process(const bool force) noexcept
+{
+    EngineAsyncRequest* request;
+
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        if (fCurrent == nullptr || ! fCurrentLoaded)
+            return;
+
+        request = fCurrent;
+    }
+
+    if (! fPublishing)
+    {
+        if (! publish(request))
+        {
+            if (request->error.isEmpty())
+                request->error = "Failed to publish new plugin list";
+
+            done(request, false);
+            return;
+        }
+
+        fPublishing = true;
+    }
+
+    // no audio thread to hand the new list over to, do it here
+    if (force || ! kEngine->isRunning())
+        kEngine->pData->doPendingPluginList();
+
+    {
+        const CarlaMutexLocker cml(listMutex);
+
+        if (nextPlugins != nullptr)
+            return;
+    }
+
+    fPublishing = false;
+    finish(request);
+    done(request, true);
+}
+#endif
+
 // -----------------------------------------------------------------------
 // Helper functions
 
@@ -413,6 +876,10 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
 #endif
       time(timeInfo, options.transportMode),
       nextAction()
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    , snapshotMutex(),
+      asyncLoader(engine)
+#endif
 {
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
     plugins[0].plugin = nullptr;
@@ -535,6 +1002,11 @@ void CarlaEngine::ProtectedData::close()
     maxPluginNumber = 0;
     nextPluginId    = 0;
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // retired lists still reference removed plugins
+    asyncLoader.freeRetiredPlugins(true);
+#endif
+
     deletePluginsAsNeeded();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -680,6 +1152,44 @@ void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
     }
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+void CarlaEngine::ProtectedData::doPendingSnapshots() noexcept
+{
+    // snapshots are still being loaded, apply them all together on a later cycle
+    if (! snapshotMutex.tryLock())
+        return;
+
+    for (uint i=0; i < curPluginCount; ++i)
+    {
+        if (CarlaPlugin* const plugin = plugins[i].plugin.get())
+            plugin->applyPendingSnapshotRT();
+    }
+
+    snapshotMutex.unlock();
+}
+
+void CarlaEngine::ProtectedData::doPendingPluginList() noexcept
+{
+    if (asyncLoader.nextPlugins == nullptr)
+        return;
+
+    // main thread is still preparing the list, try again on the next cycle
+    if (! asyncLoader.listMutex.tryLock())
+        return;
+
+    if (EnginePluginData* const newPlugins = asyncLoader.nextPlugins)
+    {
+        asyncLoader.prevPlugins     = plugins;
+        asyncLoader.nextPlugins     = nullptr;
+        plugins                     = newPlugins;
+        curPluginCount              = asyncLoader.nextPluginCount;
+        asyncLoader.nextPluginCount = 0;
+    }
+
+    asyncLoader.listMutex.unlock();
+}
+#endif
+
 // -----------------------------------------------------------------------
 // PendingRtEventsRunner
 
@@ -709,6 +1219,11 @@ PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine,
       prevTime(calcDSPLoad ? getTimeInMicroseconds() : 0)
 {
     pData->time.preProcess(frames);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->doPendingPluginList();
+    pData->doPendingSnapshots();
+#endif
 }
 
 PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
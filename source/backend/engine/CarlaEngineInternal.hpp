@@ -119,6 +119,9 @@ public:
     void removePlugin(CarlaPluginPtr plugin);
     void removeAllPlugins();
 
+    // main thread only
+    void idle();
+
     bool isUsingExternalHost() const noexcept;
     bool isUsingExternalOSC() const noexcept;
     void setUsingExternalHost(bool usingExternal) noexcept;
@@ -241,6 +244,107 @@ struct EnginePluginData {
 #endif
 };
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -----------------------------------------------------------------------
+// EngineAsyncLoader
+
+enum EngineAsyncAction {
+    kEngineAsyncActionAdd = 0,
+    kEngineAsyncActionRemove,
+    kEngineAsyncActionReplace
+};
+
+struct EngineAsyncRequest {
+    uint requestId;
+    EngineAsyncAction action;
+    uint pluginId; // plugin to remove or replace, final id of added plugin
+    BinaryType btype;
+    PluginType ptype;
+    CarlaString filename;
+    CarlaString name;
+    CarlaString label;
+    CarlaString extra;
+    int64_t uniqueId;
+    uint options;
+
+    // set while loading and publishing
+    CarlaPluginPtr plugin;
+    CarlaPluginPtr oldPlugin;
+    CarlaString error;
+
+    EngineAsyncRequest() noexcept;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(EngineAsyncRequest)
+};
+
+// Creates plugins on its own thread, one request at a time.
+// The main thread then activates them and builds a new plugin list during idle, which the audio thread swaps in at the
+// start of a cycle. Replaced lists are kept for a while before being freed, as other threads might still be reading them.
+// The next request is only loaded after the previous one has been published, so ids and names stay consistent.
+class EngineAsyncLoader : public CarlaThread
+{
+public:
+    EngineAsyncLoader(CarlaEngine* engine) noexcept;
+    ~EngineAsyncLoader() noexcept override;
+
+    // returns request id, takes ownership of request
+    uint queue(EngineAsyncRequest* request) noexcept;
+
+    // true if any request is queued, loading or waiting to be published
+    bool isBusy() const noexcept;
+
+    // publish loaded requests and report finished ones, called from the main thread
+    void idle() noexcept;
+
+    // stop loading, finish the current request and cancel queued ones
+    void clear() noexcept;
+
+    // true when called from the loader thread, engine errors are then kept with the request being loaded
+    bool isLoaderThread() const noexcept;
+    void setLoadError(const char* error) noexcept;
+
+    // free replaced plugin lists, all of them if forced (only when nothing else can be reading them)
+    void freeRetiredPlugins(bool force) noexcept;
+
+    // plugin list handover, see ProtectedData::doPendingPluginList()
+    CarlaMutex listMutex;
+    EnginePluginData* volatile nextPlugins; // waiting for the audio thread
+    uint nextPluginCount;
+    EnginePluginData* prevPlugins; // replaced by the audio thread, freed on main thread
+
+protected:
+    void run() noexcept override;
+
+private:
+    CarlaEngine* const kEngine;
+
+    CarlaMutex fMutex;
+    LinkedList<EngineAsyncRequest*> fQueue;
+    EngineAsyncRequest* fCurrent;
+    bool fCurrentLoaded;
+    bool fPublishing;
+    uint fLastRequestId;
+    uint fNextPluginId; // provisional id for added plugins, set by the main thread
+
+    // only used from the loader thread
+    CarlaString fLoadError;
+
+    struct RetiredPlugins {
+        EnginePluginData* plugins;
+        uint32_t time;
+    };
+    LinkedList<RetiredPlugins> fRetired;
+
+    void load(EngineAsyncRequest* request) noexcept;
+    bool publish(EngineAsyncRequest* request) noexcept;
+    void finish(EngineAsyncRequest* request) noexcept;
+    void done(EngineAsyncRequest* request, bool ok) noexcept;
+    void process(bool force) noexcept;
+
+    CARLA_DECLARE_NON_COPY_CLASS(EngineAsyncLoader)
+};
+#endif
+
 // -----------------------------------------------------------------------
 // CarlaEngineProtectedData
 
@@ -298,6 +402,13 @@ struct CarlaEngine::ProtectedData {
     EngineInternalTime   time;
     EngineNextAction     nextAction;
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // held while loading snapshots of several plugins, so they are all applied on the same cycle
+    CarlaMutex snapshotMutex;
+
+    EngineAsyncLoader asyncLoader;
+#endif
+
     // -------------------------------------------------------------------
 
     ProtectedData(CarlaEngine* engine);
@@ -319,6 +430,10 @@ struct CarlaEngine::ProtectedData {
     void doPluginRemove(uint pluginId) noexcept;
     void doPluginsSwitch(uint idA, uint idB) noexcept;
     void doNextPluginAction() noexcept;
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    void doPendingSnapshots() noexcept;
+    void doPendingPluginList() noexcept;
+#endif
 
     // -------------------------------------------------------------------
 
@@ -135,7 +135,6 @@ struct CarlaJackPortHints {
 
 #ifndef BUILD_BRIDGE
 static const GroupNameToId  kGroupNameToIdFallback   = { 0, { '\0' } };
-static /* */ PortNameToId   kPortNameToIdFallbackNC  = { 0, 0, { '\0' }, { '\0' } };
 static const PortNameToId   kPortNameToIdFallback    = { 0, 0, { '\0' }, { '\0' } };
 static const ConnectionToId kConnectionToIdFallback  = { 0, 0, 0, 0, 0 };
 #endif
@@ -2255,32 +2254,10 @@ public:
                     if (const uint groupId = fUsedGroups.getGroupId(plugin->getName()))
                     {
                         const CarlaMutexLocker cml2(fUsedPorts.mutex);
-
-                        for (LinkedList<PortNameToId>::Itenerator it = fUsedPorts.list.begin2(); it.valid(); it.next())
-                        {
-                            const PortNameToId& portNameToId(it.getValue(kPortNameToIdFallback));
-                            CARLA_SAFE_ASSERT_CONTINUE(portNameToId.group != 0);
-
-                            if (portNameToId.group != groupId)
-                                continue;
-
-                            ports.append(portNameToId);
-                            fUsedPorts.list.remove(it);
-                        }
+                        fUsedPorts.removeGroup(groupId, &ports);
 
                         const CarlaMutexLocker cml3(fUsedConnections.mutex);
-
-                        for (LinkedList<ConnectionToId>::Itenerator it = fUsedConnections.list.begin2(); it.valid(); it.next())
-                        {
-                            const ConnectionToId& connectionToId = it.getValue(kConnectionToIdFallback);
-                            CARLA_SAFE_ASSERT_CONTINUE(connectionToId.id != 0);
-
-                            if (connectionToId.groupA != groupId && connectionToId.groupB != groupId)
-                                continue;
-
-                            conns.append(connectionToId);
-                            fUsedConnections.list.remove(it);
-                        }
+                        fUsedConnections.removeGroup(groupId, &conns);
                     }
                 }
 
@@ -2369,19 +2346,11 @@ public:
         if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY && ! external)
             return CarlaEngine::patchbayDisconnect(false, connectionId);
 
-        ConnectionToId connectionToId = { 0, 0, 0, 0, 0 };
+        ConnectionToId connectionToId;
 
         {
             const CarlaMutexLocker cml(fUsedConnections.mutex);
-
-            for (LinkedList<ConnectionToId>::Itenerator it = fUsedConnections.list.begin2(); it.valid(); it.next())
-            {
-                connectionToId = it.getValue(kConnectionToIdFallback);
-                CARLA_SAFE_ASSERT_CONTINUE(connectionToId.id != 0);
-
-                if (connectionToId.id == connectionId)
-                    break;
-            }
+            connectionToId = fUsedConnections.getConnection(connectionId);
         }
 
         if (connectionToId.id == 0 || connectionToId.id != connectionId)
@@ -3176,10 +3145,7 @@ protected:
             // clients might have been registered without ports
             if (groupId == 0) return;
 
-            GroupNameToId groupNameToId;
-            groupNameToId.setData(groupId, name);
-
-            fUsedGroups.list.removeOne(groupNameToId);
+            fUsedGroups.remove(groupId);
         }
 
         // ignore callback if on internal patchbay mode
@@ -3238,7 +3204,7 @@ protected:
 
                 findPluginIdAndIcon(groupName, pluginId, icon);
 
-                fUsedGroups.list.append(groupNameToId);
+                fUsedGroups.add(groupNameToId);
 
                 groupFound = true;
                 groupData.icon = icon;
@@ -3278,7 +3244,7 @@ protected:
 
             PortNameToId portNameToId;
             portNameToId.setData(portData.group, portData.port, shortPortName, portName);
-            fUsedPorts.list.append(portNameToId);
+            fUsedPorts.add(portNameToId);
         }
 
         if (groupFound)
@@ -3324,7 +3290,7 @@ protected:
             groupId = portNameToId.group;
             portId = portNameToId.port;
 
-            fUsedPorts.list.removeOne(portNameToId);
+            fUsedPorts.remove(groupId, portId);
         }
 
         callback(fExternalPatchbayHost, fExternalPatchbayOsc,
@@ -3371,7 +3337,7 @@ protected:
                                    portNameToIdA.group, portNameToIdA.port,
                                    portNameToIdB.group, portNameToIdB.port);
 
-            fUsedConnections.list.append(connectionToId);
+            fUsedConnections.add(connectionToId);
         }
 
         callback(fExternalPatchbayHost, fExternalPatchbayOsc,
@@ -3405,19 +3371,11 @@ protected:
 
             const CarlaMutexLocker cml2(fUsedConnections.mutex);
 
-            for (LinkedList<ConnectionToId>::Itenerator it = fUsedConnections.list.begin2(); it.valid(); it.next())
-            {
-                const ConnectionToId& connectionToId = it.getValue(kConnectionToIdFallback);
-                CARLA_SAFE_ASSERT_CONTINUE(connectionToId.id != 0);
+            connectionId = fUsedConnections.getConnectionId(portNameToIdA.group, portNameToIdA.port,
+                                                            portNameToIdB.group, portNameToIdB.port);
 
-                if (connectionToId.groupA == portNameToIdA.group && connectionToId.portA == portNameToIdA.port &&
-                    connectionToId.groupB == portNameToIdB.group && connectionToId.portB == portNameToIdB.port)
-                {
-                    connectionId = connectionToId.id;
-                    fUsedConnections.list.remove(it);
-                    break;
-                }
-            }
+            if (connectionId != 0)
+                fUsedConnections.remove(connectionId);
         }
 
         if (connectionId != 0) {
@@ -3459,23 +3417,18 @@ protected:
 
             const CarlaMutexLocker cml2(fUsedPorts.mutex);
 
-            for (LinkedList<PortNameToId>::Itenerator it = fUsedPorts.list.begin2(); it.valid(); it.next())
-            {
-                PortNameToId& portNameToId(it.getValue(kPortNameToIdFallbackNC));
-                CARLA_SAFE_ASSERT_CONTINUE(portNameToId.group != 0);
+            const PortNameToId& portNameToId(fUsedPorts.getPortNameToId(oldFullName));
 
-                if (std::strncmp(portNameToId.fullName, oldFullName, STR_MAX) == 0)
-                {
-                    CARLA_SAFE_ASSERT_CONTINUE(portNameToId.group == groupId);
+            if (portNameToId.group != 0)
+            {
+                CARLA_SAFE_ASSERT_RETURN(portNameToId.group == groupId,);
 
-                    found = true;
-                    portId = portNameToId.port;
-                    std::strncpy(portName, newShortName, STR_MAX-1);
-                    portName[STR_MAX-1] = '\0';
+                found = true;
+                portId = portNameToId.port;
+                std::strncpy(portName, newShortName, STR_MAX-1);
+                portName[STR_MAX-1] = '\0';
 
-                    portNameToId.rename(newShortName, newFullName);
-                    break;
-                }
+                fUsedPorts.rename(oldFullName, newShortName, newFullName);
             }
         }
 
@@ -3709,29 +3662,58 @@ private:
         PatchbayIcon icon;
         int pluginId;
         char strVal[STR_MAX];
+        bool isNew;
     };
     struct PortToIdData {
         uint group;
         uint port;
         uint flags;
         char strVal[STR_MAX];
+        bool isNew;
     };
     struct ConnectionToIdData {
         uint id;
         char strVal[STR_MAX];
+        bool isNew;
     };
 
+    // move the contents of a freshly scanned registry into one of ours, keeping the last used id
+    template<typename ListType, typename T>
+    static void replacePatchbayList(ListType& dst, ListType& src, const T& fallback) noexcept
+    {
+        const uint lastId = src.lastId;
+
+        dst.clear();
+        dst.lastId = lastId;
+
+        for (typename LinkedList<T>::Itenerator it = src.list.begin2(); it.valid(); it.next())
+            dst.add(it.getValue(fallback));
+
+        src.clear();
+    }
+
+    /*
+     * Scan all JACK clients, ports and connections.
+     * Ids of things we already knew about are kept, so that a refresh only changes what is actually different.
+     * Everything is sent to the requesting side (sendHost/sendOSC), as it starts from an empty canvas.
+     * The other side, which is already in sync, only receives what changed since the last scan.
+     */
     void initJackPatchbay(const bool sendHost, const bool sendOSC, const char* const ourName, const bool groupsOnly)
     {
         CARLA_SAFE_ASSERT_RETURN(ourName != nullptr && ourName[0] != '\0',);
 
         fLastPatchbaySetGroupPos.clear();
 
-        uint id, carlaId;
-        CarlaStringList parsedGroups;
+        const bool diffHost = !sendHost && fExternalPatchbayHost;
+        const bool diffOSC  = !sendOSC  && fExternalPatchbayOsc;
+
+        uint carlaId;
         LinkedList<GroupToIdData> groupCallbackData;
         LinkedList<PortToIdData> portsCallbackData;
         LinkedList<ConnectionToIdData> connCallbackData;
+        LinkedList<uint> removedGroups;
+        LinkedList<PortNameToId> removedPorts;
+        LinkedList<uint> removedConns;
 
         {
             const CarlaMutexLocker cml1(fUsedGroups.mutex);
@@ -3740,27 +3722,33 @@ private:
             const CarlaMutexLocker cml4(fPostPonedEventsMutex);
             const CarlaMutexLocker cml5(fPostPonedUUIDsMutex);
 
-            fUsedGroups.clear();
-            fUsedPorts.clear();
-            fUsedConnections.clear();
+            // pending events are superseded by the scan below
             fPostPonedEvents.clear();
             fPostPonedUUIDs.clear();
 
+            PatchbayGroupList newGroups;
+            PatchbayPortList newPorts;
+            PatchbayConnectionList newConns;
+
+            newGroups.lastId = fUsedGroups.lastId;
+            newPorts.lastId = fUsedPorts.lastId;
+            newConns.lastId = fUsedConnections.lastId;
+
             // add our client first
             {
-                carlaId = ++fUsedGroups.lastId;
-                parsedGroups.append(ourName);
+                carlaId = fUsedGroups.getGroupId(ourName);
+
+                if (carlaId == 0)
+                    carlaId = ++newGroups.lastId;
 
                 GroupNameToId groupNameToId;
                 groupNameToId.setData(carlaId, ourName);
-                fUsedGroups.list.append(groupNameToId);
+                newGroups.add(groupNameToId);
             }
 
             // query all jack ports
+            if (const char** const ports = jackbridge_get_ports(fClient, nullptr, nullptr, 0))
             {
-                const char** const ports = jackbridge_get_ports(fClient, nullptr, nullptr, 0);
-                CARLA_SAFE_ASSERT_RETURN(ports != nullptr,);
-
                 const CarlaRecursiveMutexLocker crml(fThreadSafeMetadataMutex);
 
                 for (int i=0; ports[i] != nullptr; ++i)
@@ -3776,23 +3764,22 @@ private:
 
                     const CarlaJackPortHints jackPortHints(CarlaJackPortHints::fromPort(jackPort));
 
-                    uint groupId = 0;
-
                     bool found;
                     CarlaString groupName(fullPortName);
                     groupName.truncate(groupName.rfind(shortPortName, &found)-1);
 
                     CARLA_SAFE_ASSERT_CONTINUE(found);
 
-                    if (parsedGroups.contains(groupName))
+                    uint groupId = newGroups.getGroupId(groupName);
+
+                    if (groupId == 0)
                     {
                         groupId = fUsedGroups.getGroupId(groupName);
-                        CARLA_SAFE_ASSERT_CONTINUE(groupId > 0);
-                    }
-                    else
-                    {
-                        groupId = ++fUsedGroups.lastId;
-                        parsedGroups.append(groupName);
+
+                        const bool isNew = (groupId == 0);
+
+                        if (isNew)
+                            groupId = ++newGroups.lastId;
 
                         GroupNameToId groupNameToId;
                         groupNameToId.setData(groupId, groupName);
@@ -3802,7 +3789,7 @@ private:
 
                         findPluginIdAndIcon(groupName, pluginId, icon);
 
-                        fUsedGroups.list.append(groupNameToId);
+                        newGroups.add(groupNameToId);
 
                         if (! groupsOnly)
                         {
@@ -3812,6 +3799,7 @@ private:
                             groupData.pluginId = pluginId;
                             std::strncpy(groupData.strVal, groupName, STR_MAX-1);
                             groupData.strVal[STR_MAX-1] = '\0';
+                            groupData.isNew = isNew;
                             groupCallbackData.append(groupData);
                         }
                     }
@@ -3831,80 +3819,156 @@ private:
                     else if (jackPortHints.isMIDI)
                         canvasPortFlags |= PATCHBAY_PORT_TYPE_MIDI;
 
-                    id = ++fUsedPorts.lastId;
+                    const PortNameToId& oldPort(fUsedPorts.getPortNameToId(fullPortName));
+                    const bool isNew = (oldPort.group != groupId || oldPort.port == 0);
+                    const uint portId = isNew ? ++newPorts.lastId : oldPort.port;
 
                     PortNameToId portNameToId;
-                    portNameToId.setData(groupId, id, shortPortName, fullPortName);
-                    fUsedPorts.list.append(portNameToId);
+                    portNameToId.setData(groupId, portId, shortPortName, fullPortName);
+                    newPorts.add(portNameToId);
 
                     PortToIdData portData;
                     portData.group = groupId;
-                    portData.port = id;
+                    portData.port = portId;
                     portData.flags = canvasPortFlags;
                     std::strncpy(portData.strVal, shortPortName, STR_MAX-1);
                     portData.strVal[STR_MAX-1] = '\0';
+                    portData.isNew = isNew;
                     portsCallbackData.append(portData);
                 }
 
                 jackbridge_free(ports);
             }
 
-            if (groupsOnly)
-                return;
-
             // query connections, after all ports are in place
-            if (const char** const ports = jackbridge_get_ports(fClient, nullptr, nullptr, JackPortIsOutput))
+            if (! groupsOnly)
             {
-                for (int i=0; ports[i] != nullptr; ++i)
+                if (const char** const ports = jackbridge_get_ports(fClient, nullptr, nullptr, JackPortIsOutput))
                 {
-                    const char* const fullPortName(ports[i]);
-                    CARLA_SAFE_ASSERT_CONTINUE(fullPortName != nullptr && fullPortName[0] != '\0');
+                    for (int i=0; ports[i] != nullptr; ++i)
+                    {
+                        const char* const fullPortName(ports[i]);
+                        CARLA_SAFE_ASSERT_CONTINUE(fullPortName != nullptr && fullPortName[0] != '\0');
 
-                    const jack_port_t* const jackPort(jackbridge_port_by_name(fClient, fullPortName));
-                    CARLA_SAFE_ASSERT_CONTINUE(jackPort != nullptr);
+                        const jack_port_t* const jackPort(jackbridge_port_by_name(fClient, fullPortName));
+                        CARLA_SAFE_ASSERT_CONTINUE(jackPort != nullptr);
 
-                    const PortNameToId& thisPort(fUsedPorts.getPortNameToId(fullPortName));
+                        const PortNameToId& thisPort(newPorts.getPortNameToId(fullPortName));
 
-                    CARLA_SAFE_ASSERT_CONTINUE(thisPort.group > 0);
-                    CARLA_SAFE_ASSERT_CONTINUE(thisPort.port > 0);
+                        CARLA_SAFE_ASSERT_CONTINUE(thisPort.group > 0);
+                        CARLA_SAFE_ASSERT_CONTINUE(thisPort.port > 0);
 
-                    if (const char** const connections = jackbridge_port_get_all_connections(fClient, jackPort))
-                    {
-                        for (int j=0; connections[j] != nullptr; ++j)
+                        if (const char** const connections = jackbridge_port_get_all_connections(fClient, jackPort))
                         {
-                            const char* const connection(connections[j]);
-                            CARLA_SAFE_ASSERT_CONTINUE(connection != nullptr && connection[0] != '\0');
+                            for (int j=0; connections[j] != nullptr; ++j)
+                            {
+                                const char* const connection(connections[j]);
+                                CARLA_SAFE_ASSERT_CONTINUE(connection != nullptr && connection[0] != '\0');
 
-                            const PortNameToId& targetPort(fUsedPorts.getPortNameToId(connection));
+                                const PortNameToId& targetPort(newPorts.getPortNameToId(connection));
 
-                            CARLA_SAFE_ASSERT_CONTINUE(targetPort.group > 0);
-                            CARLA_SAFE_ASSERT_CONTINUE(targetPort.port > 0);
+                                CARLA_SAFE_ASSERT_CONTINUE(targetPort.group > 0);
+                                CARLA_SAFE_ASSERT_CONTINUE(targetPort.port > 0);
 
-                            id = ++fUsedConnections.lastId;
+                                uint connectionId = fUsedConnections.getConnectionId(thisPort.group, thisPort.port,
+                                                                                     targetPort.group, targetPort.port);
+                                const bool isNew = (connectionId == 0);
 
-                            ConnectionToId connectionToId;
-                            connectionToId.setData(id, thisPort.group, thisPort.port, targetPort.group, targetPort.port);
-                            fUsedConnections.list.append(connectionToId);
+                                if (isNew)
+                                    connectionId = ++newConns.lastId;
 
-                            ConnectionToIdData connData;
-                            connData.id = id;
-                            std::snprintf(connData.strVal, STR_MAX-1, "%i:%i:%i:%i",
-                                          thisPort.group, thisPort.port, targetPort.group, targetPort.port);
-                            connData.strVal[STR_MAX-1] = '\0';
-                            connCallbackData.append(connData);
-                        }
+                                ConnectionToId connectionToId;
+                                connectionToId.setData(connectionId,
+                                                       thisPort.group, thisPort.port, targetPort.group, targetPort.port);
+                                newConns.add(connectionToId);
 
-                        jackbridge_free(connections);
+                                ConnectionToIdData connData;
+                                connData.id = connectionId;
+                                std::snprintf(connData.strVal, STR_MAX-1, "%i:%i:%i:%i",
+                                              thisPort.group, thisPort.port, targetPort.group, targetPort.port);
+                                connData.strVal[STR_MAX-1] = '\0';
+                                connData.isNew = isNew;
+                                connCallbackData.append(connData);
+                            }
+
+                            jackbridge_free(connections);
+                        }
                     }
+
+                    jackbridge_free(ports);
                 }
 
-                jackbridge_free(ports);
+                // find out what is gone since the last scan
+                if (diffHost || diffOSC)
+                {
+                    for (LinkedList<ConnectionToId>::Itenerator it = fUsedConnections.list.begin2(); it.valid(); it.next())
+                    {
+                        const ConnectionToId& connectionToId(it.getValue(kConnectionToIdFallback));
+
+                        if (newConns.getConnection(connectionToId.id).id == 0)
+                            removedConns.append(connectionToId.id);
+                    }
+
+                    for (LinkedList<PortNameToId>::Itenerator it = fUsedPorts.list.begin2(); it.valid(); it.next())
+                    {
+                        const PortNameToId& portNameToId(it.getValue(kPortNameToIdFallback));
+
+                        if (newPorts.getFullPortName(portNameToId.group, portNameToId.port)[0] == '\0')
+                            removedPorts.append(portNameToId);
+                    }
+
+                    for (LinkedList<GroupNameToId>::Itenerator it = fUsedGroups.list.begin2(); it.valid(); it.next())
+                    {
+                        const GroupNameToId& groupNameToId(it.getValue(kGroupNameToIdFallback));
+
+                        if (newGroups.getGroupName(groupNameToId.group)[0] == '\0')
+                            removedGroups.append(groupNameToId.group);
+                    }
+                }
             }
+
+            replacePatchbayList(fUsedGroups, newGroups, kGroupNameToIdFallback);
+            replacePatchbayList(fUsedPorts, newPorts, kPortNameToIdFallback);
+            replacePatchbayList(fUsedConnections, newConns, kConnectionToIdFallback);
+        }
+
+        if (groupsOnly)
+            return;
+
+        for (LinkedList<uint>::Itenerator it = removedConns.begin2(); it.valid(); it.next())
+        {
+            callback(diffHost, diffOSC,
+                     ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED,
+                     it.getValue(0),
+                     0, 0, 0, 0.0f, nullptr);
         }
 
-        const GroupToIdData groupFallback = { 0, PATCHBAY_ICON_PLUGIN, -1, { '\0' } };
-        const PortToIdData portFallback = { 0, 0, 0, { '\0' } };
-        const ConnectionToIdData connFallback = { 0, { '\0' } };
+        for (LinkedList<PortNameToId>::Itenerator it = removedPorts.begin2(); it.valid(); it.next())
+        {
+            const PortNameToId& portNameToId(it.getValue(kPortNameToIdFallback));
+
+            callback(diffHost, diffOSC,
+                     ENGINE_CALLBACK_PATCHBAY_PORT_REMOVED,
+                     portNameToId.group,
+                     static_cast<int>(portNameToId.port),
+                     0, 0, 0.0f, nullptr);
+        }
+
+        for (LinkedList<uint>::Itenerator it = removedGroups.begin2(); it.valid(); it.next())
+        {
+            callback(diffHost, diffOSC,
+                     ENGINE_CALLBACK_PATCHBAY_CLIENT_REMOVED,
+                     it.getValue(0),
+                     0, 0, 0, 0.0f, nullptr);
+        }
+
+        removedConns.clear();
+        removedPorts.clear();
+        removedGroups.clear();
+
+        const GroupToIdData groupFallback = { 0, PATCHBAY_ICON_PLUGIN, -1, { '\0' }, false };
+        const PortToIdData portFallback = { 0, 0, 0, { '\0' }, false };
+        const ConnectionToIdData connFallback = { 0, { '\0' }, false };
 
         callback(sendHost, sendOSC,
                  ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED,
@@ -3921,7 +3985,13 @@ private:
             {
                 const GroupToIdData& group(it.getValue(groupFallback));
 
-                callback(sendHost, sendOSC,
+                const bool groupSendHost = sendHost || (group.isNew && diffHost);
+                const bool groupSendOSC  = sendOSC  || (group.isNew && diffOSC);
+
+                if (! (groupSendHost || groupSendOSC))
+                    continue;
+
+                callback(groupSendHost, groupSendOSC,
                         ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED,
                         group.id,
                         group.icon,
@@ -3973,7 +4043,7 @@ private:
                         jackbridge_free(value);
                         jackbridge_free(type);
 
-                        callback(sendHost, sendOSC,
+                        callback(groupSendHost, groupSendOSC,
                                 ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED,
                                 group.id, x1, y1, x2, static_cast<float>(y2),
                                 nullptr);
@@ -3986,7 +4056,13 @@ private:
         {
             const PortToIdData& port(it.getValue(portFallback));
 
-            callback(sendHost, sendOSC,
+            const bool portSendHost = sendHost || (port.isNew && diffHost);
+            const bool portSendOSC  = sendOSC  || (port.isNew && diffOSC);
+
+            if (! (portSendHost || portSendOSC))
+                continue;
+
+            callback(portSendHost, portSendOSC,
                      ENGINE_CALLBACK_PATCHBAY_PORT_ADDED,
                      port.group,
                      static_cast<int>(port.port),
@@ -3999,7 +4075,13 @@ private:
         {
             const ConnectionToIdData& conn(it.getValue(connFallback));
 
-            callback(sendHost, sendOSC,
+            const bool connSendHost = sendHost || (conn.isNew && diffHost);
+            const bool connSendOSC  = sendOSC  || (conn.isNew && diffOSC);
+
+            if (! (connSendHost || connSendOSC))
+                continue;
+
+            callback(connSendHost, connSendOSC,
                      ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED,
                      conn.id,
                      0, 0, 0, 0.0f,
@@ -4096,6 +4178,25 @@ private:
         float inPeaks[2] = { 0.0f };
         float outPeaks[2] = { 0.0f };
 
+        // CV sources drive parameters, so never sleep while we have them
+        if (cvsInCount == 0 && plugin->isSleepingRT(audioIn, false, nframes))
+        {
+            for (uint32_t i=0; i < audioOutCount; ++i)
+            {
+                if (audioOut[i] != nullptr)
+                    carla_zeroFloats(audioOut[i], nframes);
+            }
+
+            for (uint32_t i=0; i < cvOutCount; ++i)
+            {
+                if (cvOut[i] != nullptr)
+                    carla_zeroFloats(cvOut[i], nframes);
+            }
+
+            setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
+            return;
+        }
+
         for (uint32_t i=0; i < audioInCount && i < 2; ++i)
         {
             for (uint32_t j=0; j < nframes; ++j)
@@ -4108,6 +4209,7 @@ private:
         }
 
         plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
+        plugin->updateSleepStateRT(audioOut, nframes);
 
         for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
         {
@@ -525,7 +525,7 @@ public:
                      0, 0, 0, 0.0f,
                      strBuf);
 
-            extGraph.connections.list.append(connectionToId);
+            extGraph.connections.add(connectionToId);
         }
 
         fMidiOutMutex.lock();
@@ -550,7 +550,7 @@ public:
                      0, 0, 0, 0.0f,
                      strBuf);
 
-            extGraph.connections.list.append(connectionToId);
+            extGraph.connections.add(connectionToId);
         }
 
         fMidiOutMutex.unlock();
@@ -55,13 +55,11 @@
 
 #include "water/files/File.h"
 #include "water/streams/MemoryOutputStream.h"
-#include "water/xml/XmlDocument.h"
 #include "water/xml/XmlElement.h"
 
 using water::File;
 using water::MemoryOutputStream;
 using water::String;
-using water::XmlDocument;
 using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
@@ -1392,6 +1390,8 @@ protected:
                               nullptr, 0.0f);
         }
 
+        pData->graph.idle();
+
         {
             const CarlaMutexLocker cml(fPluginDeleterMutex);
             pData->deletePluginsAsNeeded();
@@ -1550,9 +1550,16 @@ protected:
             pData->thread.startThread();
 
         fOptionsForced = true;
-        const String state(data);
-        XmlDocument xml(state);
-        loadProjectInternal(xml, true);
+
+        // parsed in-place, so needs a copy
+        const std::size_t size = std::strlen(data);
+
+        if (char* const state = static_cast<char*>(std::malloc(size + 1)))
+        {
+            std::memcpy(state, data, size + 1);
+            loadProjectInternal(state, size, true);
+            std::free(state);
+        }
 
         reloadFromUI();
     }
@@ -2088,6 +2095,51 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
         if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
             plugin->saveStateToFile(filename);
     }
+    else if (std::strcmp(msg, "save_plugin_snapshot") == 0)
+    {
+        uint32_t pluginId, slot;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(slot), true);
+
+        if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
+            ok = plugin->saveSnapshot(slot);
+    }
+    else if (std::strcmp(msg, "load_plugin_snapshot") == 0)
+    {
+        uint32_t pluginId, slot;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(slot), true);
+
+        // parameter changes reach the UI through the usual callbacks, once applied
+        if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
+            ok = plugin->loadSnapshot(slot);
+    }
+    else if (std::strcmp(msg, "save_snapshot") == 0)
+    {
+        uint32_t slot;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(slot), true);
+
+        ok = fEngine->saveSnapshot(slot);
+    }
+    else if (std::strcmp(msg, "load_snapshot") == 0)
+    {
+        uint32_t slot;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(slot), true);
+
+        ok = fEngine->loadSnapshot(slot);
+    }
+    else if (std::strcmp(msg, "clear_snapshot") == 0)
+    {
+        uint32_t slot;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(slot), true);
+
+        fEngine->clearSnapshot(slot);
+    }
     else if (std::strcmp(msg, "set_option") == 0)
     {
         uint32_t pluginId, option;
@@ -2458,7 +2510,8 @@ static const NativePluginDescriptor carlaRackDesc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaRackNoMidiOutDesc = {
@@ -2507,7 +2560,8 @@ static const NativePluginDescriptor carlaRackNoMidiOutDesc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbayDesc = {
@@ -2556,7 +2610,8 @@ static const NativePluginDescriptor carlaPatchbayDesc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbay3sDesc = {
@@ -2605,7 +2660,8 @@ static const NativePluginDescriptor carlaPatchbay3sDesc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbay16Desc = {
@@ -2654,7 +2710,8 @@ static const NativePluginDescriptor carlaPatchbay16Desc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbay32Desc = {
@@ -2703,7 +2760,8 @@ static const NativePluginDescriptor carlaPatchbay32Desc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbay64Desc = {
@@ -2752,7 +2810,8 @@ static const NativePluginDescriptor carlaPatchbay64Desc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 static const NativePluginDescriptor carlaPatchbayCVDesc = {
@@ -2802,7 +2861,8 @@ static const NativePluginDescriptor carlaPatchbayCVDesc = {
     /* _get_buffer_port_name */ nullptr,
     /* _get_buffer_port_range */ nullptr,
     /* ui_width   */ kUiWidth,
-    /* ui_height  */ kUiHeight
+    /* ui_height  */ kUiHeight,
+    /* _process_with_parameter_events */ nullptr
 };
 
 CARLA_BACKEND_END_NAMESPACE
@@ -33,7 +33,8 @@ CarlaEngineOsc::CarlaEngineOsc(CarlaEngine* const engine) noexcept
       fServerPathTCP(),
       fServerPathUDP(),
       fServerTCP(nullptr),
-      fServerUDP(nullptr)
+      fServerUDP(nullptr),
+      fUdp()
 {
     CARLA_SAFE_ASSERT(engine != nullptr);
     carla_debug("CarlaEngineOsc::CarlaEngineOsc(%p)", engine);
@@ -204,6 +205,7 @@ void CarlaEngineOsc::close() noexcept
 
     fControlDataTCP.clear();
     fControlDataUDP.clear();
+    fUdp.clear();
 }
 
 // -----------------------------------------------------------------------
@@ -113,10 +113,16 @@ public:
 
     // -------------------------------------------------------------------
     // UDP
+    // Only values that changed enough since last sent are queued, and all of them
+    // go out together in as few bundles as possible during endUdpUpdate().
+    // beginUdpUpdate() must be called once per engine thread tick, it returns false if no update is due.
 
-    void sendRuntimeInfo() const noexcept;
-    void sendParameterValue(uint pluginId, uint32_t index, float value) const noexcept;
-    void sendPeaks(uint pluginId, const float peaks[4]) const noexcept;
+    bool beginUdpUpdate() noexcept;
+    void endUdpUpdate() noexcept;
+
+    void sendRuntimeInfo() noexcept;
+    void sendParameterValue(const CarlaPluginPtr& plugin, uint32_t index, float value) noexcept;
+    void sendPeaks(uint pluginId, const float peaks[4]) noexcept;
 
     // -------------------------------------------------------------------
 
@@ -133,6 +139,43 @@ private:
     lo_server    fServerTCP;
     lo_server    fServerUDP;
 
+    // last values sent to the UDP client and its rate limit.
+    // only one UDP client can be registered at a time (see handleMsgRegister),
+    // so all of this belongs to that client and is reset whenever it changes.
+    struct UdpPluginCache {
+        float peaks[4];
+        float* params;
+        uint32_t paramCount;
+    };
+
+    struct UdpState {
+        lo_bundle bundle;
+        CarlaString pathRuntime;
+        CarlaString pathParam;
+        CarlaString pathPeaks;
+        UdpPluginCache* plugins;
+        uint pluginCount;
+        uint32_t ticks; // engine thread ticks since last update, 0 means send right away
+        uint32_t lastRefresh;
+        bool refresh;
+        volatile bool needsReset; // set when the client changes, cache is reset by the engine thread
+        bool runtimeValid;
+        bool runtimePlaying;
+        float runtimeLoad;
+        uint32_t runtimeXruns;
+        uint64_t runtimeFrame;
+        double runtimeBPM;
+
+        UdpState() noexcept;
+        ~UdpState() noexcept;
+        void clear() noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(UdpState)
+    } fUdp;
+
+    void _addUdpMessage(const char* path, lo_message msg) noexcept;
+    void _sendUdpBundle() noexcept;
+
     // -------------------------------------------------------------------
 
     int handleMessage(bool isTCP, const char* path,
@@ -247,6 +247,9 @@ int CarlaEngineOsc::handleMsgRegister(const bool isTCP,
         oscData.path   = carla_strdup_free(lo_url_get_path(url));
         oscData.target = target;
 
+        if (! isTCP)
+            fUdp.needsReset = true;
+
         char* const targeturl = lo_address_get_url(target);
         carla_stdout("OSC %s backend registered to %s, path: %s, target: %s (host: %s, port: %s)",
                      isTCP ? "TCP" : "UDP", url, oscData.path, targeturl, host, port);
@@ -301,6 +304,9 @@ int CarlaEngineOsc::handleMsgUnregister(const bool isTCP,
     {
         carla_stdout("OSC client %s unregistered", url);
         oscData.clear();
+
+        if (! isTCP)
+            fUdp.needsReset = true;
         return 0;
     }
 
@@ -21,8 +21,11 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaEngine.hpp"
+#include "CarlaMathUtils.hpp"
 #include "CarlaPlugin.hpp"
 
+#include "water/misc/Time.h"
+
 CARLA_BACKEND_START_NAMESPACE
 
 static const char* const kNullString = "";
@@ -349,54 +352,318 @@ void CarlaEngineOsc::sendExit() const noexcept
 
 // -----------------------------------------------------------------------
 
-void CarlaEngineOsc::sendRuntimeInfo() const noexcept
+// number of engine thread ticks between UDP updates.
+// the engine thread runs every 25ms, so this gives at most 20 updates per second.
+// counting ticks instead of time avoids aliasing against the thread interval.
+static const uint32_t kUdpUpdateTicks = 2;
+
+// time between full UDP refreshes (sending all values, changed or not), in ms
+static const uint32_t kUdpRefreshInterval = 1000;
+
+// keep bundles within a typical network MTU, so they are not fragmented
+static const std::size_t kUdpMaxBundleSize = 1400;
+
+// minimum change required to send a parameter output (relative to its range) or peak value
+static const float kUdpParameterThreshold = 0.001f;
+static const float kUdpPeakThreshold = 0.001f;
+
+// marks cached values as not sent yet, far away from any real value
+// (can't use NaN for this, we build with -ffast-math)
+static const float kUdpUnsentValue = -3.0e38f;
+
+static inline
+bool udpValueChanged(const float oldValue, const float newValue, const float threshold) noexcept
+{
+    return std::abs(newValue - oldValue) >= threshold;
+}
+
+// -----------------------------------------------------------------------
+
+CarlaEngineOsc::UdpState::UdpState() noexcept
+    : bundle(nullptr),
+      pathRuntime(),
+      pathParam(),
+      pathPeaks(),
+      plugins(nullptr),
+      pluginCount(0),
+      ticks(0),
+      lastRefresh(0),
+      refresh(true),
+      needsReset(false),
+      runtimeValid(false),
+      runtimePlaying(false),
+      runtimeLoad(0.0f),
+      runtimeXruns(0),
+      runtimeFrame(0),
+      runtimeBPM(0.0) {}
+
+CarlaEngineOsc::UdpState::~UdpState() noexcept
+{
+    clear();
+}
+
+void CarlaEngineOsc::UdpState::clear() noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0',);
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr,);
+    if (bundle != nullptr)
+    {
+        try {
+            lo_bundle_free_recursive(bundle);
+        } CARLA_SAFE_EXCEPTION("lo_bundle_free_recursive");
+
+        bundle = nullptr;
+    }
+
+    if (plugins != nullptr)
+    {
+        for (uint i=0; i<pluginCount; ++i)
+            delete[] plugins[i].params;
+
+        delete[] plugins;
+        plugins = nullptr;
+    }
+
+    pathRuntime.clear();
+    pathParam.clear();
+    pathPeaks.clear();
+    pluginCount  = 0;
+    ticks        = 0;
+    lastRefresh  = 0;
+    refresh      = true;
+    needsReset   = false;
+    runtimeValid = false;
+}
+
+// -----------------------------------------------------------------------
+
+bool CarlaEngineOsc::beginUdpUpdate() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr, false);
+
+    if (fUdp.needsReset)
+        fUdp.clear();
+
+    // first update after a (re)set goes out right away
+    if (fUdp.ticks != 0 && fUdp.ticks < kUdpUpdateTicks)
+    {
+        ++fUdp.ticks;
+        return false;
+    }
+
+    fUdp.ticks = 1;
+
+    const uint32_t now = water::Time::getMillisecondCounter();
+
+    if (fUdp.pathRuntime.isEmpty())
+    {
+        fUdp.pathRuntime  = fControlDataUDP.path;
+        fUdp.pathRuntime += "/runtime";
+        fUdp.pathParam    = fControlDataUDP.path;
+        fUdp.pathParam   += "/param";
+        fUdp.pathPeaks    = fControlDataUDP.path;
+        fUdp.pathPeaks   += "/peaks";
+    }
+
+    if (fUdp.plugins == nullptr)
+    {
+        const uint count = fEngine->getMaxPluginNumber();
+        CARLA_SAFE_ASSERT_RETURN(count != 0, false);
+
+        fUdp.plugins = new UdpPluginCache[count];
+        fUdp.pluginCount = count;
+
+        for (uint i=0; i<count; ++i)
+        {
+            UdpPluginCache& cache(fUdp.plugins[i]);
+            cache.params = nullptr;
+            cache.paramCount = 0;
+        }
+
+        fUdp.refresh = true;
+    }
+
+    // resend everything once in a while, in case something got lost or plugins changed
+    if (now - fUdp.lastRefresh >= kUdpRefreshInterval)
+        fUdp.refresh = true;
+
+    if (fUdp.refresh)
+    {
+        fUdp.lastRefresh = now;
+
+        for (uint i=0; i<fUdp.pluginCount; ++i)
+        {
+            UdpPluginCache& cache(fUdp.plugins[i]);
+
+            for (int j=0; j<4; ++j)
+                cache.peaks[j] = kUdpUnsentValue;
+            for (uint32_t j=0; j<cache.paramCount; ++j)
+                cache.params[j] = kUdpUnsentValue;
+        }
+
+        fUdp.runtimeValid = false;
+        fUdp.refresh = false;
+    }
+
+    return true;
+}
+
+void CarlaEngineOsc::endUdpUpdate() noexcept
+{
+    if (fUdp.bundle != nullptr)
+        _sendUdpBundle();
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineOsc::sendRuntimeInfo() noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fUdp.pathRuntime.isNotEmpty(),);
 
     const EngineTimeInfo timeInfo(fEngine->getTimeInfo());
+    const float load = fEngine->getDSPLoad();
+    const uint32_t xruns = fEngine->getTotalXruns();
+
+    if (fUdp.runtimeValid
+        && fUdp.runtimePlaying == timeInfo.playing
+        && fUdp.runtimeFrame == timeInfo.frame
+        && fUdp.runtimeXruns == xruns
+        && carla_isEqual(fUdp.runtimeBPM, timeInfo.bbt.beatsPerMinute)
+        && ! udpValueChanged(fUdp.runtimeLoad, load, 0.5f))
+        return;
+
+    fUdp.runtimeValid   = true;
+    fUdp.runtimePlaying = timeInfo.playing;
+    fUdp.runtimeLoad    = load;
+    fUdp.runtimeXruns   = xruns;
+    fUdp.runtimeFrame   = timeInfo.frame;
+    fUdp.runtimeBPM     = timeInfo.bbt.beatsPerMinute;
+
+    const lo_message msg = lo_message_new();
+    CARLA_SAFE_ASSERT_RETURN(msg != nullptr,);
+
+    lo_message_add_float(msg, load);
+    lo_message_add_int32(msg, static_cast<int32_t>(xruns));
+    lo_message_add_int32(msg, timeInfo.playing ? 1 : 0);
+    lo_message_add_int64(msg, static_cast<int64_t>(timeInfo.frame));
+    lo_message_add_int32(msg, static_cast<int32_t>(timeInfo.bbt.bar));
+    lo_message_add_int32(msg, static_cast<int32_t>(timeInfo.bbt.beat));
+    lo_message_add_int32(msg, static_cast<int32_t>(timeInfo.bbt.tick));
+    lo_message_add_float(msg, static_cast<float>(timeInfo.bbt.beatsPerMinute));
+
+    _addUdpMessage(fUdp.pathRuntime, msg);
+}
+
+void CarlaEngineOsc::sendParameterValue(const CarlaPluginPtr& plugin, const uint32_t index, const float value) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fUdp.pathParam.isNotEmpty(),);
+    CARLA_SAFE_ASSERT_RETURN(plugin != nullptr,);
 
-    char targetPath[std::strlen(fControlDataUDP.path)+9];
-    std::strcpy(targetPath, fControlDataUDP.path);
-    std::strcat(targetPath, "/runtime");
-    try_lo_send(fControlDataUDP.target, targetPath, "fiihiiif",
-                static_cast<double>(fEngine->getDSPLoad()),
-                static_cast<int32_t>(fEngine->getTotalXruns()),
-                timeInfo.playing ? 1 : 0,
-                static_cast<int64_t>(timeInfo.frame),
-                static_cast<int32_t>(timeInfo.bbt.bar),
-                static_cast<int32_t>(timeInfo.bbt.beat),
-                static_cast<int32_t>(timeInfo.bbt.tick),
-                timeInfo.bbt.beatsPerMinute);
+    const uint pluginId = plugin->getId();
+    CARLA_SAFE_ASSERT_RETURN(pluginId < fUdp.pluginCount,);
+
+    UdpPluginCache& cache(fUdp.plugins[pluginId]);
+
+    if (index >= cache.paramCount)
+    {
+        const uint32_t paramCount = std::max(index + 1U, plugin->getParameterCount());
+
+        float* params;
+
+        try {
+            params = new float[paramCount];
+        } CARLA_SAFE_EXCEPTION_RETURN("sendParameterValue new params",);
+
+        for (uint32_t i=0; i<paramCount; ++i)
+            params[i] = i < cache.paramCount ? cache.params[i] : kUdpUnsentValue;
+
+        delete[] cache.params;
+        cache.params = params;
+        cache.paramCount = paramCount;
+    }
+
+    const ParameterRanges& ranges(plugin->getParameterRanges(index));
+    const float threshold = std::abs(ranges.max - ranges.min) * kUdpParameterThreshold;
+
+    if (! udpValueChanged(cache.params[index], value, threshold))
+        return;
+
+    cache.params[index] = value;
+
+    const lo_message msg = lo_message_new();
+    CARLA_SAFE_ASSERT_RETURN(msg != nullptr,);
+
+    lo_message_add_int32(msg, static_cast<int32_t>(pluginId));
+    lo_message_add_int32(msg, static_cast<int32_t>(index));
+    lo_message_add_float(msg, value);
+
+    _addUdpMessage(fUdp.pathParam, msg);
+}
+
+void CarlaEngineOsc::sendPeaks(const uint pluginId, const float peaks[4]) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fUdp.pathPeaks.isNotEmpty(),);
+    CARLA_SAFE_ASSERT_RETURN(pluginId < fUdp.pluginCount,);
+
+    float* const lastPeaks = fUdp.plugins[pluginId].peaks;
+
+    if (! udpValueChanged(lastPeaks[0], peaks[0], kUdpPeakThreshold) &&
+        ! udpValueChanged(lastPeaks[1], peaks[1], kUdpPeakThreshold) &&
+        ! udpValueChanged(lastPeaks[2], peaks[2], kUdpPeakThreshold) &&
+        ! udpValueChanged(lastPeaks[3], peaks[3], kUdpPeakThreshold))
+        return;
+
+    carla_copyFloats(lastPeaks, peaks, 4);
+
+    const lo_message msg = lo_message_new();
+    CARLA_SAFE_ASSERT_RETURN(msg != nullptr,);
+
+    lo_message_add_int32(msg, static_cast<int32_t>(pluginId));
+    lo_message_add_float(msg, peaks[0]);
+    lo_message_add_float(msg, peaks[1]);
+    lo_message_add_float(msg, peaks[2]);
+    lo_message_add_float(msg, peaks[3]);
+
+    _addUdpMessage(fUdp.pathPeaks, msg);
 }
 
-void CarlaEngineOsc::sendParameterValue(const uint pluginId, const uint32_t index, const float value) const noexcept
+// -----------------------------------------------------------------------
+
+void CarlaEngineOsc::_addUdpMessage(const char* const path, const lo_message msg) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0',);
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr,);
-
-    char targetPath[std::strlen(fControlDataUDP.path)+7];
-    std::strcpy(targetPath, fControlDataUDP.path);
-    std::strcat(targetPath, "/param");
-    try_lo_send(fControlDataUDP.target, targetPath, "iif",
-                static_cast<int32_t>(pluginId),
-                index,
-                static_cast<double>(value));
+    // bundle element = size + message
+    const std::size_t msgSize = 4 + lo_message_length(msg, path);
+
+    if (fUdp.bundle != nullptr && lo_bundle_length(fUdp.bundle) + msgSize > kUdpMaxBundleSize)
+        _sendUdpBundle();
+
+    if (fUdp.bundle == nullptr)
+    {
+        fUdp.bundle = lo_bundle_new(LO_TT_IMMEDIATE);
+
+        if (fUdp.bundle == nullptr)
+        {
+            lo_message_free(msg);
+            return;
+        }
+    }
+
+    if (lo_bundle_add_message(fUdp.bundle, path, msg) != 0)
+        lo_message_free(msg);
 }
 
-void CarlaEngineOsc::sendPeaks(const uint pluginId, const float peaks[4]) const noexcept
+void CarlaEngineOsc::_sendUdpBundle() noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0',);
-    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr,);
-
-    char targetPath[std::strlen(fControlDataUDP.path)+7];
-    std::strcpy(targetPath, fControlDataUDP.path);
-    std::strcat(targetPath, "/peaks");
-    try_lo_send(fControlDataUDP.target, targetPath, "iffff", static_cast<int32_t>(pluginId),
-                static_cast<double>(peaks[0]),
-                static_cast<double>(peaks[1]),
-                static_cast<double>(peaks[2]),
-                static_cast<double>(peaks[3]));
+    CARLA_SAFE_ASSERT_RETURN(fUdp.bundle != nullptr,);
+
+    try {
+        lo_send_bundle(fControlDataUDP.target, fUdp.bundle);
+    } CARLA_SAFE_EXCEPTION("lo_send_bundle");
+
+    try {
+        lo_bundle_free_recursive(fUdp.bundle);
+    } CARLA_SAFE_EXCEPTION("lo_bundle_free_recursive");
+
+    fUdp.bundle = nullptr;
 }
 
 // -----------------------------------------------------------------------
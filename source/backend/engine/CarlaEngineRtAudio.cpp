@@ -22,10 +22,11 @@
 #include "CarlaMathUtils.hpp"
 #include "CarlaStringList.hpp"
 
-#include "RtLinkedList.hpp"
-
 #include "jackbridge/JackBridge.hpp"
 
+#include <ctime>
+#include <sys/time.h>
+
 #if defined(__clang__)
 # pragma clang diagnostic push
 # pragma clang diagnostic ignored "-Wconversion"
@@ -185,12 +186,13 @@ public:
           fAudioInterleaved(false),
           fAudioInCount(0),
           fAudioOutCount(0),
-          fLastEventTime(0),
+          fLastCycleTime(0),
           fDeviceName(),
           fAudioIntBufIn(nullptr),
           fAudioIntBufOut(nullptr),
           fMidiIns(),
           fMidiInEvents(),
+          fMidiInSysExData(),
           fMidiOuts(),
           fMidiOutMutex(),
           fMidiOutVector(EngineMidiEvent::kDataSize)
@@ -205,7 +207,7 @@ public:
     {
         CARLA_SAFE_ASSERT(fAudioInCount == 0);
         CARLA_SAFE_ASSERT(fAudioOutCount == 0);
-        CARLA_SAFE_ASSERT(fLastEventTime == 0);
+        CARLA_SAFE_ASSERT(fLastCycleTime == 0);
         carla_debug("CarlaEngineRtAudio::~CarlaEngineRtAudio()");
     }
 
@@ -215,7 +217,7 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(fAudioInCount == 0, false);
         CARLA_SAFE_ASSERT_RETURN(fAudioOutCount == 0, false);
-        CARLA_SAFE_ASSERT_RETURN(fLastEventTime == 0, false);
+        CARLA_SAFE_ASSERT_RETURN(fLastCycleTime == 0, false);
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineRtAudio::init(\"%s\")", clientName);
 
@@ -327,7 +329,7 @@ public:
 
         fAudioInCount  = iParams.nChannels;
         fAudioOutCount = oParams.nChannels;
-        fLastEventTime = 0;
+        fLastCycleTime = 0;
 
         if (fAudioInCount > 0)
             fAudioIntBufIn = new float[fAudioInCount*bufferFrames];
@@ -420,7 +422,7 @@ public:
 
         fAudioInCount  = 0;
         fAudioOutCount = 0;
-        fLastEventTime = 0;
+        fLastCycleTime = 0;
         fDeviceName.clear();
 
         if (fAudioIntBufIn != nullptr)
@@ -557,7 +559,7 @@ public:
 
             std::snprintf(strBuf, STR_MAX, "%i:%i:%i:%i", connectionToId.groupA, connectionToId.portA, connectionToId.groupB, connectionToId.portB);
 
-            extGraph.connections.list.append(connectionToId);
+            extGraph.connections.add(connectionToId);
 
             callback(sendHost, sendOSC,
                       ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED,
@@ -583,7 +585,7 @@ public:
 
             std::snprintf(strBuf, STR_MAX, "%i:%i:%i:%i", connectionToId.groupA, connectionToId.portA, connectionToId.groupB, connectionToId.portB);
 
-            extGraph.connections.list.append(connectionToId);
+            extGraph.connections.add(connectionToId);
 
             callback(sendHost, sendOSC,
                       ENGINE_CALLBACK_PATCHBAY_CONNECTION_ADDED,
@@ -675,40 +677,54 @@ protected:
         carla_zeroStructs(pData->events.in,  kMaxEngineEventInternalCount);
         carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
 
-        if (fMidiInEvents.mutex.tryLock())
+        // place MIDI input events that arrived during the previous cycle, which keeps timing jitter low
         {
+            const int64_t cycleTime = getTimeInMicroseconds();
+            const int64_t lastCycleTime = fLastCycleTime;
+            fLastCycleTime = cycleTime;
+
+            int64_t cycleDuration = cycleTime - lastCycleTime;
+
+            if (lastCycleTime == 0 || cycleDuration <= 0)
+                cycleDuration = static_cast<int64_t>(nframes / pData->sampleRate * 1000000.0);
+
             uint32_t engineEventIndex = 0;
-            fMidiInEvents.splice();
+            uint32_t sysexDataOffset = 0;
 
-            for (LinkedList<RtMidiEvent>::Itenerator it = fMidiInEvents.data.begin2(); it.valid(); it.next())
+            while (engineEventIndex < kMaxEngineEventInternalCount)
             {
-                static const RtMidiEvent fallback = { 0, 0, { 0 } };
+                const RtMidiEvent* const midiEvent = fMidiInEvents.peek();
 
-                const RtMidiEvent& midiEvent(it.getValue(fallback));
-                CARLA_SAFE_ASSERT_CONTINUE(midiEvent.size > 0);
+                // leave events that arrived after this cycle started for the next one
+                if (midiEvent == nullptr || midiEvent->time > cycleTime)
+                    break;
 
-                EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+                const uint8_t* midiData = midiEvent->data;
 
-                if (midiEvent.time < pData->timeInfo.frame)
+                if (midiEvent->size > EngineMidiEvent::kDataSize)
                 {
-                    engineEvent.time = 0;
-                }
-                else if (midiEvent.time >= pData->timeInfo.frame + nframes)
-                {
-                    carla_stderr("MIDI Event in the future!, %i vs %i", engineEvent.time, pData->timeInfo.frame);
-                    engineEvent.time = static_cast<uint32_t>(pData->timeInfo.frame) + nframes - 1;
+                    // no more space for sysex in this cycle
+                    if (sysexDataOffset + midiEvent->size > RtMidiEvents::kSysExBufferSize)
+                        break;
+
+                    midiData = fMidiInSysExData + sysexDataOffset;
+                    fMidiInEvents.copySysEx(*midiEvent, fMidiInSysExData + sysexDataOffset);
+                    sysexDataOffset += midiEvent->size;
                 }
+
+                EngineEvent& engineEvent(pData->events.in[engineEventIndex++]);
+
+                if (midiEvent->time <= lastCycleTime)
+                    engineEvent.time = 0;
                 else
-                    engineEvent.time = static_cast<uint32_t>(midiEvent.time - pData->timeInfo.frame);
+                    engineEvent.time = std::min(nframes - 1U,
+                                                static_cast<uint32_t>((midiEvent->time - lastCycleTime) * nframes
+                                                                      / cycleDuration));
 
-                engineEvent.fillFromMidiData(midiEvent.size, midiEvent.data, 0);
+                engineEvent.fillFromMidiData(midiEvent->size, midiData, 0);
 
-                if (engineEventIndex >= kMaxEngineEventInternalCount)
-                    break;
+                fMidiInEvents.pop(*midiEvent);
             }
-
-            fMidiInEvents.data.clear();
-            fMidiInEvents.mutex.unlock();
         }
 
         pData->graph.process(pData, inBuf, outBuf, nframes);
@@ -818,37 +834,51 @@ protected:
         bufferSizeChanged(newBufferSize);
     }
 
-    void handleMidiCallback(double timeStamp, std::vector<uchar>* const message)
+    void handleMidiCallback(double, std::vector<uchar>* const message)
     {
+        // RtMidi timestamps are relative to the previous message, use our own clock instead
+        const int64_t time = getTimeInMicroseconds();
         const size_t messageSize(message->size());
 
-        if (messageSize == 0 || messageSize > EngineMidiEvent::kDataSize)
+        if (messageSize == 0)
             return;
 
-        timeStamp /= 2;
-
-        if (timeStamp > 0.95)
-            timeStamp = 0.95;
-        else if (timeStamp < 0.0)
-            timeStamp = 0.0;
-
-        RtMidiEvent midiEvent;
-        midiEvent.time = pData->timeInfo.frame + uint64_t(timeStamp * (double)pData->bufferSize);
-
-        if (midiEvent.time < fLastEventTime)
-            midiEvent.time = fLastEventTime;
-        else
-            fLastEventTime = midiEvent.time;
+        // only SysEx can be split over several engine events
+        if (messageSize > UINT8_MAX && message->at(0) != 0xF0 /* SysEx start */)
+        {
+            carla_stderr2("CarlaEngineRtAudio: MIDI message of %u bytes is too big, dropped",
+                          static_cast<uint>(messageSize));
+            return;
+        }
 
-        midiEvent.size = static_cast<uint8_t>(messageSize);
+        if (messageSize > RtMidiEvents::kSysExBufferSize)
+        {
+            carla_stderr2("CarlaEngineRtAudio: SysEx message of %u bytes does not fit the MIDI input queue, dropped",
+                          static_cast<uint>(messageSize));
+            return;
+        }
 
-        size_t i=0;
-        for (; i < messageSize; ++i)
-            midiEvent.data[i] = message->at(i);
-        for (; i < EngineMidiEvent::kDataSize; ++i)
-            midiEvent.data[i] = 0;
+        if (! fMidiInEvents.append(time, message->data(), messageSize))
+            carla_stderr2("CarlaEngineRtAudio: MIDI input queue is full, event dropped");
+    }
 
-        fMidiInEvents.append(midiEvent);
+    static int64_t getTimeInMicroseconds() noexcept
+    {
+    #if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+
+        return (tv.tv_sec * 1000000) + tv.tv_usec;
+    #else
+        struct timespec ts;
+    # ifdef CLOCK_MONOTONIC_RAW
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    # else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+    # endif
+
+        return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+    #endif
     }
 
     // -------------------------------------------------------------------
@@ -878,7 +908,8 @@ protected:
                 rtMidiIn = new RtMidiIn(getMatchedAudioMidiAPI(fAudio.getCurrentApi()), newRtMidiPortName.buffer(), 512);
             } CARLA_SAFE_EXCEPTION_RETURN("new RtMidiIn", false);
 
-            rtMidiIn->ignoreTypes();
+            // we want sysex, but not timing or active sensing messages
+            rtMidiIn->ignoreTypes(false, true, true);
             rtMidiIn->setCallback(carla_rtmidi_callback, this);
 
             bool found = false;
@@ -1040,7 +1071,7 @@ private:
     bool fAudioInterleaved;
     uint fAudioInCount;
     uint fAudioOutCount;
-    uint64_t fLastEventTime;
+    int64_t fLastCycleTime; // start of previous audio cycle, used for placing MIDI input events
 
     // current device name
     CarlaString fDeviceName;
@@ -1060,52 +1091,132 @@ private:
     };
 
     struct RtMidiEvent {
-        uint64_t time; // needs to compare to internal time
+        int64_t  time; // monotonic time of arrival, in microseconds
+        uint32_t sysexOffset; // position in the sysex buffer, if size > kDataSize
         uint8_t  size;
         uint8_t  data[EngineMidiEvent::kDataSize];
     };
 
+    // Single-producer single-consumer queue, the audio thread reads from it without locking.
+    // Messages bigger than kDataSize (SysEx) have their data stored in a separate byte ring.
+    // RtMidi calls us from one thread per input port, so writers are serialized with a mutex
+    // that only they share.
     struct RtMidiEvents {
-        CarlaMutex mutex;
-        RtLinkedList<RtMidiEvent>::Pool dataPool;
-        RtLinkedList<RtMidiEvent> data;
-        RtLinkedList<RtMidiEvent> dataPending;
-
-        RtMidiEvents()
-            : mutex(),
-              dataPool(512, 512),
-              data(dataPool),
-              dataPending(dataPool) {}
-
-        ~RtMidiEvents()
+        static const uint32_t kEventCount = 512;
+        static const uint32_t kSysExBufferSize = 16384;
+
+        CarlaMutex writeMutex;
+        RtMidiEvent events[kEventCount];
+        uint8_t sysexData[kSysExBufferSize];
+
+        // indexes always increase, wrapping around is handled when accessing data
+        volatile uint32_t eventWriteIndex, sysexWriteIndex;
+        volatile uint32_t eventReadIndex, sysexReadIndex;
+
+        RtMidiEvents() noexcept
+            : writeMutex(),
+              eventWriteIndex(0),
+              sysexWriteIndex(0),
+              eventReadIndex(0),
+              sysexReadIndex(0)
         {
-            clear();
+            carla_zeroStructs(events, kEventCount);
+            carla_zeroBytes(sysexData, kSysExBufferSize);
         }
 
-        void append(const RtMidiEvent& event)
+        // writer side, returns false if the queue is full.
+        // engine events hold up to UINT8_MAX bytes, longer SysEx is split over several events, all or nothing.
+        bool append(const int64_t time, const uint8_t* const data, const std::size_t size) noexcept
         {
-            mutex.lock();
-            dataPending.append(event);
-            mutex.unlock();
+            const CarlaMutexLocker cml(writeMutex);
+
+            uint32_t eventIndex = eventWriteIndex;
+            uint32_t sysexIndex = sysexWriteIndex;
+
+            const uint32_t eventCount = static_cast<uint32_t>((size + UINT8_MAX - 1) / UINT8_MAX);
+
+            if (eventIndex - eventReadIndex + eventCount > kEventCount)
+                return false;
+            if (size > EngineMidiEvent::kDataSize && sysexIndex - sysexReadIndex + size > kSysExBufferSize)
+                return false;
+
+            for (std::size_t offset = 0; offset < size; offset += UINT8_MAX)
+            {
+                const uint8_t* const eventData = data + offset;
+                const uint8_t eventSize = static_cast<uint8_t>(std::min<std::size_t>(size - offset, UINT8_MAX));
+
+                RtMidiEvent& event(events[eventIndex++ % kEventCount]);
+                event.time = time;
+                event.size = eventSize;
+
+                if (eventSize > EngineMidiEvent::kDataSize)
+                {
+                    for (uint32_t i=0; i < eventSize; ++i)
+                        sysexData[(sysexIndex + i) % kSysExBufferSize] = eventData[i];
+
+                    event.sysexOffset = sysexIndex;
+                    sysexIndex += eventSize;
+                }
+                else
+                {
+                    event.sysexOffset = 0;
+                    carla_zeroBytes(event.data, EngineMidiEvent::kDataSize);
+                    std::memcpy(event.data, eventData, eventSize);
+                }
+            }
+
+            sysexWriteIndex = sysexIndex;
+
+            // event data must be visible before the reader sees the new index
+            __sync_synchronize();
+            eventWriteIndex = eventIndex;
+            return true;
         }
 
-        void clear()
+        // reader side, returns the oldest event without removing it
+        const RtMidiEvent* peek() const noexcept
         {
-            mutex.lock();
-            data.clear();
-            dataPending.clear();
-            mutex.unlock();
+            const uint32_t eventIndex = eventReadIndex;
+
+            if (eventIndex == eventWriteIndex)
+                return nullptr;
+
+            __sync_synchronize();
+            return &events[eventIndex % kEventCount];
         }
 
-        void splice()
+        // reader side, copies the current event sysex data into a linear buffer
+        void copySysEx(const RtMidiEvent& event, uint8_t* const dst) const noexcept
         {
-            if (dataPending.count() > 0)
-                dataPending.moveTo(data, true /* append */);
+            for (uint32_t i=0; i < event.size; ++i)
+                dst[i] = sysexData[(event.sysexOffset + i) % kSysExBufferSize];
         }
+
+        // reader side, removes the event returned by peek()
+        void pop(const RtMidiEvent& event) noexcept
+        {
+            // we are done reading event data before the writer can reuse it
+            __sync_synchronize();
+
+            if (event.size > EngineMidiEvent::kDataSize)
+                sysexReadIndex = event.sysexOffset + event.size;
+
+            eventReadIndex = eventReadIndex + 1;
+        }
+
+        // only valid when there are no readers or writers
+        void clear() noexcept
+        {
+            eventWriteIndex = sysexWriteIndex = 0;
+            eventReadIndex = sysexReadIndex = 0;
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(RtMidiEvents)
     };
 
     LinkedList<MidiInPort> fMidiIns;
     RtMidiEvents           fMidiInEvents;
+    uint8_t                fMidiInSysExData[RtMidiEvents::kSysExBufferSize];
 
     LinkedList<MidiOutPort> fMidiOuts;
     CarlaMutex              fMidiOutMutex;
@@ -52,7 +52,7 @@ void CarlaEngineThread::run() noexcept
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
     // int64_t lastPingTime = 0;
-    const CarlaEngineOsc& engineOsc(kEngine->pData->osc);
+    CarlaEngineOsc& engineOsc(kEngine->pData->osc);
 #endif
 
     // thread must do something...
@@ -61,7 +61,8 @@ void CarlaEngineThread::run() noexcept
     for (; (kIsAlwaysRunning || kEngine->isRunning()) && ! shouldThreadExit();)
     {
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
-        const bool oscRegistedForUDP = engineOsc.isControlRegisteredForUDP();
+        // only true when an update is due, sent values are rate-limited and bundled
+        const bool oscRegistedForUDP = engineOsc.isControlRegisteredForUDP() && engineOsc.beginUdpUpdate();
 #else
         const bool oscRegistedForUDP = false;
 #endif
@@ -106,7 +107,7 @@ void CarlaEngineThread::run() noexcept
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
                     // Update OSC engine client
                     if (oscRegistedForUDP)
-                        engineOsc.sendParameterValue(i, j, value);
+                        engineOsc.sendParameterValue(plugin, j, value);
 #endif
                     // Update UI
                     if (updateUI)
@@ -132,7 +133,10 @@ void CarlaEngineThread::run() noexcept
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
         if (oscRegistedForUDP)
+        {
             engineOsc.sendRuntimeInfo();
+            engineOsc.endUdpUpdate();
+        }
 
         /*
         if (engineOsc.isControlRegisteredForTCP())
@@ -25,21 +25,20 @@
 #include "CarlaPluginUI.hpp"
 #include "CarlaScopeUtils.hpp"
 #include "CarlaStringList.hpp"
+#include "CarlaXmlUtils.hpp"
 
 #include <ctime>
 
 #include "water/files/File.h"
+#include "water/memory/MemoryBlock.h"
 #include "water/streams/MemoryOutputStream.h"
-#include "water/xml/XmlDocument.h"
-#include "water/xml/XmlElement.h"
 
 using water::CharPointer_UTF8;
 using water::File;
+using water::MemoryBlock;
 using water::MemoryOutputStream;
 using water::Result;
 using water::String;
-using water::XmlDocument;
-using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -294,6 +293,38 @@ float CarlaPlugin::getParameterValue(const uint32_t parameterId) const noexcept
     return 0.0f;
 }
 
+uint32_t CarlaPlugin::getChangedParameterValues(uint32_t& sequence, uint32_t* const indexes, float* const values, const uint32_t count) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(indexes != nullptr, 0);
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr, 0);
+
+    const PluginParameterData& param(pData->param);
+
+    // read before scanning, changes happening meanwhile are reported again next time instead of being missed.
+    // pairs with the release in PluginParameterData::markChanged(), parameter sequences up to this one are visible
+    const uint32_t latest = __atomic_load_n(&param.changeSequence, __ATOMIC_ACQUIRE);
+    const uint32_t since  = sequence;
+
+    uint32_t written = 0;
+
+    for (uint32_t i=0; i < param.count; ++i)
+    {
+        // wrap-around safe version of "changeSequences[i] <= since"
+        if (since != 0 && static_cast<int32_t>(__atomic_load_n(&param.changeSequences[i], __ATOMIC_RELAXED) - since) <= 0)
+            continue;
+
+        if (written == count)
+            return written;
+
+        indexes[written] = i;
+        values[written]  = getParameterValue(i);
+        ++written;
+    }
+
+    sequence = latest;
+    return written;
+}
+
 float CarlaPlugin::getParameterScalePointValue(const uint32_t parameterId, const uint32_t scalePointId) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(parameterId < getParameterCount(), 0.0f);
@@ -506,7 +537,7 @@ void CarlaPlugin::randomizeParameters() noexcept
     }
 }
 
-const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
+const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave, CarlaStateChunkFiles* const chunkFiles)
 {
     pData->stateSave.clear();
 
@@ -566,7 +597,12 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
 
         if (data != nullptr && dataSize > 0)
         {
-            pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
+            if (chunkFiles != nullptr)
+                pData->stateSave.chunkFile = chunkFiles->store(data, dataSize);
+
+            // also used as fallback if storing as file failed
+            if (pData->stateSave.chunkFile == nullptr)
+                pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
 
             if (pluginType != PLUGIN_INTERNAL)
                 usingChunk = true;
@@ -922,7 +958,22 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     // ---------------------------------------------------------------
     // Part 6 - set chunk
 
-    if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    if (stateSave.chunkFile != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    {
+        MemoryBlock chunk;
+
+        // engine resolves chunk file paths when loading a project
+        if (File::isAbsolutePath(stateSave.chunkFile)
+            && File(stateSave.chunkFile).loadFileAsData(chunk) && chunk.getSize() > 0)
+        {
+            setChunkData(chunk.getData(), chunk.getSize());
+        }
+        else
+        {
+            carla_stderr2("Failed to load chunk file '%s'", stateSave.chunkFile);
+        }
+    }
+    else if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
     {
         std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
 #ifdef CARLA_PROPER_CPP11_SUPPORT
@@ -938,7 +989,7 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
 
     const uint availOptions(getOptionsAvailable());
 
-    for (uint i=0; i<10; ++i) // FIXME - get this value somehow...
+    for (uint i=0; i<14; ++i) // FIXME - get this value somehow...
     {
         const uint option(1u << i);
 
@@ -994,16 +1045,15 @@ bool CarlaPlugin::loadStateFromFile(const char* const filename)
     File file(jfilename);
     CARLA_SAFE_ASSERT_RETURN(file.existsAsFile(), false);
 
-    XmlDocument xml(file);
-    CarlaScopedPointer<XmlElement> xmlElement(xml.getDocumentElement(true));
-    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
-    CARLA_SAFE_ASSERT_RETURN(xmlElement->getTagName().equalsIgnoreCase("carla-preset"), false);
+    MemoryBlock data;
+    CARLA_SAFE_ASSERT_RETURN(file.loadFileAsData(data), false);
 
-    // completely load file
-    xmlElement = xml.getDocumentElement(false);
-    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
+    CarlaXmlReader reader(static_cast<char*>(data.getData()), data.getSize());
+    CARLA_SAFE_ASSERT_RETURN(reader.next() == CarlaXmlReader::kTokenStartElement, false);
+    CARLA_SAFE_ASSERT_RETURN(String(CharPointer_UTF8(reader.getName())).equalsIgnoreCase("carla-preset"), false);
+    CARLA_SAFE_ASSERT_RETURN(reader.endsWithRootEndTag(), false);
 
-    if (pData->stateSave.fillFromXmlElement(xmlElement))
+    if (pData->stateSave.fillFromXmlReader(reader))
     {
         loadStateSave(pData->stateSave);
         return true;
@@ -1330,6 +1380,149 @@ bool CarlaPlugin::exportAsLV2(const char* const lv2path)
     return true;
 }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+// -------------------------------------------------------------------
+// Set data (state snapshots)
+
+bool CarlaPlugin::saveSnapshot(const uint slot)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(slot < MAX_SNAPSHOTS, "Invalid snapshot slot");
+    carla_debug("CarlaPlugin::saveSnapshot(%u)", slot);
+
+    const PluginType pluginType(getType());
+
+    ProtectedData::Snapshot snapshot;
+
+    snapshot.dryWet       = pData->postProc.dryWet;
+    snapshot.volume       = pData->postProc.volume;
+    snapshot.balanceLeft  = pData->postProc.balanceLeft;
+    snapshot.balanceRight = pData->postProc.balanceRight;
+    snapshot.panning      = pData->postProc.panning;
+
+    // ---------------------------------------------------------------
+    // Chunk, kept as-is
+
+    if (pData->options & PLUGIN_OPTION_USE_CHUNKS)
+    {
+        prepareForSave(true);
+
+        if (pData->hints & PLUGIN_IS_BRIDGE)
+            waitForBridgeSaveSignal();
+
+        void* data = nullptr;
+        const std::size_t dataSize(getChunkData(&data));
+
+        if (data != nullptr && dataSize > 0)
+        {
+            snapshot.chunk = std::malloc(dataSize);
+            CARLA_SAFE_ASSERT_RETURN_ERR(snapshot.chunk != nullptr, "Out of memory");
+
+            std::memcpy(snapshot.chunk, data, dataSize);
+            snapshot.chunkSize = dataSize;
+            snapshot.usesChunk = pluginType != PLUGIN_INTERNAL;
+        }
+    }
+
+    // ---------------------------------------------------------------
+    // Programs, same rules as getStateSave()
+
+    if (pData->prog.current >= 0 && pluginType != PLUGIN_LV2)
+        snapshot.program = pData->prog.current;
+
+    if (pData->midiprog.current >= 0 && pluginType != PLUGIN_LV2 && pluginType != PLUGIN_SF2
+        && (pData->hints & PLUGIN_USES_MULTI_PROGS) == 0)
+        snapshot.midiProgram = pData->midiprog.current;
+
+    // ---------------------------------------------------------------
+    // Parameters
+
+    if (pData->param.count > 0)
+    {
+        try {
+            snapshot.paramValues = new float[pData->param.count];
+        } CARLA_SAFE_EXCEPTION_RETURN_ERR("new float[]", "Out of memory");
+
+        snapshot.paramCount = pData->param.count;
+
+        const float sampleRate(static_cast<float>(pData->engine->getSampleRate()));
+
+        for (uint32_t i=0; i < pData->param.count; ++i)
+        {
+            float value = getParameterValue(i);
+
+            if (pData->param.data[i].hints & PARAMETER_USES_SAMPLERATE)
+                value /= sampleRate;
+
+            snapshot.paramValues[i] = value;
+        }
+    }
+
+    snapshot.valid = true;
+
+    {
+        const CarlaMutexLocker cml(pData->snapshots.mutex);
+        pData->snapshots.slots[slot].swapWith(snapshot);
+    }
+
+    // previous slot contents are freed here, outside the lock
+    return true;
+}
+
+bool CarlaPlugin::loadSnapshot(const uint slot)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(slot < MAX_SNAPSHOTS, "Invalid snapshot slot");
+    carla_debug("CarlaPlugin::loadSnapshot(%u)", slot);
+
+    {
+        // saveSnapshot() and clearSnapshot() may be called from other threads
+        const CarlaMutexLocker cml(pData->snapshots.mutex);
+
+        const ProtectedData::Snapshot& snapshot(pData->snapshots.slots[slot]);
+
+        if (! snapshot.valid)
+        {
+            pData->engine->setLastError("Snapshot slot is empty");
+            return false;
+        }
+
+        if (snapshot.paramCount != pData->param.count)
+        {
+            pData->engine->setLastError("Snapshot does not match the current plugin parameters");
+            return false;
+        }
+
+        // chunks can't be applied from the audio thread, they are set right away
+        if (snapshot.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+            setChunkData(snapshot.chunk, snapshot.chunkSize);
+
+        pData->snapshots.pending = static_cast<int32_t>(slot);
+    }
+
+    // there is no audio thread to pick it up
+    if (! pData->engine->isRunning())
+        applyPendingSnapshotRT();
+
+    return true;
+}
+
+void CarlaPlugin::clearSnapshot(const uint slot) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(slot < MAX_SNAPSHOTS,);
+    carla_debug("CarlaPlugin::clearSnapshot(%u)", slot);
+
+    ProtectedData::Snapshot snapshot;
+
+    {
+        const CarlaMutexLocker cml(pData->snapshots.mutex);
+
+        if (pData->snapshots.pending == static_cast<int32_t>(slot))
+            pData->snapshots.pending = -1;
+
+        pData->snapshots.slots[slot].swapWith(snapshot);
+    }
+}
+#endif
+
 // -------------------------------------------------------------------
 // Set data (internal stuff)
 
@@ -1358,6 +1551,9 @@ void CarlaPlugin::setOption(const uint option, const bool yesNo, const bool send
         pData->options &= ~option;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    if (option == PLUGIN_OPTION_ALWAYS_PROCESS)
+        pData->engine->patchbaySetGroupAlwaysProcessed(pData->nodeId, yesNo);
+
     if (sendCallback)
         pData->engine->callback(true, true,
                                 ENGINE_CALLBACK_OPTION_CHANGED,
@@ -1408,6 +1604,7 @@ void CarlaPlugin::setActive(const bool active, const bool sendOsc, const bool se
     }
 
     pData->active = active;
+    pData->sleepState.wakeUp = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     const float value = active ? 1.0f : 0.0f;
@@ -1655,6 +1852,9 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
     }
     CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
 
+    pData->sleepState.wakeUp = true;
+    pData->param.markChanged(parameterId);
+
     if (sendGui && (pData->hints & PLUGIN_HAS_CUSTOM_UI) != 0)
         uiParameterChange(parameterId, value);
 
@@ -1669,6 +1869,7 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
 
 void CarlaPlugin::setParameterValueRT(const uint32_t parameterId, const float value, const bool sendCallbackLater) noexcept
 {
+    pData->sleepState.wakeUp = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, static_cast<int32_t>(parameterId), value);
 }
 
@@ -1897,6 +2098,8 @@ void CarlaPlugin::setCustomData(const char* const type, const char* const key, c
             return;
     }
 
+    pData->sleepState.wakeUp = true;
+
     // Check if we already have this key
     for (LinkedList<CustomData>::Itenerator it = pData->custom.begin2(); it.valid(); it.next())
     {
@@ -1934,6 +2137,7 @@ void CarlaPlugin::setProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->prog.count),);
 
     pData->prog.current = index;
+    pData->sleepState.wakeUp = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PROGRAM_CHANGED,
@@ -1966,6 +2170,7 @@ void CarlaPlugin::setMidiProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->midiprog.count),);
 
     pData->midiprog.current = index;
+    pData->sleepState.wakeUp = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_MIDI_PROGRAM_CHANGED,
@@ -2077,6 +2282,178 @@ void CarlaPlugin::offlineModeChanged(const bool)
 {
 }
 
+bool CarlaPlugin::isSleepingRT(const float* const* const audioIn, const bool inputSilent, const uint32_t frames) noexcept
+{
+    ProtectedData::SleepState& sleepState(pData->sleepState);
+
+    // only plugins with audio outputs can sleep, and we have no idea what CV inputs are doing
+    if ((pData->options & PLUGIN_OPTION_SLEEP_ON_SILENCE) == 0 || pData->audioOut.count == 0 || pData->cvIn.count != 0)
+    {
+        sleepState.sleeping     = false;
+        sleepState.inputSilent  = false;
+        sleepState.silentFrames = 0;
+        return false;
+    }
+
+    // transport changes can make a plugin produce sound without any input
+    const EngineTimeInfo timeInfo(pData->engine->getTimeInfo());
+
+    const bool transportChanged = timeInfo.playing != sleepState.transportPlaying
+                               || timeInfo.frame != sleepState.transportFrame
+                               || ! carla_isEqual(timeInfo.bbt.beatsPerMinute, sleepState.transportBPM);
+
+    sleepState.transportPlaying = timeInfo.playing;
+    sleepState.transportFrame   = timeInfo.playing ? timeInfo.frame + frames : timeInfo.frame;
+    sleepState.transportBPM     = timeInfo.bbt.beatsPerMinute;
+
+    bool activity = false;
+
+    if (sleepState.wakeUp)
+    {
+        sleepState.wakeUp = false;
+        activity = true;
+    }
+    else if (transportChanged)
+    {
+        activity = true;
+    }
+    else if (timeInfo.playing && pData->audioIn.count == 0)
+    {
+        // generators can follow the transport (sequencers, drum machines), keep them running while it rolls
+        activity = true;
+    }
+    else if (pData->needsReset)
+    {
+        activity = true;
+    }
+    else if (pData->event.portIn != nullptr && pData->event.portIn->getEventCount() != 0)
+    {
+        activity = true;
+    }
+    else if (! inputSilent)
+    {
+        CARLA_SAFE_ASSERT_RETURN(audioIn != nullptr || pData->audioIn.count == 0, false);
+
+        for (uint32_t i=0; i < pData->audioIn.count; ++i)
+        {
+            if (! carla_isSilentFloats(audioIn[i], frames))
+            {
+                activity = true;
+                break;
+            }
+        }
+    }
+
+    if (activity)
+    {
+        sleepState.sleeping     = false;
+        sleepState.inputSilent  = false;
+        sleepState.silentFrames = 0;
+        return false;
+    }
+
+    sleepState.inputSilent = true;
+    return sleepState.sleeping;
+}
+
+void CarlaPlugin::updateSleepStateRT(const float* const* const audioOut, const uint32_t frames) noexcept
+{
+    ProtectedData::SleepState& sleepState(pData->sleepState);
+
+    if (sleepState.sleeping || ! sleepState.inputSilent)
+        return;
+
+    CARLA_SAFE_ASSERT_RETURN(audioOut != nullptr || pData->audioOut.count == 0,);
+
+    // output needs to be silent too, so any tail has fully decayed before going to sleep
+    for (uint32_t i=0; i < pData->audioOut.count; ++i)
+    {
+        if (! carla_isSilentFloats(audioOut[i], frames))
+        {
+            sleepState.silentFrames = 0;
+            return;
+        }
+    }
+
+    sleepState.silentFrames += frames;
+
+    const double timeout = static_cast<double>(pData->engine->getOptions().pluginSleepTimeout)
+                         * pData->engine->getSampleRate() / 1000.0;
+
+    if (static_cast<double>(sleepState.silentFrames) >= timeout)
+        sleepState.sleeping = true;
+}
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+void CarlaPlugin::applyPendingSnapshotRT() noexcept
+{
+    ProtectedData::Snapshots& snapshots(pData->snapshots);
+
+    if (snapshots.pending < 0)
+        return;
+
+    // main thread is changing snapshots or the plugin, try again on the next cycle
+    if (! snapshots.mutex.tryLock())
+        return;
+
+    const int32_t slot = snapshots.pending;
+
+    if (slot >= 0 && pData->masterMutex.tryLock())
+    {
+        snapshots.pending = -1;
+
+        const ProtectedData::Snapshot& snapshot(snapshots.slots[slot]);
+
+        if (snapshot.valid)
+        {
+            if (snapshot.program >= 0 && snapshot.program != pData->prog.current
+                && static_cast<uint32_t>(snapshot.program) < pData->prog.count)
+                setProgramRT(static_cast<uint32_t>(snapshot.program), true);
+
+            if (snapshot.midiProgram >= 0 && snapshot.midiProgram != pData->midiprog.current
+                && static_cast<uint32_t>(snapshot.midiProgram) < pData->midiprog.count)
+                setMidiProgramRT(static_cast<uint32_t>(snapshot.midiProgram), true);
+
+            // parameters are part of the chunk, if used
+            if (! snapshot.usesChunk)
+            {
+                const float sampleRate(static_cast<float>(pData->engine->getSampleRate()));
+                const uint32_t count = std::min(snapshot.paramCount, pData->param.count);
+
+                for (uint32_t i=0; i < count; ++i)
+                {
+                    const ParameterData& paramData(pData->param.data[i]);
+
+                    if (paramData.type != PARAMETER_INPUT)
+                        continue;
+                    if ((paramData.hints & PARAMETER_IS_ENABLED) == 0)
+                        continue;
+                    if (paramData.hints & PARAMETER_IS_NOT_SAVED)
+                        continue;
+
+                    float value = snapshot.paramValues[i];
+
+                    if (paramData.hints & PARAMETER_USES_SAMPLERATE)
+                        value *= sampleRate;
+
+                    setParameterValueRT(i, value, true);
+                }
+            }
+
+            setDryWetRT(snapshot.dryWet, true);
+            setVolumeRT(snapshot.volume, true);
+            setBalanceLeftRT(snapshot.balanceLeft, true);
+            setBalanceRightRT(snapshot.balanceRight, true);
+            setPanningRT(snapshot.panning, true);
+        }
+
+        pData->masterMutex.unlock();
+    }
+
+    snapshots.mutex.unlock();
+}
+#endif
+
 // -------------------------------------------------------------------
 // Misc
 
@@ -2104,13 +2481,10 @@ void CarlaPlugin::idle()
     }
 
     ProtectedData::PostRtEvents::Access rtEvents(pData->postRtEvents);
+    PluginPostRtEvent event;
 
-    if (rtEvents.isEmpty())
-        return;
-
-    for (RtLinkedList<PluginPostRtEvent>::Itenerator it = rtEvents.getDataIterator(); it.valid(); it.next())
+    for (; rtEvents.next(event);)
     {
-        const PluginPostRtEvent& event(it.getValue(kPluginPostRtEventFallback));
         CARLA_SAFE_ASSERT_CONTINUE(event.type != kPluginPostRtEventNull);
 
         switch (event.type)
@@ -2368,6 +2742,7 @@ void CarlaPlugin::sendMidiSingleNote(const uint8_t channel, const uint8_t note,
     extNote.velo    = velo;
 
     pData->extNotes.appendNonRT(extNote);
+    pData->sleepState.wakeUp = true;
 
     if (sendGui && (pData->hints & PLUGIN_HAS_CUSTOM_UI) != 0)
     {
@@ -84,6 +84,8 @@ struct BridgeParamInfo {
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+class CarlaPluginBridgePool;
+
 class CarlaPluginBridgeThread : public CarlaThread
 {
 public:
@@ -91,6 +93,22 @@ public:
         : CarlaThread("CarlaPluginBridgeThread"),
           kEngine(engine),
           kPlugin(plugin),
+          kPool(nullptr),
+          fBinaryArchName(),
+          fBridgeBinary(),
+          fLabel(),
+          fShmIds(),
+#ifndef CARLA_OS_WIN
+          fWinePrefix(),
+#endif
+          fProcess() {}
+
+    // used for a bridge process shared between several plugins, see CarlaPluginBridgePool
+    CarlaPluginBridgeThread(CarlaEngine* const engine, CarlaPluginBridgePool* const pool) noexcept
+        : CarlaThread("CarlaPluginBridgePoolThread"),
+          kEngine(engine),
+          kPlugin(nullptr),
+          kPool(pool),
           fBinaryArchName(),
           fBridgeBinary(),
           fLabel(),
@@ -133,6 +151,16 @@ public:
         return (uintptr_t)fProcess->getPID();
     }
 
+    const String& getLabel() const noexcept
+    {
+        return fLabel;
+    }
+
+    const String& getShmIds() const noexcept
+    {
+        return fShmIds;
+    }
+
 protected:
     void run()
     {
@@ -150,7 +178,7 @@ protected:
 
         const EngineOptions& options(kEngine->getOptions());
 
-        String filename(kPlugin->getFilename());
+        String filename(kPlugin != nullptr ? kPlugin->getFilename() : "");
 
         if (filename.isEmpty())
             filename = "(none)";
@@ -194,17 +222,26 @@ protected:
         // bridge binary
         arguments.add(fBridgeBinary);
 
-        // plugin type
-        arguments.add(getPluginTypeAsString(kPlugin->getType()));
+        if (kPool != nullptr)
+        {
+            // plugins are sent later through the pool control shm
+            arguments.add("--pool");
+            arguments.add(fShmIds);
+        }
+        else
+        {
+            // plugin type
+            arguments.add(getPluginTypeAsString(kPlugin->getType()));
 
-        // filename
-        arguments.add(filename);
+            // filename
+            arguments.add(filename);
 
-        // label
-        arguments.add(fLabel);
+            // label
+            arguments.add(fLabel);
 
-        // uniqueId
-        arguments.add(String(static_cast<water::int64>(kPlugin->getUniqueId())));
+            // uniqueId
+            arguments.add(String(static_cast<water::int64>(kPlugin->getUniqueId())));
+        }
 
         bool started;
 
@@ -277,7 +314,10 @@ protected:
             std::snprintf(strBuf, STR_MAX, P_UINTPTR, options.frontendWinId);
             carla_setenv("ENGINE_OPTION_FRONTEND_WIN_ID", strBuf);
 
-            carla_setenv("ENGINE_BRIDGE_SHM_IDS", fShmIds.toRawUTF8());
+            if (kPool != nullptr)
+                carla_unsetenv("ENGINE_BRIDGE_SHM_IDS");
+            else
+                carla_setenv("ENGINE_BRIDGE_SHM_IDS", fShmIds.toRawUTF8());
 
 #ifndef CARLA_OS_WIN
             if (fWinePrefix.isNotEmpty())
@@ -317,8 +357,12 @@ protected:
             }
 #endif
 
-            carla_stdout("Starting plugin bridge, command is:\n%s \"%s\" \"%s\" \"%s\" " P_INT64,
-                         fBridgeBinary.toRawUTF8(), getPluginTypeAsString(kPlugin->getType()), filename.toRawUTF8(), fLabel.toRawUTF8(), kPlugin->getUniqueId());
+            if (kPool != nullptr)
+                carla_stdout("Starting plugin bridge process pool, command is:\n%s --pool %s",
+                             fBridgeBinary.toRawUTF8(), fShmIds.toRawUTF8());
+            else
+                carla_stdout("Starting plugin bridge, command is:\n%s \"%s\" \"%s\" \"%s\" " P_INT64,
+                             fBridgeBinary.toRawUTF8(), getPluginTypeAsString(kPlugin->getType()), filename.toRawUTF8(), fLabel.toRawUTF8(), kPlugin->getUniqueId());
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
             const File projFolder(kEngine->getCurrentProjectFolder());
@@ -369,20 +413,32 @@ protected:
             {
                 carla_stderr("CarlaPluginBridgeThread::run() - bridge crashed");
 
-                CarlaString errorString("Plugin '" + CarlaString(kPlugin->getName()) + "' has crashed!\n"
-                                        "Saving now will lose its current settings.\n"
-                                        "Please remove this plugin, and not rely on it from this point.");
-                kEngine->callback(true, true,
-                                  CarlaBackend::ENGINE_CALLBACK_ERROR, kPlugin->getId(), 0, 0, 0, 0.0f, errorString);
+                if (kPool != nullptr)
+                    reportPoolCrash();
+                else
+                    reportCrash(kPlugin);
             }
         }
 
         fProcess = nullptr;
     }
 
+    void reportCrash(CarlaPlugin* const plugin)
+    {
+        CarlaString errorString("Plugin '" + CarlaString(plugin->getName()) + "' has crashed!\n"
+                                "Saving now will lose its current settings.\n"
+                                "Please remove this plugin, and not rely on it from this point.");
+        kEngine->callback(true, true,
+                          CarlaBackend::ENGINE_CALLBACK_ERROR, plugin->getId(), 0, 0, 0, 0.0f, errorString);
+    }
+
+    // defined after CarlaPluginBridgePool
+    void reportPoolCrash();
+
 private:
     CarlaEngine* const kEngine;
     CarlaPlugin* const kPlugin;
+    CarlaPluginBridgePool* const kPool;
 
     String fBinaryArchName;
     String fBridgeBinary;
@@ -397,6 +453,215 @@ private:
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridgeThread)
 };
 
+// ---------------------------------------------------------------------------------------------------------------------
+// Bridge process pooling, a single bridge process hosting several plugins with the same bridge binary, arch and wine prefix.
+// Enabled by setting ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE to the maximum number of plugins per process.
+// Each plugin keeps its own audio pool, control shm and RT round-trip, only the process and its runtime are shared.
+// This saves memory and startup time, but not context switches, as the host still processes plugins one by one.
+
+class CarlaPluginBridgePool
+{
+public:
+    static CarlaPluginBridgePool* acquire(CarlaEngine* const engine,
+                                          CarlaPlugin* const plugin,
+                                          const char* const winePrefix,
+                                          const char* const binaryArchName,
+                                          const char* const bridgeBinary)
+    {
+        const uint poolSize = std::min(engine->getOptions().bridgeProcessPoolSize, kPluginBridgePoolMaxSize);
+
+        if (poolSize <= 1)
+            return nullptr;
+
+        const char* const archName = binaryArchName != nullptr ? binaryArchName : "";
+        const char* const prefix   = winePrefix != nullptr ? winePrefix : "";
+
+        const CarlaMutexLocker cml(getPoolsMutex());
+        LinkedList<CarlaPluginBridgePool*>& pools(getPools());
+
+        for (LinkedList<CarlaPluginBridgePool*>::Itenerator it = pools.begin2(); it.valid(); it.next())
+        {
+            CarlaPluginBridgePool* const pool(it.getValue(nullptr));
+            CARLA_SAFE_ASSERT_CONTINUE(pool != nullptr);
+
+            if (pool->kEngine != engine)
+                continue;
+            if (pool->fBridgeBinary != bridgeBinary || pool->fBinaryArchName != archName)
+                continue;
+            if (pool->fWinePrefix != prefix)
+                continue;
+
+            const CarlaMutexLocker cml2(pool->fPluginsMutex);
+
+            if (pool->fPlugins.count() >= poolSize)
+                continue;
+
+            pool->fPlugins.append(plugin);
+            return pool;
+        }
+
+        CarlaPluginBridgePool* const pool(new CarlaPluginBridgePool(engine, prefix, archName, bridgeBinary));
+
+        if (! pool->init())
+        {
+            carla_stderr("Failed to initialize bridge process pool control, using a dedicated process instead");
+            delete pool;
+            return nullptr;
+        }
+
+        pool->fPlugins.append(plugin);
+        pools.append(pool);
+        return pool;
+    }
+
+    static void release(CarlaPluginBridgePool* const pool, CarlaPlugin* const plugin)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pool != nullptr,);
+
+        const CarlaMutexLocker cml(getPoolsMutex());
+
+        {
+            const CarlaMutexLocker cml2(pool->fPluginsMutex);
+            pool->fPlugins.removeOne(plugin);
+
+            if (pool->fPlugins.count() != 0)
+                return;
+        }
+
+        getPools().removeOne(pool);
+        delete pool;
+    }
+
+    bool isRunning() const noexcept
+    {
+        return fThread.isThreadRunning();
+    }
+
+    uintptr_t getProcessPID() const noexcept
+    {
+        return fThread.getProcessPID();
+    }
+
+    bool addPlugin(const PluginType ptype,
+                   const char* const filename,
+                   const char* const label,
+                   const int64_t uniqueId,
+                   const char* const shmIds)
+    {
+        const CarlaMutexLocker cml(fShmPoolControl.mutex);
+
+        if (! fThread.isThreadRunning())
+        {
+            fShmPoolControl.clearData();
+
+            if (! fThread.startThread())
+                return false;
+        }
+
+        const uint32_t shmIdsSize   = static_cast<uint32_t>(std::strlen(shmIds));
+        const uint32_t filenameSize = filename != nullptr ? static_cast<uint32_t>(std::strlen(filename)) : 0;
+        const uint32_t labelSize    = label != nullptr ? static_cast<uint32_t>(std::strlen(label)) : 0;
+
+        fShmPoolControl.writeUInt(kPluginBridgePoolAddPlugin);
+        fShmPoolControl.writeUInt(shmIdsSize);
+        fShmPoolControl.writeCustomData(shmIds, shmIdsSize);
+        fShmPoolControl.writeUInt(static_cast<uint32_t>(ptype));
+        fShmPoolControl.writeUInt(filenameSize);
+        if (filenameSize != 0)
+            fShmPoolControl.writeCustomData(filename, filenameSize);
+        fShmPoolControl.writeUInt(labelSize);
+        if (labelSize != 0)
+            fShmPoolControl.writeCustomData(label, labelSize);
+        fShmPoolControl.writeLong(uniqueId);
+
+        return fShmPoolControl.commitWrite();
+    }
+
+private:
+    CarlaEngine* const kEngine;
+    const String fBinaryArchName;
+    const String fBridgeBinary;
+    const String fWinePrefix;
+
+    BridgeNonRtClientControl fShmPoolControl;
+    CarlaPluginBridgeThread  fThread;
+
+    CarlaMutex                fPluginsMutex;
+    LinkedList<CarlaPlugin*>  fPlugins;
+
+    CarlaPluginBridgePool(CarlaEngine* const engine,
+                          const char* const winePrefix,
+                          const char* const binaryArchName,
+                          const char* const bridgeBinary)
+        : kEngine(engine),
+          fBinaryArchName(binaryArchName),
+          fBridgeBinary(bridgeBinary),
+          fWinePrefix(winePrefix),
+          fShmPoolControl(),
+          fThread(engine, this),
+          fPluginsMutex(),
+          fPlugins() {}
+
+    ~CarlaPluginBridgePool()
+    {
+        if (fThread.isThreadRunning())
+        {
+            const CarlaMutexLocker cml(fShmPoolControl.mutex);
+
+            fShmPoolControl.writeUInt(kPluginBridgePoolQuit);
+            fShmPoolControl.commitWrite();
+        }
+
+        fThread.stopThread(3000);
+        fShmPoolControl.clear();
+    }
+
+    bool init()
+    {
+        if (! fShmPoolControl.initializeServer())
+            return false;
+
+        fThread.setData(
+#ifndef CARLA_OS_WIN
+                        fWinePrefix.toRawUTF8(),
+#endif
+                        fBinaryArchName.toRawUTF8(),
+                        fBridgeBinary.toRawUTF8(),
+                        nullptr,
+                        &fShmPoolControl.filename[fShmPoolControl.filename.length()-6]);
+        return true;
+    }
+
+    static CarlaMutex& getPoolsMutex() noexcept
+    {
+        static CarlaMutex mutex;
+        return mutex;
+    }
+
+    static LinkedList<CarlaPluginBridgePool*>& getPools() noexcept
+    {
+        static LinkedList<CarlaPluginBridgePool*> pools;
+        return pools;
+    }
+
+    friend class CarlaPluginBridgeThread;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginBridgePool)
+};
+
+void CarlaPluginBridgeThread::reportPoolCrash()
+{
+    const CarlaMutexLocker cml(kPool->fPluginsMutex);
+
+    for (LinkedList<CarlaPlugin*>::Itenerator it = kPool->fPlugins.begin2(); it.valid(); it.next())
+    {
+        CarlaPlugin* const plugin(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(plugin != nullptr);
+
+        reportCrash(plugin);
+    }
+}
+
 // ---------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginBridge : public CarlaPlugin
@@ -416,6 +681,7 @@ public:
           fProcWaitTime(0),
           fBridgeBinary(),
           fBridgeThread(engine, this),
+          fBridgePool(nullptr),
           fShmAudioPool(),
           fShmRtClientControl(),
           fShmNonRtClientControl(),
@@ -456,7 +722,7 @@ public:
             pData->active = false;
         }
 
-        if (fBridgeThread.isThreadRunning())
+        if (isBridgeRunning())
         {
             fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientQuit);
             fShmNonRtClientControl.commitWrite();
@@ -468,7 +734,15 @@ public:
                 waitForClient("stopping", 3000);
         }
 
-        fBridgeThread.stopThread(3000);
+        if (fBridgePool != nullptr)
+        {
+            CarlaPluginBridgePool::release(fBridgePool, this);
+            fBridgePool = nullptr;
+        }
+        else
+        {
+            fBridgeThread.stopThread(3000);
+        }
 
         fShmNonRtServerControl.clear();
         fShmNonRtClientControl.clear();
@@ -651,7 +925,7 @@ public:
         const uint32_t timeoutEnd = Time::getMillisecondCounter() + 500; // 500 ms
         const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
 
-        for (; Time::getMillisecondCounter() < timeoutEnd && fBridgeThread.isThreadRunning();)
+        for (; Time::getMillisecondCounter() < timeoutEnd && isBridgeRunning();)
         {
             if (fReceivingParamText.wasDataReceived(&success))
                 return success;
@@ -662,7 +936,7 @@ public:
             carla_msleep(5);
         }
 
-        if (! fBridgeThread.isThreadRunning())
+        if (! isBridgeRunning())
         {
             carla_stderr("CarlaPluginBridge::waitForParameterText() - Bridge is not running");
             return false;
@@ -681,7 +955,7 @@ public:
         const uint32_t timeoutEnd = Time::getMillisecondCounter() + 60*1000; // 60 secs, 1 minute
         const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
 
-        for (; Time::getMillisecondCounter() < timeoutEnd && fBridgeThread.isThreadRunning();)
+        for (; Time::getMillisecondCounter() < timeoutEnd && isBridgeRunning();)
         {
             pData->engine->callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
 
@@ -694,7 +968,7 @@ public:
             carla_msleep(20);
         }
 
-        if (! fBridgeThread.isThreadRunning())
+        if (! isBridgeRunning())
             return carla_stderr("CarlaPluginBridge::waitForSaved() - Bridge is not running");
         if (! fSaved)
             return carla_stderr("CarlaPluginBridge::waitForSaved() - Timeout while requesting save state");
@@ -1032,7 +1306,7 @@ public:
 
     void idle() override
     {
-        if (fBridgeThread.isThreadRunning())
+        if (isBridgeRunning())
         {
             if (fInitiated && fTimedOut && pData->active)
                 setActive(false, true, true);
@@ -1285,7 +1559,7 @@ public:
 
     void activate() noexcept override
     {
-        if (! fBridgeThread.isThreadRunning())
+        if (! isBridgeRunning())
         {
             CARLA_SAFE_ASSERT_RETURN(restartBridgeThread(),);
         }
@@ -1634,8 +1908,6 @@ public:
                 }
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input
 
         if (! processSingle(audioIn, audioOut, cvIn, cvOut, frames))
@@ -2551,6 +2823,9 @@ public:
 
     uintptr_t getUiBridgeProcessId() const noexcept override
     {
+        if (fBridgePool != nullptr)
+            return fBridgePool->getProcessPID();
+
         return fBridgeThread.getProcessPID();
     }
 
@@ -2680,6 +2955,14 @@ public:
                                   binaryArchName, bridgeBinary, label, shmIdsStr);
         }
 
+        fBridgePool = CarlaPluginBridgePool::acquire(pData->engine, this,
+#ifndef CARLA_OS_WIN
+                                                     fWinePrefix.toRawUTF8(),
+#else
+                                                     nullptr,
+#endif
+                                                     binaryArchName, bridgeBinary);
+
         if (! restartBridgeThread())
             return false;
 
@@ -2707,6 +2990,14 @@ public:
 
         pData->options = 0x0;
 
+        if (fInfo.optionsAvailable & PLUGIN_OPTION_SLEEP_ON_SILENCE)
+            if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+                pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (fInfo.optionsAvailable & PLUGIN_OPTION_ALWAYS_PROCESS)
+            if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+                pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         if ((fInfo.optionsAvailable & PLUGIN_OPTION_FIXED_BUFFERS) == 0x0)
             pData->options |= PLUGIN_OPTION_FIXED_BUFFERS;
          else if (isPluginOptionEnabled(options, PLUGIN_OPTION_FIXED_BUFFERS))
@@ -2789,6 +3080,7 @@ private:
 
     CarlaString             fBridgeBinary;
     CarlaPluginBridgeThread fBridgeThread;
+    CarlaPluginBridgePool*  fBridgePool;
 
     BridgeAudioPool          fShmAudioPool;
     BridgeRtClientControl    fShmRtClientControl;
@@ -2994,6 +3286,14 @@ private:
         waitForClient("resize-pool", 5000);
     }
 
+    bool isBridgeRunning() const noexcept
+    {
+        if (fBridgePool != nullptr)
+            return fBridgePool->isRunning();
+
+        return fBridgeThread.isThreadRunning();
+    }
+
     void waitForClient(const char* const action, const uint msecs)
     {
         CARLA_SAFE_ASSERT_RETURN(! fTimedOut,);
@@ -3047,7 +3347,22 @@ private:
             fShmRtClientControl.commitWrite();
         }
 
-        fBridgeThread.startThread();
+        if (fBridgePool != nullptr)
+        {
+            if (! fBridgePool->addPlugin(fPluginType,
+                                         pData->filename,
+                                         fBridgeThread.getLabel().toRawUTF8(),
+                                         fUniqueId,
+                                         fBridgeThread.getShmIds().toRawUTF8()))
+            {
+                pData->engine->setLastError("Failed to start plugin bridge process pool");
+                return false;
+            }
+        }
+        else
+        {
+            fBridgeThread.startThread();
+        }
 
         const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -3065,7 +3380,7 @@ private:
         }
 #endif
 
-        for (;fBridgeThread.isThreadRunning();)
+        for (;isBridgeRunning();)
         {
             pData->engine->callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
 
@@ -3096,7 +3411,18 @@ private:
 
         if (fInitError || ! fInitiated)
         {
-            fBridgeThread.stopThread(6000);
+            if (fBridgePool != nullptr)
+            {
+                // the pool process is shared, only ask our own engine to quit
+                const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+                fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientQuit);
+                fShmNonRtClientControl.commitWrite();
+            }
+            else
+            {
+                fBridgeThread.stopThread(6000);
+            }
 
             if (! fInitError)
                 pData->engine->setLastError("Timeout while waiting for a response from plugin-bridge\n"
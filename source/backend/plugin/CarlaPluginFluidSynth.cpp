@@ -41,10 +41,23 @@ static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 
 // -------------------------------------------------------------------------------------------------------------------
 
+static int getNumCPUs() noexcept
+{
+#ifdef CARLA_OS_WIN
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return static_cast<int>(info.dwNumberOfProcessors);
+#else
+    return static_cast<int>(::sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+
 class CarlaPluginFluidSynth : public CarlaPlugin
 {
 public:
-    CarlaPluginFluidSynth(CarlaEngine* const engine, const uint id, const bool use16Outs)
+    CarlaPluginFluidSynth(CarlaEngine* const engine, const uint id, const bool use16Outs, const bool multiCore)
         : CarlaPlugin(engine, id),
           kUse16Outs(use16Outs),
           fSettings(nullptr),
@@ -53,7 +66,8 @@ public:
           fAudio16Buffers(nullptr),
           fLabel(nullptr)
     {
-        carla_debug("CarlaPluginFluidSynth::CarlaPluginFluidSynth(%p, %i, %s)", engine, id,  bool2str(use16Outs));
+        carla_debug("CarlaPluginFluidSynth::CarlaPluginFluidSynth(%p, %i, %s, %s)",
+                    engine, id, bool2str(use16Outs), bool2str(multiCore));
 
         carla_zeroFloats(fParamBuffers, FluidSynthParametersMax);
         carla_fill<int32_t>(fCurMidiProgs, 0, MAX_MIDI_CHANNELS);
@@ -66,7 +80,9 @@ public:
         fluid_settings_setint(fSettings, "synth.audio-channels", use16Outs ? 16 : 1);
         fluid_settings_setint(fSettings, "synth.audio-groups", use16Outs ? 16 : 1);
         fluid_settings_setnum(fSettings, "synth.sample-rate", pData->engine->getSampleRate());
-        //fluid_settings_setnum(fSettings, "synth.cpu-cores", 2);
+        // extra rendering threads are created by fluidsynth itself, so this can only be set before creating the synth
+        if (multiCore)
+            fluid_settings_setint(fSettings, "synth.cpu-cores", std::max(1, getNumCPUs()));
         fluid_settings_setint(fSettings, "synth.ladspa.active", 0);
         fluid_settings_setint(fSettings, "synth.lock-memory", 1);
 #if FLUIDSYNTH_VERSION_MAJOR < 2
@@ -198,6 +214,11 @@ public:
         options |= PLUGIN_OPTION_SEND_NOTE_AFTERTOUCH;
 #endif
 
+        options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+        options |= PLUGIN_OPTION_MULTI_CORE;
+
         return options;
     }
 
@@ -1455,8 +1476,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioOut, frames - timeOffset, timeOffset);
 
@@ -1698,6 +1717,7 @@ public:
 
         // ---------------------------------------------------------------
         // open soundfont
+        // FluidSynth 2.x keeps sample data in a process-wide cache, so instances using the same file share it
 
         const int synthId = fluid_synth_sfload(fSynth, filename, 0);
 
@@ -1746,6 +1766,15 @@ public:
 
         pData->options = 0x0;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_MULTI_CORE))
+            pData->options |= PLUGIN_OPTION_MULTI_CORE;
+
         if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
             pData->options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
         if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CHANNEL_PRESSURE))
@@ -1918,7 +1947,9 @@ CarlaPluginPtr CarlaPlugin::newFluidSynth(const Initializer& init, PluginType pt
     }
 #endif
 
-    std::shared_ptr<CarlaPluginFluidSynth> plugin(new CarlaPluginFluidSynth(init.engine, init.id,  use16Outs));
+    const bool multiCore = isPluginOptionInverseEnabled(init.options, PLUGIN_OPTION_MULTI_CORE);
+
+    std::shared_ptr<CarlaPluginFluidSynth> plugin(new CarlaPluginFluidSynth(init.engine, init.id, use16Outs, multiCore));
 
     if (! plugin->init(plugin, init.filename, init.name, init.label, init.options))
         return nullptr;
@@ -198,7 +198,11 @@ PluginParameterData::PluginParameterData() noexcept
     : count(0),
       data(nullptr),
       ranges(nullptr),
-      special(nullptr) {}
+      special(nullptr),
+      postRtValues(nullptr),
+      postRtFlags(nullptr),
+      changeSequences(nullptr),
+      changeSequence(0) {}
 
 PluginParameterData::~PluginParameterData() noexcept
 {
@@ -206,6 +210,9 @@ PluginParameterData::~PluginParameterData() noexcept
     CARLA_SAFE_ASSERT(data == nullptr);
     CARLA_SAFE_ASSERT(ranges == nullptr);
     CARLA_SAFE_ASSERT(special == nullptr);
+    CARLA_SAFE_ASSERT(postRtValues == nullptr);
+    CARLA_SAFE_ASSERT(postRtFlags == nullptr);
+    CARLA_SAFE_ASSERT(changeSequences == nullptr);
 }
 
 void PluginParameterData::createNew(const uint32_t newCount, const bool withSpecial)
@@ -214,6 +221,9 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
     CARLA_SAFE_ASSERT_RETURN(data == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(ranges == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(special == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(postRtValues == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(postRtFlags == nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(changeSequences == nullptr,);
     CARLA_SAFE_ASSERT_RETURN(newCount > 0,);
 
     data = new ParameterData[newCount];
@@ -237,6 +247,25 @@ void PluginParameterData::createNew(const uint32_t newCount, const bool withSpec
         carla_zeroStructs(special, newCount);
     }
 
+    postRtValues = new float[newCount];
+    carla_zeroFloats(postRtValues, newCount);
+
+    postRtFlags = new uint32_t[(newCount+15)/16];
+    carla_zeroStructs(postRtFlags, (newCount+15)/16);
+
+    // the sequence keeps going across reloads, so all new parameters are reported as changed
+    changeSequences = new uint32_t[newCount];
+
+    for (uint32_t sequence = __atomic_load_n(&changeSequence, __ATOMIC_RELAXED);;)
+    {
+        for (uint32_t i=0; i < newCount; ++i)
+            changeSequences[i] = sequence + 1;
+
+        if (__atomic_compare_exchange_n(&changeSequence, &sequence, sequence + 1, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            break;
+    }
+
     count = newCount;
 }
 
@@ -260,9 +289,44 @@ void PluginParameterData::clear() noexcept
         special = nullptr;
     }
 
+    if (postRtValues != nullptr)
+    {
+        delete[] postRtValues;
+        postRtValues = nullptr;
+    }
+
+    if (postRtFlags != nullptr)
+    {
+        delete[] postRtFlags;
+        postRtFlags = nullptr;
+    }
+
+    if (changeSequences != nullptr)
+    {
+        delete[] changeSequences;
+        changeSequences = nullptr;
+    }
+
     count = 0;
 }
 
+void PluginParameterData::markChanged(const uint32_t parameterId) noexcept
+{
+    if (parameterId >= count)
+        return;
+
+    // the parameter sequence must be stored before the global one is published, so readers never miss it.
+    // if another thread publishes first, store again with a newer sequence.
+    for (uint32_t sequence = __atomic_load_n(&changeSequence, __ATOMIC_RELAXED);;)
+    {
+        __atomic_store_n(&changeSequences[parameterId], sequence + 1, __ATOMIC_RELAXED);
+
+        if (__atomic_compare_exchange_n(&changeSequence, &sequence, sequence + 1, true,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            break;
+    }
+}
+
 float PluginParameterData::getFixedValue(const uint32_t parameterId, float value) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(parameterId < count, 0.0f);
@@ -632,40 +696,184 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
 // -----------------------------------------------------------------------
 // ProtectedData::PostRtEvents
 
-CarlaPlugin::ProtectedData::PostRtEvents::PostRtEvents() noexcept
-    : dataPool(512, 512),
-      data(dataPool),
-      dataPendingRT(dataPool),
-      dataMutex(),
-      dataPendingMutex() {}
+CarlaPlugin::ProtectedData::PostRtEvents::PostRtEvents(PluginParameterData& p) noexcept
+    : param(p),
+      queueWritePos(0),
+      queueReadPos(0),
+      queueDropped(0),
+      specialFlags(0)
+{
+    for (uint32_t i=0; i < kQueueSize; ++i)
+    {
+        queue[i].sequence = i;
+        carla_zeroStruct(queue[i].event);
+    }
 
-CarlaPlugin::ProtectedData::PostRtEvents::~PostRtEvents() noexcept
+    carla_zeroFloats(specialValues, kSpecialCount);
+}
+
+void CarlaPlugin::ProtectedData::PostRtEvents::appendRT(const PluginPostRtEvent& e) noexcept
 {
-    dataMutex.lock();
-    dataPendingMutex.lock();
+    // parameter changes only keep the latest value, so they never fill up the queue
+    if (e.type == kPluginPostRtEventParameterChange && appendParameterRT(e))
+        return;
 
-    data.clear();
-    dataPendingRT.clear();
+    uint32_t pos = queueWritePos;
+
+    for (;;)
+    {
+        Cell& cell(queue[pos % kQueueSize]);
+        const uint32_t seq = cell.sequence;
+        __sync_synchronize();
+
+        const int32_t diff = static_cast<int32_t>(seq - pos);
+
+        if (diff == 0)
+        {
+            if (__sync_bool_compare_and_swap(&queueWritePos, pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // full, report later from non-RT
+            __sync_fetch_and_add(&queueDropped, 1);
+            return;
+        }
+
+        pos = queueWritePos;
+    }
 
-    dataMutex.unlock();
-    dataPendingMutex.unlock();
+    Cell& cell(queue[pos % kQueueSize]);
+    cell.event = e;
+    __sync_synchronize();
+    cell.sequence = pos + 1;
 }
 
-void CarlaPlugin::ProtectedData::PostRtEvents::appendRT(const PluginPostRtEvent& e) noexcept
+bool CarlaPlugin::ProtectedData::PostRtEvents::appendParameterRT(const PluginPostRtEvent& e) noexcept
 {
-    CARLA_SAFE_ASSERT_INT_RETURN(dataPendingMutex.tryLock(), e.type,);
-    dataPendingRT.append(e);
-    dataPendingMutex.unlock();
+    const int32_t index = e.parameter.index;
+    const uint32_t flags = e.sendCallback ? 0x3 : 0x1;
+
+    if (index < 0)
+    {
+        const uint32_t slot = static_cast<uint32_t>(-index - 1);
+        CARLA_SAFE_ASSERT_UINT_RETURN(slot < kSpecialCount, slot, false);
+
+        specialValues[slot] = e.parameter.value;
+        __sync_fetch_and_or(&specialFlags, flags << (slot*2));
+        return true;
+    }
+
+    const uint32_t uindex = static_cast<uint32_t>(index);
+
+    // can happen during reload, queue the event as-is
+    if (uindex >= param.count || param.postRtValues == nullptr)
+        return false;
+
+    param.postRtValues[uindex] = e.parameter.value;
+    __sync_fetch_and_or(&param.postRtFlags[uindex/16], flags << ((uindex % 16)*2));
+    return true;
 }
 
-void CarlaPlugin::ProtectedData::PostRtEvents::trySplice() noexcept
+bool CarlaPlugin::ProtectedData::PostRtEvents::tryPop(PluginPostRtEvent& e) noexcept
 {
-    const CarlaMutexTryLocker cmtl(dataPendingMutex);
+    uint32_t pos = queueReadPos;
 
-    if (cmtl.wasLocked() && dataPendingRT.isNotEmpty() && dataMutex.tryLock())
+    for (;;)
     {
-        dataPendingRT.moveTo(data, true);
-        dataMutex.unlock();
+        Cell& cell(queue[pos % kQueueSize]);
+        const uint32_t seq = cell.sequence;
+        __sync_synchronize();
+
+        const int32_t diff = static_cast<int32_t>(seq - (pos + 1));
+
+        if (diff == 0)
+        {
+            if (__sync_bool_compare_and_swap(&queueReadPos, pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // empty
+            return false;
+        }
+
+        pos = queueReadPos;
+    }
+
+    Cell& cell(queue[pos % kQueueSize]);
+    e = cell.event;
+    __sync_synchronize();
+    cell.sequence = pos + kQueueSize;
+    return true;
+}
+
+CarlaPlugin::ProtectedData::PostRtEvents::Access::Access(PostRtEvents& e) noexcept
+    : fEvents(e),
+      fQueueLeft(kQueueSize),
+      fFlagsIndex(0),
+      fFlags(0)
+{
+    if (const uint32_t dropped = __sync_fetch_and_and(&e.queueDropped, 0))
+        carla_stderr2("Post-RT event queue is full, %u events were dropped", dropped);
+}
+
+bool CarlaPlugin::ProtectedData::PostRtEvents::Access::next(PluginPostRtEvent& e) noexcept
+{
+    // queued events first, limited so that we do not run forever while RT keeps adding more
+    if (fQueueLeft != 0)
+    {
+        --fQueueLeft;
+
+        if (fEvents.tryPop(e))
+            return true;
+
+        fQueueLeft = 0;
+    }
+
+    // then the latest value of each changed parameter, index 0 being the special parameters
+    const PluginParameterData& param(fEvents.param);
+    const uint32_t flagsCount = param.postRtFlags != nullptr ? (param.count+15)/16 : 0;
+
+    for (;;)
+    {
+        if (fFlags == 0)
+        {
+            if (fFlagsIndex > flagsCount)
+                return false;
+
+            if (fFlagsIndex == 0)
+                fFlags = __sync_fetch_and_and(&fEvents.specialFlags, 0);
+            else
+                fFlags = __sync_fetch_and_and(&param.postRtFlags[fFlagsIndex-1], 0);
+
+            ++fFlagsIndex;
+            continue;
+        }
+
+        const uint32_t bit = static_cast<uint32_t>(__builtin_ctz(fFlags)) & ~1U;
+        const bool sendCallback = fFlags & (0x2 << bit);
+        fFlags &= ~(0x3U << bit);
+
+        e.type = kPluginPostRtEventParameterChange;
+        e.sendCallback = sendCallback;
+
+        if (fFlagsIndex == 1)
+        {
+            const uint32_t slot = bit/2;
+            e.parameter.index = -static_cast<int32_t>(slot) - 1;
+            e.parameter.value = fEvents.specialValues[slot];
+        }
+        else
+        {
+            const uint32_t index = (fFlagsIndex-2)*16 + bit/2;
+            CARLA_SAFE_ASSERT_UINT2_CONTINUE(index < param.count, index, param.count);
+
+            e.parameter.index = static_cast<int32_t>(index);
+            e.parameter.value = param.postRtValues[index];
+        }
+
+        return true;
     }
 }
 
@@ -695,6 +903,18 @@ void CarlaPlugin::ProtectedData::PostUiEvents::clear() noexcept
     mutex.unlock();
 }
 
+// -----------------------------------------------------------------------
+// ProtectedData::SleepState
+
+CarlaPlugin::ProtectedData::SleepState::SleepState() noexcept
+    : sleeping(false),
+      inputSilent(false),
+      silentFrames(0),
+      wakeUp(false),
+      transportPlaying(false),
+      transportFrame(0),
+      transportBPM(0.0) {}
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
 // -----------------------------------------------------------------------
 // ProtectedData::PostProc
@@ -705,6 +925,76 @@ CarlaPlugin::ProtectedData::PostProc::PostProc() noexcept
       balanceLeft(-1.0f),
       balanceRight(1.0f),
       panning(0.0f) {}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Snapshot
+
+CarlaPlugin::ProtectedData::Snapshot::Snapshot() noexcept
+    : valid(false),
+      usesChunk(false),
+      program(-1),
+      midiProgram(-1),
+      dryWet(1.0f),
+      volume(1.0f),
+      balanceLeft(-1.0f),
+      balanceRight(1.0f),
+      panning(0.0f),
+      paramCount(0),
+      paramValues(nullptr),
+      chunk(nullptr),
+      chunkSize(0) {}
+
+CarlaPlugin::ProtectedData::Snapshot::~Snapshot() noexcept
+{
+    clear();
+}
+
+void CarlaPlugin::ProtectedData::Snapshot::clear() noexcept
+{
+    valid = false;
+    usesChunk = false;
+    program = -1;
+    midiProgram = -1;
+    paramCount = 0;
+    chunkSize = 0;
+
+    if (paramValues != nullptr)
+    {
+        delete[] paramValues;
+        paramValues = nullptr;
+    }
+
+    if (chunk != nullptr)
+    {
+        std::free(chunk);
+        chunk = nullptr;
+    }
+}
+
+void CarlaPlugin::ProtectedData::Snapshot::swapWith(Snapshot& other) noexcept
+{
+    std::swap(valid, other.valid);
+    std::swap(usesChunk, other.usesChunk);
+    std::swap(program, other.program);
+    std::swap(midiProgram, other.midiProgram);
+    std::swap(dryWet, other.dryWet);
+    std::swap(volume, other.volume);
+    std::swap(balanceLeft, other.balanceLeft);
+    std::swap(balanceRight, other.balanceRight);
+    std::swap(panning, other.panning);
+    std::swap(paramCount, other.paramCount);
+    std::swap(paramValues, other.paramValues);
+    std::swap(chunk, other.chunk);
+    std::swap(chunkSize, other.chunkSize);
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::Snapshots
+
+CarlaPlugin::ProtectedData::Snapshots::Snapshots() noexcept
+    : mutex(),
+      slots(),
+      pending(-1) {}
 #endif
 
 // -----------------------------------------------------------------------
@@ -748,10 +1038,12 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       uiTitle(),
       extNotes(),
       latency(),
-      postRtEvents(),
-      postUiEvents()
+      postRtEvents(param),
+      postUiEvents(),
+      sleepState()
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    , postProc()
+    , postProc(),
+      snapshots()
 #endif
       {}
 
@@ -881,6 +1173,9 @@ void CarlaPlugin::ProtectedData::postponeParameterChangeRtEvent(const bool sendC
     rtEvent.parameter.index = index;
     rtEvent.parameter.value = value;
 
+    if (index >= 0)
+        param.markChanged(static_cast<uint32_t>(index));
+
     postRtEvents.appendRT(rtEvent);
 }
 
@@ -191,10 +191,19 @@ struct PluginParameterData {
     ParameterRanges* ranges;
     SpecialParameterType* special;
 
+    // latest values postponed from RT, with 2 flags per parameter (changed, send callback), see PostRtEvents
+    float* postRtValues;
+    uint32_t* postRtFlags;
+
+    // sequence number of the latest change of each parameter, from any thread, see markChanged()
+    uint32_t* changeSequences;
+    volatile uint32_t changeSequence;
+
     PluginParameterData() noexcept;
     ~PluginParameterData() noexcept;
     void createNew(uint32_t newCount, bool withSpecial);
     void clear() noexcept;
+    void markChanged(uint32_t parameterId) noexcept;
     float getFixedValue(uint32_t parameterId, float value) const noexcept;
     float getFinalUnnormalizedValue(uint32_t parameterId, float normalizedValue) const noexcept;
     float getFinalValueWithMidiDelta(uint32_t parameterId, float value, int8_t delta) const noexcept;
@@ -322,45 +331,47 @@ struct CarlaPlugin::ProtectedData {
 
     class PostRtEvents {
     public:
-        PostRtEvents() noexcept;
-        ~PostRtEvents() noexcept;
+        PostRtEvents(PluginParameterData& p) noexcept;
         void appendRT(const PluginPostRtEvent& event) noexcept;
-        void trySplice() noexcept;
 
+        // Reads queued events in order, then the latest value of each changed parameter.
+        // Must only be used from one (non-RT) thread at a time.
         struct Access {
-            Access(PostRtEvents& e)
-              : data2(e.dataPool)
-            {
-                const CarlaMutexLocker cml(e.dataMutex);
-
-                if (e.data.isNotEmpty())
-                    e.data.moveTo(data2, true);
-            }
-
-            ~Access()
-            {
-                data2.clear();
-            }
-
-            inline RtLinkedList<PluginPostRtEvent>::Itenerator getDataIterator() const noexcept
-            {
-                return data2.begin2();
-            }
-
-            inline std::size_t isEmpty() const noexcept
-            {
-                return data2.isEmpty();
-            }
+            Access(PostRtEvents& e) noexcept;
+            bool next(PluginPostRtEvent& event) noexcept;
 
         private:
-            RtLinkedList<PluginPostRtEvent> data2;
+            PostRtEvents& fEvents;
+            uint32_t fQueueLeft;
+            uint32_t fFlagsIndex;
+            uint32_t fFlags;
+
+            CARLA_DECLARE_NON_COPY_STRUCT(Access)
         };
 
     private:
-        RtLinkedList<PluginPostRtEvent>::Pool dataPool;
-        RtLinkedList<PluginPostRtEvent> data, dataPendingRT;
-        CarlaMutex dataMutex;
-        CarlaMutex dataPendingMutex;
+        static const uint32_t kQueueSize = 512;
+        static const uint32_t kSpecialCount = 8; // PARAMETER_NULL down to PARAMETER_CTRL_CHANNEL
+
+        struct Cell {
+            volatile uint32_t sequence;
+            PluginPostRtEvent event;
+        };
+
+        PluginParameterData& param;
+
+        // bounded lock-free queue for events that need to keep their order
+        Cell queue[kQueueSize];
+        volatile uint32_t queueWritePos;
+        volatile uint32_t queueReadPos;
+        volatile uint32_t queueDropped;
+
+        // same as PluginParameterData::postRtValues/Flags, for special parameters
+        float specialValues[kSpecialCount];
+        volatile uint32_t specialFlags;
+
+        bool appendParameterRT(const PluginPostRtEvent& event) noexcept;
+        bool tryPop(PluginPostRtEvent& event) noexcept;
 
         CARLA_DECLARE_NON_COPY_CLASS(PostRtEvents)
 
@@ -379,6 +390,30 @@ struct CarlaPlugin::ProtectedData {
 
     } postUiEvents;
 
+    struct SleepState {
+        // processing is being skipped (RT only)
+        bool sleeping;
+
+        // current cycle had no input activity (RT only)
+        bool inputSilent;
+
+        // how long inputs and outputs have been silent for (RT only)
+        uint32_t silentFrames;
+
+        // set from any thread to force the plugin awake on the next cycle
+        volatile bool wakeUp;
+
+        // transport state expected on the next cycle, any other value wakes the plugin (RT only)
+        bool transportPlaying;
+        uint64_t transportFrame;
+        double transportBPM;
+
+        SleepState() noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(SleepState)
+
+    } sleepState;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     struct PostProc {
         float dryWet;
@@ -392,6 +427,44 @@ struct CarlaPlugin::ProtectedData {
         CARLA_DECLARE_NON_COPY_STRUCT(PostProc)
 
     } postProc;
+
+    struct Snapshot {
+        bool valid;
+        bool usesChunk;
+        int32_t program;
+        int32_t midiProgram;
+        float dryWet;
+        float volume;
+        float balanceLeft;
+        float balanceRight;
+        float panning;
+        uint32_t paramCount;
+        float* paramValues; // sample-rate relative where PARAMETER_USES_SAMPLERATE is set
+        void* chunk;
+        std::size_t chunkSize;
+
+        Snapshot() noexcept;
+        ~Snapshot() noexcept;
+        void clear() noexcept;
+        void swapWith(Snapshot& other) noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Snapshot)
+    };
+
+    struct Snapshots {
+        // locked by the main thread while changing slots or pending, only try-locked on the RT side
+        CarlaMutex mutex;
+
+        Snapshot slots[MAX_SNAPSHOTS];
+
+        // slot to apply on the next audio cycle, or -1
+        volatile int32_t pending;
+
+        Snapshots() noexcept;
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Snapshots)
+
+    } snapshots;
 #endif
 
     ProtectedData(CarlaEngine* engine, uint idx) noexcept;
@@ -648,6 +648,8 @@ public:
             options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
         }
 
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -1240,8 +1242,6 @@ public:
                 }
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input
 
         if (! processSingle(audioIn, audioOut, frames))
@@ -224,6 +224,11 @@ public:
             options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
         }
 
+        if (pData->audioOut.count != 0)
+            options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -1111,8 +1116,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input
 
         // --------------------------------------------------------------------------------------------------------
@@ -1500,6 +1503,12 @@ public:
         pData->options |= PLUGIN_OPTION_FIXED_BUFFERS;
         pData->options |= PLUGIN_OPTION_USE_CHUNKS;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         if (fInstance->acceptsMidi())
         {
             if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
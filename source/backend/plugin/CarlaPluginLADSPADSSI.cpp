@@ -523,6 +523,11 @@ public:
             }
         }
 
+        if (pData->audioOut.count != 0)
+            options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -1912,8 +1917,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, frames - timeOffset, timeOffset, midiEventCount);
 
@@ -3010,6 +3013,12 @@ public:
 
         pData->options = 0x0;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         /**/ if (fLatencyIndex >= 0 || fNeedsFixedBuffers)
             pData->options |= PLUGIN_OPTION_FIXED_BUFFERS;
         else if (options & PLUGIN_OPTION_FIXED_BUFFERS)
@@ -22,7 +22,8 @@
 #include "CarlaPluginInternal.hpp"
 #include "CarlaEngine.hpp"
 
-#include "CarlaLv2Utils.hpp"
+#include "CarlaLv2CacheUtils.hpp"
+#include "CarlaLv2UridUtils.hpp"
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
@@ -649,7 +650,7 @@ public:
           fEventsOut(),
           fLv2Options(),
           fPipeServer(engine, this),
-          fCustomURIDs(kUridCount, std::string("urn:null")),
+          fUridSyncedCount(kUridCount),
           fFirstActive(true),
           fLastStateChunk(nullptr),
           fLastTimeInfo(),
@@ -658,7 +659,6 @@ public:
           fUI()
     {
         carla_debug("CarlaPluginLV2::CarlaPluginLV2(%p, %i)", engine, id);
-        CARLA_SAFE_ASSERT(fCustomURIDs.size() == kUridCount);
 
         carla_zeroPointers(fFeatures, kFeatureCountAll+1);
         carla_zeroPointers(fStateFeatures, kStateFeatureCountAll+1);
@@ -989,6 +989,11 @@ public:
             options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
         }
 
+        if (pData->audioOut.count != 0)
+            options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -1615,8 +1620,7 @@ public:
         {
             const LV2_URID_Map* const uridMap = (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data;
 
-            LilvState* const state = Lv2WorldClass::getInstance().getStateFromURI(fRdfDescriptor->Presets[index].URI,
-                                                                                  uridMap);
+            LilvState* const state = getLv2World().getStateFromURI(fRdfDescriptor->Presets[index].URI, uridMap);
             CARLA_SAFE_ASSERT_RETURN(state != nullptr,);
 
             // invalidate midi-program selection
@@ -1761,27 +1765,10 @@ public:
                     const CarlaScopedLocale csl;
 
                     // write URI mappings
-                    uint32_t u = 0;
-                    for (std::vector<std::string>::iterator it=fCustomURIDs.begin(), end=fCustomURIDs.end(); it != end; ++it, ++u)
-                    {
-                        if (u < kUridCount)
-                            continue;
-                        const std::string& uri(*it);
-
-                        if (! fPipeServer.writeMessage("urid\n", 5))
-                            return;
-
-                        std::snprintf(tmpBuf, 0xfe, "%u\n", u);
-                        if (! fPipeServer.writeMessage(tmpBuf))
-                            return;
-
-                        std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(uri.length()));
-                        if (! fPipeServer.writeMessage(tmpBuf))
-                            return;
+                    fUridSyncedCount = kUridCount;
 
-                        if (! fPipeServer.writeAndFixMessage(uri.c_str()))
-                            return;
-                    }
+                    if (! syncUridsToBridge(false))
+                        return;
 
                     // write UI options
                     if (! fPipeServer.writeMessage("uiOptions\n", 10))
@@ -2121,6 +2108,10 @@ public:
             return;
         }
 
+        // new URIDs must reach the UI bridge before any atom using them
+        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
+            syncUridsToBridge(true);
+
         if (fAtomBufferUiOut.isDataAvailableForReading())
         {
             Lv2AtomRingBuffer tmpRingBuffer(fAtomBufferUiOut, fAtomBufferUiOutTmpData);
@@ -3367,8 +3358,8 @@ public:
             else if (fHasLoadDefaultState)
             {
                 // load default state
-                if (LilvState* const state = Lv2WorldClass::getInstance().getStateFromURI(fDescriptor->URI,
-                                                                                          (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data))
+                if (LilvState* const state = getLv2World().getStateFromURI(fDescriptor->URI,
+                                                                           (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data))
                 {
                     lilv_state_restore(state, fExt.state, fHandle, carla_lilv_set_port_value, this, 0, fFeatures);
 
@@ -3755,8 +3746,6 @@ public:
                 //lv2_atom_buffer_write(&evInAtomIters[i], 0, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom));
             }
 
-            pData->postRtEvents.trySplice();
-
             fLastTimeInfo = timeInfo;
         }
 
@@ -4211,8 +4200,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
@@ -4492,8 +4479,6 @@ public:
             }
         }
 
-        pData->postRtEvents.trySplice();
-
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
@@ -5532,7 +5517,9 @@ public:
     {
         parameterId = UINT32_MAX;
 
-        if (urid >= fCustomURIDs.size())
+        const char* const uri = getUridRegistry().unmap(urid);
+
+        if (uri == nullptr)
             return false;
 
         for (uint32_t i=0; i < fRdfDescriptor->ParameterCount; ++i)
@@ -5551,9 +5538,7 @@ public:
                 continue;
             }
 
-            const std::string& uri(fCustomURIDs[urid]);
-
-            if (uri != rdfParam.URI)
+            if (rdfParam.URI == nullptr || std::strcmp(uri, rdfParam.URI) != 0)
                 continue;
 
             const int32_t rindex = static_cast<int32_t>(fRdfDescriptor->PortCount + i);
@@ -5579,35 +5564,43 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("CarlaPluginLV2::getCustomURID(\"%s\")", uri);
 
-        const std::string    s_uri(uri);
-        const std::ptrdiff_t s_pos(std::find(fCustomURIDs.begin(), fCustomURIDs.end(), s_uri) - fCustomURIDs.begin());
+        return getUridRegistry().map(uri);
+    }
 
-        if (s_pos <= 0 || s_pos >= INT32_MAX)
-            return kUridNull;
+    const char* getCustomURIDString(const LV2_URID urid) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, kUnmapFallback);
+        carla_debug("CarlaPluginLV2::getCustomURIString(%i)", urid);
 
-        const LV2_URID urid     = static_cast<LV2_URID>(s_pos);
-        const LV2_URID uriCount = static_cast<LV2_URID>(fCustomURIDs.size());
+        const char* const uri = getUridRegistry().unmap(urid);
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr, kUnmapFallback);
 
-        if (urid < uriCount)
-            return urid;
+        return uri;
+    }
 
-        CARLA_SAFE_ASSERT(urid == uriCount);
+    // Send all URIDs the UI bridge does not know about yet, in batches.
+    bool syncUridsToBridge(const bool withWriteLock) noexcept
+    {
+        const Lv2UridRegistry& registry(getUridRegistry());
+        const uint32_t count = registry.getCount();
 
-        fCustomURIDs.push_back(uri);
+        const char* uris[64];
 
-        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
-            fPipeServer.writeLv2UridMessage(urid, uri);
+        while (fUridSyncedCount < count)
+        {
+            const uint32_t first = fUridSyncedCount;
+            const uint32_t batch = std::min<uint32_t>(count - first, 64);
 
-        return urid;
-    }
+            for (uint32_t i=0; i<batch; ++i)
+                uris[i] = registry.unmap(first + i);
 
-    const char* getCustomURIDString(const LV2_URID urid) const noexcept
-    {
-        CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, kUnmapFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.size(), kUnmapFallback);
-        carla_debug("CarlaPluginLV2::getCustomURIString(%i)", urid);
+            if (! fPipeServer.writeLv2UridsMessage(first, batch, uris, withWriteLock))
+                return false;
 
-        return fCustomURIDs[urid].c_str();
+            fUridSyncedCount = first + batch;
+        }
+
+        return true;
     }
 
     // -------------------------------------------------------------------
@@ -6315,26 +6308,25 @@ public:
         const EngineOptions& opts(pData->engine->getOptions());
 
         // ---------------------------------------------------------------
-        // Init LV2 World if needed, sets LV2_PATH for lilv
-
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-
-        if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
-            lv2World.initIfNeeded(opts.pathLV2);
-        else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
-            lv2World.initIfNeeded(LV2_PATH);
-        else
-            lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
+        // get plugin from cache, or from lv2_rdf (lilv) after loading the LV2 world
 
-        // ---------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
+        Lv2RdfCache& lv2RdfCache(Lv2RdfCache::getInstance());
 
-        fRdfDescriptor = lv2_rdf_new(uri, true);
+        fRdfDescriptor = lv2RdfCache.lookup(uri, true);
 
         if (fRdfDescriptor == nullptr)
         {
-            pData->engine->setLastError("Failed to find the requested plugin");
-            return false;
+            getLv2World();
+
+            fRdfDescriptor = lv2_rdf_new(uri, true);
+
+            if (fRdfDescriptor == nullptr)
+            {
+                pData->engine->setLastError("Failed to find the requested plugin");
+                return false;
+            }
+
+            lv2RdfCache.store(fRdfDescriptor, true);
         }
 
 #ifdef ADAPT_FOR_APPLE_SILLICON
@@ -6742,6 +6734,12 @@ public:
 
         pData->options = 0x0;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         if (fLatencyIndex >= 0 || getMidiOutCount() != 0 || fNeedsFixedBuffers)
             pData->options |= PLUGIN_OPTION_FIXED_BUFFERS;
         else if (options & PLUGIN_OPTION_FIXED_BUFFERS)
@@ -7280,25 +7278,19 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
-        carla_debug("CarlaPluginLV2::handleUridMap(%i v " P_SIZE ", \"%s\")", urid, fCustomURIDs.size()-1, uri);
+        carla_debug("CarlaPluginLV2::handleUridMap(%i v %u, \"%s\")", urid, getUridRegistry().getCount()-1, uri);
 
-        const std::size_t uriCount(fCustomURIDs.size());
+        const LV2_URID ourURID = getUridRegistry().map(uri);
 
-        if (urid < uriCount)
+        if (ourURID != urid)
         {
-            const char* const ourURI(carla_lv2_urid_unmap(this, urid));
-            CARLA_SAFE_ASSERT_RETURN(ourURI != nullptr && ourURI != kUnmapFallback,);
-
-            if (std::strcmp(ourURI, uri) != 0)
-            {
-                carla_stderr2("PLUGIN :: wrong URI '%s' vs '%s'", ourURI,  uri);
-            }
-        }
-        else
-        {
-            CARLA_SAFE_ASSERT_RETURN(urid == uriCount,);
-            fCustomURIDs.push_back(uri);
+            carla_stderr2("PLUGIN :: wrong URID %u vs %u for '%s'", ourURID, urid, uri);
+            return;
         }
+
+        // the UI bridge already knows about this one
+        if (fUridSyncedCount == urid)
+            fUridSyncedCount = urid + 1;
     }
 
     // -------------------------------------------------------------------
@@ -7332,6 +7324,25 @@ public:
 
     // -------------------------------------------------------------------
 
+    // Init LV2 World if needed, sets LV2_PATH for lilv.
+    // Plugins found in the RDF cache only need this when loading presets or state.
+    Lv2WorldClass& getLv2World() const
+    {
+        const EngineOptions& opts(pData->engine->getOptions());
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
+        if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
+            lv2World.initIfNeeded(opts.pathLV2);
+        else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
+            lv2World.initIfNeeded(LV2_PATH);
+        else
+            lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
+
+        return lv2World;
+    }
+
+    // -------------------------------------------------------------------
+
 private:
     LV2_Handle   fHandle;
     LV2_Handle   fHandle2;
@@ -7367,7 +7378,7 @@ private:
     CarlaPluginLV2Options   fLv2Options;
     CarlaPipeServerLV2      fPipeServer;
 
-    std::vector<std::string> fCustomURIDs;
+    uint32_t fUridSyncedCount;
 
     bool fFirstActive; // first process() call after activate()
     void* fLastStateChunk;
@@ -7657,133 +7668,6 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return kUridAtomBlank;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return kUridAtomBool;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return kUridAtomChunk;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return kUridAtomDouble;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return kUridAtomEvent;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return kUridAtomFloat;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return kUridAtomInt;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return kUridAtomLiteral;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return kUridAtomLong;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return kUridAtomNumber;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return kUridAtomObject;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return kUridAtomPath;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return kUridAtomProperty;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return kUridAtomResource;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return kUridAtomSequence;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return kUridAtomSound;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return kUridAtomString;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return kUridAtomTuple;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return kUridAtomURI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return kUridAtomURID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return kUridAtomVector;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return kUridAtomTransferAtom;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return kUridAtomTransferEvent;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return kUridBufMaxLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return kUridBufMinLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__nominalBlockLength) == 0)
-            return kUridBufNominalLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return kUridBufSequenceSize;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return kUridLogError;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return kUridLogNote;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return kUridLogTrace;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return kUridLogWarning;
-
-        // Patch types
-        if (std::strcmp(uri, LV2_PATCH__Set) == 0)
-            return kUridPatchSet;
-        if (std::strcmp(uri, LV2_PATCH__property) == 0)
-            return kUridPatchProperty;
-        if (std::strcmp(uri, LV2_PATCH__subject) == 0)
-            return kUridPatchSubject;
-        if (std::strcmp(uri, LV2_PATCH__value) == 0)
-            return kUridPatchValue;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return kUridTimePosition;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return kUridTimeBar;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return kUridTimeBarBeat;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return kUridTimeBeat;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return kUridTimeBeatUnit;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return kUridTimeBeatsPerBar;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return kUridTimeBeatsPerMinute;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return kUridTimeFrame;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return kUridTimeFramesPerSecond;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return kUridTimeSpeed;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return kUridTimeTicksPerBeat;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return kUridMidiEvent;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return kUridParamSampleRate;
-        if (std::strcmp(uri, LV2_UI__backgroundColor) == 0)
-            return kUridBackgroundColor;
-        if (std::strcmp(uri, LV2_UI__foregroundColor) == 0)
-            return kUridForegroundColor;
-        if (std::strcmp(uri, LV2_UI__scaleFactor) == 0)
-            return kUridScaleFactor;
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return kUridWindowTitle;
-
-        // Custom Carla types
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_IN) == 0)
-            return kUridCarlaAtomWorkerIn;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_RESP) == 0)
-            return kUridCarlaAtomWorkerResp;
-        if (std::strcmp(uri, URI_CARLA_PARAMETER_CHANGE) == 0)
-            return kUridCarlaParameterChange;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return kUridCarlaTransientWindowId;
-
-        // Custom plugin types
         return ((CarlaPluginLV2*)handle)->getCustomURID(uri);
     }
 
@@ -7793,6 +7677,12 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
+        return ((CarlaPluginLV2*)handle)->getCustomURIDString(urid);
+    }
+
+    // URIs of the URIDs fixed at compile-time, see CarlaLv2URIDs
+    static const char* carla_lv2_urid_unmap_fixed(const LV2_URID urid) noexcept
+    {
         switch (urid)
         {
         // Atom types
@@ -7922,8 +7812,26 @@ private:
             return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
         }
 
-        // Custom plugin types
-        return ((CarlaPluginLV2*)handle)->getCustomURIDString(urid);
+        return nullptr;
+    }
+
+    // Shared by all plugins, first URIDs match CarlaLv2URIDs
+    static Lv2UridRegistry& getUridRegistry() noexcept
+    {
+        struct FixedUridRegistry : Lv2UridRegistry {
+            FixedUridRegistry() noexcept
+                : Lv2UridRegistry()
+            {
+                for (LV2_URID u = kUridNull + 1; u < kUridCount; ++u)
+                {
+                    const LV2_URID urid = map(carla_lv2_urid_unmap_fixed(u));
+                    CARLA_SAFE_ASSERT_UINT2(urid == u, urid, u);
+                }
+            }
+        };
+
+        static FixedUridRegistry registry;
+        return registry;
     }
 
     // -------------------------------------------------------------------
@@ -256,14 +256,19 @@ public:
           fIsUiAvailable(false),
           fIsUiVisible(false),
           fNeedsIdle(false),
+          fUsesParamEvents(false),
+          fCanProcessInPlace(false),
           fInlineDisplayNeedsRedraw(false),
           fInlineDisplayLastRedrawTime(0),
           fLastProjectFilename(),
           fLastProjectFolder(),
           fAudioAndCvInBuffers(nullptr),
           fAudioAndCvOutBuffers(nullptr),
+          fEngineAudioAndCvInBuffers(nullptr),
+          fEngineAudioAndCvOutBuffers(nullptr),
           fMidiEventInCount(0),
           fMidiEventOutCount(0),
+          fParamEventCount(0),
           fCurBufferSize(engine->getBufferSize()),
           fCurSampleRate(engine->getSampleRate()),
           fMidiIn(),
@@ -275,6 +280,7 @@ public:
         carla_fill(fCurMidiProgs, 0, MAX_MIDI_CHANNELS);
         carla_zeroStructs(fMidiInEvents, kPluginMaxMidiEvents);
         carla_zeroStructs(fMidiOutEvents, kPluginMaxMidiEvents);
+        carla_zeroStructs(fParamEvents, kPluginMaxMidiEvents);
         carla_zeroStruct(fTimeInfo);
 
         fHost.handle      = this;
@@ -453,6 +459,11 @@ public:
         else if (hasMidiProgs)
             options |= PLUGIN_OPTION_MAP_PROGRAM_CHANGES;
 
+        if (pData->audioOut.count != 0)
+            options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -783,6 +794,28 @@ public:
         CarlaPlugin::setParameterValueRT(parameterId, fixedValue, sendCallbackLater);
     }
 
+    // sent to the plugin together with the audio if it supports parameter events, applied right away otherwise
+    void setParameterValueAtRT(const uint32_t parameterId, const float value, uint32_t frameOffset) noexcept
+    {
+        if (! fUsesParamEvents || fParamEventCount >= kPluginMaxMidiEvents)
+            return setParameterValueRT(parameterId, value, true);
+
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        const float fixedValue(pData->param.getFixedValue(parameterId, value));
+
+        // keep events sorted
+        if (fParamEventCount > 0 && frameOffset < fParamEvents[fParamEventCount-1].time)
+            frameOffset = fParamEvents[fParamEventCount-1].time;
+
+        NativeParameterEvent& paramEvent(fParamEvents[fParamEventCount++]);
+        paramEvent.time  = frameOffset;
+        paramEvent.index = parameterId;
+        paramEvent.value = fixedValue;
+
+        CarlaPlugin::setParameterValueRT(parameterId, fixedValue, true);
+    }
+
     void setCustomData(const char* const type, const char* const key, const char* const value, const bool sendGui) override
     {
         CARLA_SAFE_ASSERT_RETURN(fDescriptor != nullptr,);
@@ -1132,12 +1165,18 @@ public:
         {
             fAudioAndCvInBuffers = new float*[acIns];
             carla_zeroPointers(fAudioAndCvInBuffers, acIns);
+
+            fEngineAudioAndCvInBuffers = new float*[acIns];
+            carla_zeroPointers(fEngineAudioAndCvInBuffers, acIns);
         }
 
         if (const uint32_t acOuts = aOuts + cvOuts)
         {
             fAudioAndCvOutBuffers = new float*[acOuts];
             carla_zeroPointers(fAudioAndCvOutBuffers, acOuts);
+
+            fEngineAudioAndCvOutBuffers = new float*[acOuts];
+            carla_zeroPointers(fEngineAudioAndCvOutBuffers, acOuts);
         }
 
         if (mIns > 0)
@@ -1431,6 +1470,11 @@ public:
         if (fDescriptor->hints & NATIVE_PLUGIN_HAS_INLINE_DISPLAY)
             pData->hints |= PLUGIN_HAS_INLINE_DISPLAY;
 
+        // only check the extra process function if the hint is set, old descriptors do not have it
+        fUsesParamEvents   = (fDescriptor->hints & NATIVE_PLUGIN_USES_PARAM_EVENTS) != 0
+                           && fDescriptor->process_with_parameter_events != nullptr;
+        fCanProcessInPlace = (fDescriptor->hints & NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE) != 0;
+
         // extra plugin hints
         pData->extraHints = 0x0;
 
@@ -1756,7 +1800,7 @@ public:
             return;
         }
 
-        fMidiEventInCount = fMidiEventOutCount = 0;
+        fMidiEventInCount = fMidiEventOutCount = fParamEventCount = 0;
         carla_zeroStructs(fMidiInEvents, kPluginMaxMidiEvents);
         carla_zeroStructs(fMidiOutEvents, kPluginMaxMidiEvents);
 
@@ -1898,6 +1942,9 @@ public:
 #endif
             const bool isSampleAccurate = (pData->options & PLUGIN_OPTION_FIXED_BUFFERS) == 0;
 
+            // plugins using parameter events get everything in one go, with event times kept
+            const bool splitsBlocks = isSampleAccurate && ! fUsesParamEvents;
+
             uint32_t startTime  = 0;
             uint32_t timeOffset = 0;
             uint32_t nextBankId;
@@ -1929,7 +1976,7 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                if (splitsBlocks && eventTime > timeOffset)
                 {
                     if (processSingle(audioIn, audioOut, cvIn, cvOut, eventTime - timeOffset, timeOffset))
                     {
@@ -1983,7 +2030,7 @@ public:
 
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
-                            setParameterValueRT(k, value, true);
+                            setParameterValueAtRT(k, value, eventTime);
                             continue;
                         }
 
@@ -2043,7 +2090,7 @@ public:
 
                             ctrlEvent.handled = true;
                             value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
-                            setParameterValueRT(k, value, true);
+                            setParameterValueAtRT(k, value, eventTime);
                         }
 
                         if ((pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
@@ -2054,7 +2101,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = splitsBlocks ? startTime : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = uint8_t(ctrlEvent.param);
                             nativeEvent.data[2] = uint8_t(ctrlEvent.normalizedValue*127.0f);
@@ -2082,7 +2129,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = splitsBlocks ? startTime : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_BANK_SELECT;
                             nativeEvent.data[2] = uint8_t(ctrlEvent.param);
@@ -2126,7 +2173,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = splitsBlocks ? startTime : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_PROGRAM_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = uint8_t(ctrlEvent.param);
                             nativeEvent.size    = 2;
@@ -2142,7 +2189,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = splitsBlocks ? startTime : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_ALL_SOUND_OFF;
                             nativeEvent.data[2] = 0;
@@ -2167,7 +2214,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = splitsBlocks ? startTime : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_ALL_NOTES_OFF;
                             nativeEvent.data[2] = 0;
@@ -2211,7 +2258,7 @@ public:
                     carla_zeroStruct(nativeEvent);
 
                     nativeEvent.port = midiEvent.port;
-                    nativeEvent.time = isSampleAccurate ? startTime : eventTime;
+                    nativeEvent.time = splitsBlocks ? startTime : eventTime;
                     nativeEvent.size = midiEvent.size;
 
                     nativeEvent.data[0] = uint8_t(status | (event.channel & MIDI_CHANNEL_BIT));
@@ -2231,8 +2278,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
@@ -2317,12 +2362,50 @@ public:
                     cvOut[i][k+timeOffset] = 0.0f;
             }
 
+            // the host side already has the new values, keep the plugin in sync (see process_with_parameter_events)
+            for (uint32_t i=0; i < fParamEventCount; ++i)
+            {
+                fDescriptor->set_parameter_value(fHandle, fParamEvents[i].index, fParamEvents[i].value);
+
+                if (fHandle2 != nullptr)
+                    fDescriptor->set_parameter_value(fHandle2, fParamEvents[i].index, fParamEvents[i].value);
+            }
+
+            fParamEventCount = 0;
             return false;
         }
 
         // --------------------------------------------------------------------------------------------------------
         // Set audio buffers
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        // dry/wet needs the original input, which might be overwritten when processing in place
+        const bool useEngineBuffers = fCanProcessInPlace && ! ((pData->hints & PLUGIN_CAN_DRYWET) != 0 &&
+                                                               carla_isNotEqual(pData->postProc.dryWet, 1.0f));
+#else
+        const bool useEngineBuffers = fCanProcessInPlace;
+#endif
+
+        float** inBuffers  = fAudioAndCvInBuffers;
+        float** outBuffers = fAudioAndCvOutBuffers;
+
+        if (useEngineBuffers)
+        {
+            // plugin can process in place, no need for copies
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                fEngineAudioAndCvInBuffers[i] = const_cast<float*>(audioIn[i])+timeOffset;
+            for (uint32_t i=0; i < pData->cvIn.count; ++i)
+                fEngineAudioAndCvInBuffers[pData->audioIn.count+i] = const_cast<float*>(cvIn[i])+timeOffset;
+
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                fEngineAudioAndCvOutBuffers[i] = audioOut[i]+timeOffset;
+            for (uint32_t i=0; i < pData->cvOut.count; ++i)
+                fEngineAudioAndCvOutBuffers[pData->audioOut.count+i] = cvOut[i]+timeOffset;
+
+            inBuffers  = fEngineAudioAndCvInBuffers;
+            outBuffers = fEngineAudioAndCvOutBuffers;
+        }
+        else
         {
             for (uint32_t i=0; i < pData->audioIn.count; ++i)
                 carla_copyFloats(fAudioAndCvInBuffers[i], audioIn[i]+timeOffset, frames);
@@ -2342,23 +2425,23 @@ public:
 
         if (fHandle2 == nullptr)
         {
-            fDescriptor->process(fHandle,
-                                 fAudioAndCvInBuffers, fAudioAndCvOutBuffers, frames,
-                                 fMidiInEvents, fMidiEventInCount);
+            runPlugin(fHandle, inBuffers, outBuffers, frames);
         }
         else
         {
-            fDescriptor->process(fHandle,
-                                 (fAudioAndCvInBuffers != nullptr)  ? &fAudioAndCvInBuffers[0]  : nullptr,
-                                 (fAudioAndCvOutBuffers != nullptr) ? &fAudioAndCvOutBuffers[0] : nullptr,
-                                 frames, fMidiInEvents, fMidiEventInCount);
+            runPlugin(fHandle,
+                      (inBuffers != nullptr)  ? &inBuffers[0]  : nullptr,
+                      (outBuffers != nullptr) ? &outBuffers[0] : nullptr,
+                      frames);
 
-            fDescriptor->process(fHandle2,
-                                 (fAudioAndCvInBuffers != nullptr)  ? &fAudioAndCvInBuffers[1]  : nullptr,
-                                 (fAudioAndCvOutBuffers != nullptr) ? &fAudioAndCvOutBuffers[1] : nullptr,
-                                 frames, fMidiInEvents, fMidiEventInCount);
+            runPlugin(fHandle2,
+                      (inBuffers != nullptr)  ? &inBuffers[1]  : nullptr,
+                      (outBuffers != nullptr) ? &outBuffers[1] : nullptr,
+                      frames);
         }
 
+        fParamEventCount = 0;
+
         fIsProcessing = false;
 
         if (fTimeInfo.playing)
@@ -2383,8 +2466,8 @@ public:
                 {
                     for (uint32_t k=0; k < frames; ++k)
                     {
-                        bufValue = fAudioAndCvInBuffers[(pData->audioIn.count == 1) ? 0 : i][k];
-                        fAudioAndCvOutBuffers[i][k] = (fAudioAndCvOutBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
+                        bufValue = inBuffers[(pData->audioIn.count == 1) ? 0 : i][k];
+                        outBuffers[i][k] = (outBuffers[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
                     }
                 }
 
@@ -2396,7 +2479,7 @@ public:
                     if (isPair)
                     {
                         CARLA_ASSERT(i+1 < pData->audioOut.count);
-                        carla_copyFloats(oldBufLeft, fAudioAndCvOutBuffers[i], frames);
+                        carla_copyFloats(oldBufLeft, outBuffers[i], frames);
                     }
 
                     float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
@@ -2407,38 +2490,44 @@ public:
                         if (isPair)
                         {
                             // left
-                            fAudioAndCvOutBuffers[i][k]  = oldBufLeft[k]            * (1.0f - balRangeL);
-                            fAudioAndCvOutBuffers[i][k] += fAudioAndCvOutBuffers[i+1][k] * (1.0f - balRangeR);
+                            outBuffers[i][k]  = oldBufLeft[k]      * (1.0f - balRangeL);
+                            outBuffers[i][k] += outBuffers[i+1][k] * (1.0f - balRangeR);
                         }
                         else
                         {
                             // right
-                            fAudioAndCvOutBuffers[i][k]  = fAudioAndCvOutBuffers[i][k] * balRangeR;
-                            fAudioAndCvOutBuffers[i][k] += oldBufLeft[k]          * balRangeL;
+                            outBuffers[i][k]  = outBuffers[i][k] * balRangeR;
+                            outBuffers[i][k] += oldBufLeft[k]    * balRangeL;
                         }
                     }
                 }
 
                 // Volume (and buffer copy)
+                if (useEngineBuffers)
+                {
+                    if (carla_isNotEqual(pData->postProc.volume, 1.0f))
+                        carla_multiply(outBuffers[i], pData->postProc.volume, frames);
+                }
+                else
                 {
                     for (uint32_t k=0; k < frames; ++k)
-                        audioOut[i][k+timeOffset] = fAudioAndCvOutBuffers[i][k] * pData->postProc.volume;
+                        audioOut[i][k+timeOffset] = outBuffers[i][k] * pData->postProc.volume;
                 }
             }
 
         } // End of Post-processing
 #else
-        for (; i < pData->audioOut.count; ++i)
+        for (; i < pData->audioOut.count && ! useEngineBuffers; ++i)
         {
             for (uint32_t k=0; k < frames; ++k)
-                audioOut[i][k+timeOffset] = fAudioAndCvOutBuffers[i][k];
+                audioOut[i][k+timeOffset] = outBuffers[i][k];
         }
 #endif
         // CV stuff too
-        for (; i < pData->cvOut.count; ++i)
+        for (; i < pData->cvOut.count && ! useEngineBuffers; ++i)
         {
             for (uint32_t k=0; k < frames; ++k)
-                cvOut[i][k+timeOffset] = fAudioAndCvOutBuffers[pData->audioOut.count+i][k];
+                cvOut[i][k+timeOffset] = outBuffers[pData->audioOut.count+i][k];
         }
 
         // --------------------------------------------------------------------------------------------------------
@@ -2464,6 +2553,17 @@ public:
         return true;
     }
 
+    void runPlugin(const NativePluginHandle handle, float** const inBuffers, float** const outBuffers, const uint32_t frames)
+    {
+        if (fUsesParamEvents)
+            fDescriptor->process_with_parameter_events(handle,
+                                                       inBuffers, outBuffers, frames,
+                                                       fMidiInEvents, fMidiEventInCount,
+                                                       fParamEvents, fParamEventCount);
+        else
+            fDescriptor->process(handle, inBuffers, outBuffers, frames, fMidiInEvents, fMidiEventInCount);
+    }
+
     void bufferSizeChanged(const uint32_t newBufferSize) override
     {
         CARLA_ASSERT_INT(newBufferSize > 0, newBufferSize);
@@ -2577,6 +2677,18 @@ public:
             fAudioAndCvOutBuffers = nullptr;
         }
 
+        if (fEngineAudioAndCvInBuffers != nullptr)
+        {
+            delete[] fEngineAudioAndCvInBuffers;
+            fEngineAudioAndCvInBuffers = nullptr;
+        }
+
+        if (fEngineAudioAndCvOutBuffers != nullptr)
+        {
+            delete[] fEngineAudioAndCvOutBuffers;
+            fEngineAudioAndCvOutBuffers = nullptr;
+        }
+
         if (fMidiIn.count > 1)
             pData->event.portIn = nullptr;
 
@@ -3006,6 +3118,12 @@ public:
 
         pData->options = 0x0;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         if (fDescriptor->hints & NATIVE_PLUGIN_NEEDS_FIXED_BUFFERS)
             pData->options |= PLUGIN_OPTION_FIXED_BUFFERS;
          else if (options & PLUGIN_OPTION_FIXED_BUFFERS)
@@ -3069,6 +3187,8 @@ private:
     bool fIsUiAvailable;
     bool fIsUiVisible;
     volatile bool fNeedsIdle;
+    bool fUsesParamEvents;
+    bool fCanProcessInPlace;
 
     bool fInlineDisplayNeedsRedraw;
     int64_t fInlineDisplayLastRedrawTime;
@@ -3078,11 +3198,16 @@ private:
 
     float**         fAudioAndCvInBuffers;
     float**         fAudioAndCvOutBuffers;
+    float**         fEngineAudioAndCvInBuffers;  // point to the engine buffers, for in-place processing
+    float**         fEngineAudioAndCvOutBuffers;
     uint32_t        fMidiEventInCount;
     uint32_t        fMidiEventOutCount;
     NativeMidiEvent fMidiInEvents[kPluginMaxMidiEvents];
     NativeMidiEvent fMidiOutEvents[kPluginMaxMidiEvents];
 
+    uint32_t             fParamEventCount;
+    NativeParameterEvent fParamEvents[kPluginMaxMidiEvents];
+
     int32_t  fCurMidiProgs[MAX_MIDI_CHANNELS];
     uint32_t fCurBufferSize;
     double   fCurSampleRate;
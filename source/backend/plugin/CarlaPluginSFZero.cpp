@@ -40,11 +40,6 @@ CARLA_BACKEND_START_NAMESPACE
 static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 
 
-static void loadingIdleCallbackFunction(void* ptr)
-{
-    ((CarlaEngine*)ptr)->callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
-}
-
 // -------------------------------------------------------------------------------------------------------------------
 
 class CarlaPluginSFZero : public CarlaPlugin
@@ -55,7 +50,9 @@ public:
           fSynth(),
           fNumVoices(0.0f),
           fLabel(nullptr),
-          fRealName(nullptr)
+          fRealName(nullptr),
+          fNeedsCancelableAction(false),
+          fLastNumSamplesLoaded(-1)
     {
         carla_debug("CarlaPluginSFZero::CarlaPluginSFZero(%p, %i)", engine, id);
     }
@@ -128,6 +125,10 @@ public:
         options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
         options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
 
+        options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         return options;
     }
 
@@ -543,8 +544,6 @@ public:
                 }
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioOutBuffer, frames - timeOffset, timeOffset);
 
@@ -688,12 +687,34 @@ public:
         sfzero::Sound* const sound = new sfzero::Sound(file);
 
         sfzero::Sound::LoadingIdleCallback cb = {
-            loadingIdleCallbackFunction,
-            pData->engine,
+            carla_sfzero_loading_idle,
+            this,
         };
 
         sound->loadRegions();
-        sound->loadSamples(cb);
+
+        fNeedsCancelableAction = ! pData->engine->isLoadingProject();
+        fLastNumSamplesLoaded = -1;
+
+        if (fNeedsCancelableAction)
+            pData->engine->setActionCanceled(false);
+
+        const bool samplesLoaded = sound->loadSamples(cb);
+
+        if (fNeedsCancelableAction && fLastNumSamplesLoaded >= 0)
+            pData->engine->callback(true, true,
+                                    ENGINE_CALLBACK_CANCELABLE_ACTION,
+                                    pData->id,
+                                    0,
+                                    0, 0, 0.0f,
+                                    "Loading SFZ samples");
+
+        if (! samplesLoaded)
+        {
+            delete sound;
+            pData->engine->setLastError("Loading SFZ samples was canceled");
+            return false;
+        }
 
         if (fSynth.addSound(sound) == nullptr)
         {
@@ -737,6 +758,12 @@ public:
 
         pData->options = 0x0;
 
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
         if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
             pData->options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
         if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CHANNEL_PRESSURE))
@@ -762,6 +789,42 @@ private:
     const char* fLabel;
     const char* fRealName;
 
+    bool fNeedsCancelableAction;
+    int fLastNumSamplesLoaded;
+
+    // -------------------------------------------------------------------
+
+    bool handleLoadingIdle(const int numLoaded, const int numTotal)
+    {
+        pData->engine->callback(true, false, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+
+        if (! fNeedsCancelableAction)
+            return ! pData->engine->isAboutToClose();
+
+        if (numLoaded != fLastNumSamplesLoaded)
+        {
+            fLastNumSamplesLoaded = numLoaded;
+
+            char strBuf[STR_MAX+1];
+            std::snprintf(strBuf, STR_MAX, "Loading SFZ samples (%i/%i)", numLoaded, numTotal);
+            strBuf[STR_MAX] = '\0';
+
+            pData->engine->callback(true, true,
+                                    ENGINE_CALLBACK_CANCELABLE_ACTION,
+                                    pData->id,
+                                    1,
+                                    0, 0, 0.0f,
+                                    strBuf);
+        }
+
+        return ! (pData->engine->isAboutToClose() || pData->engine->wasActionCanceled());
+    }
+
+    static bool carla_sfzero_loading_idle(void* const ptr, const int numLoaded, const int numTotal)
+    {
+        return ((CarlaPluginSFZero*)ptr)->handleLoadingIdle(numLoaded, numTotal);
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginSFZero)
 };
 
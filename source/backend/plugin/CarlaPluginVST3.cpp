@@ -15,25 +15,4037 @@
  * For a full copy of the GNU General Public License see the doc/GPL.txt file.
  */
 
-#include "CarlaPlugin.hpp"
+#include "CarlaPluginInternal.hpp"
 #include "CarlaEngine.hpp"
-#include "CarlaUtils.hpp"
+#include "AppConfig.h"
+
+#if defined(USING_JUCE) && JUCE_PLUGINHOST_VST3
+# define USE_JUCE_FOR_VST3
+#endif
+
+#include "CarlaBackendUtils.hpp"
+#include "CarlaMathUtils.hpp"
+#include "CarlaVst3Utils.hpp"
+#include "CarlaXmlUtils.hpp"
+
+#include "CarlaPluginUI.hpp"
+
+#ifdef CARLA_OS_MAC
+# include <CoreFoundation/CoreFoundation.h>
+#endif
+
+#if SMTG_OS_LINUX
+# include <sys/select.h>
+#endif
+
+#include <algorithm>
+
+#include "water/files/File.h"
+#include "water/misc/Time.h"
+
+using water::File;
+using water::String;
+
+using namespace Steinberg;
 
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------------------------------------------------------
 
+// maximum number of points per parameter per audio block, newer values replace the last point when full
+static const int32 kMaxParameterPoints = 8;
+
+// marks MIDI controllers not assigned to any parameter
+static const uint32_t kNoMidiMapping = 0xffffffff;
+
+// JUCE state header, "VC2!" in little-endian
+static const uint32_t kJuceStateMagic = 0x21324356;
+
+// JUCE base64 uses its own alphabet and prefixes the data size
+static const char kJuceBase64Chars[] = ".ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+";
+
+// -------------------------------------------------------------------------------------------------------------------
+// Host-side objects for VST3 plugins
+//
+// Unless noted otherwise these are owned by the plugin instance and outlive any plugin object,
+// so reference counting is not needed.
+
+class Vst3AttributeList : public Vst::IAttributeList
+{
+public:
+    Vst3AttributeList() noexcept
+        : fRefCount(1),
+          fAttributes(nullptr) {}
+
+    virtual ~Vst3AttributeList() noexcept
+    {
+        for (Attribute* attr = fAttributes, *next; attr != nullptr; attr = next)
+        {
+            next = attr->next;
+            std::free(attr->data);
+            delete[] attr->id;
+            delete attr;
+        }
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IAttributeList_iid))
+        {
+            addRef();
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return __sync_add_and_fetch(&fRefCount, 1);
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        const uint32 refCount = __sync_sub_and_fetch(&fRefCount, 1);
+
+        if (refCount == 0)
+            delete this;
+
+        return refCount;
+    }
+
+    tresult PLUGIN_API setInt(const AttrID id, const int64 value) override
+    {
+        return _set(id, &value, sizeof(value), kTypeInt);
+    }
+
+    tresult PLUGIN_API getInt(const AttrID id, int64& value) override
+    {
+        const Attribute* const attr = _get(id, kTypeInt);
+        CARLA_SAFE_ASSERT_RETURN(attr != nullptr, kResultFalse);
+
+        std::memcpy(&value, attr->data, sizeof(value));
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API setFloat(const AttrID id, const double value) override
+    {
+        return _set(id, &value, sizeof(value), kTypeFloat);
+    }
+
+    tresult PLUGIN_API getFloat(const AttrID id, double& value) override
+    {
+        const Attribute* const attr = _get(id, kTypeFloat);
+        CARLA_SAFE_ASSERT_RETURN(attr != nullptr, kResultFalse);
+
+        std::memcpy(&value, attr->data, sizeof(value));
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API setString(const AttrID id, const Vst::TChar* const string) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(string != nullptr, kInvalidArgument);
+
+        std::size_t len = 0;
+        for (; string[len] != 0; ++len) {}
+
+        return _set(id, string, (len + 1) * sizeof(Vst::TChar), kTypeString);
+    }
+
+    // NOTE: size is in bytes
+    tresult PLUGIN_API getString(const AttrID id, Vst::TChar* const string, const uint32 size) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(string != nullptr, kInvalidArgument);
+        CARLA_SAFE_ASSERT_RETURN(size >= sizeof(Vst::TChar), kInvalidArgument);
+
+        const Attribute* const attr = _get(id, kTypeString);
+
+        if (attr == nullptr)
+            return kResultFalse;
+
+        const uint32 len = std::min(size, attr->size) / sizeof(Vst::TChar);
+        std::memcpy(string, attr->data, len * sizeof(Vst::TChar));
+        string[len - 1] = 0;
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API setBinary(const AttrID id, const void* const data, const uint32 size) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr || size == 0, kInvalidArgument);
+
+        return _set(id, data, size, kTypeBinary);
+    }
+
+    tresult PLUGIN_API getBinary(const AttrID id, const void*& data, uint32& size) override
+    {
+        const Attribute* const attr = _get(id, kTypeBinary);
+
+        if (attr == nullptr)
+            return kResultFalse;
+
+        data = attr->data;
+        size = attr->size;
+        return kResultOk;
+    }
+
+private:
+    enum Type {
+        kTypeInt,
+        kTypeFloat,
+        kTypeString,
+        kTypeBinary
+    };
+
+    struct Attribute {
+        const char* id;
+        Type type;
+        void* data;
+        uint32 size;
+        Attribute* next;
+    };
+
+    volatile uint32 fRefCount;
+    Attribute* fAttributes;
+
+    const Attribute* _get(const AttrID id, const Type type) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(id != nullptr, nullptr);
+
+        for (const Attribute* attr = fAttributes; attr != nullptr; attr = attr->next)
+        {
+            if (std::strcmp(attr->id, id) == 0)
+                return attr->type == type ? attr : nullptr;
+        }
+
+        return nullptr;
+    }
+
+    tresult _set(const AttrID id, const void* const data, const uint32 size, const Type type) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(id != nullptr && id[0] != '\0', kInvalidArgument);
+
+        void* const dataCopy = std::malloc(size > 0 ? size : 1);
+        CARLA_SAFE_ASSERT_RETURN(dataCopy != nullptr, kOutOfMemory);
+
+        if (size > 0)
+            std::memcpy(dataCopy, data, size);
+
+        Attribute* attr = fAttributes;
+
+        for (; attr != nullptr; attr = attr->next)
+        {
+            if (std::strcmp(attr->id, id) == 0)
+                break;
+        }
+
+        if (attr != nullptr)
+        {
+            std::free(attr->data);
+        }
+        else
+        {
+            try {
+                attr = new Attribute;
+                attr->id = carla_strdup(id);
+            } catch(...) {
+                std::free(dataCopy);
+                return kOutOfMemory;
+            }
+
+            attr->next = fAttributes;
+            fAttributes = attr;
+        }
+
+        attr->type = type;
+        attr->data = dataCopy;
+        attr->size = size;
+        return kResultOk;
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3AttributeList)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// created by the plugin through the host application, deleted on its last release
+class Vst3Message : public Vst::IMessage
+{
+public:
+    Vst3Message()
+        : fRefCount(1),
+          fMessageId(nullptr),
+          fAttributes(new Vst3AttributeList()) {}
+
+    virtual ~Vst3Message() noexcept
+    {
+        delete[] fMessageId;
+        fAttributes->release();
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IMessage_iid))
+        {
+            addRef();
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return __sync_add_and_fetch(&fRefCount, 1);
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        const uint32 refCount = __sync_sub_and_fetch(&fRefCount, 1);
+
+        if (refCount == 0)
+            delete this;
+
+        return refCount;
+    }
+
+    FIDString PLUGIN_API getMessageID() override
+    {
+        return fMessageId;
+    }
+
+    void PLUGIN_API setMessageID(const FIDString id) override
+    {
+        delete[] fMessageId;
+        fMessageId = id != nullptr ? carla_strdup_safe(id) : nullptr;
+    }
+
+    Vst::IAttributeList* PLUGIN_API getAttributes() override
+    {
+        return fAttributes;
+    }
+
+private:
+    volatile uint32 fRefCount;
+    const char* fMessageId;
+    Vst3AttributeList* const fAttributes;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3Message)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// shared by all plugins, never goes away
+class Vst3HostApplication : public Vst::IHostApplication
+{
+public:
+    Vst3HostApplication() noexcept {}
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IHostApplication_iid))
+        {
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return 1;
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        return 1;
+    }
+
+    tresult PLUGIN_API getName(Vst::String128 name) override
+    {
+        carla_v3_strncpy(name, "Carla", 128);
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API createInstance(TUID cid, TUID iid, void** const obj) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(obj != nullptr, kInvalidArgument);
+
+        *obj = nullptr;
+
+        if (FUnknownPrivate::iidEqual(cid, Vst::IMessage_iid) && FUnknownPrivate::iidEqual(iid, Vst::IMessage_iid))
+        {
+            try {
+                *obj = static_cast<Vst::IMessage*>(new Vst3Message());
+            } CARLA_SAFE_EXCEPTION_RETURN("Vst3HostApplication::createInstance", kOutOfMemory);
+
+            return kResultOk;
+        }
+
+        if (FUnknownPrivate::iidEqual(cid, Vst::IAttributeList_iid) && FUnknownPrivate::iidEqual(iid, Vst::IAttributeList_iid))
+        {
+            try {
+                *obj = static_cast<Vst::IAttributeList*>(new Vst3AttributeList());
+            } CARLA_SAFE_EXCEPTION_RETURN("Vst3HostApplication::createInstance", kOutOfMemory);
+
+            return kResultOk;
+        }
+
+        return kResultFalse;
+    }
+
+    static Vst3HostApplication* getInstance() noexcept
+    {
+        static Vst3HostApplication sInstance;
+        return &sInstance;
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3HostApplication)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// growing memory stream, used for plugin state
+class Vst3MemoryStream : public IBStream
+{
+public:
+    Vst3MemoryStream() noexcept
+        : fData(nullptr),
+          fSize(0),
+          fCapacity(0),
+          fPosition(0) {}
+
+    ~Vst3MemoryStream() noexcept
+    {
+        std::free(fData);
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, IBStream_iid))
+        {
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return 1;
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        return 1;
+    }
+
+    tresult PLUGIN_API read(void* const buffer, const int32 numBytes, int32* const numBytesRead) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(buffer != nullptr || numBytes <= 0, kInvalidArgument);
+
+        const std::size_t size = numBytes > 0 ? std::min(static_cast<std::size_t>(numBytes), fSize - fPosition) : 0;
+
+        if (size > 0)
+        {
+            std::memcpy(buffer, fData + fPosition, size);
+            fPosition += size;
+        }
+
+        if (numBytesRead != nullptr)
+            *numBytesRead = static_cast<int32>(size);
+
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API write(void* const buffer, const int32 numBytes, int32* const numBytesWritten) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(buffer != nullptr || numBytes <= 0, kInvalidArgument);
+
+        const std::size_t size = numBytes > 0 ? static_cast<std::size_t>(numBytes) : 0;
+
+        if (fPosition + size > fCapacity)
+        {
+            std::size_t newCapacity = fCapacity > 0 ? fCapacity : 4096;
+
+            while (newCapacity < fPosition + size)
+                newCapacity *= 2;
+
+            uint8_t* const newData = static_cast<uint8_t*>(std::realloc(fData, newCapacity));
+            CARLA_SAFE_ASSERT_RETURN(newData != nullptr, kOutOfMemory);
+
+            fData = newData;
+            fCapacity = newCapacity;
+        }
+
+        if (size > 0)
+        {
+            std::memcpy(fData + fPosition, buffer, size);
+            fPosition += size;
+
+            if (fPosition > fSize)
+                fSize = fPosition;
+        }
+
+        if (numBytesWritten != nullptr)
+            *numBytesWritten = static_cast<int32>(size);
+
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API seek(const int64 pos, const int32 mode, int64* const result) override
+    {
+        int64 newPosition;
+
+        switch (mode)
+        {
+        case kIBSeekSet:
+            newPosition = pos;
+            break;
+        case kIBSeekCur:
+            newPosition = static_cast<int64>(fPosition) + pos;
+            break;
+        case kIBSeekEnd:
+            newPosition = static_cast<int64>(fSize) + pos;
+            break;
+        default:
+            return kInvalidArgument;
+        }
+
+        CARLA_SAFE_ASSERT_RETURN(newPosition >= 0, kInvalidArgument);
+
+        fPosition = std::min(static_cast<std::size_t>(newPosition), fSize);
+
+        if (result != nullptr)
+            *result = static_cast<int64>(fPosition);
+
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API tell(int64* const pos) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pos != nullptr, kInvalidArgument);
+
+        *pos = static_cast<int64>(fPosition);
+        return kResultOk;
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    const uint8_t* getData() const noexcept
+    {
+        return fData;
+    }
+
+    std::size_t getSize() const noexcept
+    {
+        return fSize;
+    }
+
+    void rewind() noexcept
+    {
+        fPosition = 0;
+    }
+
+    // take ownership of some malloc'ed data, and rewind
+    void adopt(uint8_t* const data, const std::size_t size) noexcept
+    {
+        std::free(fData);
+        fData = data;
+        fSize = fCapacity = size;
+        fPosition = 0;
+    }
+
+private:
+    uint8_t* fData;
+    std::size_t fSize;
+    std::size_t fCapacity;
+    std::size_t fPosition;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3MemoryStream)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// parameter changes for a single parameter during one audio block, with a fixed amount of points
+class Vst3ParamValueQueue : public Vst::IParamValueQueue
+{
+public:
+    Vst3ParamValueQueue() noexcept
+        : fParamId(0),
+          fIndex(0),
+          fPointCount(0)
+    {
+        carla_zeroStructs(fPoints, kMaxParameterPoints);
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IParamValueQueue_iid))
+        {
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return 1;
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        return 1;
+    }
+
+    Vst::ParamID PLUGIN_API getParameterId() override
+    {
+        return fParamId;
+    }
+
+    int32 PLUGIN_API getPointCount() override
+    {
+        return fPointCount;
+    }
+
+    tresult PLUGIN_API getPoint(const int32 index, int32& sampleOffset, Vst::ParamValue& value) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(index >= 0 && index < fPointCount, kInvalidArgument);
+
+        sampleOffset = fPoints[index].offset;
+        value = fPoints[index].value;
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API addPoint(const int32 sampleOffset, const Vst::ParamValue value, int32& index) override
+    {
+        // points must be sorted, replace last one if at the same time or if full
+        if (fPointCount > 0 && (fPoints[fPointCount-1].offset >= sampleOffset || fPointCount == kMaxParameterPoints))
+        {
+            index = fPointCount - 1;
+        }
+        else
+        {
+            index = fPointCount++;
+            fPoints[index].offset = sampleOffset;
+        }
+
+        fPoints[index].value = value;
+        return kResultOk;
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    void init(const Vst::ParamID paramId, const uint32_t index) noexcept
+    {
+        fParamId = paramId;
+        fIndex = index;
+        fPointCount = 0;
+    }
+
+    uint32_t getIndex() const noexcept
+    {
+        return fIndex;
+    }
+
+private:
+    Vst::ParamID fParamId;
+    uint32_t fIndex; // index on our side, if known
+    int32 fPointCount;
+
+    struct Point {
+        int32 offset;
+        Vst::ParamValue value;
+    } fPoints[kMaxParameterPoints];
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3ParamValueQueue)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// parameter changes during one audio block, real-time safe as long as there is no more than 1 queue per parameter
+class Vst3ParameterChanges : public Vst::IParameterChanges
+{
+public:
+    Vst3ParameterChanges() noexcept
+        : fQueues(nullptr),
+          fQueueSlots(nullptr),
+          fCapacity(0),
+          fCount(0) {}
+
+    ~Vst3ParameterChanges() noexcept
+    {
+        clear();
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IParameterChanges_iid))
+        {
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return 1;
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        return 1;
+    }
+
+    int32 PLUGIN_API getParameterCount() override
+    {
+        return fCount;
+    }
+
+    Vst::IParamValueQueue* PLUGIN_API getParameterData(const int32 index) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(index >= 0 && index < fCount, nullptr);
+
+        return &fQueues[index];
+    }
+
+    Vst::IParamValueQueue* PLUGIN_API addParameterData(const Vst::ParamID& paramId, int32& index) override
+    {
+        for (int32 i=0; i<fCount; ++i)
+        {
+            if (fQueues[i].getParameterId() == paramId)
+            {
+                index = i;
+                return &fQueues[i];
+            }
+        }
+
+        if (fCount >= fCapacity)
+            return nullptr;
+
+        index = fCount++;
+        fQueues[index].init(paramId, kNoMidiMapping);
+        return &fQueues[index];
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    void init(const uint32_t paramCount)
+    {
+        clear();
+
+        if (paramCount == 0)
+            return;
+
+        fQueues = new Vst3ParamValueQueue[paramCount];
+        fQueueSlots = new int32[paramCount];
+        fCapacity = static_cast<int32>(paramCount);
+
+        for (uint32_t i=0; i<paramCount; ++i)
+            fQueueSlots[i] = -1;
+    }
+
+    void clear() noexcept
+    {
+        delete[] fQueues;
+        delete[] fQueueSlots;
+        fQueues = nullptr;
+        fQueueSlots = nullptr;
+        fCapacity = fCount = 0;
+    }
+
+    // remove all changes, to be called before each audio block
+    void reset() noexcept
+    {
+        for (int32 i=0; i<fCount; ++i)
+        {
+            const uint32_t index = fQueues[i].getIndex();
+
+            if (index < static_cast<uint32_t>(fCapacity))
+                fQueueSlots[index] = -1;
+        }
+
+        fCount = 0;
+    }
+
+    // add a new point from the host side, 'index' being our own parameter index
+    void addPoint(const uint32_t index, const Vst::ParamID paramId, const int32 sampleOffset, const Vst::ParamValue value) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(index < static_cast<uint32_t>(fCapacity),);
+
+        int32 slot = fQueueSlots[index];
+
+        if (slot < 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(fCount < fCapacity,);
+
+            slot = fCount++;
+            fQueueSlots[index] = slot;
+            fQueues[slot].init(paramId, index);
+        }
+
+        int32 pointIndex;
+        fQueues[slot].addPoint(sampleOffset, value, pointIndex);
+    }
+
+private:
+    Vst3ParamValueQueue* fQueues;
+    int32* fQueueSlots; // queue slot for each parameter index, -1 if unused
+    int32 fCapacity;
+    int32 fCount;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3ParameterChanges)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// events during one audio block, with a fixed maximum amount
+class Vst3EventList : public Vst::IEventList
+{
+public:
+    Vst3EventList() noexcept
+        : fCount(0)
+    {
+        carla_zeroStructs(fEvents, kPluginMaxMidiEvents*2);
+    }
+
+    tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+    {
+        if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IEventList_iid))
+        {
+            *obj = this;
+            return kResultOk;
+        }
+
+        *obj = nullptr;
+        return kNoInterface;
+    }
+
+    uint32 PLUGIN_API addRef() override
+    {
+        return 1;
+    }
+
+    uint32 PLUGIN_API release() override
+    {
+        return 1;
+    }
+
+    int32 PLUGIN_API getEventCount() override
+    {
+        return static_cast<int32>(fCount);
+    }
+
+    tresult PLUGIN_API getEvent(const int32 index, Vst::Event& event) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(index >= 0 && static_cast<uint32_t>(index) < fCount, kInvalidArgument);
+
+        std::memcpy(&event, &fEvents[index], sizeof(Vst::Event));
+        return kResultOk;
+    }
+
+    tresult PLUGIN_API addEvent(Vst::Event& event) override
+    {
+        if (fCount >= kPluginMaxMidiEvents*2)
+            return kResultFalse;
+
+        std::memcpy(&fEvents[fCount++], &event, sizeof(Vst::Event));
+        return kResultOk;
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    // get a new cleared event to fill in, returns null when full
+    Vst::Event* append(const uint32_t sampleOffset, const uint16 type) noexcept
+    {
+        if (fCount >= kPluginMaxMidiEvents*2)
+            return nullptr;
+
+        Vst::Event& event(fEvents[fCount++]);
+        carla_zeroStruct(event);
+        event.sampleOffset = static_cast<int32>(sampleOffset);
+        event.type = type;
+        return &event;
+    }
+
+    const Vst::Event& at(const uint32_t index) const noexcept
+    {
+        return fEvents[index];
+    }
+
+    uint32_t count() const noexcept
+    {
+        return fCount;
+    }
+
+    void reset() noexcept
+    {
+        fCount = 0;
+    }
+
+private:
+    Vst::Event fEvents[kPluginMaxMidiEvents*2];
+    uint32_t fCount;
+
+    CARLA_DECLARE_NON_COPY_CLASS(Vst3EventList)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+// marks parameters changed in one thread, to be sent to the plugin in another one
+struct Vst3ParameterSync {
+    volatile bool pending;
+    volatile bool* flags;
+
+    Vst3ParameterSync() noexcept
+        : pending(false),
+          flags(nullptr) {}
+
+    ~Vst3ParameterSync() noexcept
+    {
+        clear();
+    }
+
+    void init(const uint32_t count)
+    {
+        clear();
+
+        if (count == 0)
+            return;
+
+        flags = new bool[count];
+
+        for (uint32_t i=0; i<count; ++i)
+            flags[i] = false;
+    }
+
+    void clear() noexcept
+    {
+        delete[] flags;
+        flags = nullptr;
+        pending = false;
+    }
+
+    void mark(const uint32_t index) noexcept
+    {
+        flags[index] = true;
+        __sync_synchronize();
+        pending = true;
+    }
+
+    // check if there is anything to do, then take() each parameter
+    bool start() noexcept
+    {
+        if (! pending)
+            return false;
+
+        pending = false;
+        __sync_synchronize();
+        return true;
+    }
+
+    bool take(const uint32_t index) noexcept
+    {
+        if (! flags[index])
+            return false;
+
+        flags[index] = false;
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPY_STRUCT(Vst3ParameterSync)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
+class CarlaPluginVST3 : public CarlaPlugin,
+                        private CarlaPluginUI::Callback
+{
+public:
+    CarlaPluginVST3(CarlaEngine* const engine, const uint id)
+        : CarlaPlugin(engine, id),
+          fModuleExit(nullptr),
+#ifdef CARLA_OS_MAC
+          fMacBundleRef(nullptr),
+#endif
+          fFactory(nullptr),
+          fComponent(nullptr),
+          fProcessor(nullptr),
+          fController(nullptr),
+          fComponentConnection(nullptr),
+          fControllerConnection(nullptr),
+          fMidiMapping(nullptr),
+          fControllerIsComponent(false),
+          fLabel(),
+          fMaker(),
+          fSubCategories(),
+          fComponentHandler(this),
+          fPlugFrame(this),
+          fEventInBusCount(0),
+          fEventOutBusCount(0),
+          fUsesDoubles(false),
+          fBufferSize(engine->getBufferSize()),
+          fLatency(0),
+          fCurrentEventTime(0),
+          fRestartFlags(0),
+          fLastChunk(nullptr),
+          fAudioIns(),
+          fAudioOuts(),
+          fDryBuffers(nullptr),
+          fInputEvents(),
+          fOutputEvents(),
+          fInputParameterChanges(),
+          fOutputParameterChanges(),
+          fParamIds(nullptr),
+          fParamIdMap(nullptr),
+          fParamValues(nullptr),
+          fProcessorParamSync(),
+          fControllerParamSync(),
+          fMidiControllerMap(nullptr),
+          fUI()
+    {
+        carla_debug("CarlaPluginVST3::CarlaPluginVST3(%p, %i)", engine, id);
+
+        carla_zeroStruct(fClassId);
+        carla_zeroStruct(fContext);
+    }
+
+    ~CarlaPluginVST3() override
+    {
+        carla_debug("CarlaPluginVST3::~CarlaPluginVST3()");
+
+        // close UI
+        if (pData->hints & PLUGIN_HAS_CUSTOM_UI)
+        {
+            showCustomUI(false);
+            closeView();
+        }
+
+        pData->singleMutex.lock();
+        pData->masterMutex.lock();
+
+        if (pData->client != nullptr && pData->client->isActive())
+            pData->client->deactivate(true);
+
+        if (pData->active)
+        {
+            deactivate();
+            pData->active = false;
+        }
+
+        if (fMidiMapping != nullptr)
+        {
+            fMidiMapping->release();
+            fMidiMapping = nullptr;
+        }
+
+        if (fComponentConnection != nullptr && fControllerConnection != nullptr)
+        {
+            try {
+                fComponentConnection->disconnect(fControllerConnection);
+                fControllerConnection->disconnect(fComponentConnection);
+            } CARLA_SAFE_EXCEPTION("VST3 disconnect");
+        }
+
+        if (fComponentConnection != nullptr)
+        {
+            fComponentConnection->release();
+            fComponentConnection = nullptr;
+        }
+
+        if (fControllerConnection != nullptr)
+        {
+            fControllerConnection->release();
+            fControllerConnection = nullptr;
+        }
+
+        if (fController != nullptr)
+        {
+            try {
+                fController->setComponentHandler(nullptr);
+
+                if (! fControllerIsComponent)
+                    fController->terminate();
+
+                fController->release();
+            } CARLA_SAFE_EXCEPTION("VST3 controller release");
+
+            fController = nullptr;
+        }
+
+        if (fProcessor != nullptr)
+        {
+            fProcessor->release();
+            fProcessor = nullptr;
+        }
+
+        if (fComponent != nullptr)
+        {
+            try {
+                fComponent->terminate();
+                fComponent->release();
+            } CARLA_SAFE_EXCEPTION("VST3 component release");
+
+            fComponent = nullptr;
+        }
+
+        if (fFactory != nullptr)
+        {
+            fFactory->release();
+            fFactory = nullptr;
+        }
+
+        if (fModuleExit != nullptr)
+        {
+            try {
+                fModuleExit();
+            } CARLA_SAFE_EXCEPTION("VST3 module exit");
+
+            fModuleExit = nullptr;
+        }
+
+#ifdef CARLA_OS_MAC
+        if (fMacBundleRef != nullptr)
+        {
+            CFBundleUnloadExecutable(fMacBundleRef);
+            CFRelease(fMacBundleRef);
+            fMacBundleRef = nullptr;
+        }
+#endif
+
+        if (fLastChunk != nullptr)
+        {
+            std::free(fLastChunk);
+            fLastChunk = nullptr;
+        }
+
+        clearBuffers();
+    }
+
+    // -------------------------------------------------------------------
+    // Information (base)
+
+    PluginType getType() const noexcept override
+    {
+        return PLUGIN_VST3;
+    }
+
+    PluginCategory getCategory() const noexcept override
+    {
+        if (fSubCategories.contains("Instrument"))
+            return PLUGIN_CATEGORY_SYNTH;
+
+        if (fSubCategories.isNotEmpty())
+        {
+            const PluginCategory category = getPluginCategoryFromName(fSubCategories);
+
+            if (category != PLUGIN_CATEGORY_NONE)
+                return category;
+        }
+
+        return CarlaPlugin::getCategory();
+    }
+
+    int64_t getUniqueId() const noexcept override
+    {
+        return getVST3UniqueId(fClassId);
+    }
+
+    uint32_t getLatencyInFrames() const noexcept override
+    {
+        return fLatency;
+    }
+
+    // -------------------------------------------------------------------
+    // Information (count)
+
+    // nothing
+
+    // -------------------------------------------------------------------
+    // Information (current data)
+
+    std::size_t getChunkData(void** const dataPtr) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->options & PLUGIN_OPTION_USE_CHUNKS, 0);
+        CARLA_SAFE_ASSERT_RETURN(fComponent != nullptr, 0);
+        CARLA_SAFE_ASSERT_RETURN(dataPtr != nullptr, 0);
+
+        *dataPtr = nullptr;
+
+        Vst3MemoryStream componentStream, controllerStream;
+        bool hasComponentState, hasControllerState = false;
+
+        try {
+            hasComponentState = fComponent->getState(&componentStream) == kResultOk;
+        } CARLA_SAFE_EXCEPTION_RETURN("CarlaPluginVST3::getChunkData component", 0);
+
+        if (fController != nullptr)
+        {
+            try {
+                hasControllerState = fController->getState(&controllerStream) == kResultOk;
+            } CARLA_SAFE_EXCEPTION("CarlaPluginVST3::getChunkData controller");
+        }
+
+        if (fLastChunk != nullptr)
+        {
+            std::free(fLastChunk);
+            fLastChunk = nullptr;
+        }
+
+        return createJuceSaveFormat(hasComponentState ? &componentStream : nullptr,
+                                    hasControllerState ? &controllerStream : nullptr,
+                                    dataPtr);
+    }
+
+    // -------------------------------------------------------------------
+    // Information (per-plugin data)
+
+    uint getOptionsAvailable() const noexcept override
+    {
+        uint options = 0x0;
+
+        options |= PLUGIN_OPTION_USE_CHUNKS;
+
+        if (hasMidiInput())
+        {
+            if (fMidiControllerMap != nullptr)
+            {
+                options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
+                options |= PLUGIN_OPTION_SEND_CHANNEL_PRESSURE;
+                options |= PLUGIN_OPTION_SEND_PITCHBEND;
+            }
+
+            options |= PLUGIN_OPTION_SEND_NOTE_AFTERTOUCH;
+            options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
+            options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
+        }
+
+        if (pData->audioOut.count != 0)
+            options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
+        return options;
+    }
+
+    float getParameterValue(const uint32_t parameterId) const noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fParamValues != nullptr, 0.0f);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, 0.0f);
+
+        return fParamValues[parameterId];
+    }
+
+    bool getLabel(char* const strBuf) const noexcept override
+    {
+        std::strncpy(strBuf, fLabel, STR_MAX);
+        return true;
+    }
+
+    bool getMaker(char* const strBuf) const noexcept override
+    {
+        std::strncpy(strBuf, fMaker, STR_MAX);
+        return true;
+    }
+
+    bool getCopyright(char* const strBuf) const noexcept override
+    {
+        return getMaker(strBuf);
+    }
+
+    bool getRealName(char* const strBuf) const noexcept override
+    {
+        return getLabel(strBuf);
+    }
+
+    bool getParameterName(const uint32_t parameterId, char* const strBuf) const noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, false);
+
+        Vst::ParameterInfo paramInfo;
+
+        if (! getParameterInfo(parameterId, paramInfo))
+            return false;
+
+        carla_v3_strncpy(strBuf, paramInfo.title, STR_MAX);
+        return true;
+    }
+
+    bool getParameterText(const uint32_t parameterId, char* const strBuf) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fController != nullptr, false);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, false);
+
+        Vst::String128 text;
+        carla_zeroStruct(text);
+
+        try {
+            if (fController->getParamStringByValue(fParamIds[parameterId],
+                                                   getNormalizedValue(parameterId, fParamValues[parameterId]),
+                                                   text) == kResultOk)
+            {
+                carla_v3_strncpy(strBuf, text, STR_MAX);
+                return true;
+            }
+        } CARLA_SAFE_EXCEPTION("CarlaPluginVST3::getParameterText");
+
+        std::snprintf(strBuf, STR_MAX, "%.12g", static_cast<double>(fParamValues[parameterId]));
+        return true;
+    }
+
+    bool getParameterUnit(const uint32_t parameterId, char* const strBuf) const noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count, false);
+
+        Vst::ParameterInfo paramInfo;
+
+        if (! getParameterInfo(parameterId, paramInfo))
+            return false;
+
+        carla_v3_strncpy(strBuf, paramInfo.units, STR_MAX);
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+    // Set data (state)
+
+    // nothing
+
+    // -------------------------------------------------------------------
+    // Set data (internal stuff)
+
+    void setName(const char* const newName) override
+    {
+        CarlaPlugin::setName(newName);
+
+        if (fUI.window == nullptr || pData->uiTitle.isNotEmpty())
+            return;
+
+        CarlaString uiTitle(pData->name);
+        uiTitle += " (GUI)";
+        fUI.window->setTitle(uiTitle.buffer());
+    }
+
+    // -------------------------------------------------------------------
+    // Set data (plugin-specific stuff)
+
+    void setParameterValue(const uint32_t parameterId, const float value, const bool sendGui, const bool sendOsc, const bool sendCallback) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fParamValues != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        const float fixedValue(pData->param.getFixedValue(parameterId, value));
+        fParamValues[parameterId] = fixedValue;
+
+        // sent on next audio block and idle
+        fProcessorParamSync.mark(parameterId);
+        fControllerParamSync.mark(parameterId);
+
+        CarlaPlugin::setParameterValue(parameterId, fixedValue, sendGui, sendOsc, sendCallback);
+    }
+
+    void setParameterValueRT(const uint32_t parameterId, const float value, const bool sendCallbackLater) noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fParamValues != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
+
+        const float fixedValue(pData->param.getFixedValue(parameterId, value));
+        fParamValues[parameterId] = fixedValue;
+
+        // sample-accurate, at the time of the event being processed
+        fInputParameterChanges.addPoint(parameterId, fParamIds[parameterId],
+                                        static_cast<int32>(fCurrentEventTime),
+                                        getNormalizedValue(parameterId, fixedValue));
+        fControllerParamSync.mark(parameterId);
+
+        CarlaPlugin::setParameterValueRT(parameterId, fixedValue, sendCallbackLater);
+    }
+
+    void setChunkData(const void* const data, const std::size_t dataSize) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->options & PLUGIN_OPTION_USE_CHUNKS,);
+        CARLA_SAFE_ASSERT_RETURN(fComponent != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(dataSize > 0,);
+
+        Vst3MemoryStream componentStream, controllerStream;
+        bool hasComponentState, hasControllerState;
+
+        if (! loadJuceSaveFormat(data, dataSize, componentStream, controllerStream, hasComponentState, hasControllerState))
+        {
+            carla_stderr2("CarlaPluginVST3::setChunkData(%p, " P_SIZE ") - unsupported state format", data, dataSize);
+            return;
+        }
+
+        {
+            const ScopedSingleProcessLocker spl(this, true);
+
+            if (hasComponentState)
+            {
+                try {
+                    fComponent->setState(&componentStream);
+                } CARLA_SAFE_EXCEPTION("CarlaPluginVST3::setChunkData component");
+
+                if (fController != nullptr)
+                {
+                    componentStream.rewind();
+
+                    try {
+                        fController->setComponentState(&componentStream);
+                    } CARLA_SAFE_EXCEPTION("CarlaPluginVST3::setChunkData component to controller");
+                }
+            }
+
+            if (hasControllerState && fController != nullptr)
+            {
+                try {
+                    fController->setState(&controllerStream);
+                } CARLA_SAFE_EXCEPTION("CarlaPluginVST3::setChunkData controller");
+            }
+        }
+
+        updateParameterValuesFromController();
+        pData->updateParameterValues(this, true, true, false);
+    }
+
+    // -------------------------------------------------------------------
+    // Set ui stuff
+
+    void setCustomUITitle(const char* const title) noexcept override
+    {
+        if (fUI.window != nullptr)
+        {
+            try {
+                fUI.window->setTitle(title);
+            } CARLA_SAFE_EXCEPTION("set custom ui title");
+        }
+
+        CarlaPlugin::setCustomUITitle(title);
+    }
+
+    void showCustomUI(const bool yesNo) override
+    {
+        if (fUI.isVisible == yesNo)
+            return;
+
+        if (yesNo)
+        {
+            CarlaString uiTitle;
+
+            if (pData->uiTitle.isNotEmpty())
+            {
+                uiTitle = pData->uiTitle;
+            }
+            else
+            {
+                uiTitle  = pData->name;
+                uiTitle += " (GUI)";
+            }
+
+            if (fUI.window == nullptr)
+            {
+                CARLA_SAFE_ASSERT_RETURN(fController != nullptr,);
+
+                const char* msg = nullptr;
+                const char* platformType = nullptr;
+                const EngineOptions& opts(pData->engine->getOptions());
+
+#if defined(CARLA_OS_MAC)
+                fUI.window = CarlaPluginUI::newCocoa(this, opts.frontendWinId, false);
+                platformType = kPlatformTypeNSView;
+#elif defined(CARLA_OS_WIN)
+                fUI.window = CarlaPluginUI::newWindows(this, opts.frontendWinId, false);
+                platformType = kPlatformTypeHWND;
+#elif defined(HAVE_X11)
+                fUI.window = CarlaPluginUI::newX11(this, opts.frontendWinId, false);
+                platformType = kPlatformTypeX11EmbedWindowID;
+#else
+                msg = "Unsupported UI type";
+                // unused
+                (void)opts;
+#endif
+
+                if (fUI.window == nullptr)
+                    return pData->engine->callback(true, true,
+                                                   ENGINE_CALLBACK_UI_STATE_CHANGED,
+                                                   pData->id,
+                                                   -1,
+                                                   0, 0, 0.0f,
+                                                   msg);
+
+                fUI.window->setTitle(uiTitle.buffer());
+
+                try {
+                    fUI.view = fController->createView(Vst::ViewType::kEditor);
+                } CARLA_SAFE_EXCEPTION("VST3 createView");
+
+                if (fUI.view != nullptr && fUI.view->isPlatformTypeSupported(platformType) == kResultOk)
+                {
+                    fUI.view->setFrame(&fPlugFrame);
+
+                    if (fUI.view->attached(fUI.window->getPtr(), platformType) == kResultOk)
+                    {
+                        fUI.isAttached = true;
+
+                        ViewRect rect;
+                        if (fUI.view->getSize(&rect) == kResultOk)
+                        {
+                            const int32 width  = rect.getWidth();
+                            const int32 height = rect.getHeight();
+
+                            CARLA_SAFE_ASSERT_INT2(width > 1 && height > 1, width, height);
+
+                            if (width > 1 && height > 1)
+                                fUI.window->setSize(static_cast<uint>(width), static_cast<uint>(height), true);
+                        }
+                    }
+                }
+
+                if (! fUI.isAttached)
+                {
+                    closeView();
+
+                    carla_stderr2("Plugin refused to open its own UI");
+                    return pData->engine->callback(true, true,
+                                                   ENGINE_CALLBACK_UI_STATE_CHANGED,
+                                                   pData->id,
+                                                   -1,
+                                                   0, 0, 0.0f,
+                                                   "Plugin refused to open its own UI");
+                }
+            }
+
+            fUI.window->show();
+            fUI.isVisible = true;
+        }
+        else
+        {
+            fUI.isVisible = false;
+
+            CARLA_SAFE_ASSERT_RETURN(fUI.window != nullptr,);
+            fUI.window->hide();
+        }
+    }
+
+    void idle() override
+    {
+        // send parameter changes from the host or processor to the controller
+        if (fController != nullptr && fControllerParamSync.start())
+        {
+            for (uint32_t i=0; i < pData->param.count; ++i)
+            {
+                if (! fControllerParamSync.take(i))
+                    continue;
+
+                try {
+                    fController->setParamNormalized(fParamIds[i], getNormalizedValue(i, fParamValues[i]));
+                } CARLA_SAFE_EXCEPTION("VST3 setParamNormalized");
+            }
+        }
+
+        if (const int32 restartFlags = __sync_fetch_and_and(&fRestartFlags, 0))
+            handleRestartComponent(restartFlags);
+
+        CarlaPlugin::idle();
+    }
+
+    void uiIdle() override
+    {
+        if (fUI.window != nullptr)
+        {
+            fUI.window->idle();
+            fPlugFrame.idle();
+        }
+
+        CarlaPlugin::uiIdle();
+    }
+
+    // -------------------------------------------------------------------
+    // Plugin state
+
+    void reload() override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->engine != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fComponent != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fProcessor != nullptr,);
+        carla_debug("CarlaPluginVST3::reload() - start");
+
+        const EngineProcessMode processMode(pData->engine->getProccessMode());
+
+        // Safely disable plugin for reload
+        const ScopedDisabler sd(this);
+
+        if (pData->active)
+            deactivate();
+
+        clearBuffers();
+
+        uint32_t aIns, aOuts, mIns, mOuts, params;
+
+        bool needsCtrlIn, needsCtrlOut;
+        needsCtrlIn = needsCtrlOut = false;
+
+        // audio buses, all of them get activated and flattened into ports
+        fAudioIns.init(fComponent, Vst::kInput);
+        fAudioOuts.init(fComponent, Vst::kOutput);
+
+        aIns  = fAudioIns.channels;
+        aOuts = fAudioOuts.channels;
+
+        // only the first event bus is used
+        if (fEventInBusCount > 0)
+        {
+            try {
+                fComponent->activateBus(Vst::kEvent, Vst::kInput, 0, true);
+            } CARLA_SAFE_EXCEPTION("VST3 activateBus");
+
+            mIns = 1;
+            needsCtrlIn = true;
+        }
+        else
+            mIns = 0;
+
+        if (fEventOutBusCount > 0)
+        {
+            try {
+                fComponent->activateBus(Vst::kEvent, Vst::kOutput, 0, true);
+            } CARLA_SAFE_EXCEPTION("VST3 activateBus");
+
+            mOuts = 1;
+            needsCtrlOut = true;
+        }
+        else
+            mOuts = 0;
+
+        params = 0;
+
+        if (fController != nullptr)
+        {
+            try {
+                const int32 count = fController->getParameterCount();
+                params = count > 0 ? static_cast<uint32_t>(count) : 0;
+            } CARLA_SAFE_EXCEPTION("VST3 getParameterCount");
+        }
+
+        if (aIns > 0)
+        {
+            pData->audioIn.createNew(aIns);
+        }
+
+        if (aOuts > 0)
+        {
+            pData->audioOut.createNew(aOuts);
+            needsCtrlIn = true;
+        }
+
+        if (params > 0)
+        {
+            pData->param.createNew(params, false);
+            needsCtrlIn = true;
+
+            fParamIds    = new Vst::ParamID[params];
+            fParamIdMap  = new ParamIdMapping[params];
+            fParamValues = new float[params];
+
+            fInputParameterChanges.init(params);
+            fOutputParameterChanges.init(params);
+            fProcessorParamSync.init(params);
+            fControllerParamSync.init(params);
+        }
+
+        const uint portNameSize(pData->engine->getMaxPortNameSize());
+        CarlaString portName;
+
+        // Audio Ins
+        for (uint32_t j=0; j < aIns; ++j)
+        {
+            portName.clear();
+
+            if (processMode == ENGINE_PROCESS_MODE_SINGLE_CLIENT)
+            {
+                portName  = pData->name;
+                portName += ":";
+            }
+
+            if (aIns > 1)
+            {
+                portName += "input_";
+                portName += CarlaString(j+1);
+            }
+            else
+                portName += "input";
+
+            portName.truncate(portNameSize);
+
+            pData->audioIn.ports[j].port   = (CarlaEngineAudioPort*)pData->client->addPort(kEnginePortTypeAudio, portName, true, j);
+            pData->audioIn.ports[j].rindex = j;
+        }
+
+        // Audio Outs
+        for (uint32_t j=0; j < aOuts; ++j)
+        {
+            portName.clear();
+
+            if (processMode == ENGINE_PROCESS_MODE_SINGLE_CLIENT)
+            {
+                portName  = pData->name;
+                portName += ":";
+            }
+
+            if (aOuts > 1)
+            {
+                portName += "output_";
+                portName += CarlaString(j+1);
+            }
+            else
+                portName += "output";
+
+            portName.truncate(portNameSize);
+
+            pData->audioOut.ports[j].port   = (CarlaEngineAudioPort*)pData->client->addPort(kEnginePortTypeAudio, portName, false, j);
+            pData->audioOut.ports[j].rindex = j;
+        }
+
+        for (uint32_t j=0; j < params; ++j)
+        {
+            const int32_t ij = static_cast<int32_t>(j);
+
+            Vst::ParameterInfo paramInfo;
+
+            if (! getParameterInfo(j, paramInfo))
+                paramInfo.flags = Vst::ParameterInfo::kIsReadOnly;
+
+            fParamIds[j] = paramInfo.id;
+            fParamIdMap[j].id = paramInfo.id;
+            fParamIdMap[j].index = j;
+
+            pData->param.data[j].index  = ij;
+            pData->param.data[j].rindex = ij;
+
+            if (paramInfo.flags & Vst::ParameterInfo::kIsReadOnly)
+            {
+                pData->param.data[j].type = PARAMETER_OUTPUT;
+                needsCtrlOut = true;
+            }
+            else
+            {
+                pData->param.data[j].type = PARAMETER_INPUT;
+            }
+
+            float max, def, step, stepSmall, stepLarge;
+
+            // discrete parameters use their plain values, continuous ones stay normalized
+            if (paramInfo.stepCount > 0)
+            {
+                max = static_cast<float>(paramInfo.stepCount);
+                def = static_cast<float>(std::floor(paramInfo.defaultNormalizedValue * paramInfo.stepCount + 0.5));
+                step = 1.0f;
+                stepSmall = 1.0f;
+                stepLarge = std::min(10.0f, max);
+
+                if (paramInfo.stepCount == 1)
+                    pData->param.data[j].hints |= PARAMETER_IS_BOOLEAN;
+                else
+                    pData->param.data[j].hints |= PARAMETER_IS_INTEGER;
+            }
+            else
+            {
+                max = 1.0f;
+                def = static_cast<float>(paramInfo.defaultNormalizedValue);
+                step = 0.01f;
+                stepSmall = 0.001f;
+                stepLarge = 0.1f;
+            }
+
+            if (def < 0.0f)
+                def = 0.0f;
+            else if (def > max)
+                def = max;
+
+            pData->param.data[j].hints |= PARAMETER_IS_ENABLED;
+            pData->param.data[j].hints |= PARAMETER_USES_CUSTOM_TEXT;
+
+            if (paramInfo.flags & Vst::ParameterInfo::kCanAutomate)
+            {
+                pData->param.data[j].hints |= PARAMETER_IS_AUTOMABLE;
+
+                if (paramInfo.stepCount == 0)
+                    pData->param.data[j].hints |= PARAMETER_CAN_BE_CV_CONTROLLED;
+            }
+
+            pData->param.ranges[j].min = 0.0f;
+            pData->param.ranges[j].max = max;
+            pData->param.ranges[j].def = def;
+            pData->param.ranges[j].step = step;
+            pData->param.ranges[j].stepSmall = stepSmall;
+            pData->param.ranges[j].stepLarge = stepLarge;
+        }
+
+        if (params > 0)
+        {
+            std::sort(fParamIdMap, fParamIdMap + params);
+            updateParameterValuesFromController();
+        }
+
+        // map MIDI controllers to parameters, as VST3 has no MIDI CC events
+        if (mIns > 0 && params > 0 && fMidiMapping != nullptr)
+        {
+            fMidiControllerMap = new uint32_t[MAX_MIDI_CHANNELS * Vst::kCountCtrlNumber];
+
+            bool hasMapping = false;
+
+            for (int16 channel=0; channel < MAX_MIDI_CHANNELS; ++channel)
+            {
+                for (int32 ctrl=0; ctrl < Vst::kCountCtrlNumber; ++ctrl)
+                {
+                    uint32_t& index(fMidiControllerMap[channel * Vst::kCountCtrlNumber + ctrl]);
+                    index = kNoMidiMapping;
+
+                    Vst::ParamID paramId;
+
+                    try {
+                        if (fMidiMapping->getMidiControllerAssignment(0, channel, static_cast<Vst::CtrlNumber>(ctrl), paramId) != kResultOk)
+                            continue;
+                    } CARLA_SAFE_EXCEPTION_CONTINUE("VST3 getMidiControllerAssignment");
+
+                    index = findParameterIndex(paramId);
+
+                    if (index < params)
+                        hasMapping = true;
+                    else
+                        index = kNoMidiMapping;
+                }
+            }
+
+            if (! hasMapping)
+            {
+                delete[] fMidiControllerMap;
+                fMidiControllerMap = nullptr;
+            }
+        }
+
+        if (needsCtrlIn)
+        {
+            portName.clear();
+
+            if (processMode == ENGINE_PROCESS_MODE_SINGLE_CLIENT)
+            {
+                portName  = pData->name;
+                portName += ":";
+            }
+
+            portName += "events-in";
+            portName.truncate(portNameSize);
+
+            pData->event.portIn = (CarlaEngineEventPort*)pData->client->addPort(kEnginePortTypeEvent, portName, true, 0);
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            pData->event.cvSourcePorts = pData->client->createCVSourcePorts();
+#endif
+        }
+
+        if (needsCtrlOut)
+        {
+            portName.clear();
+
+            if (processMode == ENGINE_PROCESS_MODE_SINGLE_CLIENT)
+            {
+                portName  = pData->name;
+                portName += ":";
+            }
+
+            portName += "events-out";
+            portName.truncate(portNameSize);
+
+            pData->event.portOut = (CarlaEngineEventPort*)pData->client->addPort(kEnginePortTypeEvent, portName, false, 0);
+        }
+
+        // plugin hints
+        pData->hints = 0x0;
+
+        if (getCategory() == PLUGIN_CATEGORY_SYNTH)
+            pData->hints |= PLUGIN_IS_SYNTH;
+
+#if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN) || defined(HAVE_X11)
+        if (fController != nullptr)
+        {
+            pData->hints |= PLUGIN_HAS_CUSTOM_UI;
+            pData->hints |= PLUGIN_NEEDS_UI_MAIN_THREAD;
+        }
+#endif
+
+        if (aOuts > 0 && (aIns == aOuts || aIns == 1))
+            pData->hints |= PLUGIN_CAN_DRYWET;
+
+        if (aOuts > 0)
+            pData->hints |= PLUGIN_CAN_VOLUME;
+
+        if (aOuts >= 2 && aOuts % 2 == 0)
+            pData->hints |= PLUGIN_CAN_BALANCE;
+
+        // extra plugin hints
+        pData->extraHints = 0x0;
+
+        if (mIns > 0)
+            pData->extraHints |= PLUGIN_EXTRA_HINT_HAS_MIDI_IN;
+
+        if (mOuts > 0)
+            pData->extraHints |= PLUGIN_EXTRA_HINT_HAS_MIDI_OUT;
+
+        // everything the plugin needs for processing, buffers are set on each audio block
+        fProcessData.symbolicSampleSize     = fUsesDoubles ? Vst::kSample64 : Vst::kSample32;
+        fProcessData.numInputs              = static_cast<int32>(fAudioIns.count);
+        fProcessData.numOutputs             = static_cast<int32>(fAudioOuts.count);
+        fProcessData.inputs                 = fAudioIns.buses;
+        fProcessData.outputs                = fAudioOuts.buses;
+        fProcessData.inputParameterChanges  = &fInputParameterChanges;
+        fProcessData.outputParameterChanges = &fOutputParameterChanges;
+        fProcessData.inputEvents            = mIns > 0 ? &fInputEvents : nullptr;
+        fProcessData.outputEvents           = mOuts > 0 ? &fOutputEvents : nullptr;
+        fProcessData.processContext         = &fContext;
+
+        bufferSizeChanged(pData->engine->getBufferSize());
+
+        // latency is only valid after setting up processing
+        activate();
+        updateLatency();
+        deactivate();
+
+        if (fLatency != 0 || pData->client->getLatency() != 0)
+        {
+            pData->client->setLatency(fLatency);
+#ifndef BUILD_BRIDGE
+            pData->latency.recreateBuffers(std::max(aIns, aOuts), fLatency);
+#endif
+        }
+
+        if (pData->active)
+            activate();
+
+        carla_debug("CarlaPluginVST3::reload() - end");
+    }
+
+    // -------------------------------------------------------------------
+    // Plugin processing
+
+    void activate() noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fComponent != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fProcessor != nullptr,);
+
+        Vst::ProcessSetup setup;
+        setup.processMode        = pData->engine->isOffline() ? Vst::kOffline : Vst::kRealtime;
+        setup.symbolicSampleSize = fUsesDoubles ? Vst::kSample64 : Vst::kSample32;
+        setup.maxSamplesPerBlock = static_cast<int32>(fBufferSize);
+        setup.sampleRate         = pData->engine->getSampleRate();
+
+        fProcessData.processMode = setup.processMode;
+
+        try {
+            fProcessor->setupProcessing(setup);
+        } CARLA_SAFE_EXCEPTION("VST3 setupProcessing");
+
+        try {
+            fComponent->setActive(true);
+        } CARLA_SAFE_EXCEPTION("VST3 setActive");
+
+        // not all plugins implement this, ignore the result
+        try {
+            fProcessor->setProcessing(true);
+        } CARLA_SAFE_EXCEPTION("VST3 setProcessing");
+
+        fContext.continousTimeSamples = 0;
+    }
+
+    void deactivate() noexcept override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fComponent != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fProcessor != nullptr,);
+
+        try {
+            fProcessor->setProcessing(false);
+        } CARLA_SAFE_EXCEPTION("VST3 setProcessing");
+
+        try {
+            fComponent->setActive(false);
+        } CARLA_SAFE_EXCEPTION("VST3 setActive");
+    }
+
+    void process(const float* const* const audioIn,
+                 float** const audioOut,
+                 const float* const* const cvIn,
+                 float** const,
+                 const uint32_t frames) override
+    {
+        // --------------------------------------------------------------------------------------------------------
+        // Check if active
+
+        if (! pData->active)
+        {
+            // disable any output sound
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                carla_zeroFloats(audioOut[i], frames);
+            return;
+        }
+
+        fInputEvents.reset();
+        fOutputEvents.reset();
+        fInputParameterChanges.reset();
+        fOutputParameterChanges.reset();
+        fCurrentEventTime = 0;
+
+        // --------------------------------------------------------------------------------------------------------
+        // Check if needs reset
+
+        if (pData->needsReset)
+        {
+            if (fEventInBusCount > 0 && pData->ctrlChannel >= 0 && pData->ctrlChannel < MAX_MIDI_CHANNELS)
+            {
+                for (uint8_t i=0; i < MAX_MIDI_NOTE; ++i)
+                {
+                    Vst::Event* const event = fInputEvents.append(0, Vst::Event::kNoteOffEvent);
+                    CARLA_SAFE_ASSERT_BREAK(event != nullptr);
+
+                    event->noteOff.channel = pData->ctrlChannel;
+                    event->noteOff.pitch   = i;
+                    event->noteOff.noteId  = -1;
+                }
+            }
+
+            pData->needsReset = false;
+        }
+
+        // --------------------------------------------------------------------------------------------------------
+        // Parameter changes from outside the audio thread
+
+        if (fProcessorParamSync.start())
+        {
+            for (uint32_t i=0; i < pData->param.count; ++i)
+            {
+                if (fProcessorParamSync.take(i))
+                    fInputParameterChanges.addPoint(i, fParamIds[i], 0, getNormalizedValue(i, fParamValues[i]));
+            }
+        }
+
+        // --------------------------------------------------------------------------------------------------------
+        // Set process context
+
+        const EngineTimeInfo timeInfo(pData->engine->getTimeInfo());
+
+        fContext.state = Vst::ProcessContext::kContTimeValid;
+        fContext.sampleRate = pData->engine->getSampleRate();
+        fContext.projectTimeSamples = static_cast<Vst::TSamples>(timeInfo.frame);
+
+        if (timeInfo.playing)
+            fContext.state |= Vst::ProcessContext::kPlaying;
+
+        if (timeInfo.usecs != 0)
+        {
+            fContext.systemTime = static_cast<int64>(timeInfo.usecs) * 1000;
+            fContext.state |= Vst::ProcessContext::kSystemTimeValid;
+        }
+
+        if (timeInfo.bbt.valid)
+        {
+            CARLA_SAFE_ASSERT_INT(timeInfo.bbt.bar > 0, timeInfo.bbt.bar);
+            CARLA_SAFE_ASSERT_INT(timeInfo.bbt.beat > 0, timeInfo.bbt.beat);
+
+            // musical positions are in quarter notes
+            const double quartersPerBeat = 4.0 / timeInfo.bbt.beatType;
+
+            fContext.barPositionMusic = static_cast<double>(timeInfo.bbt.bar - 1) * timeInfo.bbt.beatsPerBar * quartersPerBeat;
+            fContext.projectTimeMusic = fContext.barPositionMusic
+                                      + (static_cast<double>(timeInfo.bbt.beat - 1) + timeInfo.bbt.tick / timeInfo.bbt.ticksPerBeat) * quartersPerBeat;
+            fContext.tempo = timeInfo.bbt.beatsPerMinute;
+            fContext.timeSigNumerator   = static_cast<int32>(timeInfo.bbt.beatsPerBar);
+            fContext.timeSigDenominator = static_cast<int32>(timeInfo.bbt.beatType);
+            fContext.state |= Vst::ProcessContext::kProjectTimeMusicValid
+                            | Vst::ProcessContext::kBarPositionValid
+                            | Vst::ProcessContext::kTempoValid
+                            | Vst::ProcessContext::kTimeSigValid;
+        }
+        else
+        {
+            fContext.barPositionMusic = 0.0;
+            fContext.projectTimeMusic = 0.0;
+            fContext.tempo = 120.0;
+            fContext.timeSigNumerator   = 4;
+            fContext.timeSigDenominator = 4;
+            fContext.state |= Vst::ProcessContext::kTempoValid
+                            | Vst::ProcessContext::kTimeSigValid;
+        }
+
+        // --------------------------------------------------------------------------------------------------------
+        // Event Input
+
+        if (pData->event.portIn != nullptr)
+        {
+            // ----------------------------------------------------------------------------------------------------
+            // MIDI Input (External)
+
+            if (fEventInBusCount > 0 && pData->extNotes.mutex.tryLock())
+            {
+                ExternalMidiNote note = { 0, 0, 0 };
+
+                for (; ! pData->extNotes.data.isEmpty();)
+                {
+                    note = pData->extNotes.data.getFirst(note, true);
+
+                    CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
+
+                    if (! appendNoteEvent(0, static_cast<uint8_t>(note.channel), note.note, note.velo))
+                        break;
+                }
+
+                pData->extNotes.mutex.unlock();
+
+            } // End of MIDI Input (External)
+
+            // ----------------------------------------------------------------------------------------------------
+            // Event Input (System)
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            bool allNotesOffSent = false;
+
+            if (cvIn != nullptr && pData->event.cvSourcePorts != nullptr)
+                pData->event.cvSourcePorts->initPortBuffers(cvIn, frames, true, pData->event.portIn);
+#endif
+
+            for (uint32_t i=0, numEvents = pData->event.portIn->getEventCount(); i < numEvents; ++i)
+            {
+                EngineEvent& event(pData->event.portIn->getEvent(i));
+
+                uint32_t eventTime = event.time;
+                CARLA_SAFE_ASSERT_UINT2_CONTINUE(eventTime < frames, eventTime, frames);
+
+                if (eventTime < fCurrentEventTime)
+                {
+                    carla_stderr2("Timing error, eventTime:%u < previous eventTime:%u for '%s'",
+                                  eventTime, fCurrentEventTime, pData->name);
+                    eventTime = fCurrentEventTime;
+                }
+
+                // no need to split the audio block, all changes are sent with their offset
+                fCurrentEventTime = eventTime;
+
+                switch (event.type)
+                {
+                case kEngineEventTypeNull:
+                    break;
+
+                case kEngineEventTypeControl: {
+                    EngineControlEvent& ctrlEvent(event.ctrl);
+
+                    switch (ctrlEvent.type)
+                    {
+                    case kEngineControlEventTypeNull:
+                        break;
+
+                    case kEngineControlEventTypeParameter: {
+                        float value;
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                        // non-midi
+                        if (event.channel == kEngineEventNonMidiChannel)
+                        {
+                            const uint32_t k = ctrlEvent.param;
+                            CARLA_SAFE_ASSERT_CONTINUE(k < pData->param.count);
+
+                            ctrlEvent.handled = true;
+                            value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
+                            setParameterValueRT(k, value, true);
+                            continue;
+                        }
+
+                        // Control backend stuff
+                        if (event.channel == pData->ctrlChannel)
+                        {
+                            if (MIDI_IS_CONTROL_BREATH_CONTROLLER(ctrlEvent.param) && (pData->hints & PLUGIN_CAN_DRYWET) != 0)
+                            {
+                                ctrlEvent.handled = true;
+                                value = ctrlEvent.normalizedValue;
+                                setDryWetRT(value, true);
+                            }
+                            else if (MIDI_IS_CONTROL_CHANNEL_VOLUME(ctrlEvent.param) && (pData->hints & PLUGIN_CAN_VOLUME) != 0)
+                            {
+                                ctrlEvent.handled = true;
+                                value = ctrlEvent.normalizedValue*127.0f/100.0f;
+                                setVolumeRT(value, true);
+                            }
+                            else if (MIDI_IS_CONTROL_BALANCE(ctrlEvent.param) && (pData->hints & PLUGIN_CAN_BALANCE) != 0)
+                            {
+                                float left, right;
+                                value = ctrlEvent.normalizedValue/0.5f - 1.0f;
+
+                                if (value < 0.0f)
+                                {
+                                    left  = -1.0f;
+                                    right = (value*2.0f)+1.0f;
+                                }
+                                else if (value > 0.0f)
+                                {
+                                    left  = (value*2.0f)-1.0f;
+                                    right = 1.0f;
+                                }
+                                else
+                                {
+                                    left  = -1.0f;
+                                    right = 1.0f;
+                                }
+
+                                ctrlEvent.handled = true;
+                                setBalanceLeftRT(left, true);
+                                setBalanceRightRT(right, true);
+                            }
+                        }
+#endif
+                        // Control plugin parameters
+                        uint32_t k;
+                        for (k=0; k < pData->param.count; ++k)
+                        {
+                            if (pData->param.data[k].midiChannel != event.channel)
+                                continue;
+                            if (pData->param.data[k].mappedControlIndex != ctrlEvent.param)
+                                continue;
+                            if (pData->param.data[k].type != PARAMETER_INPUT)
+                                continue;
+                            if ((pData->param.data[k].hints & PARAMETER_IS_AUTOMABLE) == 0)
+                                continue;
+
+                            ctrlEvent.handled = true;
+                            value = pData->param.getFinalUnnormalizedValue(k, ctrlEvent.normalizedValue);
+                            setParameterValueRT(k, value, true);
+                        }
+
+                        if ((pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) != 0 && ctrlEvent.param < MAX_MIDI_VALUE)
+                        {
+                            if (setMidiControllerValueRT(event.channel, ctrlEvent.param, ctrlEvent.normalizedValue))
+                                ctrlEvent.handled = true;
+                        }
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                        if (! ctrlEvent.handled)
+                            checkForMidiLearn(event);
+#endif
+                        break;
+                    } // case kEngineControlEventTypeParameter
+
+                    case kEngineControlEventTypeMidiBank:
+                    case kEngineControlEventTypeMidiProgram:
+                        // VST3 plugins expose programs as parameters, nothing to do here
+                        break;
+
+                    case kEngineControlEventTypeAllSoundOff:
+                        if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
+                            setMidiControllerValueRT(event.channel, MIDI_CONTROL_ALL_SOUND_OFF, 0.0f);
+                        break;
+
+                    case kEngineControlEventTypeAllNotesOff:
+                        if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
+                        {
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                            if (event.channel == pData->ctrlChannel && ! allNotesOffSent)
+                            {
+                                allNotesOffSent = true;
+                                postponeRtAllNotesOff();
+                            }
+#endif
+
+                            setMidiControllerValueRT(event.channel, MIDI_CONTROL_ALL_NOTES_OFF, 0.0f);
+                        }
+                        break;
+                    } // switch (ctrlEvent.type)
+                    break;
+                } // case kEngineEventTypeControl
+
+                case kEngineEventTypeMidi: {
+                    if (fEventInBusCount == 0)
+                        continue;
+
+                    const EngineMidiEvent& midiEvent(event.midi);
+
+                    if (midiEvent.size > 3)
+                        continue;
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+                    static_assert(3 <= EngineMidiEvent::kDataSize, "Incorrect data");
+#endif
+
+                    uint8_t status = uint8_t(MIDI_GET_STATUS_FROM_DATA(midiEvent.data));
+
+                    if ((status == MIDI_STATUS_NOTE_OFF || status == MIDI_STATUS_NOTE_ON) && (pData->options & PLUGIN_OPTION_SKIP_SENDING_NOTES))
+                        continue;
+                    if (status == MIDI_STATUS_CHANNEL_PRESSURE && (pData->options & PLUGIN_OPTION_SEND_CHANNEL_PRESSURE) == 0)
+                        continue;
+                    if (status == MIDI_STATUS_CONTROL_CHANGE && (pData->options & PLUGIN_OPTION_SEND_CONTROL_CHANGES) == 0)
+                        continue;
+                    if (status == MIDI_STATUS_POLYPHONIC_AFTERTOUCH && (pData->options & PLUGIN_OPTION_SEND_NOTE_AFTERTOUCH) == 0)
+                        continue;
+                    if (status == MIDI_STATUS_PITCH_WHEEL_CONTROL && (pData->options & PLUGIN_OPTION_SEND_PITCHBEND) == 0)
+                        continue;
+
+                    const uint8_t data1 = midiEvent.size >= 2 ? midiEvent.data[1] : 0;
+                    const uint8_t data2 = midiEvent.size >= 3 ? midiEvent.data[2] : 0;
+
+                    // Fix bad note-off
+                    if (status == MIDI_STATUS_NOTE_ON && data2 == 0)
+                        status = MIDI_STATUS_NOTE_OFF;
+
+                    switch (status)
+                    {
+                    case MIDI_STATUS_NOTE_OFF:
+                        appendNoteEvent(eventTime, event.channel, data1, 0);
+                        pData->postponeNoteOffRtEvent(true, event.channel, data1);
+                        break;
+
+                    case MIDI_STATUS_NOTE_ON:
+                        appendNoteEvent(eventTime, event.channel, data1, data2);
+                        pData->postponeNoteOnRtEvent(true, event.channel, data1, data2);
+                        break;
+
+                    case MIDI_STATUS_POLYPHONIC_AFTERTOUCH:
+                        if (Vst::Event* const vstEvent = fInputEvents.append(eventTime, Vst::Event::kPolyPressureEvent))
+                        {
+                            vstEvent->polyPressure.channel  = event.channel;
+                            vstEvent->polyPressure.pitch    = data1;
+                            vstEvent->polyPressure.pressure = static_cast<float>(data2) / 127.0f;
+                            vstEvent->polyPressure.noteId   = -1;
+                        }
+                        break;
+
+                    case MIDI_STATUS_CONTROL_CHANGE:
+                        setMidiControllerValueRT(event.channel, data1, static_cast<float>(data2) / 127.0f);
+                        break;
+
+                    case MIDI_STATUS_CHANNEL_PRESSURE:
+                        setMidiControllerValueRT(event.channel, Vst::kAfterTouch, static_cast<float>(data1) / 127.0f);
+                        break;
+
+                    case MIDI_STATUS_PITCH_WHEEL_CONTROL:
+                        setMidiControllerValueRT(event.channel, Vst::kPitchBend,
+                                                 static_cast<float>((data2 << 7) | data1) / 16383.0f);
+                        break;
+                    }
+                } break;
+                } // switch (event.type)
+            }
+
+        } // End of Event Input
+
+        // --------------------------------------------------------------------------------------------------------
+        // Plugin processing
+
+        if (processSingle(audioIn, audioOut, frames))
+        {
+            // ----------------------------------------------------------------------------------------------------
+            // Parameter changes from the plugin
+
+            for (int32 i=0, count=fOutputParameterChanges.getParameterCount(); i < count; ++i)
+            {
+                Vst::IParamValueQueue* const queue = fOutputParameterChanges.getParameterData(i);
+                CARLA_SAFE_ASSERT_CONTINUE(queue != nullptr);
+
+                const int32 pointCount = queue->getPointCount();
+
+                if (pointCount <= 0)
+                    continue;
+
+                int32 offset;
+                Vst::ParamValue normalized;
+
+                if (queue->getPoint(pointCount - 1, offset, normalized) != kResultOk)
+                    continue;
+
+                const uint32_t k = findParameterIndex(queue->getParameterId());
+
+                if (k >= pData->param.count)
+                    continue;
+
+                const float value = static_cast<float>(normalized) * pData->param.ranges[k].max;
+                fParamValues[k] = value;
+                fControllerParamSync.mark(k);
+
+                // output parameters are polled by the engine
+                if (pData->param.data[k].type == PARAMETER_INPUT)
+                    pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(k), value);
+            }
+
+            // ----------------------------------------------------------------------------------------------------
+            // MIDI Output
+
+            if (pData->event.portOut != nullptr && fEventOutBusCount > 0)
+            {
+                for (uint32_t i=0, count=fOutputEvents.count(); i < count; ++i)
+                {
+                    const Vst::Event& vstEvent(fOutputEvents.at(i));
+
+                    CARLA_SAFE_ASSERT_CONTINUE(vstEvent.sampleOffset >= 0);
+
+                    uint8_t midiData[3] = { 0, 0, 0 };
+                    uint8_t midiSize = 3;
+
+                    if (! getMidiDataFromEvent(vstEvent, midiData, midiSize))
+                        continue;
+
+                    const uint32_t time = std::min(static_cast<uint32_t>(vstEvent.sampleOffset), frames - 1);
+
+                    if (! pData->event.portOut->writeMidiEvent(time, midiSize, midiData))
+                        break;
+                }
+            }
+        }
+
+        // --------------------------------------------------------------------------------------------------------
+
+#ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        return;
+
+        // unused
+        (void)cvIn;
+#endif
+    }
+
+    bool processSingle(const float* const* const inBuffer, float** const outBuffer, const uint32_t frames)
+    {
+        CARLA_SAFE_ASSERT_RETURN(frames > 0, false);
+
+        if (pData->audioIn.count > 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(inBuffer != nullptr, false);
+        }
+        if (pData->audioOut.count > 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(outBuffer != nullptr, false);
+        }
+
+        // --------------------------------------------------------------------------------------------------------
+        // Try lock, silence otherwise
+
+#ifndef STOAT_TEST_BUILD
+        if (pData->engine->isOffline())
+        {
+            pData->singleMutex.lock();
+        }
+        else
+#endif
+        if (! pData->singleMutex.tryLock())
+        {
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+                carla_zeroFloats(outBuffer[i], frames);
+
+            return false;
+        }
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        // --------------------------------------------------------------------------------------------------------
+        // Keep dry signal, input and output buffers can be the same
+
+        const bool doDryWet = (pData->hints & PLUGIN_CAN_DRYWET) != 0 && carla_isNotEqual(pData->postProc.dryWet, 1.0f);
+
+        if (doDryWet)
+        {
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                carla_copyFloats(fDryBuffers[i], inBuffer[i], frames);
+        }
+#endif
+
+        // --------------------------------------------------------------------------------------------------------
+        // Set audio buffers, processing happens in-place on the engine buffers
+
+        if (fUsesDoubles)
+        {
+            for (uint32_t i=0; i < fAudioIns.channels; ++i)
+            {
+                for (uint32_t k=0; k < frames; ++k)
+                    fAudioIns.buffers64[i][k] = static_cast<double>(inBuffer[i][k]);
+            }
+        }
+        else
+        {
+            for (uint32_t i=0; i < fAudioIns.channels; ++i)
+                fAudioIns.buffers32[i] = const_cast<float*>(inBuffer[i]);
+
+            for (uint32_t i=0; i < fAudioOuts.channels; ++i)
+                fAudioOuts.buffers32[i] = outBuffer[i];
+        }
+
+        for (uint32_t i=0; i < fAudioIns.count; ++i)
+            fAudioIns.buses[i].silenceFlags = 0;
+
+        for (uint32_t i=0; i < fAudioOuts.count; ++i)
+            fAudioOuts.buses[i].silenceFlags = 0;
+
+        // --------------------------------------------------------------------------------------------------------
+        // Run plugin
+
+        fProcessData.numSamples = static_cast<int32>(frames);
+
+        try {
+            fProcessor->process(fProcessData);
+        } CARLA_SAFE_EXCEPTION("VST3 process");
+
+        fContext.continousTimeSamples += frames;
+
+        if (fUsesDoubles)
+        {
+            for (uint32_t i=0; i < fAudioOuts.channels; ++i)
+            {
+                for (uint32_t k=0; k < frames; ++k)
+                    outBuffer[i][k] = static_cast<float>(fAudioOuts.buffers64[i][k]);
+            }
+        }
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        // --------------------------------------------------------------------------------------------------------
+        // Post-processing (dry/wet, volume and balance)
+
+        {
+            const bool doVolume  = (pData->hints & PLUGIN_CAN_VOLUME) != 0 && carla_isNotEqual(pData->postProc.volume, 1.0f);
+            const bool doBalance = (pData->hints & PLUGIN_CAN_BALANCE) != 0 && ! (carla_isEqual(pData->postProc.balanceLeft, -1.0f) && carla_isEqual(pData->postProc.balanceRight, 1.0f));
+            const bool isMono    = (pData->audioIn.count == 1);
+
+            bool isPair;
+            float bufValue, oldBufLeft[doBalance ? frames : 1];
+
+            for (uint32_t i=0; i < pData->audioOut.count; ++i)
+            {
+                // Dry/Wet
+                if (doDryWet)
+                {
+                    const uint32_t c = isMono ? 0 : i;
+
+                    for (uint32_t k=0; k < frames; ++k)
+                    {
+                        bufValue = fDryBuffers[c][k];
+                        outBuffer[i][k] = (outBuffer[i][k] * pData->postProc.dryWet) + (bufValue * (1.0f - pData->postProc.dryWet));
+                    }
+                }
+
+                // Balance
+                if (doBalance)
+                {
+                    isPair = (i % 2 == 0);
+
+                    if (isPair)
+                    {
+                        CARLA_ASSERT(i+1 < pData->audioOut.count);
+                        carla_copyFloats(oldBufLeft, outBuffer[i], frames);
+                    }
+
+                    float balRangeL = (pData->postProc.balanceLeft  + 1.0f)/2.0f;
+                    float balRangeR = (pData->postProc.balanceRight + 1.0f)/2.0f;
+
+                    for (uint32_t k=0; k < frames; ++k)
+                    {
+                        if (isPair)
+                        {
+                            // left
+                            outBuffer[i][k]  = oldBufLeft[k]      * (1.0f - balRangeL);
+                            outBuffer[i][k] += outBuffer[i+1][k] * (1.0f - balRangeR);
+                        }
+                        else
+                        {
+                            // right
+                            outBuffer[i][k]  = outBuffer[i][k] * balRangeR;
+                            outBuffer[i][k] += oldBufLeft[k]   * balRangeL;
+                        }
+                    }
+                }
+
+                // Volume
+                if (doVolume)
+                {
+                    for (uint32_t k=0; k < frames; ++k)
+                        outBuffer[i][k] *= pData->postProc.volume;
+                }
+            }
+
+        } // End of Post-processing
+#endif
+
+        // --------------------------------------------------------------------------------------------------------
+
+        pData->singleMutex.unlock();
+        return true;
+    }
+
+    void bufferSizeChanged(const uint32_t newBufferSize) override
+    {
+        CARLA_ASSERT_INT(newBufferSize > 0, newBufferSize);
+        carla_debug("CarlaPluginVST3::bufferSizeChanged(%i)", newBufferSize);
+
+        fBufferSize = newBufferSize;
+
+        if (pData->active)
+            deactivate();
+
+        if (fUsesDoubles)
+        {
+            fAudioIns.resizeBuffers64(newBufferSize);
+            fAudioOuts.resizeBuffers64(newBufferSize);
+        }
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (fDryBuffers != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                delete[] fDryBuffers[i];
+        }
+        else if (pData->audioIn.count > 0)
+        {
+            fDryBuffers = new float*[pData->audioIn.count];
+        }
+
+        for (uint32_t i=0; i < pData->audioIn.count; ++i)
+            fDryBuffers[i] = new float[newBufferSize];
+#endif
+
+        if (pData->active)
+            activate();
+    }
+
+    void sampleRateChanged(const double newSampleRate) override
+    {
+        CARLA_ASSERT_INT(newSampleRate > 0.0, newSampleRate);
+        carla_debug("CarlaPluginVST3::sampleRateChanged(%g)", newSampleRate);
+
+        if (pData->active)
+        {
+            deactivate();
+            activate();
+        }
+    }
+
+    void offlineModeChanged(const bool) override
+    {
+
+        if (pData->active)
+        {
+            deactivate();
+            activate();
+        }
+    }
+
+    // -------------------------------------------------------------------
+    // Plugin buffers
+
+    void clearBuffers() noexcept override
+    {
+        carla_debug("CarlaPluginVST3::clearBuffers() - start");
+
+        if (fDryBuffers != nullptr)
+        {
+            for (uint32_t i=0; i < pData->audioIn.count; ++i)
+                delete[] fDryBuffers[i];
+
+            delete[] fDryBuffers;
+            fDryBuffers = nullptr;
+        }
+
+        fAudioIns.clear();
+        fAudioOuts.clear();
+
+        fInputParameterChanges.clear();
+        fOutputParameterChanges.clear();
+        fProcessorParamSync.clear();
+        fControllerParamSync.clear();
+
+        if (fParamIds != nullptr)
+        {
+            delete[] fParamIds;
+            fParamIds = nullptr;
+        }
+
+        if (fParamIdMap != nullptr)
+        {
+            delete[] fParamIdMap;
+            fParamIdMap = nullptr;
+        }
+
+        if (fParamValues != nullptr)
+        {
+            delete[] fParamValues;
+            fParamValues = nullptr;
+        }
+
+        if (fMidiControllerMap != nullptr)
+        {
+            delete[] fMidiControllerMap;
+            fMidiControllerMap = nullptr;
+        }
+
+        CarlaPlugin::clearBuffers();
+
+        carla_debug("CarlaPluginVST3::clearBuffers() - end");
+    }
+
+    // -------------------------------------------------------------------
+
+protected:
+    void handlePluginUIClosed() override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fUI.window != nullptr,);
+        carla_debug("CarlaPluginVST3::handlePluginUIClosed()");
+
+        showCustomUI(false);
+        pData->engine->callback(true, true,
+                                ENGINE_CALLBACK_UI_STATE_CHANGED,
+                                pData->id,
+                                0,
+                                0, 0, 0.0f, nullptr);
+    }
+
+    void handlePluginUIResized(const uint width, const uint height) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(fUI.window != nullptr,);
+        carla_debug("CarlaPluginVST3::handlePluginUIResized(%u, %u)", width, height);
+
+        if (fUI.view == nullptr || ! fUI.isAttached)
+            return;
+
+        try {
+            if (fUI.view->canResize() != kResultOk)
+                return;
+
+            ViewRect rect(0, 0, static_cast<int32>(width), static_cast<int32>(height));
+            fUI.view->checkSizeConstraint(&rect);
+            fUI.view->onSize(&rect);
+        } CARLA_SAFE_EXCEPTION("VST3 view resize");
+    }
+
+    // -------------------------------------------------------------------
+
+    // controller changed a parameter, usually from its UI
+    tresult handlePerformEdit(const Vst::ParamID paramId, const Vst::ParamValue normalized)
+    {
+        const uint32_t index = findParameterIndex(paramId);
+        CARLA_SAFE_ASSERT_RETURN(index < pData->param.count, kInvalidArgument);
+
+        const float value = static_cast<float>(normalized) * pData->param.ranges[index].max;
+        fParamValues[index] = value;
+        fProcessorParamSync.mark(index);
+
+        CarlaPlugin::setParameterValue(index, value, false, true, true);
+        return kResultOk;
+    }
+
+    // can be called from any thread, handled later during idle
+    tresult handleRestartComponentRequest(const int32 flags)
+    {
+        carla_debug("CarlaPluginVST3::handleRestartComponentRequest(0x%x)", flags);
+
+        __sync_fetch_and_or(&fRestartFlags, flags);
+        return kResultOk;
+    }
+
+    void handleRestartComponent(const int32 flags)
+    {
+        carla_debug("CarlaPluginVST3::handleRestartComponent(0x%x)", flags);
+
+        static const int32 kReloadFlags = Vst::kReloadComponent
+                                        | Vst::kIoChanged
+                                        | Vst::kParamTitlesChanged
+                                        | Vst::kMidiCCAssignmentChanged;
+
+        if (flags & kReloadFlags)
+        {
+            reload();
+            pData->engine->callback(true, true,
+                                    ENGINE_CALLBACK_RELOAD_ALL,
+                                    pData->id,
+                                    0, 0, 0, 0.0f, nullptr);
+        }
+        else if (flags & Vst::kParamValuesChanged)
+        {
+            updateParameterValuesFromController();
+            pData->updateParameterValues(this, true, true, false);
+        }
+
+        // new latency gets applied during idle
+        if (flags & Vst::kLatencyChanged)
+            updateLatency();
+    }
+
+    tresult handleResizeView(IPlugView* const view, ViewRect* const rect)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fUI.window != nullptr, kResultFalse);
+        CARLA_SAFE_ASSERT_RETURN(view != nullptr && view == fUI.view, kInvalidArgument);
+        CARLA_SAFE_ASSERT_RETURN(rect != nullptr, kInvalidArgument);
+
+        const int32 width  = rect->getWidth();
+        const int32 height = rect->getHeight();
+        CARLA_SAFE_ASSERT_INT2_RETURN(width > 1 && height > 1, width, height, kInvalidArgument);
+
+        fUI.window->setSize(static_cast<uint>(width), static_cast<uint>(height), true);
+
+        try {
+            view->onSize(rect);
+        } CARLA_SAFE_EXCEPTION("VST3 view onSize");
+
+        return kResultOk;
+    }
+
+    // -------------------------------------------------------------------
+
+    bool hasMidiInput() const noexcept
+    {
+        return fEventInBusCount > 0;
+    }
+
+    bool hasMidiOutput() const noexcept
+    {
+        return fEventOutBusCount > 0;
+    }
+
+    float getNormalizedValue(const uint32_t index, const float value) const noexcept
+    {
+        return value / pData->param.ranges[index].max;
+    }
+
+    bool getParameterInfo(const uint32_t index, Vst::ParameterInfo& paramInfo) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fController != nullptr, false);
+
+        carla_zeroStruct(paramInfo);
+
+        try {
+            return fController->getParameterInfo(static_cast<int32>(index), paramInfo) == kResultOk;
+        } CARLA_SAFE_EXCEPTION_RETURN("VST3 getParameterInfo", false);
+    }
+
+    uint32_t findParameterIndex(const Vst::ParamID paramId) const noexcept
+    {
+        if (fParamIdMap == nullptr)
+            return kNoMidiMapping;
+
+        const ParamIdMapping key = { paramId, 0 };
+        const ParamIdMapping* const end = fParamIdMap + pData->param.count;
+        const ParamIdMapping* const it  = std::lower_bound(static_cast<const ParamIdMapping*>(fParamIdMap), end, key);
+
+        if (it != end && it->id == paramId)
+            return it->index;
+
+        return kNoMidiMapping;
+    }
+
+    void updateLatency() noexcept
+    {
+        try {
+            fLatency = fProcessor->getLatencySamples();
+        } CARLA_SAFE_EXCEPTION("VST3 getLatencySamples");
+    }
+
+    void updateParameterValuesFromController() noexcept
+    {
+        if (fController == nullptr || fParamValues == nullptr)
+            return;
+
+        for (uint32_t i=0; i < pData->param.count; ++i)
+        {
+            try {
+                fParamValues[i] = static_cast<float>(fController->getParamNormalized(fParamIds[i])) * pData->param.ranges[i].max;
+            } CARLA_SAFE_EXCEPTION_CONTINUE("VST3 getParamNormalized");
+        }
+    }
+
+    // velocity 0 means note-off
+    bool appendNoteEvent(const uint32_t time, const uint8_t channel, const uint8_t note, const uint8_t velocity) noexcept
+    {
+        if (velocity > 0)
+        {
+            Vst::Event* const event = fInputEvents.append(time, Vst::Event::kNoteOnEvent);
+
+            if (event == nullptr)
+                return false;
+
+            event->noteOn.channel  = channel;
+            event->noteOn.pitch    = note;
+            event->noteOn.velocity = static_cast<float>(velocity) / 127.0f;
+            event->noteOn.noteId   = -1;
+        }
+        else
+        {
+            Vst::Event* const event = fInputEvents.append(time, Vst::Event::kNoteOffEvent);
+
+            if (event == nullptr)
+                return false;
+
+            event->noteOff.channel = channel;
+            event->noteOff.pitch   = note;
+            event->noteOff.noteId  = -1;
+        }
+
+        return true;
+    }
+
+    // MIDI controllers become parameter changes, if the plugin maps them
+    bool setMidiControllerValueRT(const uint8_t channel, const uint16_t controller, const float normalized) noexcept
+    {
+        if (fMidiControllerMap == nullptr)
+            return false;
+
+        CARLA_SAFE_ASSERT_RETURN(channel < MAX_MIDI_CHANNELS, false);
+        CARLA_SAFE_ASSERT_RETURN(controller < Vst::kCountCtrlNumber, false);
+
+        const uint32_t index = fMidiControllerMap[channel * Vst::kCountCtrlNumber + controller];
+
+        if (index >= pData->param.count)
+            return false;
+
+        const float value = normalized * pData->param.ranges[index].max;
+        fParamValues[index] = value;
+
+        fInputParameterChanges.addPoint(index, fParamIds[index], static_cast<int32>(fCurrentEventTime), normalized);
+        fControllerParamSync.mark(index);
+
+        pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(index), value);
+        return true;
+    }
+
+    static bool getMidiDataFromEvent(const Vst::Event& event, uint8_t midiData[3], uint8_t& midiSize) noexcept
+    {
+        switch (event.type)
+        {
+        case Vst::Event::kNoteOnEvent:
+            midiData[0] = uint8_t(MIDI_STATUS_NOTE_ON | (event.noteOn.channel & MIDI_CHANNEL_BIT));
+            midiData[1] = uint8_t(event.noteOn.pitch & 0x7f);
+            midiData[2] = uint8_t(carla_fixedValue(1, 127, static_cast<int>(event.noteOn.velocity * 127.0f + 0.5f)));
+            return true;
+
+        case Vst::Event::kNoteOffEvent:
+            midiData[0] = uint8_t(MIDI_STATUS_NOTE_OFF | (event.noteOff.channel & MIDI_CHANNEL_BIT));
+            midiData[1] = uint8_t(event.noteOff.pitch & 0x7f);
+            midiData[2] = uint8_t(carla_fixedValue(0, 127, static_cast<int>(event.noteOff.velocity * 127.0f + 0.5f)));
+            return true;
+
+        case Vst::Event::kPolyPressureEvent:
+            midiData[0] = uint8_t(MIDI_STATUS_POLYPHONIC_AFTERTOUCH | (event.polyPressure.channel & MIDI_CHANNEL_BIT));
+            midiData[1] = uint8_t(event.polyPressure.pitch & 0x7f);
+            midiData[2] = uint8_t(carla_fixedValue(0, 127, static_cast<int>(event.polyPressure.pressure * 127.0f + 0.5f)));
+            return true;
+
+        case Vst::Event::kLegacyMIDICCOutEvent: {
+            const Vst::LegacyMIDICCOutEvent& ccEvent(event.midiCCOut);
+            const uint8_t channel = uint8_t(ccEvent.channel & MIDI_CHANNEL_BIT);
+
+            if (ccEvent.controlNumber < Vst::kAfterTouch)
+            {
+                midiData[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | channel);
+                midiData[1] = ccEvent.controlNumber;
+                midiData[2] = uint8_t(ccEvent.value & 0x7f);
+                return true;
+            }
+
+            switch (ccEvent.controlNumber)
+            {
+            case Vst::kAfterTouch:
+                midiData[0] = uint8_t(MIDI_STATUS_CHANNEL_PRESSURE | channel);
+                midiData[1] = uint8_t(ccEvent.value & 0x7f);
+                midiSize = 2;
+                return true;
+            case Vst::kPitchBend:
+                midiData[0] = uint8_t(MIDI_STATUS_PITCH_WHEEL_CONTROL | channel);
+                midiData[1] = uint8_t(ccEvent.value & 0x7f);
+                midiData[2] = uint8_t(ccEvent.value2 & 0x7f);
+                return true;
+            case Vst::kCtrlProgramChange:
+                midiData[0] = uint8_t(MIDI_STATUS_PROGRAM_CHANGE | channel);
+                midiData[1] = uint8_t(ccEvent.value & 0x7f);
+                midiSize = 2;
+                return true;
+            case Vst::kCtrlPolyPressure:
+                midiData[0] = uint8_t(MIDI_STATUS_POLYPHONIC_AFTERTOUCH | channel);
+                midiData[1] = uint8_t(ccEvent.value & 0x7f);
+                midiData[2] = uint8_t(ccEvent.value2 & 0x7f);
+                return true;
+            }
+        }   break;
+        }
+
+        return false;
+    }
+
+    void closeView() noexcept
+    {
+        if (fUI.view != nullptr)
+        {
+            try {
+                if (fUI.isAttached)
+                    fUI.view->removed();
+
+                fUI.view->setFrame(nullptr);
+                fUI.view->release();
+            } CARLA_SAFE_EXCEPTION("VST3 view close");
+
+            fUI.view = nullptr;
+        }
+
+        fUI.isAttached = false;
+
+        if (fUI.window != nullptr)
+        {
+            delete fUI.window;
+            fUI.window = nullptr;
+        }
+
+        fPlugFrame.clear();
+    }
+
+    // -------------------------------------------------------------------
+    // Plugin state in the same format as JUCE uses, so projects can switch between both hosts
+
+    std::size_t createJuceSaveFormat(Vst3MemoryStream* const componentStream,
+                                     Vst3MemoryStream* const controllerStream,
+                                     void** const dataPtr) noexcept
+    {
+        static const char kXmlHeader[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?> <VST3PluginState>";
+        static const char kXmlFooter[] = "</VST3PluginState>";
+
+        std::size_t xmlSize = std::strlen(kXmlHeader) + std::strlen(kXmlFooter);
+
+        if (componentStream != nullptr)
+            xmlSize += std::strlen("<IComponent></IComponent>") + getJuceBase64Size(componentStream->getSize());
+
+        if (controllerStream != nullptr)
+            xmlSize += std::strlen("<IEditController></IEditController>") + getJuceBase64Size(controllerStream->getSize());
+
+        char* const data = static_cast<char*>(std::malloc(8 + xmlSize + 1));
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, 0);
+
+        const uint32_t header[2] = { kJuceStateMagic, static_cast<uint32_t>(xmlSize) };
+        std::memcpy(data, header, sizeof(header));
+
+        char* xml = data + 8;
+        xml = writeString(xml, kXmlHeader);
+
+        if (componentStream != nullptr)
+        {
+            xml = writeString(xml, "<IComponent>");
+            xml = writeJuceBase64(xml, componentStream->getData(), componentStream->getSize());
+            xml = writeString(xml, "</IComponent>");
+        }
+
+        if (controllerStream != nullptr)
+        {
+            xml = writeString(xml, "<IEditController>");
+            xml = writeJuceBase64(xml, controllerStream->getData(), controllerStream->getSize());
+            xml = writeString(xml, "</IEditController>");
+        }
+
+        xml = writeString(xml, kXmlFooter);
+        *xml = '\0';
+
+        CARLA_SAFE_ASSERT_UINT2(xml == data + 8 + xmlSize, static_cast<uint>(xml - data), static_cast<uint>(8 + xmlSize));
+
+        fLastChunk = data;
+        *dataPtr = data;
+        return 8 + xmlSize + 1;
+    }
+
+    static bool loadJuceSaveFormat(const void* const data, const std::size_t dataSize,
+                                   Vst3MemoryStream& componentStream, Vst3MemoryStream& controllerStream,
+                                   bool& hasComponentState, bool& hasControllerState)
+    {
+        hasComponentState = hasControllerState = false;
+
+        if (dataSize <= 8)
+            return false;
+
+        uint32_t header[2];
+        std::memcpy(header, data, sizeof(header));
+
+        if (header[0] != kJuceStateMagic)
+            return false;
+
+        const std::size_t xmlSize = std::min(static_cast<std::size_t>(header[1]), dataSize - 8);
+        CARLA_SAFE_ASSERT_RETURN(xmlSize > 0, false);
+
+        // the reader works in-place
+        char* const xml = static_cast<char*>(std::malloc(xmlSize));
+        CARLA_SAFE_ASSERT_RETURN(xml != nullptr, false);
+
+        std::memcpy(xml, static_cast<const uint8_t*>(data) + 8, xmlSize);
+
+        CarlaXmlReader reader(xml, xmlSize);
+        bool ok = false;
+
+        if (reader.next() == CarlaXmlReader::kTokenStartElement && std::strcmp(reader.getName(), "VST3PluginState") == 0)
+        {
+            for (;;)
+            {
+                const CarlaXmlReader::Token token = reader.next();
+
+                if (token == CarlaXmlReader::kTokenStartElement)
+                {
+                    if (reader.getDepth() != 2 && ! reader.skipElement())
+                        break;
+                    continue;
+                }
+
+                if (token != CarlaXmlReader::kTokenEndElement)
+                    break;
+
+                if (reader.getDepth() == 1)
+                {
+                    ok = true;
+                    break;
+                }
+
+                if (std::strcmp(reader.getName(), "IComponent") == 0)
+                    hasComponentState = readJuceBase64(reader.getText(), componentStream);
+                else if (std::strcmp(reader.getName(), "IEditController") == 0)
+                    hasControllerState = readJuceBase64(reader.getText(), controllerStream);
+            }
+        }
+
+        if (reader.hasError())
+            carla_stderr2("CarlaPluginVST3::loadJuceSaveFormat() - %s", reader.getError());
+
+        std::free(xml);
+        return ok;
+    }
+
+    static char* writeString(char* const dst, const char* const str) noexcept
+    {
+        const std::size_t len = std::strlen(str);
+        std::memcpy(dst, str, len);
+        return dst + len;
+    }
+
+    static std::size_t getJuceBase64Size(const std::size_t dataSize) noexcept
+    {
+        char sizeStr[32];
+        std::snprintf(sizeStr, 32, P_SIZE ".", dataSize);
+
+        return std::strlen(sizeStr) + (dataSize * 8 + 5) / 6;
+    }
+
+    // "size.data", each char holding 6 bits, least significant first
+    static char* writeJuceBase64(char* dst, const uint8_t* const data, const std::size_t dataSize) noexcept
+    {
+        char sizeStr[32];
+        std::snprintf(sizeStr, 32, P_SIZE ".", dataSize);
+        dst = writeString(dst, sizeStr);
+
+        for (std::size_t i=0, numChars = (dataSize * 8 + 5) / 6; i < numChars; ++i)
+        {
+            const std::size_t byte  = (i * 6) / 8;
+            const uint        shift = (i * 6) % 8;
+
+            uint value = static_cast<uint>(data[byte]) >> shift;
+
+            if (shift > 2 && byte + 1 < dataSize)
+                value |= static_cast<uint>(data[byte + 1]) << (8 - shift);
+
+            *dst++ = kJuceBase64Chars[value & 0x3f];
+        }
+
+        return dst;
+    }
+
+    static bool readJuceBase64(const char* const text, Vst3MemoryStream& stream) noexcept
+    {
+        const char* const dot = std::strchr(text, '.');
+        CARLA_SAFE_ASSERT_RETURN(dot != nullptr, false);
+
+        const std::size_t dataSize = static_cast<std::size_t>(std::strtoul(text, nullptr, 10));
+
+        uint8_t* const data = static_cast<uint8_t*>(std::calloc(dataSize > 0 ? dataSize : 1, 1));
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr, false);
+
+        std::size_t bit = 0;
+
+        for (const char* c = dot + 1; *c != '\0'; ++c)
+        {
+            const char* const pos = std::strchr(kJuceBase64Chars, *c);
+
+            // JUCE ignores anything unknown too
+            if (pos == nullptr)
+                continue;
+
+            const uint value = static_cast<uint>(pos - kJuceBase64Chars);
+            const std::size_t byte  = bit / 8;
+            const uint        shift = bit % 8;
+
+            if (byte < dataSize)
+                data[byte] = static_cast<uint8_t>(data[byte] | (value << shift));
+
+            if (shift > 2 && byte + 1 < dataSize)
+                data[byte + 1] = static_cast<uint8_t>(data[byte + 1] | (value >> (8 - shift)));
+
+            bit += 6;
+        }
+
+        stream.adopt(data, dataSize);
+        return true;
+    }
+
+    // -------------------------------------------------------------------
+
+public:
+    bool init(const CarlaPluginPtr plugin,
+              const char* const filename, const char* const name, const char* const label,
+              const int64_t uniqueId, const uint options)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->engine != nullptr, false);
+
+        // ---------------------------------------------------------------
+        // first checks
+
+        if (pData->client != nullptr)
+        {
+            pData->engine->setLastError("Plugin client is already registered");
+            return false;
+        }
+
+        if (filename == nullptr || filename[0] == '\0')
+        {
+            pData->engine->setLastError("null filename");
+            return false;
+        }
+
+        // ---------------------------------------------------------------
+        // open module and get factory
+
+        V3_GetFactoryFunc v3_getFactory = nullptr;
+
+#ifdef CARLA_OS_MAC
+        {
+            // FIXME assert returns, set engine error
+            const CFURLRef urlRef = CFURLCreateFromFileSystemRepresentation(0, (const UInt8*)filename, (CFIndex)strlen(filename), true);
+            CARLA_SAFE_ASSERT_RETURN(urlRef != nullptr, false);
+
+            fMacBundleRef = CFBundleCreate(kCFAllocatorDefault, urlRef);
+            CFRelease(urlRef);
+            CARLA_SAFE_ASSERT_RETURN(fMacBundleRef != nullptr, false);
+
+            if (! CFBundleLoadExecutable(fMacBundleRef))
+            {
+                CFRelease(fMacBundleRef);
+                fMacBundleRef = nullptr;
+                pData->engine->setLastError("Failed to load VST3 bundle executable");
+                return false;
+            }
+
+            v3_getFactory = (V3_GetFactoryFunc)CFBundleGetFunctionPointerForName(fMacBundleRef, CFSTR("GetPluginFactory"));
+
+            if (v3_getFactory == nullptr)
+            {
+                pData->engine->setLastError("Not a VST3 plugin");
+                return false;
+            }
+
+            const V3_ModuleEntryFunc v3_entry = (V3_ModuleEntryFunc)CFBundleGetFunctionPointerForName(fMacBundleRef, CFSTR(V3_ENTRYFNNAME));
+
+            if (v3_entry != nullptr)
+            {
+                if (! v3_entry(fMacBundleRef))
+                {
+                    pData->engine->setLastError("Failed to initialize VST3 module");
+                    return false;
+                }
+
+                fModuleExit = (V3_ModuleExitFunc)CFBundleGetFunctionPointerForName(fMacBundleRef, CFSTR(V3_EXITFNNAME));
+            }
+        }
+#else
+        {
+            // bundles keep the binary inside an architecture specific folder
+            File file(filename);
+
+            if (file.isDirectory())
+            {
+                const String binaryName(file.getFileNameWithoutExtension());
+                file = file.getChildFile("Contents").getChildFile(getVST3BundleArchitecture());
+# ifdef CARLA_OS_WIN
+                file = file.getChildFile(binaryName + ".vst3");
+# else
+                file = file.getChildFile(binaryName + ".so");
+# endif
+            }
+
+            const String binaryFilename(file.getFullPathName());
+
+            if (! pData->libOpen(binaryFilename.toRawUTF8()))
+            {
+                pData->engine->setLastError(pData->libError(binaryFilename.toRawUTF8()));
+                return false;
+            }
+
+            v3_getFactory = pData->libSymbol<V3_GetFactoryFunc>("GetPluginFactory");
+
+            if (v3_getFactory == nullptr)
+            {
+                pData->engine->setLastError("Not a VST3 plugin");
+                return false;
+            }
+
+            // some old plugins do not have this
+            if (const V3_ModuleEntryFunc v3_entry = pData->libSymbol<V3_ModuleEntryFunc>(V3_ENTRYFNNAME))
+            {
+                bool ok = false;
+
+                try {
+# ifdef CARLA_OS_WIN
+                    ok = v3_entry();
+# else
+                    ok = v3_entry(pData->lib);
+# endif
+                } CARLA_SAFE_EXCEPTION("VST3 module entry");
+
+                if (! ok)
+                {
+                    pData->engine->setLastError("Failed to initialize VST3 module");
+                    return false;
+                }
+
+                fModuleExit = pData->libSymbol<V3_ModuleExitFunc>(V3_EXITFNNAME);
+            }
+        }
+#endif
+
+        try {
+            fFactory = v3_getFactory();
+        } CARLA_SAFE_EXCEPTION("VST3 GetPluginFactory");
+
+        if (fFactory == nullptr)
+        {
+            pData->engine->setLastError("VST3 plugin has no factory");
+            return false;
+        }
+
+        // ---------------------------------------------------------------
+        // find the requested class, by unique id, then label, or use the first audio effect
+
+        int32 classIndex = -1;
+
+        try {
+            for (int32 i=0, count=fFactory->countClasses(); i < count; ++i)
+            {
+                PClassInfo classInfo;
+
+                if (fFactory->getClassInfo(i, &classInfo) != kResultOk)
+                    continue;
+                if (std::strcmp(classInfo.category, kVstAudioEffectClass) != 0)
+                    continue;
+
+                if (uniqueId != 0)
+                {
+                    if (getVST3UniqueId(classInfo.cid) != uniqueId)
+                        continue;
+                }
+                else if (label != nullptr && label[0] != '\0')
+                {
+                    if (std::strcmp(classInfo.name, label) != 0)
+                        continue;
+                }
+
+                classIndex = i;
+                std::memcpy(fClassId, classInfo.cid, sizeof(TUID));
+                fLabel = classInfo.name;
+                break;
+            }
+        } CARLA_SAFE_EXCEPTION("VST3 getClassInfo");
+
+        if (classIndex < 0)
+        {
+            pData->engine->setLastError("Could not find the requested plugin in the VST3 module");
+            return false;
+        }
+
+        {
+            PFactoryInfo factoryInfo;
+
+            if (fFactory->getFactoryInfo(&factoryInfo) == kResultOk)
+                fMaker = factoryInfo.vendor;
+        }
+
+        IPluginFactory2* factory2 = nullptr;
+
+        if (fFactory->queryInterface(IPluginFactory2_iid, (void**)&factory2) == kResultOk && factory2 != nullptr)
+        {
+            PClassInfo2 classInfo2;
+
+            if (factory2->getClassInfo2(classIndex, &classInfo2) == kResultOk)
+            {
+                fSubCategories = classInfo2.subCategories;
+
+                if (classInfo2.vendor[0] != '\0')
+                    fMaker = classInfo2.vendor;
+            }
+
+            factory2->release();
+        }
+
+        IPluginFactory3* factory3 = nullptr;
+
+        if (fFactory->queryInterface(IPluginFactory3_iid, (void**)&factory3) == kResultOk && factory3 != nullptr)
+        {
+            factory3->setHostContext(Vst3HostApplication::getInstance());
+            factory3->release();
+        }
+
+        // ---------------------------------------------------------------
+        // create component, processor and controller
+
+        FUnknown* const hostContext = Vst3HostApplication::getInstance();
+
+        try {
+            if (fFactory->createInstance(fClassId, Vst::IComponent_iid, (void**)&fComponent) != kResultOk)
+                fComponent = nullptr;
+        } CARLA_SAFE_EXCEPTION("VST3 createInstance component");
+
+        if (fComponent == nullptr)
+        {
+            pData->engine->setLastError("Failed to create VST3 component");
+            return false;
+        }
+
+        if (fComponent->initialize(hostContext) != kResultOk)
+        {
+            fComponent->release();
+            fComponent = nullptr;
+            pData->engine->setLastError("Failed to initialize VST3 component");
+            return false;
+        }
+
+        if (fComponent->queryInterface(Vst::IAudioProcessor_iid, (void**)&fProcessor) != kResultOk || fProcessor == nullptr)
+        {
+            fProcessor = nullptr;
+            pData->engine->setLastError("VST3 component has no audio processor");
+            return false;
+        }
+
+        if (fComponent->queryInterface(Vst::IEditController_iid, (void**)&fController) == kResultOk && fController != nullptr)
+        {
+            fControllerIsComponent = true;
+        }
+        else
+        {
+            fController = nullptr;
+
+            TUID controllerClassId;
+
+            try {
+                if (fComponent->getControllerClassId(controllerClassId) == kResultOk &&
+                    fFactory->createInstance(controllerClassId, Vst::IEditController_iid, (void**)&fController) != kResultOk)
+                    fController = nullptr;
+            } CARLA_SAFE_EXCEPTION("VST3 createInstance controller");
+
+            if (fController != nullptr && fController->initialize(hostContext) != kResultOk)
+            {
+                carla_stderr2("Failed to initialize VST3 controller, plugin will have no parameters");
+                fController->release();
+                fController = nullptr;
+            }
+        }
+
+        if (fController != nullptr)
+        {
+            // separate component and controller talk through connection points
+            if (! fControllerIsComponent)
+            {
+                if (fComponent->queryInterface(Vst::IConnectionPoint_iid, (void**)&fComponentConnection) != kResultOk)
+                    fComponentConnection = nullptr;
+                if (fController->queryInterface(Vst::IConnectionPoint_iid, (void**)&fControllerConnection) != kResultOk)
+                    fControllerConnection = nullptr;
+
+                if (fComponentConnection != nullptr && fControllerConnection != nullptr)
+                {
+                    fComponentConnection->connect(fControllerConnection);
+                    fControllerConnection->connect(fComponentConnection);
+                }
+            }
+
+            fController->setComponentHandler(&fComponentHandler);
+
+            // sync controller with the component initial state
+            Vst3MemoryStream stream;
+
+            if (fComponent->getState(&stream) == kResultOk)
+            {
+                stream.rewind();
+                fController->setComponentState(&stream);
+            }
+
+            if (fController->queryInterface(Vst::IMidiMapping_iid, (void**)&fMidiMapping) != kResultOk)
+                fMidiMapping = nullptr;
+        }
+
+        // Carla buffers are 32-bit, use 64-bit only for plugins that require it
+        if (fProcessor->canProcessSampleSize(Vst::kSample32) != kResultOk)
+        {
+            if (fProcessor->canProcessSampleSize(Vst::kSample64) != kResultOk)
+            {
+                pData->engine->setLastError("VST3 plugin does not support any known sample size");
+                return false;
+            }
+
+            fUsesDoubles = true;
+        }
+
+        {
+            const int32 count = fComponent->getBusCount(Vst::kEvent, Vst::kInput);
+            fEventInBusCount = count > 0 ? static_cast<uint32_t>(count) : 0;
+        }
+        {
+            const int32 count = fComponent->getBusCount(Vst::kEvent, Vst::kOutput);
+            fEventOutBusCount = count > 0 ? static_cast<uint32_t>(count) : 0;
+        }
+
+        // ---------------------------------------------------------------
+        // get info
+
+        if (name != nullptr && name[0] != '\0')
+            pData->name = pData->engine->getUniquePluginName(name);
+        else if (fLabel.isNotEmpty())
+            pData->name = pData->engine->getUniquePluginName(fLabel);
+        else
+            pData->name = pData->engine->getUniquePluginName("unknown");
+
+        pData->filename = carla_strdup(filename);
+
+        // ---------------------------------------------------------------
+        // register client
+
+        pData->client = pData->engine->addClient(plugin);
+
+        if (pData->client == nullptr || ! pData->client->isOk())
+        {
+            pData->engine->setLastError("Failed to register plugin client");
+            return false;
+        }
+
+        // ---------------------------------------------------------------
+        // set default options
+
+        pData->options = 0x0;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SLEEP_ON_SILENCE))
+            pData->options |= PLUGIN_OPTION_SLEEP_ON_SILENCE;
+
+        if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_ALWAYS_PROCESS))
+            pData->options |= PLUGIN_OPTION_ALWAYS_PROCESS;
+
+        // the plugin state is the only way to save everything
+        pData->options |= PLUGIN_OPTION_USE_CHUNKS;
+
+        if (hasMidiInput())
+        {
+            if (fMidiMapping != nullptr)
+            {
+                if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CONTROL_CHANGES))
+                    pData->options |= PLUGIN_OPTION_SEND_CONTROL_CHANGES;
+                if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_CHANNEL_PRESSURE))
+                    pData->options |= PLUGIN_OPTION_SEND_CHANNEL_PRESSURE;
+                if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_PITCHBEND))
+                    pData->options |= PLUGIN_OPTION_SEND_PITCHBEND;
+            }
+
+            if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_NOTE_AFTERTOUCH))
+                pData->options |= PLUGIN_OPTION_SEND_NOTE_AFTERTOUCH;
+            if (isPluginOptionEnabled(options, PLUGIN_OPTION_SEND_ALL_SOUND_OFF))
+                pData->options |= PLUGIN_OPTION_SEND_ALL_SOUND_OFF;
+            if (isPluginOptionInverseEnabled(options, PLUGIN_OPTION_SKIP_SENDING_NOTES))
+                pData->options |= PLUGIN_OPTION_SKIP_SENDING_NOTES;
+        }
+
+        return true;
+    }
+
+private:
+    // ---------------------------------------------------------------------------------------------------------------
+    // Host-side objects given to the plugin, forwarding to us
+
+    class ComponentHandler : public Vst::IComponentHandler
+    {
+    public:
+        ComponentHandler(CarlaPluginVST3* const plugin) noexcept
+            : fPlugin(plugin) {}
+
+        tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+        {
+            if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, Vst::IComponentHandler_iid))
+            {
+                *obj = this;
+                return kResultOk;
+            }
+
+            *obj = nullptr;
+            return kNoInterface;
+        }
+
+        uint32 PLUGIN_API addRef() override
+        {
+            return 1;
+        }
+
+        uint32 PLUGIN_API release() override
+        {
+            return 1;
+        }
+
+        tresult PLUGIN_API beginEdit(Vst::ParamID) override
+        {
+            return kResultOk;
+        }
+
+        tresult PLUGIN_API performEdit(const Vst::ParamID paramId, const Vst::ParamValue normalized) override
+        {
+            return fPlugin->handlePerformEdit(paramId, normalized);
+        }
+
+        tresult PLUGIN_API endEdit(Vst::ParamID) override
+        {
+            return kResultOk;
+        }
+
+        tresult PLUGIN_API restartComponent(const int32 flags) override
+        {
+            return fPlugin->handleRestartComponentRequest(flags);
+        }
+
+    private:
+        CarlaPluginVST3* const fPlugin;
+
+        CARLA_DECLARE_NON_COPY_CLASS(ComponentHandler)
+    };
+
+    class PlugFrame : public IPlugFrame
+#if SMTG_OS_LINUX
+                    , public Linux::IRunLoop
+#endif
+    {
+    public:
+        PlugFrame(CarlaPluginVST3* const plugin) noexcept
+            : fPlugin(plugin)
+#if SMTG_OS_LINUX
+            , fEventHandlerCount(0),
+              fTimerCount(0)
+#endif
+        {
+#if SMTG_OS_LINUX
+            carla_zeroStructs(fEventHandlers, kMaxHandlers);
+            carla_zeroStructs(fTimers, kMaxHandlers);
+#endif
+        }
+
+        ~PlugFrame() noexcept
+        {
+            clear();
+        }
+
+        tresult PLUGIN_API queryInterface(const TUID iid, void** const obj) override
+        {
+            if (FUnknownPrivate::iidEqual(iid, FUnknown_iid) || FUnknownPrivate::iidEqual(iid, IPlugFrame_iid))
+            {
+                *obj = static_cast<IPlugFrame*>(this);
+                return kResultOk;
+            }
+
+#if SMTG_OS_LINUX
+            if (FUnknownPrivate::iidEqual(iid, Linux::IRunLoop_iid))
+            {
+                *obj = static_cast<Linux::IRunLoop*>(this);
+                return kResultOk;
+            }
+#endif
+
+            *obj = nullptr;
+            return kNoInterface;
+        }
+
+        uint32 PLUGIN_API addRef() override
+        {
+            return 1;
+        }
+
+        uint32 PLUGIN_API release() override
+        {
+            return 1;
+        }
+
+        tresult PLUGIN_API resizeView(IPlugView* const view, ViewRect* const newSize) override
+        {
+            return fPlugin->handleResizeView(view, newSize);
+        }
+
+#if SMTG_OS_LINUX
+        // there is no global event loop on Linux, handlers are run during UI idle
+        tresult PLUGIN_API registerEventHandler(Linux::IEventHandler* const handler, const Linux::FileDescriptor fd) override
+        {
+            CARLA_SAFE_ASSERT_RETURN(handler != nullptr, kInvalidArgument);
+            CARLA_SAFE_ASSERT_RETURN(fd >= 0, kInvalidArgument);
+            CARLA_SAFE_ASSERT_RETURN(fEventHandlerCount < kMaxHandlers, kResultFalse);
+
+            handler->addRef();
+
+            EventHandler& eventHandler(fEventHandlers[fEventHandlerCount++]);
+            eventHandler.handler = handler;
+            eventHandler.fd = fd;
+            return kResultOk;
+        }
+
+        tresult PLUGIN_API unregisterEventHandler(Linux::IEventHandler* const handler) override
+        {
+            for (uint i=0; i < fEventHandlerCount; ++i)
+            {
+                if (fEventHandlers[i].handler != handler)
+                    continue;
+
+                handler->release();
+
+                fEventHandlers[i] = fEventHandlers[--fEventHandlerCount];
+                return kResultOk;
+            }
+
+            return kInvalidArgument;
+        }
+
+        tresult PLUGIN_API registerTimer(Linux::ITimerHandler* const handler, const Linux::TimerInterval milliseconds) override
+        {
+            CARLA_SAFE_ASSERT_RETURN(handler != nullptr, kInvalidArgument);
+            CARLA_SAFE_ASSERT_RETURN(fTimerCount < kMaxHandlers, kResultFalse);
+
+            handler->addRef();
+
+            Timer& timer(fTimers[fTimerCount++]);
+            timer.handler = handler;
+            timer.interval = static_cast<uint32_t>(milliseconds);
+            timer.lastRun = water::Time::getMillisecondCounter();
+            return kResultOk;
+        }
+
+        tresult PLUGIN_API unregisterTimer(Linux::ITimerHandler* const handler) override
+        {
+            for (uint i=0; i < fTimerCount; ++i)
+            {
+                if (fTimers[i].handler != handler)
+                    continue;
+
+                handler->release();
+
+                fTimers[i] = fTimers[--fTimerCount];
+                return kResultOk;
+            }
+
+            return kInvalidArgument;
+        }
+#endif
+
+        void idle()
+        {
+#if SMTG_OS_LINUX
+            // handlers might unregister themselves while being called
+            for (uint i=0; i < fEventHandlerCount; ++i)
+            {
+                const EventHandler eventHandler(fEventHandlers[i]);
+
+                fd_set fds;
+                FD_ZERO(&fds);
+                FD_SET(eventHandler.fd, &fds);
+
+                timeval timeout = { 0, 0 };
+
+                if (select(eventHandler.fd + 1, &fds, nullptr, nullptr, &timeout) > 0)
+                {
+                    try {
+                        eventHandler.handler->onFDIsSet(eventHandler.fd);
+                    } CARLA_SAFE_EXCEPTION("VST3 onFDIsSet");
+                }
+            }
+
+            const uint32_t now = water::Time::getMillisecondCounter();
+
+            for (uint i=0; i < fTimerCount; ++i)
+            {
+                Timer& timer(fTimers[i]);
+
+                if (now - timer.lastRun < timer.interval)
+                    continue;
+
+                timer.lastRun = now;
+
+                try {
+                    timer.handler->onTimer();
+                } CARLA_SAFE_EXCEPTION("VST3 onTimer");
+            }
+#endif
+        }
+
+        // release anything the plugin did not unregister
+        void clear() noexcept
+        {
+#if SMTG_OS_LINUX
+            for (uint i=0; i < fEventHandlerCount; ++i)
+                fEventHandlers[i].handler->release();
+
+            for (uint i=0; i < fTimerCount; ++i)
+                fTimers[i].handler->release();
+
+            fEventHandlerCount = fTimerCount = 0;
+#endif
+        }
+
+    private:
+        CarlaPluginVST3* const fPlugin;
+
+#if SMTG_OS_LINUX
+        enum { kMaxHandlers = 16 };
+
+        struct EventHandler {
+            Linux::IEventHandler* handler;
+            Linux::FileDescriptor fd;
+        } fEventHandlers[kMaxHandlers];
+
+        struct Timer {
+            Linux::ITimerHandler* handler;
+            uint32_t interval;
+            uint32_t lastRun;
+        } fTimers[kMaxHandlers];
+
+        uint fEventHandlerCount;
+        uint fTimerCount;
+#endif
+
+        CARLA_DECLARE_NON_COPY_CLASS(PlugFrame)
+    };
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    // all audio buses of one direction, flattened into consecutive channels
+    struct AudioBuses {
+        uint32_t count;
+        uint32_t channels;
+        Vst::AudioBusBuffers* buses;
+        float** buffers32;
+        double** buffers64;
+
+        AudioBuses() noexcept
+            : count(0),
+              channels(0),
+              buses(nullptr),
+              buffers32(nullptr),
+              buffers64(nullptr) {}
+
+        ~AudioBuses() noexcept
+        {
+            clear();
+        }
+
+        void init(Vst::IComponent* const component, const Vst::BusDirection direction)
+        {
+            clear();
+
+            int32 busCount = 0;
+
+            try {
+                busCount = component->getBusCount(Vst::kAudio, direction);
+            } CARLA_SAFE_EXCEPTION("VST3 getBusCount");
+
+            if (busCount <= 0)
+                return;
+
+            count = static_cast<uint32_t>(busCount);
+            buses = new Vst::AudioBusBuffers[count];
+
+            for (int32 i=0; i < busCount; ++i)
+            {
+                Vst::BusInfo busInfo;
+                carla_zeroStruct(busInfo);
+
+                try {
+                    if (component->getBusInfo(Vst::kAudio, direction, i, busInfo) != kResultOk)
+                        busInfo.channelCount = 0;
+                } CARLA_SAFE_EXCEPTION("VST3 getBusInfo");
+
+                buses[i].numChannels = busInfo.channelCount > 0 ? busInfo.channelCount : 0;
+                channels += static_cast<uint32_t>(buses[i].numChannels);
+
+                if (buses[i].numChannels > 0)
+                {
+                    try {
+                        component->activateBus(Vst::kAudio, direction, i, true);
+                    } CARLA_SAFE_EXCEPTION("VST3 activateBus");
+                }
+            }
+
+            buffers32 = new float*[channels > 0 ? channels : 1];
+            carla_zeroPointers(buffers32, channels > 0 ? channels : 1);
+
+            for (uint32_t i=0, offset=0; i < count; ++i)
+            {
+                buses[i].channelBuffers32 = buffers32 + offset;
+                offset += static_cast<uint32_t>(buses[i].numChannels);
+            }
+        }
+
+        // 64-bit processing needs its own buffers, converted on each audio block
+        void resizeBuffers64(const uint32_t bufferSize)
+        {
+            if (buffers64 == nullptr)
+            {
+                buffers64 = new double*[channels > 0 ? channels : 1];
+                carla_zeroPointers(buffers64, channels > 0 ? channels : 1);
+            }
+
+            for (uint32_t i=0; i < channels; ++i)
+            {
+                delete[] buffers64[i];
+                buffers64[i] = new double[bufferSize];
+                carla_zeroStructs(buffers64[i], bufferSize);
+            }
+
+            for (uint32_t i=0, offset=0; i < count; ++i)
+            {
+                buses[i].channelBuffers64 = buffers64 + offset;
+                offset += static_cast<uint32_t>(buses[i].numChannels);
+            }
+        }
+
+        void clear() noexcept
+        {
+            if (buffers64 != nullptr)
+            {
+                for (uint32_t i=0; i < channels; ++i)
+                    delete[] buffers64[i];
+
+                delete[] buffers64;
+                buffers64 = nullptr;
+            }
+
+            delete[] buffers32;
+            delete[] buses;
+            buffers32 = nullptr;
+            buses = nullptr;
+            count = channels = 0;
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(AudioBuses)
+    };
+
+    struct ParamIdMapping {
+        Vst::ParamID id;
+        uint32_t index;
+
+        bool operator<(const ParamIdMapping& other) const noexcept
+        {
+            return id < other.id;
+        }
+    };
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    V3_ModuleExitFunc fModuleExit;
+#ifdef CARLA_OS_MAC
+    CFBundleRef fMacBundleRef;
+#endif
+
+    IPluginFactory*        fFactory;
+    Vst::IComponent*       fComponent;
+    Vst::IAudioProcessor*  fProcessor;
+    Vst::IEditController*  fController;
+    Vst::IConnectionPoint* fComponentConnection;
+    Vst::IConnectionPoint* fControllerConnection;
+    Vst::IMidiMapping*     fMidiMapping;
+    bool fControllerIsComponent; // single component plugin, same object
+
+    TUID fClassId;
+    CarlaString fLabel;
+    CarlaString fMaker;
+    CarlaString fSubCategories;
+
+    ComponentHandler fComponentHandler;
+    PlugFrame fPlugFrame;
+
+    uint32_t fEventInBusCount;
+    uint32_t fEventOutBusCount;
+
+    bool fUsesDoubles;
+    uint32_t fBufferSize;
+    uint32_t fLatency;
+    uint32_t fCurrentEventTime; // time of the event being processed, used for sample-accurate changes
+    volatile int32 fRestartFlags;
+    void* fLastChunk;
+
+    Vst::ProcessContext fContext;
+    Vst::ProcessData fProcessData;
+
+    AudioBuses fAudioIns;
+    AudioBuses fAudioOuts;
+    float** fDryBuffers;
+
+    Vst3EventList fInputEvents;
+    Vst3EventList fOutputEvents;
+    Vst3ParameterChanges fInputParameterChanges;
+    Vst3ParameterChanges fOutputParameterChanges;
+
+    Vst::ParamID* fParamIds;
+    ParamIdMapping* fParamIdMap; // sorted by id
+    float* fParamValues;         // current values, as used by Carla
+    Vst3ParameterSync fProcessorParamSync;
+    Vst3ParameterSync fControllerParamSync;
+    uint32_t* fMidiControllerMap;
+
+    struct UI {
+        bool isAttached;
+        bool isVisible;
+        IPlugView* view;
+        CarlaPluginUI* window;
+
+        UI() noexcept
+            : isAttached(false),
+              isVisible(false),
+              view(nullptr),
+              window(nullptr) {}
+
+        ~UI()
+        {
+            CARLA_ASSERT(! isVisible);
+            CARLA_ASSERT(view == nullptr);
+
+            if (window != nullptr)
+            {
+                delete window;
+                window = nullptr;
+            }
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(UI);
+    } fUI;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginVST3)
+};
+
+// -------------------------------------------------------------------------------------------------------------------
+
 CarlaPluginPtr CarlaPlugin::newVST3(const Initializer& init)
 {
-    carla_debug("CarlaPlugin::newVST3({%p, \"%s\", \"%s\", " P_INT64 "})",
-                init.engine, init.filename, init.name, init.uniqueId);
+    carla_debug("CarlaPlugin::newVST3({%p, \"%s\", \"%s\", \"%s\", " P_INT64 "})",
+                init.engine, init.filename, init.name, init.label, init.uniqueId);
 
-#ifdef USING_JUCE
-    return newJuce(init, "VST3");
-#else
-    init.engine->setLastError("VST3 support not available");
-    return nullptr;
+#ifdef USE_JUCE_FOR_VST3
+    if (std::getenv("CARLA_DO_NOT_USE_JUCE_FOR_VST3") == nullptr)
+        return newJuce(init, "VST3");
 #endif
+
+    std::shared_ptr<CarlaPluginVST3> plugin(new CarlaPluginVST3(init.engine, init.id));
+
+    if (! plugin->init(plugin, init.filename, init.name, init.label, init.uniqueId, init.options))
+        return nullptr;
+
+    return plugin;
 }
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -20,6 +20,7 @@
 #include "CarlaNative.h"
 #include "CarlaString.hpp"
 #include "CarlaBackendUtils.hpp"
+#include "CarlaLv2CacheUtils.hpp"
 #include "CarlaLv2Utils.hpp"
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -30,6 +31,8 @@
 #include "water/containers/Array.h"
 #include "water/files/File.h"
 
+#include <algorithm>
+
 namespace CB = CarlaBackend;
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -521,6 +524,174 @@ static const CarlaCachedPluginInfo* get_cached_plugin_lv2(Lv2WorldClass& lv2Worl
     return &info;
 }
 
+static void fill_cached_plugin_lv2(Lv2CachedPluginInfo& cinfo, Lv2WorldClass& lv2World, Lilv::Plugin& lilvPlugin)
+{
+    const CarlaCachedPluginInfo* const info(get_cached_plugin_lv2(lv2World, lilvPlugin));
+
+    cinfo.valid         = info->valid;
+    cinfo.category      = info->category;
+    cinfo.hints         = info->hints;
+    cinfo.audioIns      = info->audioIns;
+    cinfo.audioOuts     = info->audioOuts;
+    cinfo.cvIns         = info->cvIns;
+    cinfo.cvOuts        = info->cvOuts;
+    cinfo.midiIns       = info->midiIns;
+    cinfo.midiOuts      = info->midiOuts;
+    cinfo.parameterIns  = info->parameterIns;
+    cinfo.parameterOuts = info->parameterOuts;
+    cinfo.uri           = lilvPlugin.get_uri().as_uri();
+    cinfo.label         = info->label;
+    cinfo.name          = info->name;
+    cinfo.maker         = info->maker;
+    cinfo.copyright     = info->copyright;
+    cinfo.binary.clear();
+
+    if (char* const binary = lilv_file_uri_parse(lilvPlugin.get_library_uri().as_uri(), nullptr))
+    {
+        cinfo.binary = binary;
+        lilv_free(binary);
+    }
+}
+
+static const CarlaCachedPluginInfo* get_cached_plugin_lv2(const Lv2CachedPluginInfo& cinfo)
+{
+    static CarlaCachedPluginInfo info;
+
+    info.valid         = cinfo.valid;
+    info.category      = static_cast<CB::PluginCategory>(cinfo.category);
+    info.hints         = cinfo.hints;
+    info.audioIns      = cinfo.audioIns;
+    info.audioOuts     = cinfo.audioOuts;
+    info.cvIns         = cinfo.cvIns;
+    info.cvOuts        = cinfo.cvOuts;
+    info.midiIns       = cinfo.midiIns;
+    info.midiOuts      = cinfo.midiOuts;
+    info.parameterIns  = cinfo.parameterIns;
+    info.parameterOuts = cinfo.parameterOuts;
+    info.name          = cinfo.name;
+    info.label         = cinfo.label;
+    info.maker         = cinfo.maker;
+    info.copyright     = cinfo.copyright;
+    return &info;
+}
+
+// -------------------------------------------------------------------------------------------------------------------
+
+static std::vector<Lv2CachedPluginInfo> gLV2s;
+
+static water::String getLv2BundleKey(const water::String& bundle)
+{
+    // lilv joins LV2_PATH dirs and bundle names with '/', which can lead to double separators
+    return water::File(bundle.replace("//", "/")).getFullPathName();
+}
+
+static bool compareLv2PluginURIs(const Lv2CachedPluginInfo& a, const Lv2CachedPluginInfo& b)
+{
+    return std::strcmp(a.uri, b.uri) < 0;
+}
+
+// list LV2 plugins from the RDF cache, or from lilv if any bundle in the path is new or changed
+static void findLV2s(const char* lv2Paths)
+{
+    gLV2s.clear();
+
+    if (lv2Paths == nullptr || lv2Paths[0] == '\0')
+        lv2Paths = LILV_DEFAULT_LV2_PATH;
+
+    // same bundles and order as lilv, which loads every dir with a manifest
+    std::vector<Lv2CachedBundle> bundles;
+    water::HashMap<water::String, int> bundleIndexes;
+
+    const water::StringArray splitPaths(water::StringArray::fromTokens(lv2Paths, CARLA_OS_SPLIT_STR, ""));
+
+    for (water::String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
+    {
+        if (it->isEmpty())
+            continue;
+
+        water::Array<water::File> results;
+
+        if (water::File(*it).findChildFiles(results, water::File::findDirectories, false) == 0)
+            continue;
+
+        for (int i=0, count=results.size(); i < count; ++i)
+        {
+            const water::File& bundleDir(results.getReference(i));
+
+            if (! bundleDir.getChildFile("manifest.ttl").existsAsFile())
+                continue;
+
+            const water::String key(getLv2BundleKey(bundleDir.getFullPathName()));
+
+            if (bundleIndexes.contains(key))
+                continue;
+
+            bundleIndexes.set(key, static_cast<int>(bundles.size()));
+            bundles.push_back(Lv2CachedBundle());
+            bundles.back().bundle = key.toRawUTF8();
+        }
+    }
+
+    Lv2RdfCache& lv2RdfCache(Lv2RdfCache::getInstance());
+
+    if (lv2RdfCache.lookupPath(lv2Paths, bundles))
+    {
+        // lilv lists each URI once, sorted
+        water::HashMap<water::String, bool> seenURIs;
+
+        for (std::size_t i=0; i < bundles.size(); ++i)
+        {
+            for (std::size_t j=0; j < bundles[i].plugins.size(); ++j)
+            {
+                const Lv2CachedPluginInfo& cinfo(bundles[i].plugins[j]);
+                const water::String uri(cinfo.uri.buffer());
+
+                if (seenURIs.contains(uri))
+                    continue;
+
+                seenURIs.set(uri, true);
+                gLV2s.push_back(cinfo);
+            }
+        }
+
+        std::sort(gLV2s.begin(), gLV2s.end(), compareLv2PluginURIs);
+        return;
+    }
+
+    Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
+    // the LV2 world is only loaded once, results of an earlier different path must not be cached
+    const bool loadsPath = lv2World.needsInit;
+    lv2World.initIfNeeded(lv2Paths);
+
+    for (std::size_t i=0; i < bundles.size(); ++i)
+        bundles[i].plugins.clear();
+
+    for (uint i=0, count=lv2World.getPluginCount(); i < count; ++i)
+    {
+        const LilvPlugin* const cPlugin(lv2World.getPluginFromIndex(i));
+        CARLA_SAFE_ASSERT_CONTINUE(cPlugin != nullptr);
+
+        Lilv::Plugin lilvPlugin(cPlugin);
+        CARLA_SAFE_ASSERT_CONTINUE(lilvPlugin.get_uri().is_uri());
+
+        gLV2s.push_back(Lv2CachedPluginInfo());
+        fill_cached_plugin_lv2(gLV2s.back(), lv2World, lilvPlugin);
+
+        if (char* const bundle = lilv_file_uri_parse(lilvPlugin.get_bundle_uri().as_uri(), nullptr))
+        {
+            const water::String key(getLv2BundleKey(bundle));
+            lilv_free(bundle);
+
+            if (bundleIndexes.contains(key))
+                bundles[static_cast<std::size_t>(bundleIndexes[key])].plugins.push_back(gLV2s.back());
+        }
+    }
+
+    if (loadsPath)
+        lv2RdfCache.storePath(lv2Paths, bundles);
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -632,9 +803,8 @@ uint carla_get_cached_plugin_count(CB::PluginType ptype, const char* pluginPath)
     }
 
     case CB::PLUGIN_LV2: {
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-        lv2World.initIfNeeded(pluginPath);
-        return lv2World.getPluginCount();
+        findLV2s(pluginPath);
+        return static_cast<uint>(gLV2s.size());
     }
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -671,15 +841,8 @@ const CarlaCachedPluginInfo* carla_get_cached_plugin_info(CB::PluginType ptype,
     }
 
     case CB::PLUGIN_LV2: {
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-
-        const LilvPlugin* const cPlugin(lv2World.getPluginFromIndex(index));
-        CARLA_SAFE_ASSERT_BREAK(cPlugin != nullptr);
-
-        Lilv::Plugin lilvPlugin(cPlugin);
-        CARLA_SAFE_ASSERT_BREAK(lilvPlugin.get_uri().is_uri());
-
-        return get_cached_plugin_lv2(lv2World, lilvPlugin);
+        CARLA_SAFE_ASSERT_BREAK(index < static_cast<uint>(gLV2s.size()));
+        return get_cached_plugin_lv2(gLV2s[index]);
     }
 
 #if defined(USING_JUCE) && defined(CARLA_OS_MAC)
@@ -21,8 +21,10 @@
 
 #include "CarlaEngine.hpp"
 #include "CarlaHost.h"
+#include "CarlaHostImpl.hpp"
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaBridgeUtils.hpp"
 #include "CarlaJuceUtils.hpp"
 #include "CarlaMainLoop.hpp"
 #include "CarlaMIDI.h"
@@ -382,14 +384,462 @@ private:
 
 // -------------------------------------------------------------------------
 
+static CarlaString getClientName(const char* const name, const CarlaBackend::PluginType itype,
+                                 const char* const label, const File& file)
+{
+    CarlaString clientName;
+
+    if (name != nullptr)
+    {
+        clientName = name;
+    }
+    else if (itype == CarlaBackend::PLUGIN_LV2)
+    {
+        // LV2 requires URI
+        CARLA_SAFE_ASSERT_RETURN(label != nullptr && label[0] != '\0', CarlaString("carla-plugin"));
+
+        // LV2 URI is not usable as client name, create a usable name from URI
+        CarlaString label2(label);
+
+        // truncate until last valid char
+        for (std::size_t i=label2.length()-1; i != 0; --i)
+        {
+            if (! std::isalnum(label2[i]))
+                continue;
+
+            label2.truncate(i+1);
+            break;
+        }
+
+        // get last used separator
+        bool found;
+        std::size_t septmp, sep = 0;
+
+        septmp = label2.rfind('#', &found)+1;
+        if (found && septmp > sep)
+            sep = septmp;
+
+        septmp = label2.rfind('/', &found)+1;
+        if (found && septmp > sep)
+            sep = septmp;
+
+        septmp = label2.rfind('=', &found)+1;
+        if (found && septmp > sep)
+            sep = septmp;
+
+        septmp = label2.rfind(':', &found)+1;
+        if (found && septmp > sep)
+            sep = septmp;
+
+        // make name starting from the separator and first valid char
+        const char* name2 = label2.buffer() + sep;
+        for (; *name2 != '\0' && ! std::isalnum(*name2); ++name2) {}
+
+        if (*name2 != '\0')
+            clientName = name2;
+    }
+    else if (label != nullptr)
+    {
+        clientName = label;
+    }
+    else
+    {
+        clientName = file.getFileNameWithoutExtension().toRawUTF8();
+    }
+
+    // if we still have no client name by now, use a dummy one
+    if (clientName.isEmpty())
+        clientName = "carla-plugin";
+
+    // just to be safe
+    clientName.toBasic();
+
+    return clientName;
+}
+
+// -------------------------------------------------------------------------
+
+static void initProcess(const bool testing)
+{
+#ifdef CARLA_OS_WIN
+    OleInitialize(nullptr);
+    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+# ifndef __WINPTHREADS_VERSION
+    // (non-portable) initialization of statically linked pthread library
+    pthread_win32_process_attach_np();
+    pthread_win32_thread_attach_np();
+# endif
+#endif
+
+#ifdef HAVE_X11
+    if (std::getenv("DISPLAY") != nullptr)
+        XInitThreads();
+#endif
+
+    // ---------------------------------------------------------------------
+    // Set ourselves with high priority
+
+#ifdef CARLA_OS_LINUX
+    // reset scheduler to normal mode
+    struct sched_param sparam;
+    carla_zeroStruct(sparam);
+    sched_setscheduler(0, SCHED_OTHER|SCHED_RESET_ON_FORK, &sparam);
+
+    // try niceness first, if it fails, try SCHED_RR
+    if (nice(-5) < 0)
+    {
+        sparam.sched_priority = (sched_get_priority_max(SCHED_RR) + sched_get_priority_min(SCHED_RR*7)) / 8;
+
+        if (sparam.sched_priority > 0)
+        {
+            if (sched_setscheduler(0, SCHED_RR|SCHED_RESET_ON_FORK, &sparam) < 0 && ! testing)
+            {
+                CarlaString error(std::strerror(errno));
+                carla_stderr("Failed to set high priority, error %i: %s", errno, error.buffer());
+            }
+        }
+    }
+#endif
+
+#ifdef CARLA_OS_WIN
+    if (! SetPriorityClass(GetCurrentProcess(), ABOVE_NORMAL_PRIORITY_CLASS) && ! testing)
+        carla_stderr("Failed to set high priority.");
+#endif
+
+    // ---------------------------------------------------------------------
+    // Listen for ctrl+c or sigint/sigterm events
+
+    initSignalHandler();
+    return;
+
+    // maybe unused
+    (void)testing;
+}
+
+static void closeProcess()
+{
+#ifdef CARLA_OS_WIN
+#ifndef __WINPTHREADS_VERSION
+    pthread_win32_thread_detach_np();
+    pthread_win32_process_detach_np();
+#endif
+    CoUninitialize();
+    OleUninitialize();
+#endif
+}
+
+// -------------------------------------------------------------------------
+// Process pool mode, a single process hosting several plugins, each with its own bridge engine and RT round-trip.
+// Plugins are requested by the host through a shared control buffer, see CarlaPluginBridgePool.
+
+class CarlaBridgePluginPool
+{
+public:
+    CarlaBridgePluginPool(const CarlaBackend::BinaryType btype)
+        : kBinaryType(btype),
+#ifdef USING_JUCE
+          fJuceInitialiser(),
+#endif
+          fShmPoolControl()
+    {
+        for (uint i=0; i < kPluginBridgePoolMaxSize; ++i)
+        {
+            fSlots[i].closeNow = false;
+            carla_set_engine_callback(&fSlots[i].handle, callback, &fSlots[i]);
+        }
+    }
+
+    ~CarlaBridgePluginPool()
+    {
+        for (uint i=0; i < kPluginBridgePoolMaxSize; ++i)
+            closeSlot(fSlots[i]);
+
+        fShmPoolControl.clear();
+    }
+
+    bool init(const char* const poolBaseName)
+    {
+        CARLA_SAFE_ASSERT_RETURN(poolBaseName != nullptr && std::strlen(poolBaseName) == 6, false);
+
+        if (! fShmPoolControl.attachClient(poolBaseName))
+        {
+            carla_stderr("Failed to attach to bridge process pool shared memory");
+            return false;
+        }
+
+        if (! fShmPoolControl.mapData())
+        {
+            carla_stderr("Failed to map bridge process pool shared memory");
+            fShmPoolControl.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void exec()
+    {
+        gIsInitiated = true;
+
+        for (; runMainLoopOnce() && ! gCloseNow;)
+        {
+            handleNonRtData();
+
+            for (uint i=0; i < kPluginBridgePoolMaxSize; ++i)
+            {
+                Slot& slot(fSlots[i]);
+
+                if (slot.handle.engine == nullptr)
+                    continue;
+
+                carla_engine_idle(&slot.handle);
+
+                if (slot.closeNow)
+                    closeSlot(slot);
+            }
+
+# if defined(CARLA_OS_MAC) || defined(CARLA_OS_WIN)
+            carla_msleep(1);
+# else
+            carla_msleep(5);
+# endif
+        }
+    }
+
+private:
+    struct Slot {
+        CarlaHostStandalone handle;
+        volatile bool closeNow;
+    };
+
+    const CarlaBackend::BinaryType kBinaryType;
+
+#ifdef USING_JUCE
+    const juce::ScopedJuceInitialiser_GUI fJuceInitialiser;
+#endif
+
+    BridgeNonRtClientControl fShmPoolControl;
+    Slot fSlots[kPluginBridgePoolMaxSize];
+
+    void handleNonRtData()
+    {
+        for (; fShmPoolControl.isDataAvailableForReading();)
+        {
+            const PluginBridgePoolOpcode opcode = static_cast<PluginBridgePoolOpcode>(fShmPoolControl.readUInt());
+
+            carla_debug("CarlaBridgePluginPool::handleNonRtData() - got opcode: %s", PluginBridgePoolOpcode2str(opcode));
+
+            switch (opcode)
+            {
+            case kPluginBridgePoolNull:
+                break;
+
+            case kPluginBridgePoolAddPlugin: {
+                // shm ids
+                const uint32_t shmIdsSize(fShmPoolControl.readUInt());
+                CARLA_SAFE_ASSERT_RETURN(shmIdsSize == 6*4,);
+
+                char shmIds[6*4+1];
+                carla_zeroChars(shmIds, 6*4+1);
+                fShmPoolControl.readCustomData(shmIds, shmIdsSize);
+
+                // type
+                const CarlaBackend::PluginType itype(static_cast<CarlaBackend::PluginType>(fShmPoolControl.readUInt()));
+
+                // filename
+                // sizes come from shared memory, never trust them for stack allocations
+                const uint32_t filenameSize(fShmPoolControl.readUInt());
+                CARLA_SAFE_ASSERT_UINT_RETURN(filenameSize < BigStackBuffer::size, filenameSize,);
+
+                char filename[BigStackBuffer::size];
+                carla_zeroChars(filename, filenameSize+1);
+
+                if (filenameSize > 0)
+                    fShmPoolControl.readCustomData(filename, filenameSize);
+
+                // label
+                const uint32_t labelSize(fShmPoolControl.readUInt());
+                CARLA_SAFE_ASSERT_UINT_RETURN(labelSize < BigStackBuffer::size, labelSize,);
+
+                char label[BigStackBuffer::size];
+                carla_zeroChars(label, labelSize+1);
+
+                if (labelSize > 0)
+                    fShmPoolControl.readCustomData(label, labelSize);
+
+                // uniqueId
+                const int64_t uniqueId(fShmPoolControl.readLong());
+
+                addPlugin(shmIds, itype,
+                          (filename[0] != '\0' && std::strcmp(filename, "(none)") != 0) ? filename : nullptr,
+                          (label[0] != '\0' && std::strcmp(label, "(none)") != 0) ? label : nullptr,
+                          uniqueId);
+                break;
+            }
+
+            case kPluginBridgePoolQuit:
+                gCloseNow = true;
+                break;
+            }
+        }
+    }
+
+    void addPlugin(const char* const shmIds, const CarlaBackend::PluginType itype,
+                   const char* const filename, const char* label, const int64_t uniqueId)
+    {
+        Slot* slot = nullptr;
+
+        for (uint i=0; i < kPluginBridgePoolMaxSize; ++i)
+        {
+            if (fSlots[i].handle.engine != nullptr)
+                continue;
+
+            slot = &fSlots[i];
+            break;
+        }
+
+        // host will timeout waiting for us
+        CARLA_SAFE_ASSERT_RETURN(slot != nullptr,);
+
+        char audioPoolBaseName[6+1];
+        char rtClientBaseName[6+1];
+        char nonRtClientBaseName[6+1];
+        char nonRtServerBaseName[6+1];
+
+        std::memcpy(audioPoolBaseName,   shmIds+6*0, 6);
+        std::memcpy(rtClientBaseName,    shmIds+6*1, 6);
+        std::memcpy(nonRtClientBaseName, shmIds+6*2, 6);
+        std::memcpy(nonRtServerBaseName, shmIds+6*3, 6);
+        audioPoolBaseName[6]   = '\0';
+        rtClientBaseName[6]    = '\0';
+        nonRtClientBaseName[6] = '\0';
+        nonRtServerBaseName[6] = '\0';
+
+        const File file(filename != nullptr ? filename : "");
+        const CarlaString clientName(getClientName(nullptr, itype, label, file));
+
+        const void* extraStuff = nullptr;
+
+        if (itype == CarlaBackend::PLUGIN_SF2)
+        {
+            if (label == nullptr)
+                label = clientName;
+
+            if (std::strstr(label, " (16 outs)") != nullptr)
+                extraStuff = "true";
+        }
+
+        slot->closeNow = false;
+
+        if (! carla_engine_init_bridge(&slot->handle,
+                                       audioPoolBaseName,
+                                       rtClientBaseName,
+                                       nonRtClientBaseName,
+                                       nonRtServerBaseName,
+                                       clientName))
+        {
+            carla_stderr("Failed to init engine, error was:\n%s", carla_get_last_error(&slot->handle));
+            return;
+        }
+
+        if (! carla_add_plugin(&slot->handle,
+                               kBinaryType, itype,
+                               file.getFullPathName().toRawUTF8(), nullptr, label, uniqueId, extraStuff, 0x0))
+        {
+            carla_stderr("Plugin failed to load, error was:\n%s", carla_get_last_error(&slot->handle));
+
+            // do a single idle so that we can send error message to server
+            carla_engine_idle(&slot->handle);
+            closeSlot(*slot);
+        }
+    }
+
+    static void closeSlot(Slot& slot)
+    {
+        CarlaEngine* const engine = slot.handle.engine;
+
+        if (engine == nullptr)
+            return;
+
+        // not using carla_engine_close(), as that also shuts down JUCE for all other plugins
+        engine->setAboutToClose();
+        engine->removeAllPlugins();
+        engine->close();
+
+        slot.handle.engine = nullptr;
+        slot.closeNow = false;
+        delete engine;
+    }
+
+    static void callback(void* ptr, EngineCallbackOpcode action, unsigned int,
+                         int, int, int, float, const char*)
+    {
+        CARLA_SAFE_ASSERT_RETURN(ptr != nullptr,);
+
+        switch (action)
+        {
+        case CarlaBackend::ENGINE_CALLBACK_ENGINE_STOPPED:
+        case CarlaBackend::ENGINE_CALLBACK_PLUGIN_REMOVED:
+        case CarlaBackend::ENGINE_CALLBACK_QUIT:
+            static_cast<Slot*>(ptr)->closeNow = true;
+            break;
+        default:
+            break;
+        }
+    }
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaBridgePluginPool)
+};
+
+static int runPool(const char* const poolBaseName)
+{
+    CarlaBackend::BinaryType btype = CarlaBackend::BINARY_NATIVE;
+
+    if (const char* const binaryTypeStr = std::getenv("CARLA_BRIDGE_PLUGIN_BINARY_TYPE"))
+        btype = CarlaBackend::getBinaryTypeFromString(binaryTypeStr);
+
+    if (btype == CarlaBackend::BINARY_NONE)
+    {
+        carla_stderr("Invalid binary type '%i'", btype);
+        return 1;
+    }
+
+    jackbridge_parent_deathsig(false);
+    initProcess(false);
+
+    int ret;
+
+    {
+        CarlaBridgePluginPool pool(btype);
+
+        if (pool.init(poolBaseName))
+        {
+            pool.exec();
+            ret = 0;
+        }
+        else
+        {
+            ret = 1;
+        }
+    }
+
+    closeProcess();
+    return ret;
+}
+
+// -------------------------------------------------------------------------
+
 int main(int argc, char* argv[])
 {
     // ---------------------------------------------------------------------
     // Check argument count
 
-    if (argc != 4 && argc != 5)
+    const bool usePool = (argc == 3 && std::strcmp(argv[1], "--pool") == 0);
+
+    if (argc != 4 && argc != 5 && ! usePool)
     {
         carla_stdout("usage: %s <type> <filename> <label> [uniqueId]", argv[0]);
+        carla_stdout("       %s --pool <shm-id>", argv[0]);
         return 1;
     }
 
@@ -404,6 +854,9 @@ int main(int argc, char* argv[])
     }
 #endif
 
+    if (usePool)
+        return runPool(argv[2]);
+
     // ---------------------------------------------------------------------
     // Get args
 
@@ -496,72 +949,13 @@ int main(int argc, char* argv[])
     // ---------------------------------------------------------------------
     // Set client name
 
-    CarlaString clientName;
-
-    if (name != nullptr)
+    // LV2 requires URI
+    if (itype == CarlaBackend::PLUGIN_LV2 && name == nullptr)
     {
-        clientName = name;
-    }
-    else if (itype == CarlaBackend::PLUGIN_LV2)
-    {
-        // LV2 requires URI
         CARLA_SAFE_ASSERT_RETURN(label != nullptr && label[0] != '\0', 1);
-
-        // LV2 URI is not usable as client name, create a usable name from URI
-        CarlaString label2(label);
-
-        // truncate until last valid char
-        for (std::size_t i=label2.length()-1; i != 0; --i)
-        {
-            if (! std::isalnum(label2[i]))
-                continue;
-
-            label2.truncate(i+1);
-            break;
-        }
-
-        // get last used separator
-        bool found;
-        std::size_t septmp, sep = 0;
-
-        septmp = label2.rfind('#', &found)+1;
-        if (found && septmp > sep)
-            sep = septmp;
-
-        septmp = label2.rfind('/', &found)+1;
-        if (found && septmp > sep)
-            sep = septmp;
-
-        septmp = label2.rfind('=', &found)+1;
-        if (found && septmp > sep)
-            sep = septmp;
-
-        septmp = label2.rfind(':', &found)+1;
-        if (found && septmp > sep)
-            sep = septmp;
-
-        // make name starting from the separator and first valid char
-        const char* name2 = label2.buffer() + sep;
-        for (; *name2 != '\0' && ! std::isalnum(*name2); ++name2) {}
-
-        if (*name2 != '\0')
-            clientName = name2;
-    }
-    else if (label != nullptr)
-    {
-        clientName = label;
-    }
-    else
-    {
-        clientName = file.getFileNameWithoutExtension().toRawUTF8();
     }
 
-    // if we still have no client name by now, use a dummy one
-    if (clientName.isEmpty())
-        clientName = "carla-plugin";
-
-    // just to be safe
-    clientName.toBasic();
+    const CarlaString clientName(getClientName(name, itype, label, file));
 
     // ---------------------------------------------------------------------
     // Set extraStuff
@@ -582,55 +976,7 @@ int main(int argc, char* argv[])
 
     const bool testing = std::getenv("CARLA_BRIDGE_TESTING") != nullptr;
 
-#ifdef CARLA_OS_WIN
-    OleInitialize(nullptr);
-    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-# ifndef __WINPTHREADS_VERSION
-    // (non-portable) initialization of statically linked pthread library
-    pthread_win32_process_attach_np();
-    pthread_win32_thread_attach_np();
-# endif
-#endif
-
-#ifdef HAVE_X11
-    if (std::getenv("DISPLAY") != nullptr)
-        XInitThreads();
-#endif
-
-    // ---------------------------------------------------------------------
-    // Set ourselves with high priority
-
-#ifdef CARLA_OS_LINUX
-    // reset scheduler to normal mode
-    struct sched_param sparam;
-    carla_zeroStruct(sparam);
-    sched_setscheduler(0, SCHED_OTHER|SCHED_RESET_ON_FORK, &sparam);
-
-    // try niceness first, if it fails, try SCHED_RR
-    if (nice(-5) < 0)
-    {
-        sparam.sched_priority = (sched_get_priority_max(SCHED_RR) + sched_get_priority_min(SCHED_RR*7)) / 8;
-
-        if (sparam.sched_priority > 0)
-        {
-            if (sched_setscheduler(0, SCHED_RR|SCHED_RESET_ON_FORK, &sparam) < 0 && ! testing)
-            {
-                CarlaString error(std::strerror(errno));
-                carla_stderr("Failed to set high priority, error %i: %s", errno, error.buffer());
-            }
-        }
-    }
-#endif
-
-#ifdef CARLA_OS_WIN
-    if (! SetPriorityClass(GetCurrentProcess(), ABOVE_NORMAL_PRIORITY_CLASS) && ! testing)
-        carla_stderr("Failed to set high priority.");
-#endif
-
-    // ---------------------------------------------------------------------
-    // Listen for ctrl+c or sigint/sigterm events
-
-    initSignalHandler();
+    initProcess(testing);
 
     // ---------------------------------------------------------------------
     // Init plugin bridge
@@ -704,14 +1050,7 @@ int main(int argc, char* argv[])
         }
     }
 
-#ifdef CARLA_OS_WIN
-#ifndef __WINPTHREADS_VERSION
-    pthread_win32_thread_detach_np();
-    pthread_win32_process_detach_np();
-#endif
-    CoUninitialize();
-    OleUninitialize();
-#endif
+    closeProcess();
 
     return ret;
 }
@@ -112,7 +112,8 @@ bool CarlaBridgeFormat::msgReceived(const char* const msg) noexcept
 {
     carla_debug("CarlaBridgeFormat::msgReceived(\"%s\")", msg);
 
-    if (! fGotOptions && std::strcmp(msg, "urid") != 0 && std::strcmp(msg, "uiOptions") != 0)
+    if (! fGotOptions && std::strcmp(msg, "urid") != 0 && std::strcmp(msg, "urids") != 0
+                      && std::strcmp(msg, "uiOptions") != 0)
     {
         carla_stderr2("CarlaBridgeFormat::msgReceived(\"%s\") - invalid message while waiting for options", msg);
         return true;
@@ -165,6 +166,26 @@ bool CarlaBridgeFormat::msgReceived(const char* const msg) noexcept
         return true;
     }
 
+    if (std::strcmp(msg, "urids") == 0)
+    {
+        uint32_t firstUrid, count, size;
+        const char* uri;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(firstUrid), true);
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(count), true);
+
+        for (uint32_t i=0; i<count; ++i)
+        {
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(size), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(uri, false, size), true);
+
+            if (firstUrid != 0)
+                dspURIDReceived(firstUrid + i, uri);
+        }
+
+        return true;
+    }
+
     if (std::strcmp(msg, "control") == 0)
     {
         uint32_t index;
@@ -16,6 +16,7 @@
  */
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaCacheUtils.hpp"
 #include "CarlaLibUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
@@ -77,6 +78,21 @@
 
 #include <iostream>
 
+#ifdef CARLA_OS_UNIX
+# include <ctime>
+# include <list>
+# include <map>
+# include <string>
+# include <vector>
+# include <fcntl.h>
+# include <poll.h>
+# include <signal.h>
+# include <sys/stat.h>
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+#include "water/files/DirectoryIterator.h"
 #include "water/files/File.h"
 
 #ifndef BUILD_BRIDGE
@@ -724,8 +740,56 @@ static void do_dssi_check(lib_t& libHandle, const char* const filename, const bo
 }
 
 #ifndef BUILD_BRIDGE
+static bool do_lv2_lib_check(const char* const binary)
+{
+    // test if lib is loadable, twice
+    const lib_t libHandle1 = lib_open(binary);
+
+    if (libHandle1 == nullptr)
+    {
+        print_lib_error(binary);
+        return false;
+    }
+
+    lib_close(libHandle1);
+
+    const lib_t libHandle2 = lib_open(binary);
+
+    if (libHandle2 == nullptr)
+    {
+        print_lib_error(binary);
+        return false;
+    }
+
+    lib_close(libHandle2);
+    return true;
+}
+
 static void do_lv2_check(const char* const bundle, const bool doInit)
 {
+    Lv2RdfCache& lv2RdfCache(Lv2RdfCache::getInstance());
+
+    // Use the cached plugin list if the bundle did not change
+    {
+        std::vector<Lv2CachedPluginInfo> cachedPlugins;
+
+        if (lv2RdfCache.lookupBundle(bundle, cachedPlugins))
+        {
+            if (cachedPlugins.empty())
+                DISCOVERY_OUT("warning", "LV2 Bundle doesn't provide any plugins");
+
+            for (std::size_t i=0; i < cachedPlugins.size(); ++i)
+            {
+                if (doInit && ! do_lv2_lib_check(cachedPlugins[i].binary))
+                    continue;
+
+                print_cached_plugin(get_cached_plugin_lv2(cachedPlugins[i]));
+            }
+
+            return;
+        }
+    }
+
     Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
 
     Lilv::Node bundleNode(lv2World.new_file_uri(nullptr, bundle));
@@ -753,9 +817,15 @@ static void do_lv2_check(const char* const bundle, const bool doInit)
             URIs.addIfNotAlreadyThere(water::String(uri));
     }
 
+    // Only cached if all plugins can be found, library errors are checked again on every run
+    Lv2CachedBundle cachedBundle;
+    cachedBundle.bundle = bundle;
+    bool cacheable = true;
+
     if (URIs.size() == 0)
     {
         DISCOVERY_OUT("warning", "LV2 Bundle doesn't provide any plugins");
+        lv2RdfCache.storeBundle(cachedBundle);
         return;
     }
 
@@ -768,43 +838,27 @@ static void do_lv2_check(const char* const bundle, const bool doInit)
         if (rdfDescriptor == nullptr || rdfDescriptor->URI == nullptr)
         {
             DISCOVERY_OUT("error", "Failed to find LV2 plugin '" << URI << "'");
+            cacheable = false;
             continue;
         }
 
-        if (doInit)
-        {
-            // test if lib is loadable, twice
-            const lib_t libHandle1 = lib_open(rdfDescriptor->Binary);
-
-            if (libHandle1 == nullptr)
-            {
-                print_lib_error(rdfDescriptor->Binary);
-                delete rdfDescriptor;
-                continue;
-            }
-
-            lib_close(libHandle1);
-
-            const lib_t libHandle2 = lib_open(rdfDescriptor->Binary);
-
-            if (libHandle2 == nullptr)
-            {
-                print_lib_error(rdfDescriptor->Binary);
-                delete rdfDescriptor;
-                continue;
-            }
-
-            lib_close(libHandle2);
-        }
-
         const LilvPlugin* const cPlugin(lv2World.getPluginFromURI(URI));
         CARLA_SAFE_ASSERT_CONTINUE(cPlugin != nullptr);
 
         Lilv::Plugin lilvPlugin(cPlugin);
         CARLA_SAFE_ASSERT_CONTINUE(lilvPlugin.get_uri().is_uri());
 
-        print_cached_plugin(get_cached_plugin_lv2(lv2World, lilvPlugin));
+        cachedBundle.plugins.push_back(Lv2CachedPluginInfo());
+        fill_cached_plugin_lv2(cachedBundle.plugins.back(), lv2World, lilvPlugin);
+
+        if (doInit && ! do_lv2_lib_check(rdfDescriptor->Binary))
+            continue;
+
+        print_cached_plugin(get_cached_plugin_lv2(cachedBundle.plugins.back()));
     }
+
+    if (cacheable)
+        lv2RdfCache.storeBundle(cachedBundle);
 }
 #endif
 
@@ -1651,19 +1705,11 @@ static void do_fluidsynth_check(const char* const filename, const PluginType typ
 #endif
 }
 
-// ------------------------------ main entry point ------------------------------
+// ------------------------------ discovery of a single file ------------------------------
 
-int main(int argc, char* argv[])
+static bool do_discovery(const char* const argv0, const char* const stype, const char* const filename)
 {
-    if (argc != 3)
-    {
-        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
-        return 1;
-    }
-
-    const char* const stype    = argv[1];
-    const char* const filename = argv[2];
-    const PluginType  type     = getPluginTypeFromString(stype);
+    const PluginType type = getPluginTypeFromString(stype);
 
     CarlaString filenameCheck(filename);
     filenameCheck.toLower();
@@ -1688,7 +1734,7 @@ int main(int argc, char* argv[])
     if (type != PLUGIN_SF2 && filenameCheck.contains("fluidsynth", true))
     {
         DISCOVERY_OUT("info", "skipping fluidsynth based plugin");
-        return 0;
+        return true;
     }
 
 #ifdef CARLA_OS_MAC
@@ -1696,25 +1742,6 @@ int main(int argc, char* argv[])
         openLib = false;
 #endif
 
-    // ---------------------------------------------------------------------------------------------------------------
-    // Initialize OS features
-
-    // we want stuff in English so we can parse error messages
-    ::setlocale(LC_ALL, "C");
-#ifndef CARLA_OS_WIN
-    carla_setenv("LC_ALL", "C");
-#endif
-
-#ifdef CARLA_OS_WIN
-    OleInitialize(nullptr);
-    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-# ifndef __WINPTHREADS_VERSION
-    // (non-portable) initialization of statically linked pthread library
-    pthread_win32_process_attach_np();
-    pthread_win32_thread_attach_np();
-# endif
-#endif
-
     // ---------------------------------------------------------------------------------------------------------------
 
     if (openLib)
@@ -1724,7 +1751,7 @@ int main(int argc, char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            return 1;
+            return false;
         }
     }
 
@@ -1742,7 +1769,7 @@ int main(int argc, char* argv[])
         if (! lib_close(handle))
         {
             print_lib_error(filename);
-            return 1;
+            return false;
         }
 
         handle = lib_open(filename);
@@ -1750,7 +1777,7 @@ int main(int argc, char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            return 1;
+            return false;
         }
     }
 
@@ -1758,7 +1785,7 @@ int main(int argc, char* argv[])
     if (std::strcmp(filename, ":all") == 0)
     {
         do_cached_check(type);
-        return 0;
+        return true;
     }
 #endif
 
@@ -1841,7 +1868,7 @@ int main(int argc, char* argv[])
         {
             if (pid == 0)
             {
-                execl("/usr/bin/arch", "/usr/bin/arch", "-arch", "x86_64", argv[0], argv[1], argv[2], nullptr);
+                execl("/usr/bin/arch", "/usr/bin/arch", "-arch", "x86_64", argv0, stype, filename, nullptr);
                 exit(1);
             }
             else
@@ -1856,6 +1883,756 @@ int main(int argc, char* argv[])
     if (openLib && handle != nullptr)
         lib_close(handle);
 
+    return true;
+
+    // might be unused
+    (void)argv0;
+#ifdef USING_JUCE
+    (void)retryJucePlugin;
+#endif
+}
+
+// ------------------------------ discovery service ------------------------------
+
+#ifdef CARLA_OS_UNIX
+// Long-lived mode, reads "<type>\t</path/to/plugin>" lines from stdin and scans them in parallel.
+// File names containing newlines cannot be represented in this protocol, and must not be sent.
+// Files are checked inside a pool of worker processes forked from this (already initialized) one,
+// so crashes and hangs stay isolated while avoiding a full process startup per file.
+// Workers are reused for several files, and replaced when they crash, hang or reach their request limit.
+// Results are kept in a cache keyed by file size and modification time, so rescans only check changed files.
+// Crashes and timeouts are never cached, so such files are checked again on the next scan.
+// The output of each file is written as a single block between "service-begin" and "service-end" lines.
+
+class DiscoveryService
+{
+public:
+    DiscoveryService(const char* const argv0, const uint maxJobs)
+        : fArgv0(argv0),
+          fMaxJobs(maxJobs),
+          fTimeout(60),
+          fDoneMarker(),
+          fCachePath(),
+          fCache(),
+          fCacheChanges(0),
+          fPending(),
+          fWorkers(),
+          fInputBuffer(),
+          fInputClosed(false)
+    {
+        if (const char* const timeout = std::getenv("CARLA_DISCOVERY_TIMEOUT"))
+            fTimeout = std::atoi(timeout);
+
+        // workers end each result with this marker, plugins printing to stdout cannot guess it
+        char strBuf[STR_MAX+1];
+        std::snprintf(strBuf, STR_MAX, "\ncarla-discovery::worker-done::%i-%li-%li\n",
+                      static_cast<int>(::getpid()), static_cast<long>(std::time(nullptr)), static_cast<long>(std::clock()));
+        strBuf[STR_MAX] = '\0';
+        fDoneMarker = strBuf;
+
+        fCachePath = getCachePath(argv0);
+        loadCache();
+    }
+
+    int run()
+    {
+        ::signal(SIGPIPE, SIG_IGN);
+
+#ifndef BUILD_BRIDGE
+        // create the lilv world once, workers only need to load their own bundle
+        Lv2WorldClass::getInstance();
+#endif
+
+        std::vector<struct pollfd> pfds;
+        std::vector<Worker*> pfdWorkers;
+
+        for (;;)
+        {
+            startPendingJobs();
+
+            if (fInputClosed && fPending.empty() && ! hasBusyWorkers())
+                break;
+
+            pfds.clear();
+            pfdWorkers.clear();
+
+            if (! fInputClosed)
+            {
+                const struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+                pfds.push_back(pfd);
+                pfdWorkers.push_back(nullptr);
+            }
+
+            for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            {
+                const struct pollfd pfd = { it->resultFd, POLLIN, 0 };
+                pfds.push_back(pfd);
+                pfdWorkers.push_back(&*it);
+            }
+
+            if (::poll(pfds.data(), static_cast<nfds_t>(pfds.size()), 1000) < 0 && errno != EINTR)
+            {
+                carla_stderr2("DiscoveryService: poll failed: %s", std::strerror(errno));
+                break;
+            }
+
+            for (std::size_t i=0; i < pfds.size(); ++i)
+            {
+                if (pfds[i].revents == 0)
+                    continue;
+
+                if (pfdWorkers[i] == nullptr)
+                    readInput();
+                else
+                    readWorker(*pfdWorkers[i]);
+            }
+
+            killTimedOutWorkers();
+            collectFinishedWorkers();
+        }
+
+        // idle workers exit once their request pipe is closed
+        for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            stopWorker(*it);
+
+        for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+        {
+            ::close(it->resultFd);
+            ::waitpid(it->pid, nullptr, 0);
+        }
+
+        fWorkers.clear();
+
+        saveCache();
+        return 0;
+    }
+
+private:
+    struct Request {
+        std::string stype;
+        std::string filename;
+    };
+
+    struct CacheEntry {
+        int64_t size;
+        int64_t modTime;
+        std::string output;
+    };
+
+    struct Worker {
+        pid_t pid;
+        int requestFd;
+        int resultFd;
+        uint numRequests;
+        bool busy;
+        bool dead;
+        bool timedOut;
+        Request request;
+        int64_t size;
+        int64_t modTime;
+        std::time_t startTime;
+        std::string output;
+    };
+
+    // workers are replaced after this many files, in case plugins leak memory or leave threads running
+    static const uint kMaxRequestsPerWorker = 64;
+
+    const char* const fArgv0;
+    const uint fMaxJobs;
+    int fTimeout;
+    std::string fDoneMarker;
+
+    CarlaString fCachePath;
+    std::map<std::string, CacheEntry> fCache;
+    uint fCacheChanges;
+
+    std::list<Request> fPending;
+    std::list<Worker> fWorkers;
+
+    std::string fInputBuffer;
+    bool fInputClosed;
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    void readInput()
+    {
+        char buf[4096];
+        const ssize_t r = ::read(STDIN_FILENO, buf, sizeof(buf));
+
+        if (r < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN)
+                return;
+        }
+        else if (r > 0)
+        {
+            fInputBuffer.append(buf, static_cast<std::size_t>(r));
+
+            for (std::size_t nl; (nl = fInputBuffer.find('\n')) != std::string::npos;)
+            {
+                const std::string line(fInputBuffer, 0, nl);
+                fInputBuffer.erase(0, nl + 1);
+
+                const std::size_t tab = line.find('\t');
+
+                if (tab == std::string::npos || tab == 0 || tab + 1 == line.size())
+                {
+                    carla_stderr2("DiscoveryService: invalid request '%s'", line.c_str());
+                    continue;
+                }
+
+                Request request;
+                request.stype = line.substr(0, tab);
+                request.filename = line.substr(tab + 1);
+                fPending.push_back(request);
+            }
+            return;
+        }
+
+        fInputClosed = true;
+    }
+
+    void readWorker(Worker& worker)
+    {
+        if (worker.dead)
+            return;
+
+        char buf[4096];
+        const ssize_t r = ::read(worker.resultFd, buf, sizeof(buf));
+
+        if (r > 0)
+        {
+            if (! worker.busy)
+                return;
+
+            worker.output.append(buf, static_cast<std::size_t>(r));
+
+            const std::size_t markerPos = worker.output.find(fDoneMarker);
+
+            if (markerPos == std::string::npos)
+                return;
+
+            worker.output.erase(markerPos);
+            writeResult(worker.request.filename, worker.output);
+
+            CacheEntry& entry(fCache[worker.request.stype + "\t" + worker.request.filename]);
+            entry.size = worker.size;
+            entry.modTime = worker.modTime;
+            entry.output = worker.output;
+
+            // save once in a while, in case we get killed
+            if (++fCacheChanges >= 32)
+                saveCache();
+
+            worker.busy = false;
+            worker.output.clear();
+
+            if (++worker.numRequests >= kMaxRequestsPerWorker)
+                stopWorker(worker);
+
+            return;
+        }
+
+        if (r < 0 && (errno == EINTR || errno == EAGAIN))
+            return;
+
+        // worker exited, or crashed in the middle of a request
+        worker.dead = true;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    bool hasBusyWorkers() const noexcept
+    {
+        for (std::list<Worker>::const_iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            if (it->busy)
+                return true;
+
+        return false;
+    }
+
+    Worker* getIdleWorker()
+    {
+        for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            if (! it->busy && ! it->dead && it->requestFd >= 0)
+                return &*it;
+
+        if (fWorkers.size() >= fMaxJobs)
+            return nullptr;
+
+        return startWorker();
+    }
+
+    void startPendingJobs()
+    {
+        while (! fPending.empty())
+        {
+            const Request request(fPending.front());
+
+            int64_t size, modTime;
+            getFileStamp(request.filename.c_str(), size, modTime);
+
+            const std::string key(request.stype + "\t" + request.filename);
+            const std::map<std::string, CacheEntry>::const_iterator it = fCache.find(key);
+
+            if (it != fCache.end() && it->second.size == size && it->second.modTime == modTime)
+            {
+                fPending.pop_front();
+                writeResult(request.filename, it->second.output);
+                continue;
+            }
+
+            Worker* const worker = getIdleWorker();
+
+            if (worker == nullptr)
+                break;
+
+            fPending.pop_front();
+
+            if (! sendRequest(*worker, request))
+            {
+                // worker died while idle, the request is tried again with a new one
+                stopWorker(*worker);
+                worker->dead = true;
+                fPending.push_front(request);
+                continue;
+            }
+
+            worker->busy = true;
+            worker->timedOut = false;
+            worker->request = request;
+            worker->size = size;
+            worker->modTime = modTime;
+            worker->startTime = std::time(nullptr);
+            worker->output.clear();
+        }
+    }
+
+    // requests are sent as 2 native-endian uint32 sizes, followed by the type and filename strings
+    static bool sendRequest(const Worker& worker, const Request& request)
+    {
+        const uint32_t sizes[2] = {
+            static_cast<uint32_t>(request.stype.size()),
+            static_cast<uint32_t>(request.filename.size())
+        };
+
+        std::string data(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+        data += request.stype;
+        data += request.filename;
+
+        return writeAll(worker.requestFd, data.data(), data.size());
+    }
+
+    static bool writeAll(const int fd, const char* data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            const ssize_t r = ::write(fd, data, size);
+
+            if (r < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return false;
+            }
+
+            data += r;
+            size -= static_cast<std::size_t>(r);
+        }
+
+        return true;
+    }
+
+    static bool readAll(const int fd, char* data, std::size_t size)
+    {
+        while (size != 0)
+        {
+            const ssize_t r = ::read(fd, data, size);
+
+            if (r < 0 && errno == EINTR)
+                continue;
+            if (r <= 0)
+                return false;
+
+            data += r;
+            size -= static_cast<std::size_t>(r);
+        }
+
+        return true;
+    }
+
+    Worker* startWorker()
+    {
+        int requestPipe[2], resultPipe[2];
+
+        if (::pipe(requestPipe) != 0)
+        {
+            carla_stderr2("DiscoveryService: pipe failed: %s", std::strerror(errno));
+            return nullptr;
+        }
+
+        if (::pipe(resultPipe) != 0)
+        {
+            carla_stderr2("DiscoveryService: pipe failed: %s", std::strerror(errno));
+            ::close(requestPipe[0]);
+            ::close(requestPipe[1]);
+            return nullptr;
+        }
+
+        // make sure the child does not inherit and later flush our pending output
+        std::cout.flush();
+
+        const pid_t pid = ::fork();
+
+        if (pid == 0)
+        {
+            // worker process, other workers' pipes must be closed or they never see EOF
+            for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            {
+                if (it->requestFd >= 0)
+                    ::close(it->requestFd);
+                ::close(it->resultFd);
+            }
+
+            ::close(requestPipe[1]);
+            ::close(resultPipe[0]);
+            ::dup2(resultPipe[1], STDOUT_FILENO);
+            ::close(resultPipe[1]);
+
+            const int devnull = ::open("/dev/null", O_RDONLY);
+            if (devnull >= 0)
+            {
+                ::dup2(devnull, STDIN_FILENO);
+                ::close(devnull);
+            }
+
+            runWorker(requestPipe[0]);
+
+            std::cout.flush();
+            std::fflush(stdout);
+            ::_exit(0);
+        }
+
+        ::close(requestPipe[0]);
+        ::close(resultPipe[1]);
+
+        if (pid < 0)
+        {
+            carla_stderr2("DiscoveryService: fork failed: %s", std::strerror(errno));
+            ::close(requestPipe[1]);
+            ::close(resultPipe[0]);
+            return nullptr;
+        }
+
+        Worker worker;
+        worker.pid = pid;
+        worker.requestFd = requestPipe[1];
+        worker.resultFd = resultPipe[0];
+        worker.numRequests = 0;
+        worker.busy = false;
+        worker.dead = false;
+        worker.timedOut = false;
+        worker.size = worker.modTime = -1;
+        worker.startTime = 0;
+        fWorkers.push_back(worker);
+
+        return &fWorkers.back();
+    }
+
+    // worker process main loop, exits when the request pipe is closed
+    void runWorker(const int requestFd)
+    {
+        for (uint32_t sizes[2]; readAll(requestFd, reinterpret_cast<char*>(sizes), sizeof(sizes));)
+        {
+            std::string stype(sizes[0], '\0');
+            std::string filename(sizes[1], '\0');
+
+            if ((sizes[0] != 0 && ! readAll(requestFd, &stype[0], sizes[0]))
+                || (sizes[1] != 0 && ! readAll(requestFd, &filename[0], sizes[1])))
+                break;
+
+            do_discovery(fArgv0, stype.c_str(), filename.c_str());
+
+            std::cout << fDoneMarker;
+            std::cout.flush();
+            std::fflush(stdout);
+        }
+
+        ::close(requestFd);
+    }
+
+    static void stopWorker(Worker& worker)
+    {
+        if (worker.requestFd < 0)
+            return;
+
+        ::close(worker.requestFd);
+        worker.requestFd = -1;
+    }
+
+    void killTimedOutWorkers()
+    {
+        if (fTimeout <= 0)
+            return;
+
+        const std::time_t now = std::time(nullptr);
+
+        for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+        {
+            if (! it->busy || it->timedOut || now - it->startTime < fTimeout)
+                continue;
+
+            it->timedOut = true;
+            it->dead = true;
+            ::kill(it->pid, SIGKILL);
+        }
+    }
+
+    void collectFinishedWorkers()
+    {
+        for (std::list<Worker>::iterator it = fWorkers.begin(); it != fWorkers.end();)
+        {
+            Worker& worker(*it);
+
+            if (! worker.dead)
+            {
+                ++it;
+                continue;
+            }
+
+            // the result pipe is closed at this point, so the worker is gone or about to be
+            int status = 0;
+            const pid_t ret = ::waitpid(worker.pid, &status, 0);
+
+            stopWorker(worker);
+            ::close(worker.resultFd);
+
+            // results of crashed or hung workers are reported but not cached,
+            // so files are checked again after a library update that keeps the same plugin file
+            if (worker.busy)
+            {
+                if (worker.timedOut)
+                {
+                    worker.output += "\ncarla-discovery::error::Plugin took too long to scan, skipped\n";
+                }
+                else if (ret > 0 && WIFSIGNALED(status))
+                {
+                    char strBuf[STR_MAX+1];
+                    std::snprintf(strBuf, STR_MAX, "\ncarla-discovery::error::Plugin crashed during discovery (signal %i)\n",
+                                  WTERMSIG(status));
+                    strBuf[STR_MAX] = '\0';
+                    worker.output += strBuf;
+                }
+                else
+                {
+                    worker.output += "\ncarla-discovery::error::Plugin terminated the discovery process\n";
+                }
+
+                writeResult(worker.request.filename, worker.output);
+            }
+
+            it = fWorkers.erase(it);
+        }
+    }
+
+    static void writeResult(const std::string& filename, const std::string& output)
+    {
+        std::cout << "\ncarla-discovery::service-begin::" << filename << "\n"
+                  << output
+                  << "\ncarla-discovery::service-end::" << filename << std::endl;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    // bundles are directories, check everything inside them
+    static void getFileStamp(const char* const filename, int64_t& size, int64_t& modTime)
+    {
+        size = modTime = -1;
+
+        struct stat st;
+        if (::stat(filename, &st) != 0)
+            return;
+
+        size = static_cast<int64_t>(st.st_size);
+        modTime = static_cast<int64_t>(st.st_mtime);
+
+        if (! S_ISDIR(st.st_mode))
+            return;
+
+        for (water::DirectoryIterator it(water::File(filename), true, "*", File::findFilesAndDirectories); it.next();)
+        {
+            if (::stat(it.getFile().getFullPathName().toRawUTF8(), &st) != 0)
+                continue;
+
+            size += static_cast<int64_t>(st.st_size);
+            modTime = std::max(modTime, static_cast<int64_t>(st.st_mtime));
+        }
+    }
+
+    static CarlaString getCachePath(const char* const argv0)
+    {
+        const CarlaString cacheDir(carla_get_cache_dir("CARLA_DISCOVERY_CACHE_DIR"));
+
+        // empty path means caching is disabled
+        if (cacheDir.isEmpty())
+            return cacheDir;
+
+        // one cache per discovery tool, as results differ per architecture
+        const char* toolName = std::strrchr(argv0, '/');
+        toolName = toolName != nullptr ? toolName + 1 : argv0;
+
+        return cacheDir + "/" + toolName + ".cache";
+    }
+
+    void loadCache()
+    {
+        if (fCachePath.isEmpty())
+            return;
+
+        FILE* const file = std::fopen(fCachePath, "rb");
+
+        if (file == nullptr)
+            return;
+
+        char line[128];
+        uint version = 0;
+
+        if (std::fgets(line, sizeof(line), file) == nullptr
+            || std::sscanf(line, "CarlaDiscoveryCache %u", &version) != 1 || version != 1)
+        {
+            std::fclose(file);
+            return;
+        }
+
+        while (std::fgets(line, sizeof(line), file) != nullptr)
+        {
+            unsigned long keySize, outputSize;
+            long long size, modTime;
+
+            if (std::sscanf(line, "%lu %lld %lld %lu", &keySize, &size, &modTime, &outputSize) != 4)
+                break;
+
+            std::string key(keySize, '\0');
+            CacheEntry entry;
+            entry.size = size;
+            entry.modTime = modTime;
+            entry.output.resize(outputSize);
+
+            if ((keySize != 0 && std::fread(&key[0], 1, keySize, file) != keySize)
+                || (outputSize != 0 && std::fread(&entry.output[0], 1, outputSize, file) != outputSize))
+                break;
+
+            fCache[key] = entry;
+        }
+
+        std::fclose(file);
+    }
+
+    void saveCache()
+    {
+        fCacheChanges = 0;
+
+        if (fCachePath.isEmpty())
+            return;
+
+        // create cache dir if needed
+        {
+            CarlaString cacheDir(fCachePath);
+            cacheDir.truncate(cacheDir.rfind('/'));
+
+            if (! carla_create_dir_path(cacheDir))
+                return;
+        }
+
+        const CarlaString tmpPath(fCachePath + ".tmp");
+        FILE* const file = std::fopen(tmpPath, "wb");
+
+        if (file == nullptr)
+            return;
+
+        bool ok = std::fputs("CarlaDiscoveryCache 1\n", file) >= 0;
+
+        for (std::map<std::string, CacheEntry>::const_iterator it = fCache.begin(); ok && it != fCache.end(); ++it)
+        {
+            ok = std::fprintf(file, "%lu %lld %lld %lu\n",
+                              static_cast<unsigned long>(it->first.size()),
+                              static_cast<long long>(it->second.size),
+                              static_cast<long long>(it->second.modTime),
+                              static_cast<unsigned long>(it->second.output.size())) > 0
+              && std::fwrite(it->first.data(), 1, it->first.size(), file) == it->first.size()
+              && std::fwrite(it->second.output.data(), 1, it->second.output.size(), file) == it->second.output.size();
+        }
+
+        if (std::fclose(file) != 0)
+            ok = false;
+
+        if (! ok || std::rename(tmpPath, fCachePath) != 0)
+            std::remove(tmpPath);
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(DiscoveryService)
+};
+#endif
+
+// ------------------------------ main entry point ------------------------------
+
+int main(int argc, char* argv[])
+{
+#ifdef CARLA_OS_UNIX
+    const bool serviceMode = (argc == 2 || argc == 3) && std::strcmp(argv[1], "--service") == 0;
+#else
+    const bool serviceMode = false;
+#endif
+
+    if (argc != 3 && ! serviceMode)
+    {
+        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
+#ifdef CARLA_OS_UNIX
+        carla_stdout("       %s --service [jobs]", argv[0]);
+#endif
+        return 1;
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+    // Initialize OS features
+
+    // we want stuff in English so we can parse error messages
+    ::setlocale(LC_ALL, "C");
+#ifndef CARLA_OS_WIN
+    carla_setenv("LC_ALL", "C");
+#endif
+
+#ifdef CARLA_OS_WIN
+    OleInitialize(nullptr);
+    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+# ifndef __WINPTHREADS_VERSION
+    // (non-portable) initialization of statically linked pthread library
+    pthread_win32_process_attach_np();
+    pthread_win32_thread_attach_np();
+# endif
+#endif
+
+    // ---------------------------------------------------------------------------------------------------------------
+
+    int ret;
+
+#ifdef CARLA_OS_UNIX
+    if (serviceMode)
+    {
+        long maxJobs = argc == 3 ? std::atol(argv[2]) : ::sysconf(_SC_NPROCESSORS_ONLN);
+
+        if (maxJobs <= 0)
+            maxJobs = 1;
+
+        DiscoveryService service(argv[0], static_cast<uint>(maxJobs));
+        ret = service.run();
+    }
+    else
+#endif
+    {
+        ret = do_discovery(argv[0], argv[1], argv[2]) ? 0 : 1;
+    }
+
     // ---------------------------------------------------------------------------------------------------------------
 
 #ifdef CARLA_OS_WIN
@@ -1867,12 +2644,7 @@ int main(int argc, char* argv[])
     OleUninitialize();
 #endif
 
-    return 0;
-
-#ifdef USING_JUCE
-    // might be unused
-    (void)retryJucePlugin;
-#endif
+    return ret;
 }
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -31,6 +31,7 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QProcess>
 
 #include <QtWidgets/QPushButton>
 
@@ -128,6 +129,100 @@ struct SearchPluginsThread::PrivateData {
     {
     }
 
+    // Scan several files using a single carla-discovery process in service mode (not available for wine or Windows).
+    // Files are checked in parallel, results are returned as (filename, discovery output lines) in the order they finish.
+    QList<QPair<QString, QStringList>> runCarlaDiscoveryService(const QString& stype,
+                                                                const QStringList& filenames,
+                                                                const QString& tool)
+    {
+        QList<QPair<QString, QStringList>> results;
+
+        if (! QFileInfo::exists(tool))
+        {
+            qWarning("runCarlaDiscoveryService() - tool '%s' does not exist", tool.toUtf8().constData());
+            return results;
+        }
+
+        QProcessEnvironment env(QProcessEnvironment::systemEnvironment());
+        env.insert("LANG", "C");
+        env.insert("LD_PRELOAD", "");
+
+        QProcess process;
+        process.setProcessEnvironment(env);
+        process.start(tool, QStringList() << "--service");
+
+        if (! process.waitForStarted())
+        {
+            qWarning("runCarlaDiscoveryService() - failed to start '%s'", tool.toUtf8().constData());
+            return results;
+        }
+
+        QByteArray requests;
+
+        for (const QString& filename : filenames)
+        {
+            // the service protocol is line based
+            if (filename.contains('\n') || filename.contains('\r'))
+            {
+                qWarning("runCarlaDiscoveryService() - skipping file with newline in its name '%s'",
+                         filename.toUtf8().constData());
+                continue;
+            }
+
+            requests += QString("%1\t%2\n").arg(stype, filename).toUtf8();
+        }
+
+        process.write(requests);
+        process.closeWriteChannel();
+
+        const QString kServiceBegin("carla-discovery::service-begin::");
+        const QString kServiceEnd("carla-discovery::service-end::");
+
+        QString filename;
+        QStringList lines;
+        bool inResult = false;
+
+        for (;;)
+        {
+            while (! process.canReadLine() && fContinueChecking)
+            {
+                if (! process.waitForReadyRead(1000) && process.state() == QProcess::NotRunning)
+                    break;
+            }
+
+            if (! process.canReadLine() || ! fContinueChecking)
+                break;
+
+            const QString line(QString::fromUtf8(process.readLine()).trimmed());
+
+            if (line.startsWith(kServiceBegin))
+            {
+                filename = line.mid(kServiceBegin.length());
+                lines.clear();
+                inResult = true;
+            }
+            else if (line.startsWith(kServiceEnd))
+            {
+                if (inResult)
+                    results.append(QPair<QString, QStringList>(filename, lines));
+
+                inResult = false;
+            }
+            else if (inResult && ! line.isEmpty())
+            {
+                lines.append(line);
+            }
+        }
+
+        if (process.state() != QProcess::NotRunning)
+        {
+            process.kill();
+            process.waitForFinished();
+        }
+
+        return results;
+    }
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PrivateData)
 };
 
@@ -473,6 +568,8 @@ void JackApplicationW::getCommandAndFlags(QString& command, QString& name, QStri
         flags |= LIBJACK_FLAG_CAPTURE_FIRST_WINDOW;
     if (self->ui.cb_buffers_addition_mode->isChecked())
         flags |= LIBJACK_FLAG_AUDIO_BUFFERS_ADDITION;
+    if (self->ui.cb_parallel_clients->isChecked())
+        flags |= LIBJACK_FLAG_PARALLEL_CLIENTS;
     if (self->ui.cb_out_midi_mixdown->isChecked())
         flags |= LIBJACK_FLAG_MIDI_OUTPUT_CHANNEL_MIXDOWN;
     if (self->ui.cb_external_start->isChecked())
@@ -30,7 +30,7 @@ from sys import platform, maxsize
 from ctypes import (
     c_bool, c_char_p, c_double, c_float, c_int, c_long, c_longdouble, c_longlong, c_ubyte, c_uint, c_void_p,
     c_int8, c_int16, c_int32, c_int64, c_uint8, c_uint16, c_uint32, c_uint64,
-    cast, Structure,
+    byref, cast, Structure,
     CDLL, CFUNCTYPE, RTLD_GLOBAL, RTLD_LOCAL, POINTER
 )
 
@@ -169,6 +169,10 @@ MAX_PATCHBAY_PLUGINS = 255
 # @see ENGINE_OPTION_MAX_PARAMETERS
 MAX_DEFAULT_PARAMETERS = 200
 
+# Number of in-memory state snapshot slots per plugin.
+# @see carla_save_snapshot()
+MAX_SNAPSHOTS = 16
+
 # The "plugin Id" for the global Carla instance.
 # Currently only used for audio peaks.
 MAIN_CARLA_PLUGIN_ID = 0xFFFF
@@ -278,6 +282,23 @@ PLUGIN_OPTION_SEND_PROGRAM_CHANGES = 0x200
 # We always want notes enabled by default, not the contrary.
 PLUGIN_OPTION_SKIP_SENDING_NOTES = 0x400
 
+# Stop processing the plugin while it is idle.
+# After its audio inputs and outputs have been silent for a while (and no events arrived) the plugin is put to sleep,
+# its processing is skipped and it outputs silence until new audio or events arrive.
+# Transport changes (play/stop, relocation, tempo) also wake it up,
+# and plugins without audio inputs never sleep while the transport is rolling.
+# @see ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT
+PLUGIN_OPTION_SLEEP_ON_SILENCE = 0x800
+
+# Keep processing the plugin in patchbay mode even if none of its outputs reach the engine outputs.
+# By default such plugins are left out of the patchbay rendering sequence, enable this for plugins like recorders.
+# @see ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED
+PLUGIN_OPTION_ALWAYS_PROCESS = 0x1000
+
+# Render the plugin voices using multiple CPU cores.
+# Only used by plugins that can split their own rendering, like FluidSynth, and applied when the plugin is loaded.
+PLUGIN_OPTION_MULTI_CORE = 0x2000
+
 # Special flag to indicate that plugin options are not yet set.
 # This flag exists because 0x0 as an option value is a valid one, so we need something else to indicate "null-ness".
 PLUGIN_OPTIONS_NULL = 0x10000
@@ -792,6 +813,7 @@ ENGINE_CALLBACK_BUFFER_SIZE_CHANGED = 33
 ENGINE_CALLBACK_SAMPLE_RATE_CHANGED = 34
 
 # A cancelable action has been started or stopped.
+# Sending "started" again while an action is running updates its name, as a way to report progress.
 # @a pluginId Plugin Id the action relates to, -1 for none
 # @a value1   1 for action started, 0 for stopped
 # @a valueStr Action name
@@ -863,6 +885,28 @@ ENGINE_CALLBACK_PARAMETER_MAPPED_RANGE_CHANGED = 46
 # @a valuef   Y position 2
 ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED = 47
 
+# A plugin embed UI has been resized.
+# @a pluginId Plugin Id to resize
+# @a value1   New width
+# @a value2   New height
+ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+
+# A patchbay client has been added to or removed from the rendering sequence.
+# Clients whose outputs do not reach the engine outputs are not processed.
+# @a pluginId Client Id
+# @a value1   1 if the client is not being processed, 0 otherwise
+# @see PLUGIN_OPTION_ALWAYS_PROCESS
+ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED = 49
+
+# An asynchronous plugin add, remove or replace request has finished.
+# On success this is sent after the matching plugin added, removed or reload-all callback.
+# @a pluginId Plugin Id
+# @a value1   Request Id
+# @a value2   1 if the request succeeded, 0 otherwise
+# @a valueStr Error message, if the request failed
+# @see carla_add_plugin_async()
+ENGINE_CALLBACK_PLUGIN_ASYNC_DONE = 50
+
 # ---------------------------------------------------------------------------------------------------------------------
 # NSM Callback Opcode
 # NSM callback opcodes.
@@ -1042,6 +1086,23 @@ ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT = 33
 # @note MUST include at least one "." (dot).
 ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
 
+# Save plugin chunks as binary files next to the project file, instead of as base64 text inside it.
+# Chunk files are named after their contents and only written when they change.
+# Default is false.
+ENGINE_OPTION_PROJECT_CHUNK_FILES = 35
+
+# Time in milliseconds a plugin needs to be silent before it is put to sleep.
+# Only applies to plugins with PLUGIN_OPTION_SLEEP_ON_SILENCE enabled.
+# Default is 2000.
+ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT = 36
+
+# Bridge process pooling, maximum number of bridged plugins hosted by a single bridge process.
+# Only plugins using the same bridge binary, architecture and wine prefix are grouped together.
+# This only shares the process and its runtime, each plugin still does its own real-time round-trip per block.
+# Set to 0 or 1 to use one process per bridged plugin.
+# Default is 0.
+ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE = 37
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1841,6 +1902,34 @@ class CarlaHostMeta():
     def switch_plugins(self, pluginIdA, pluginIdB):
         raise NotImplementedError
 
+    # Add a new plugin without blocking the caller.
+    # The plugin is created and activated on a separate thread, and starts processing on a later audio cycle.
+    # Requests are processed in order, and plugin ids are resolved when each request is processed.
+    # Completion is reported through ENGINE_CALLBACK_PLUGIN_ASYNC_DONE, during carla_engine_idle().
+    # Returns a request Id, or 0 on failure.
+    # @param extra Extra string, defined per plugin type (only "true" for 16-output SoundFonts is used)
+    # @see carla_add_plugin()
+    @abstractmethod
+    def add_plugin_async(self, btype, ptype, filename, name, label, uniqueId, extra, options):
+        raise NotImplementedError
+
+    # Remove one plugin without blocking the caller.
+    # Returns a request Id, or 0 on failure.
+    # @param pluginId Plugin to remove
+    # @see carla_add_plugin_async()
+    @abstractmethod
+    def remove_plugin_async(self, pluginId):
+        raise NotImplementedError
+
+    # Replace a plugin without blocking the caller.
+    # The current plugin keeps processing until the new one is ready.
+    # Returns a request Id, or 0 on failure.
+    # @param pluginId Plugin to replace
+    # @see carla_add_plugin_async()
+    @abstractmethod
+    def replace_plugin_async(self, pluginId, btype, ptype, filename, name, label, uniqueId, extra, options):
+        raise NotImplementedError
+
     # Load a plugin state.
     # @param pluginId Plugin
     # @param filename Path to plugin state
@@ -1857,6 +1946,45 @@ class CarlaHostMeta():
     def save_plugin_state(self, pluginId, filename):
         raise NotImplementedError
 
+    # Capture a plugin state into an in-memory snapshot.
+    # Snapshots keep parameter values, programs and chunk data ready to use, for fast switching.
+    # @param pluginId Plugin
+    # @param slot     Snapshot slot, must be lower than MAX_SNAPSHOTS
+    # @see carla_load_plugin_snapshot()
+    @abstractmethod
+    def save_plugin_snapshot(self, pluginId, slot):
+        raise NotImplementedError
+
+    # Restore a plugin state from an in-memory snapshot.
+    # Parameter changes are applied by the audio thread at the start of the next processing cycle.
+    # @param pluginId Plugin
+    # @param slot     Snapshot slot
+    # @see carla_save_plugin_snapshot()
+    @abstractmethod
+    def load_plugin_snapshot(self, pluginId, slot):
+        raise NotImplementedError
+
+    # Capture the state of all plugins into an in-memory snapshot.
+    # @param slot Snapshot slot, must be lower than MAX_SNAPSHOTS
+    # @see carla_load_snapshot()
+    @abstractmethod
+    def save_snapshot(self, slot):
+        raise NotImplementedError
+
+    # Restore the state of all plugins from an in-memory snapshot.
+    # Parameter changes of all plugins are applied at the start of the same processing cycle.
+    # @param slot Snapshot slot
+    # @see carla_save_snapshot()
+    @abstractmethod
+    def load_snapshot(self, slot):
+        raise NotImplementedError
+
+    # Clear an in-memory snapshot of all plugins.
+    # @param slot Snapshot slot
+    @abstractmethod
+    def clear_snapshot(self, slot):
+        raise NotImplementedError
+
     # Export plugin as LV2.
     # @param pluginId Plugin
     # @param lv2path Path to lv2 plugin folder
@@ -2058,6 +2186,37 @@ class CarlaHostMeta():
     def get_output_peak_value(self, pluginId, isLeft):
         raise NotImplementedError
 
+    # Get the parameter data of all parameters of a plugin.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_all_parameter_data(self, pluginId):
+        raise NotImplementedError
+
+    # Get the parameter ranges of all parameters of a plugin.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_all_parameter_ranges(self, pluginId):
+        raise NotImplementedError
+
+    # Get the current values of all parameters of a plugin.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_current_parameter_values(self, pluginId):
+        raise NotImplementedError
+
+    # Get the parameters of a plugin that changed since the last call.
+    # Returns a tuple with the sequence number to pass next time and a dict of changed parameter values.
+    # @param pluginId Plugin
+    # @param sequence Sequence number from the previous call, use 0 to get all parameters
+    @abstractmethod
+    def get_changed_parameter_values(self, pluginId, sequence):
+        raise NotImplementedError
+
+    # Get the peak values of all plugins, as a list of 4 values per plugin.
+    @abstractmethod
+    def get_all_peak_values(self):
+        raise NotImplementedError
+
     # Render a plugin's inline display.
     # @param pluginId Plugin
     @abstractmethod
@@ -2418,12 +2577,36 @@ class CarlaHostNull(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return False
 
+    def add_plugin_async(self, btype, ptype, filename, name, label, uniqueId, extra, options):
+        return 0
+
+    def remove_plugin_async(self, pluginId):
+        return 0
+
+    def replace_plugin_async(self, pluginId, btype, ptype, filename, name, label, uniqueId, extra, options):
+        return 0
+
     def load_plugin_state(self, pluginId, filename):
         return False
 
     def save_plugin_state(self, pluginId, filename):
         return False
 
+    def save_plugin_snapshot(self, pluginId, slot):
+        return False
+
+    def load_plugin_snapshot(self, pluginId, slot):
+        return False
+
+    def save_snapshot(self, slot):
+        return False
+
+    def load_snapshot(self, slot):
+        return False
+
+    def clear_snapshot(self, slot):
+        return
+
     def export_plugin_lv2(self, pluginId, lv2path):
         return False
 
@@ -2508,6 +2691,21 @@ class CarlaHostNull(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return 0.0
 
+    def get_all_parameter_data(self, pluginId):
+        return []
+
+    def get_all_parameter_ranges(self, pluginId):
+        return []
+
+    def get_current_parameter_values(self, pluginId):
+        return []
+
+    def get_changed_parameter_values(self, pluginId, sequence):
+        return (sequence, {})
+
+    def get_all_peak_values(self):
+        return []
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
@@ -2740,12 +2938,38 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_switch_plugins.argtypes = (c_void_p, c_uint, c_uint)
         self.lib.carla_switch_plugins.restype = c_bool
 
+        self.lib.carla_add_plugin_async.argtypes = (c_void_p, c_enum, c_enum, c_char_p, c_char_p, c_char_p, c_int64,
+                                                    c_char_p, c_uint)
+        self.lib.carla_add_plugin_async.restype = c_uint
+
+        self.lib.carla_remove_plugin_async.argtypes = (c_void_p, c_uint)
+        self.lib.carla_remove_plugin_async.restype = c_uint
+
+        self.lib.carla_replace_plugin_async.argtypes = (c_void_p, c_uint, c_enum, c_enum, c_char_p, c_char_p, c_char_p,
+                                                        c_int64, c_char_p, c_uint)
+        self.lib.carla_replace_plugin_async.restype = c_uint
+
         self.lib.carla_load_plugin_state.argtypes = (c_void_p, c_uint, c_char_p)
         self.lib.carla_load_plugin_state.restype = c_bool
 
         self.lib.carla_save_plugin_state.argtypes = (c_void_p, c_uint, c_char_p)
         self.lib.carla_save_plugin_state.restype = c_bool
 
+        self.lib.carla_save_plugin_snapshot.argtypes = (c_void_p, c_uint, c_uint)
+        self.lib.carla_save_plugin_snapshot.restype = c_bool
+
+        self.lib.carla_load_plugin_snapshot.argtypes = (c_void_p, c_uint, c_uint)
+        self.lib.carla_load_plugin_snapshot.restype = c_bool
+
+        self.lib.carla_save_snapshot.argtypes = (c_void_p, c_uint)
+        self.lib.carla_save_snapshot.restype = c_bool
+
+        self.lib.carla_load_snapshot.argtypes = (c_void_p, c_uint)
+        self.lib.carla_load_snapshot.restype = c_bool
+
+        self.lib.carla_clear_snapshot.argtypes = (c_void_p, c_uint)
+        self.lib.carla_clear_snapshot.restype = None
+
         self.lib.carla_export_plugin_lv2.argtypes = (c_void_p, c_uint, c_char_p)
         self.lib.carla_export_plugin_lv2.restype = c_bool
 
@@ -2830,6 +3054,22 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_output_peak_value.argtypes = (c_void_p, c_uint, c_bool)
         self.lib.carla_get_output_peak_value.restype = c_float
 
+        self.lib.carla_get_all_parameter_data.argtypes = (c_void_p, c_uint, POINTER(ParameterData), c_uint32)
+        self.lib.carla_get_all_parameter_data.restype = c_uint32
+
+        self.lib.carla_get_all_parameter_ranges.argtypes = (c_void_p, c_uint, POINTER(ParameterRanges), c_uint32)
+        self.lib.carla_get_all_parameter_ranges.restype = c_uint32
+
+        self.lib.carla_get_current_parameter_values.argtypes = (c_void_p, c_uint, POINTER(c_float), c_uint32)
+        self.lib.carla_get_current_parameter_values.restype = c_uint32
+
+        self.lib.carla_get_changed_parameter_values.argtypes = (c_void_p, c_uint, POINTER(c_uint32),
+                                                                POINTER(c_uint32), POINTER(c_float), c_uint32)
+        self.lib.carla_get_changed_parameter_values.restype = c_uint32
+
+        self.lib.carla_get_all_peak_values.argtypes = (c_void_p, POINTER(c_float), c_uint)
+        self.lib.carla_get_all_peak_values.restype = c_uint
+
         self.lib.carla_render_inline_display.argtypes = (c_void_p, c_uint, c_uint, c_uint)
         self.lib.carla_render_inline_display.restype = POINTER(CarlaInlineDisplayImageSurface)
 
@@ -3063,12 +3303,54 @@ class CarlaHostDLL(CarlaHostMeta):
     def switch_plugins(self, pluginIdA, pluginIdB):
         return bool(self.lib.carla_switch_plugins(self.handle, pluginIdA, pluginIdB))
 
+    def add_plugin_async(self, btype, ptype, filename, name, label, uniqueId, extra, options):
+        cfilename = filename.encode("utf-8") if filename else None
+        cname     = name.encode("utf-8") if name else None
+        cextra    = extra.encode("utf-8") if extra else None
+        if ptype == PLUGIN_JACK:
+            clabel = bytes(ord(b) for b in label)
+        else:
+            clabel = label.encode("utf-8") if label else None
+
+        return int(self.lib.carla_add_plugin_async(self.handle, btype, ptype,
+                                                   cfilename, cname, clabel, uniqueId, cextra, options))
+
+    def remove_plugin_async(self, pluginId):
+        return int(self.lib.carla_remove_plugin_async(self.handle, pluginId))
+
+    def replace_plugin_async(self, pluginId, btype, ptype, filename, name, label, uniqueId, extra, options):
+        cfilename = filename.encode("utf-8") if filename else None
+        cname     = name.encode("utf-8") if name else None
+        cextra    = extra.encode("utf-8") if extra else None
+        if ptype == PLUGIN_JACK:
+            clabel = bytes(ord(b) for b in label)
+        else:
+            clabel = label.encode("utf-8") if label else None
+
+        return int(self.lib.carla_replace_plugin_async(self.handle, pluginId, btype, ptype,
+                                                       cfilename, cname, clabel, uniqueId, cextra, options))
+
     def load_plugin_state(self, pluginId, filename):
         return bool(self.lib.carla_load_plugin_state(self.handle, pluginId, filename.encode("utf-8")))
 
     def save_plugin_state(self, pluginId, filename):
         return bool(self.lib.carla_save_plugin_state(self.handle, pluginId, filename.encode("utf-8")))
 
+    def save_plugin_snapshot(self, pluginId, slot):
+        return bool(self.lib.carla_save_plugin_snapshot(self.handle, pluginId, slot))
+
+    def load_plugin_snapshot(self, pluginId, slot):
+        return bool(self.lib.carla_load_plugin_snapshot(self.handle, pluginId, slot))
+
+    def save_snapshot(self, slot):
+        return bool(self.lib.carla_save_snapshot(self.handle, slot))
+
+    def load_snapshot(self, slot):
+        return bool(self.lib.carla_load_snapshot(self.handle, slot))
+
+    def clear_snapshot(self, slot):
+        self.lib.carla_clear_snapshot(self.handle, slot)
+
     def export_plugin_lv2(self, pluginId, lv2path):
         return bool(self.lib.carla_export_plugin_lv2(self.handle, pluginId, lv2path.encode("utf-8")))
 
@@ -3159,6 +3441,39 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return float(self.lib.carla_get_output_peak_value(self.handle, pluginId, isLeft))
 
+    def get_all_parameter_data(self, pluginId):
+        count = int(self.lib.carla_get_parameter_count(self.handle, pluginId))
+        data  = (ParameterData * count)()
+        count = int(self.lib.carla_get_all_parameter_data(self.handle, pluginId, data, count))
+        return [structToDict(data[i]) for i in range(count)]
+
+    def get_all_parameter_ranges(self, pluginId):
+        count  = int(self.lib.carla_get_parameter_count(self.handle, pluginId))
+        ranges = (ParameterRanges * count)()
+        count  = int(self.lib.carla_get_all_parameter_ranges(self.handle, pluginId, ranges, count))
+        return [structToDict(ranges[i]) for i in range(count)]
+
+    def get_current_parameter_values(self, pluginId):
+        count  = int(self.lib.carla_get_parameter_count(self.handle, pluginId))
+        values = (c_float * count)()
+        count  = int(self.lib.carla_get_current_parameter_values(self.handle, pluginId, values, count))
+        return values[:count]
+
+    def get_changed_parameter_values(self, pluginId, sequence):
+        count    = int(self.lib.carla_get_parameter_count(self.handle, pluginId))
+        indexes  = (c_uint32 * count)()
+        values   = (c_float * count)()
+        sequence = c_uint32(sequence)
+        count    = int(self.lib.carla_get_changed_parameter_values(self.handle, pluginId, byref(sequence),
+                                                                   indexes, values, count))
+        return (sequence.value, dict(zip(indexes[:count], values[:count])))
+
+    def get_all_peak_values(self):
+        count = int(self.lib.carla_get_current_plugin_count(self.handle))
+        peaks = (c_float * (count * 4))()
+        count = int(self.lib.carla_get_all_peak_values(self.handle, peaks, count))
+        return [peaks[i*4:i*4+4] for i in range(count)]
+
     def render_inline_display(self, pluginId, width, height):
         ptr = self.lib.carla_render_inline_display(self.handle, pluginId, width, height)
         if not ptr or not ptr.contents:
@@ -3470,12 +3785,39 @@ class CarlaHostPlugin(CarlaHostMeta):
             self._switchPlugins(pluginIdA, pluginIdB)
         return ret
 
+    def add_plugin_async(self, btype, ptype, filename, name, label, uniqueId, extra, options):
+        self.fLastError = "Operation unavailable in plugin version"
+        return 0
+
+    def remove_plugin_async(self, pluginId):
+        self.fLastError = "Operation unavailable in plugin version"
+        return 0
+
+    def replace_plugin_async(self, pluginId, btype, ptype, filename, name, label, uniqueId, extra, options):
+        self.fLastError = "Operation unavailable in plugin version"
+        return 0
+
     def load_plugin_state(self, pluginId, filename):
         return self.sendMsgAndSetError(["load_plugin_state", pluginId, filename])
 
     def save_plugin_state(self, pluginId, filename):
         return self.sendMsgAndSetError(["save_plugin_state", pluginId, filename])
 
+    def save_plugin_snapshot(self, pluginId, slot):
+        return self.sendMsgAndSetError(["save_plugin_snapshot", pluginId, slot])
+
+    def load_plugin_snapshot(self, pluginId, slot):
+        return self.sendMsgAndSetError(["load_plugin_snapshot", pluginId, slot])
+
+    def save_snapshot(self, slot):
+        return self.sendMsgAndSetError(["save_snapshot", slot])
+
+    def load_snapshot(self, slot):
+        return self.sendMsgAndSetError(["load_snapshot", slot])
+
+    def clear_snapshot(self, slot):
+        self.sendMsg(["clear_snapshot", slot])
+
     def export_plugin_lv2(self, pluginId, lv2path):
         self.fLastError = "Operation unavailable in plugin version"
         return False
@@ -3572,6 +3914,23 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return self.fPluginsInfo[pluginId].peaks[2 if isLeft else 3]
 
+    def get_all_parameter_data(self, pluginId):
+        return self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).parameterData[:]
+
+    def get_all_parameter_ranges(self, pluginId):
+        return self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).parameterRanges[:]
+
+    def get_current_parameter_values(self, pluginId):
+        return self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).parameterValues[:]
+
+    def get_changed_parameter_values(self, pluginId, sequence):
+        # changes are not tracked here, always report everything
+        values = self.fPluginsInfo.get(pluginId, self.fFallbackPluginInfo).parameterValues
+        return (0, dict(enumerate(values)))
+
+    def get_all_peak_values(self):
+        return [self.fPluginsInfo[pluginId].peaks[:] for pluginId in sorted(self.fPluginsInfo)]
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
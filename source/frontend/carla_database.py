@@ -21,6 +21,7 @@
 
 from copy import deepcopy
 from subprocess import Popen, PIPE
+from threading import Thread
 
 from PyQt5.QtCore import pyqtSignal, pyqtSlot, Qt, QByteArray, QEventLoop, QThread
 from PyQt5.QtGui import QPixmap
@@ -172,6 +173,89 @@ def findWinePrefix(filename, recursionLimit = 10):
 
     return findWinePrefix(path, recursionLimit-1)
 
+def parseCarlaDiscoveryLine(line, itype, filename, pinfo, plugins):
+    fakeLabel = os.path.basename(filename).rsplit(".", 1)[0]
+
+    if line == "carla-discovery::init::-----------":
+        pinfo = deepcopy(PyPluginInfo)
+        pinfo['type']     = itype
+        pinfo['filename'] = filename if filename != ":all" else ""
+
+    elif line == "carla-discovery::end::------------":
+        if pinfo is not None:
+            plugins.append(pinfo)
+            del pinfo
+            pinfo = None
+
+    elif line == "Segmentation fault":
+        print("carla-discovery::crash::%s crashed during discovery" % filename)
+
+    elif line.startswith("err:module:import_dll Library"):
+        print(line)
+
+    elif line.startswith("carla-discovery::info::"):
+        print("%s - %s" % (line, filename))
+
+    elif line.startswith("carla-discovery::warning::"):
+        print("%s - %s" % (line, filename))
+
+    elif line.startswith("carla-discovery::error::"):
+        print("%s - %s" % (line, filename))
+
+    elif line.startswith("carla-discovery::"):
+        if pinfo == None:
+            return pinfo
+
+        try:
+            prop, value = line.replace("carla-discovery::", "").split("::", 1)
+        except:
+            return pinfo
+
+        if prop == "build":
+            if value.isdigit(): pinfo['build'] = int(value)
+        elif prop == "name":
+            pinfo['name'] = value if value else fakeLabel
+        elif prop == "label":
+            pinfo['label'] = value if value else fakeLabel
+        elif prop == "filename":
+            pinfo['filename'] = value
+        elif prop == "maker":
+            pinfo['maker'] = value
+        elif prop == "category":
+            pinfo['category'] = value
+        elif prop == "uniqueId":
+            if value.isdigit(): pinfo['uniqueId'] = int(value)
+        elif prop == "hints":
+            if value.isdigit(): pinfo['hints'] = int(value)
+        elif prop == "audio.ins":
+            if value.isdigit(): pinfo['audio.ins'] = int(value)
+        elif prop == "audio.outs":
+            if value.isdigit(): pinfo['audio.outs'] = int(value)
+        elif prop == "cv.ins":
+            if value.isdigit(): pinfo['cv.ins'] = int(value)
+        elif prop == "cv.outs":
+            if value.isdigit(): pinfo['cv.outs'] = int(value)
+        elif prop == "midi.ins":
+            if value.isdigit(): pinfo['midi.ins'] = int(value)
+        elif prop == "midi.outs":
+            if value.isdigit(): pinfo['midi.outs'] = int(value)
+        elif prop == "parameters.ins":
+            if value.isdigit(): pinfo['parameters.ins'] = int(value)
+        elif prop == "parameters.outs":
+            if value.isdigit(): pinfo['parameters.outs'] = int(value)
+        elif prop == "uri":
+            if value:
+                pinfo['label'] = value
+            else:
+                # cannot use empty URIs
+                del pinfo
+                pinfo = None
+                return pinfo
+        else:
+            print("%s - %s (unknown property)" % (line, filename))
+
+    return pinfo
+
 def runCarlaDiscovery(itype, stype, filename, tool, wineSettings=None):
     if not os.path.exists(tool):
         qWarning("runCarlaDiscovery() - tool '%s' does not exist" % tool)
@@ -218,7 +302,6 @@ def runCarlaDiscovery(itype, stype, filename, tool, wineSettings=None):
 
     pinfo = None
     plugins = []
-    fakeLabel = os.path.basename(filename).rsplit(".", 1)[0]
 
     while True:
         try:
@@ -239,89 +322,82 @@ def runCarlaDiscovery(itype, stype, filename, tool, wineSettings=None):
         else:
             break
 
-        if line == "carla-discovery::init::-----------":
-            pinfo = deepcopy(PyPluginInfo)
-            pinfo['type']     = itype
-            pinfo['filename'] = filename if filename != ":all" else ""
+        pinfo = parseCarlaDiscoveryLine(line, itype, filename, pinfo, plugins)
 
-        elif line == "carla-discovery::end::------------":
-            if pinfo is not None:
-                plugins.append(pinfo)
-                del pinfo
-                pinfo = None
+    tmp = gDiscoveryProcess
+    gDiscoveryProcess = None
+    del tmp
 
-        elif line == "Segmentation fault":
-            print("carla-discovery::crash::%s crashed during discovery" % filename)
+    return plugins
+
+# Scan several files using a single carla-discovery process in service mode (not available for wine or Windows).
+# Files are checked in parallel, the results are yielded as (filename, plugins) in the order they finish.
+def runCarlaDiscoveryService(itype, stype, filenames, tool):
+    if not os.path.exists(tool):
+        qWarning("runCarlaDiscoveryService() - tool '%s' does not exist" % tool)
+        return
 
-        elif line.startswith("err:module:import_dll Library"):
-            print(line)
+    command = ["env", "LANG=C", "LD_PRELOAD=", tool, "--service"]
 
-        elif line.startswith("carla-discovery::info::"):
-            print("%s - %s" % (line, filename))
+    global gDiscoveryProcess
+    gDiscoveryProcess = Popen(command, stdin=PIPE, stdout=PIPE)
 
-        elif line.startswith("carla-discovery::warning::"):
-            print("%s - %s" % (line, filename))
+    # feed requests from a separate thread, so that a full stdout pipe cannot block us
+    def writeRequests(stdin):
+        try:
+            for filename in filenames:
+                # the service protocol is line based
+                if "\n" in filename or "\r" in filename:
+                    qWarning("runCarlaDiscoveryService() - skipping file with newline in its name '%s'" % filename)
+                    continue
+                stdin.write(("%s\t%s\n" % (stype, filename)).encode("utf-8"))
+            stdin.close()
+        except:
+            pass
 
-        elif line.startswith("carla-discovery::error::"):
-            print("%s - %s" % (line, filename))
+    writer = Thread(target=writeRequests, args=(gDiscoveryProcess.stdin,))
+    writer.daemon = True
+    writer.start()
 
-        elif line.startswith("carla-discovery::"):
-            if pinfo == None:
-                continue
+    filename = None
+    pinfo = None
+    plugins = []
 
+    try:
+        while True:
             try:
-                prop, value = line.replace("carla-discovery::", "").split("::", 1)
+                line = gDiscoveryProcess.stdout.readline().decode("utf-8", errors="ignore")
             except:
-                continue
+                print("ERROR: discovery service readline failed")
+                break
 
-            if prop == "build":
-                if value.isdigit(): pinfo['build'] = int(value)
-            elif prop == "name":
-                pinfo['name'] = value if value else fakeLabel
-            elif prop == "label":
-                pinfo['label'] = value if value else fakeLabel
-            elif prop == "filename":
-                pinfo['filename'] = value
-            elif prop == "maker":
-                pinfo['maker'] = value
-            elif prop == "category":
-                pinfo['category'] = value
-            elif prop == "uniqueId":
-                if value.isdigit(): pinfo['uniqueId'] = int(value)
-            elif prop == "hints":
-                if value.isdigit(): pinfo['hints'] = int(value)
-            elif prop == "audio.ins":
-                if value.isdigit(): pinfo['audio.ins'] = int(value)
-            elif prop == "audio.outs":
-                if value.isdigit(): pinfo['audio.outs'] = int(value)
-            elif prop == "cv.ins":
-                if value.isdigit(): pinfo['cv.ins'] = int(value)
-            elif prop == "cv.outs":
-                if value.isdigit(): pinfo['cv.outs'] = int(value)
-            elif prop == "midi.ins":
-                if value.isdigit(): pinfo['midi.ins'] = int(value)
-            elif prop == "midi.outs":
-                if value.isdigit(): pinfo['midi.outs'] = int(value)
-            elif prop == "parameters.ins":
-                if value.isdigit(): pinfo['parameters.ins'] = int(value)
-            elif prop == "parameters.outs":
-                if value.isdigit(): pinfo['parameters.outs'] = int(value)
-            elif prop == "uri":
-                if value:
-                    pinfo['label'] = value
-                else:
-                    # cannot use empty URIs
-                    del pinfo
-                    pinfo = None
-                    continue
-            else:
-                print("%s - %s (unknown property)" % (line, filename))
+            if not line:
+                break
 
-    tmp = gDiscoveryProcess
-    gDiscoveryProcess = None
-    del tmp
+            line = line.strip()
 
-    return plugins
+            if line.startswith("carla-discovery::service-begin::"):
+                filename = line.replace("carla-discovery::service-begin::", "", 1)
+                pinfo = None
+                plugins = []
+
+            elif line.startswith("carla-discovery::service-end::"):
+                if filename is not None:
+                    yield (filename, plugins)
+                filename = None
+
+            elif filename is not None:
+                pinfo = parseCarlaDiscoveryLine(line, itype, filename, pinfo, plugins)
+
+    finally:
+        if gDiscoveryProcess is not None:
+            if gDiscoveryProcess.poll() is None:
+                gDiscoveryProcess.kill()
+            gDiscoveryProcess.wait()
+
+        tmp = gDiscoveryProcess
+        gDiscoveryProcess = None
+        del tmp
 
 def killDiscovery():
     global gDiscoveryProcess
@@ -742,12 +818,10 @@ class SearchPluginsThread(QThread):
         if not self.fContinueChecking:
             return ladspaPlugins
 
-        for i in range(len(ladspaBinaries)):
-            ladspa  = ladspaBinaries[i]
+        for i, (ladspa, plugins) in enumerate(self._runDiscovery(PLUGIN_LADSPA, "LADSPA", ladspaBinaries, tool, isWine)):
             percent = ( float(i) / len(ladspaBinaries) ) * self.fCurPercentValue
             self._pluginLook((self.fLastCheckValue + percent) * 0.9, ladspa)
 
-            plugins = checkPluginLADSPA(ladspa, tool, self.fWineSettings if isWine else None)
             if plugins:
                 ladspaPlugins.append(plugins)
 
@@ -778,12 +852,10 @@ class SearchPluginsThread(QThread):
         if not self.fContinueChecking:
             return dssiPlugins
 
-        for i in range(len(dssiBinaries)):
-            dssi    = dssiBinaries[i]
+        for i, (dssi, plugins) in enumerate(self._runDiscovery(PLUGIN_DSSI, "DSSI", dssiBinaries, tool, isWine)):
             percent = ( float(i) / len(dssiBinaries) ) * self.fCurPercentValue
             self._pluginLook(self.fLastCheckValue + percent, dssi)
 
-            plugins = checkPluginDSSI(dssi, tool, self.fWineSettings if isWine else None)
             if plugins:
                 dssiPlugins.append(plugins)
 
@@ -820,12 +892,10 @@ class SearchPluginsThread(QThread):
         if not self.fContinueChecking:
             return vst2Plugins
 
-        for i in range(len(vst2Binaries)):
-            vst2    = vst2Binaries[i]
+        for i, (vst2, plugins) in enumerate(self._runDiscovery(PLUGIN_VST2, "VST2", vst2Binaries, tool, isWine)):
             percent = ( float(i) / len(vst2Binaries) ) * self.fCurPercentValue
             self._pluginLook(self.fLastCheckValue + percent, vst2)
 
-            plugins = checkPluginVST2(vst2, tool, self.fWineSettings if isWine else None)
             if plugins:
                 vst2Plugins.append(plugins)
 
@@ -862,12 +932,10 @@ class SearchPluginsThread(QThread):
         if not self.fContinueChecking:
             return vst3Plugins
 
-        for i in range(len(vst3Binaries)):
-            vst3    = vst3Binaries[i]
+        for i, (vst3, plugins) in enumerate(self._runDiscovery(PLUGIN_VST3, "VST3", vst3Binaries, tool, isWine)):
             percent = ( float(i) / len(vst3Binaries) ) * self.fCurPercentValue
             self._pluginLook(self.fLastCheckValue + percent, vst3)
 
-            plugins = checkPluginVST3(vst3, tool, self.fWineSettings if isWine else None)
             if plugins:
                 vst3Plugins.append(plugins)
 
@@ -877,6 +945,18 @@ class SearchPluginsThread(QThread):
         self.fLastCheckValue += self.fCurPercentValue
         return vst3Plugins
 
+    def _runDiscovery(self, itype, stype, binaries, tool, isWine):
+        # native tools can scan all binaries at once, in parallel
+        if not (isWine or WINDOWS):
+            for binary, plugins in runCarlaDiscoveryService(itype, stype, binaries, tool):
+                yield (binary, plugins)
+            return
+
+        wineSettings = self.fWineSettings if isWine else None
+
+        for binary in binaries:
+            yield (binary, runCarlaDiscovery(itype, stype, binary, tool, wineSettings))
+
     def _checkAU(self, tool):
         auPlugins = []
 
@@ -2253,6 +2333,7 @@ class JackApplicationW(QDialog):
 
     FLAG_CONTROL_WINDOW              = 0x01
     FLAG_CAPTURE_FIRST_WINDOW        = 0x02
+    FLAG_PARALLEL_CLIENTS            = 0x04
     FLAG_BUFFERS_ADDITION_MODE       = 0x10
     FLAG_MIDI_OUTPUT_CHANNEL_MIXDOWN = 0x20
     FLAG_EXTERNAL_START              = 0x40
@@ -2304,6 +2385,8 @@ class JackApplicationW(QDialog):
             flags |= self.FLAG_CAPTURE_FIRST_WINDOW
         if self.ui.cb_buffers_addition_mode.isChecked():
             flags |= self.FLAG_BUFFERS_ADDITION_MODE
+        if self.ui.cb_parallel_clients.isChecked():
+            flags |= self.FLAG_PARALLEL_CLIENTS
         if self.ui.cb_out_midi_mixdown.isChecked():
             flags |= self.FLAG_MIDI_OUTPUT_CHANNEL_MIXDOWN
         if self.ui.cb_external_start.isChecked():
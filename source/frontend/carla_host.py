@@ -1126,6 +1126,11 @@ class HostWindow(QMainWindow):
 
     @pyqtSlot(int, bool, str)
     def slot_handleCancelableActionCallback(self, pluginId, started, action):
+        # action still running, update its progress text
+        if started and self.fCancelableActionBox is not None:
+            self.fCancelableActionBox.setText(action)
+            return
+
         if self.fCancelableActionBox is not None:
             self.fCancelableActionBox.close()
 
@@ -61,6 +61,9 @@ from carla_backend import (
     PLUGIN_OPTION_SEND_ALL_SOUND_OFF,
     PLUGIN_OPTION_SEND_PROGRAM_CHANGES,
     PLUGIN_OPTION_SKIP_SENDING_NOTES,
+    PLUGIN_OPTION_SLEEP_ON_SILENCE,
+    PLUGIN_OPTION_ALWAYS_PROCESS,
+    PLUGIN_OPTION_MULTI_CORE,
     PARAMETER_DRYWET,
     PARAMETER_VOLUME,
     PARAMETER_BALANCE_LEFT,
@@ -750,6 +753,9 @@ class PluginEdit(QDialog):
 
         self.ui.ch_fixed_buffer.clicked.connect(self.slot_optionChanged)
         self.ui.ch_force_stereo.clicked.connect(self.slot_optionChanged)
+        self.ui.ch_sleep_on_silence.clicked.connect(self.slot_optionChanged)
+        self.ui.ch_always_process.clicked.connect(self.slot_optionChanged)
+        self.ui.ch_multi_core.clicked.connect(self.slot_optionChanged)
         self.ui.ch_map_program_changes.clicked.connect(self.slot_optionChanged)
         self.ui.ch_use_chunks.clicked.connect(self.slot_optionChanged)
         self.ui.ch_send_notes.clicked.connect(self.slot_optionChanged)
@@ -977,6 +983,12 @@ class PluginEdit(QDialog):
         self.ui.ch_fixed_buffer.setChecked(optsEnabled & PLUGIN_OPTION_FIXED_BUFFERS)
         self.ui.ch_force_stereo.setEnabled(optsAvailable & PLUGIN_OPTION_FORCE_STEREO)
         self.ui.ch_force_stereo.setChecked(optsEnabled & PLUGIN_OPTION_FORCE_STEREO)
+        self.ui.ch_sleep_on_silence.setEnabled(optsAvailable & PLUGIN_OPTION_SLEEP_ON_SILENCE)
+        self.ui.ch_sleep_on_silence.setChecked(optsEnabled & PLUGIN_OPTION_SLEEP_ON_SILENCE)
+        self.ui.ch_always_process.setEnabled(optsAvailable & PLUGIN_OPTION_ALWAYS_PROCESS)
+        self.ui.ch_always_process.setChecked(optsEnabled & PLUGIN_OPTION_ALWAYS_PROCESS)
+        self.ui.ch_multi_core.setEnabled(optsAvailable & PLUGIN_OPTION_MULTI_CORE)
+        self.ui.ch_multi_core.setChecked(optsEnabled & PLUGIN_OPTION_MULTI_CORE)
         self.ui.ch_map_program_changes.setEnabled(optsAvailable & PLUGIN_OPTION_MAP_PROGRAM_CHANGES)
         self.ui.ch_map_program_changes.setChecked(optsEnabled & PLUGIN_OPTION_MAP_PROGRAM_CHANGES)
         self.ui.ch_send_notes.setEnabled(optsAvailable & PLUGIN_OPTION_SKIP_SENDING_NOTES)
@@ -1257,6 +1269,12 @@ class PluginEdit(QDialog):
             widget = self.ui.ch_fixed_buffer
         elif option == PLUGIN_OPTION_FORCE_STEREO:
             widget = self.ui.ch_force_stereo
+        elif option == PLUGIN_OPTION_SLEEP_ON_SILENCE:
+            widget = self.ui.ch_sleep_on_silence
+        elif option == PLUGIN_OPTION_ALWAYS_PROCESS:
+            widget = self.ui.ch_always_process
+        elif option == PLUGIN_OPTION_MULTI_CORE:
+            widget = self.ui.ch_multi_core
         elif option == PLUGIN_OPTION_MAP_PROGRAM_CHANGES:
             widget = self.ui.ch_map_program_changes
         elif option == PLUGIN_OPTION_SKIP_SENDING_NOTES:
@@ -1448,6 +1466,12 @@ class PluginEdit(QDialog):
             option = PLUGIN_OPTION_FIXED_BUFFERS
         elif sender == self.ui.ch_force_stereo:
             option = PLUGIN_OPTION_FORCE_STEREO
+        elif sender == self.ui.ch_sleep_on_silence:
+            option = PLUGIN_OPTION_SLEEP_ON_SILENCE
+        elif sender == self.ui.ch_always_process:
+            option = PLUGIN_OPTION_ALWAYS_PROCESS
+        elif sender == self.ui.ch_multi_core:
+            option = PLUGIN_OPTION_MULTI_CORE
         elif sender == self.ui.ch_map_program_changes:
             option = PLUGIN_OPTION_MAP_PROGRAM_CHANGES
         elif sender == self.ui.ch_send_notes:
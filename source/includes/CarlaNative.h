@@ -67,7 +67,9 @@ typedef enum {
     NATIVE_PLUGIN_HAS_INLINE_DISPLAY   = 1 << 12,
     NATIVE_PLUGIN_USES_CONTROL_VOLTAGE = 1 << 13,
     NATIVE_PLUGIN_REQUESTS_IDLE        = 1 << 15,
-    NATIVE_PLUGIN_USES_UI_SIZE         = 1 << 16
+    NATIVE_PLUGIN_USES_UI_SIZE         = 1 << 16,
+    NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE = 1 << 17, /** can use the same in/out buffers        */
+    NATIVE_PLUGIN_USES_PARAM_EVENTS    = 1 << 18  /** sample-accurate parameter changes      */
 } NativePluginHints;
 
 typedef enum {
@@ -170,6 +172,12 @@ typedef struct {
     uint8_t  data[4];
 } NativeMidiEvent;
 
+typedef struct {
+    uint32_t time;
+    uint32_t index;
+    float    value;
+} NativeParameterEvent;
+
 typedef struct {
     uint32_t bank;
     uint32_t program;
@@ -304,6 +312,17 @@ typedef struct _NativePluginDescriptor {
     /* placed at the end for backwards compatibility. only valid if NATIVE_PLUGIN_USES_UI_SIZE is set */
     uint16_t ui_width, ui_height;
 
+    /* placed at the end for backwards compatibility. only valid if NATIVE_PLUGIN_USES_PARAM_EVENTS is set.
+     * same as process, with parameter changes sorted by time and meant to be applied at that frame.
+     * each change is given to the plugin once, either here or through set_parameter_value.
+     * the host uses set_parameter_value for changes it cannot pass here, such as changes queued for a cycle that is
+     * skipped (then called before returning from that cycle, in the audio thread) or changes past the event limit.
+     * plugins must still implement set_parameter_value and process. */
+    void (*process_with_parameter_events)(NativePluginHandle handle,
+                                          float** inBuffer, float** outBuffer, uint32_t frames,
+                                          const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                          const NativeParameterEvent* paramEvents, uint32_t paramEventCount);
+
 } NativePluginDescriptor;
 
 /* ------------------------------------------------------------------------------------------------------------
@@ -640,7 +640,8 @@ public:                                                                      \
     ClassName::_set_state,              \
     ClassName::_dispatcher,             \
     ClassName::_render_inline_display,  \
-    0, 0, nullptr, nullptr, 0, 0
+    0, 0, nullptr, nullptr, 0, 0,       \
+    nullptr
 
 // --------------------------------------------------------------------------------------------------------------------
 
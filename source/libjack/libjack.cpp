@@ -17,10 +17,12 @@
 
 #include "libjack.hpp"
 
+#include "CarlaSemUtils.hpp"
 #include "CarlaThread.hpp"
 #include "CarlaJuceUtils.hpp"
 
 #include <signal.h>
+#include <unistd.h>
 #include <sys/prctl.h>
 #include <sys/time.h>
 
@@ -95,8 +97,80 @@ private:
 
 // ---------------------------------------------------------------------------------------------------------------------
 
+class CarlaJackParallelThread : public CarlaThread
+{
+public:
+    struct Callback {
+        Callback() {}
+        virtual ~Callback() {};
+        virtual void runParallelClients() = 0;
+    };
+
+    CarlaJackParallelThread(Callback* const callback)
+        : CarlaThread("CarlaJackParallelThread"),
+          fCallback(callback),
+          fStartSem(),
+          fDoneSem()
+    {
+        carla_sem_create2(fStartSem, false);
+        carla_sem_create2(fDoneSem, false);
+    }
+
+    ~CarlaJackParallelThread() noexcept override
+    {
+        CARLA_SAFE_ASSERT(! isThreadRunning());
+
+        carla_sem_destroy2(fStartSem);
+        carla_sem_destroy2(fDoneSem);
+    }
+
+    // wake up the thread for a single process cycle
+    void startProcessing() noexcept
+    {
+        carla_sem_post(fStartSem);
+    }
+
+    // wait until the thread is done with the current process cycle
+    void waitForProcessing() noexcept
+    {
+        for (; ! carla_sem_timedwait(fDoneSem, 1000);)
+        {
+            if (! isThreadRunning())
+                break;
+        }
+    }
+
+protected:
+    void run() override
+    {
+#ifdef __SSE2_MATH__
+        // Set FTZ and DAZ flags
+        _mm_setcsr(_mm_getcsr() | 0x8040);
+#endif
+
+        for (; ! shouldThreadExit();)
+        {
+            if (! carla_sem_timedwait(fStartSem, 100))
+                continue;
+
+            fCallback->runParallelClients();
+            carla_sem_post(fDoneSem);
+        }
+    }
+
+private:
+    Callback* const fCallback;
+    carla_sem_t fStartSem;
+    carla_sem_t fDoneSem;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaJackParallelThread)
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+
 class CarlaJackAppClient : public CarlaJackRealtimeThread::Callback,
-                           public CarlaJackNonRealtimeThread::Callback
+                           public CarlaJackNonRealtimeThread::Callback,
+                           public CarlaJackParallelThread::Callback
 {
 public:
     JackServerState fServer;
@@ -125,7 +199,16 @@ public:
           fSetupHints(0),
           fRealtimeThread(this),
           fNonRealtimeThread(this),
-          fRealtimeThreadMutex()
+          fRealtimeThreadMutex(),
+          fParallelThreads(),
+          fNumParallelThreads(0),
+          fNumParallelThreadsStarted(0),
+          fParallelClients(),
+          fParallelClientCount(0),
+          fParallelClientNext(0),
+          fParallelTransportChanged(false),
+          fCpuLoadMaxUsecs(0),
+          fCpuLoadCycles(0)
 #ifdef DEBUG
           ,leakDetector_CarlaJackAppClient()
 #endif
@@ -181,6 +264,10 @@ public:
                                      fSessionManager,
                                      nullptr);
 
+        // needs to be ready before any client gets activated
+        if (fSetupHints & LIBJACK_FLAG_PARALLEL_CLIENTS)
+            startParallelThreads();
+
         fNonRealtimeThread.startThread(false);
 
         fInitialized = true;
@@ -195,6 +282,8 @@ public:
 
         fNonRealtimeThread.stopThread(5000);
 
+        stopParallelThreads();
+
         {
             const CarlaMutexLocker cms(fRealtimeThreadMutex);
 
@@ -248,6 +337,9 @@ public:
             return false;
         }
 
+        if (fNumParallelThreads != 0)
+            allocateParallelBuffer(jclient);
+
         jclient->activated = true;
         jclient->deactivated = false;
         return true;
@@ -323,11 +415,20 @@ public:
 protected:
     void runRealtimeThread() override;
     void runNonRealtimeThread() override;
+    void runParallelClients() override;
 
 private:
     bool initSharedMemmory();
     void clearSharedMemory() noexcept;
 
+    void startParallelThreads();
+    void stopParallelThreads() noexcept;
+    void allocateParallelBuffer(JackClientState* jclient);
+    uint startParallelClients(bool transportChanged);
+    int finishParallelClients(float* fdataRealOuts, int numClientOutputsProcessed);
+    void processClientInParallel(JackClientState* jclient);
+    void updateCpuLoad(jack_time_t cycleStartTime) noexcept;
+
     bool handleRtData();
     bool handleNonRtData();
 
@@ -362,6 +463,23 @@ private:
 
     CarlaMutex fRealtimeThreadMutex;
 
+    // parallel processing of clients, see LIBJACK_FLAG_PARALLEL_CLIENTS
+    static const uint kMaxParallelThreads = 8;
+    static const uint kMaxParallelClients = 64;
+
+    CarlaJackParallelThread* fParallelThreads[kMaxParallelThreads];
+    uint fNumParallelThreads;
+    uint fNumParallelThreadsStarted;
+
+    JackClientState* fParallelClients[kMaxParallelClients];
+    uint fParallelClientCount;
+    volatile uint fParallelClientNext;
+    bool fParallelTransportChanged;
+
+    // used for jack_cpu_load
+    jack_time_t fCpuLoadMaxUsecs;
+    uint fCpuLoadCycles;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaJackAppClient)
 };
 
@@ -508,6 +626,264 @@ void CarlaJackAppClient::clearSharedMemory() noexcept
     fShmNonRtServerControl.clear();
 }
 
+// ---------------------------------------------------------------------------------------------------------------------
+
+void CarlaJackAppClient::startParallelThreads()
+{
+    // the realtime thread takes part in the processing, so one less thread than CPUs
+    const long numCPUs = ::sysconf(_SC_NPROCESSORS_ONLN);
+
+    if (numCPUs <= 1)
+    {
+        carla_stdout("CarlaJackAppClient: single CPU system, clients will not be processed in parallel");
+        return;
+    }
+
+    const uint numThreads = std::min(static_cast<uint>(numCPUs - 1), kMaxParallelThreads);
+
+    for (uint i=0; i<numThreads; ++i)
+    {
+        CarlaJackParallelThread* const thread = new CarlaJackParallelThread(this);
+
+        if (! thread->startThread(true))
+        {
+            delete thread;
+            break;
+        }
+
+        fParallelThreads[fNumParallelThreads++] = thread;
+    }
+
+    carla_stdout("CarlaJackAppClient: processing clients in parallel with %u extra threads", fNumParallelThreads);
+}
+
+void CarlaJackAppClient::stopParallelThreads() noexcept
+{
+    for (uint i=0; i<fNumParallelThreads; ++i)
+    {
+        CarlaJackParallelThread* const thread = fParallelThreads[i];
+        fParallelThreads[i] = nullptr;
+
+        thread->stopThread(1000);
+        delete thread;
+    }
+
+    fNumParallelThreads = 0;
+}
+
+void CarlaJackAppClient::allocateParallelBuffer(JackClientState* const jclient)
+{
+    delete[] jclient->parallelBuffer;
+    jclient->parallelBuffer = nullptr;
+
+    if (fServer.bufferSize == 0)
+        return;
+
+    // audio outputs, then a scratch buffer for unused ports
+    jclient->parallelBuffer = new float[fServer.bufferSize*(fServer.numAudioOuts+1U)];
+}
+
+uint CarlaJackAppClient::startParallelClients(const bool transportChanged)
+{
+    uint count = 0;
+
+    for (LinkedList<JackClientState*>::Itenerator it = fClients.begin2(); it.valid(); it.next())
+    {
+        JackClientState* const jclient(it.getValue(nullptr));
+        CARLA_SAFE_ASSERT_CONTINUE(jclient != nullptr);
+
+        jclient->processInParallel = false;
+
+        if (count == kMaxParallelClients || ! jclient->mutex.tryLock())
+            continue;
+
+        // MIDI outputs are shared between clients, leave those for the realtime thread
+        if (jclient->processCb == nullptr || ! jclient->activated ||
+            jclient->parallelBuffer == nullptr || ! jclient->midiOuts.isEmpty())
+        {
+            jclient->mutex.unlock();
+            continue;
+        }
+
+        jclient->processInParallel = true;
+        fParallelClients[count++] = jclient;
+    }
+
+    // nothing to gain with a single client
+    if (count < 2)
+    {
+        for (uint i=0; i<count; ++i)
+        {
+            JackClientState* const jclient = fParallelClients[i];
+            fParallelClients[i] = nullptr;
+
+            jclient->processInParallel = false;
+            jclient->mutex.unlock();
+        }
+
+        return 0;
+    }
+
+    fParallelClientCount = count;
+    fParallelClientNext = 0;
+    fParallelTransportChanged = transportChanged;
+    fNumParallelThreadsStarted = std::min(fNumParallelThreads, count - 1);
+
+    for (uint i=0; i<fNumParallelThreadsStarted; ++i)
+        fParallelThreads[i]->startProcessing();
+
+    return count;
+}
+
+int CarlaJackAppClient::finishParallelClients(float* const fdataRealOuts, int numClientOutputsProcessed)
+{
+    // help with whatever is left, then wait for the other threads
+    runParallelClients();
+
+    for (uint i=0; i<fNumParallelThreadsStarted; ++i)
+        fParallelThreads[i]->waitForProcessing();
+
+    const std::size_t outputsSize = fServer.bufferSize*fServer.numAudioOuts;
+
+    for (uint i=0; i<fParallelClientCount; ++i)
+    {
+        JackClientState* const jclient = fParallelClients[i];
+        fParallelClients[i] = nullptr;
+
+        if (outputsSize != 0)
+        {
+            if (++numClientOutputsProcessed == 1)
+                carla_copyFloats(fdataRealOuts, jclient->parallelBuffer, outputsSize);
+            else
+                carla_add(fdataRealOuts, jclient->parallelBuffer, outputsSize);
+        }
+
+        jclient->processInParallel = false;
+        jclient->mutex.unlock();
+    }
+
+    fParallelClientCount = 0;
+    fNumParallelThreadsStarted = 0;
+
+    return numClientOutputsProcessed;
+}
+
+void CarlaJackAppClient::processClientInParallel(JackClientState* const jclient)
+{
+    const uint32_t bufferSize = fServer.bufferSize;
+
+    // private location for outputs, mixed down to shm buffer later on
+    float* const fdataOuts = jclient->parallelBuffer;
+    // scratch buffer for ports we cannot map
+    float* const fdataTmp  = fdataOuts + (bufferSize*fServer.numAudioOuts);
+    bool needsTmpBufClear = false;
+
+    // report transport sync changes if needed
+    if (fParallelTransportChanged && jclient->syncCb != nullptr)
+    {
+        jclient->syncCb(fServer.playing ? JackTransportRolling : JackTransportStopped,
+                        &fServer.position,
+                        jclient->syncCbPtr);
+    }
+
+    uint8_t i;
+
+    // set audio inputs, directly from shm buffer
+    i = 0;
+    for (LinkedList<JackPortState*>::Itenerator it = jclient->audioIns.begin2(); it.valid(); it.next())
+    {
+        JackPortState* const jport = it.getValue(nullptr);
+        CARLA_SAFE_ASSERT_CONTINUE(jport != nullptr);
+
+        if (i < fServer.numAudioIns)
+        {
+            jport->buffer = fShmAudioPool.data + (i*bufferSize);
+        }
+        else
+        {
+            jport->buffer = fdataTmp;
+            needsTmpBufClear = true;
+        }
+
+        ++i;
+    }
+
+    // set audio outputs
+    i = 0;
+    for (LinkedList<JackPortState*>::Itenerator it = jclient->audioOuts.begin2(); it.valid(); it.next())
+    {
+        JackPortState* const jport = it.getValue(nullptr);
+        CARLA_SAFE_ASSERT_CONTINUE(jport != nullptr);
+
+        if (i < fServer.numAudioOuts)
+        {
+            jport->buffer = fdataOuts + (i*bufferSize);
+        }
+        else
+        {
+            jport->buffer = fdataTmp;
+            needsTmpBufClear = true;
+        }
+
+        ++i;
+    }
+
+    const uint8_t numClientAudioOuts = std::min(i, fServer.numAudioOuts);
+
+    // set midi inputs
+    i = 0;
+    for (LinkedList<JackPortState*>::Itenerator it = jclient->midiIns.begin2(); it.valid(); it.next())
+    {
+        JackPortState* const jport = it.getValue(nullptr);
+        CARLA_SAFE_ASSERT_CONTINUE(jport != nullptr);
+
+        if (i++ < fServer.numMidiIns)
+            jport->buffer = &fMidiInBuffers[i-1];
+        else
+            jport->buffer = &fDummyMidiInBuffer;
+    }
+
+    if (needsTmpBufClear)
+        carla_zeroFloats(fdataTmp, bufferSize);
+
+    jclient->processCb(bufferSize, jclient->processCbPtr);
+
+    if (numClientAudioOuts == 1)
+    {
+        // mono client, copy to all outputs
+        for (uint8_t j=1; j<fServer.numAudioOuts; ++j)
+            carla_copyFloats(fdataOuts+(bufferSize*j), fdataOuts, bufferSize);
+    }
+    else if (numClientAudioOuts < fServer.numAudioOuts)
+    {
+        carla_zeroFloats(fdataOuts+(bufferSize*numClientAudioOuts),
+                         bufferSize*static_cast<uint8_t>(fServer.numAudioOuts - numClientAudioOuts));
+    }
+}
+
+void CarlaJackAppClient::updateCpuLoad(const jack_time_t cycleStartTime) noexcept
+{
+    const jack_time_t cycleUsecs = jack_get_time() - cycleStartTime;
+
+    if (fCpuLoadMaxUsecs < cycleUsecs)
+        fCpuLoadMaxUsecs = cycleUsecs;
+
+    // same as JACK, report the worst of the last 32 cycles, smoothed over time
+    if (++fCpuLoadCycles < 32)
+        return;
+
+    if (fServer.bufferSize != 0 && carla_isNotZero(fServer.sampleRate))
+    {
+        const double periodUsecs = static_cast<double>(fServer.bufferSize) * 1000000.0 / fServer.sampleRate;
+        const double load = 100.0 * static_cast<double>(fCpuLoadMaxUsecs) / periodUsecs;
+
+        fServer.cpuLoad = (fServer.cpuLoad + static_cast<float>(load)) * 0.5f;
+    }
+
+    fCpuLoadMaxUsecs = 0;
+    fCpuLoadCycles = 0;
+}
+
 bool CarlaJackAppClient::handleRtData()
 {
     if (fNewClients.count() != 0)
@@ -581,6 +957,9 @@ bool CarlaJackAppClient::handleRtData()
 
                         if (jclient->bufferSizeCb != nullptr)
                             jclient->bufferSizeCb(fServer.bufferSize, jclient->bufferSizeCbPtr);
+
+                        if (fNumParallelThreads != 0)
+                            allocateParallelBuffer(jclient);
                     }
 
                     delete[] fAudioTmpBuf;
@@ -795,6 +1174,8 @@ bool CarlaJackAppClient::handleRtData()
             {
                 CARLA_SAFE_ASSERT_BREAK(fShmAudioPool.data != nullptr);
 
+                const jack_time_t cycleStartTime = jack_get_time();
+
                 // mixdown is default, do buffer addition (for multiple clients) if requested
                 const bool doBufferAddition  = fSetupHints & LIBJACK_FLAG_AUDIO_BUFFERS_ADDITION;
                 // mixdown midi outputs based on channel if requested
@@ -842,12 +1223,21 @@ bool CarlaJackAppClient::handleRtData()
 
                     int numClientOutputsProcessed = 0;
 
+                    // clients are only independent of each other when not chaining buffers
+                    const uint numParallelClients = (fNumParallelThreads != 0 && ! doBufferAddition)
+                                                  ? startParallelClients(transportChanged)
+                                                  : 0;
+
                     // now go through each client
                     for (LinkedList<JackClientState*>::Itenerator it = fClients.begin2(); it.valid(); it.next())
                     {
                         JackClientState* const jclient(it.getValue(nullptr));
                         CARLA_SAFE_ASSERT_CONTINUE(jclient != nullptr);
 
+                        // already being taken care of
+                        if (jclient->processInParallel)
+                            continue;
+
                         const CarlaMutexTryLocker cmtl2(jclient->mutex, fIsOffline);
 
                         // check if we can process
@@ -1002,6 +1392,9 @@ bool CarlaJackAppClient::handleRtData()
                         }
                     }
 
+                    if (numParallelClients != 0)
+                        numClientOutputsProcessed = finishParallelClients(fdataRealOuts, numClientOutputsProcessed);
+
                     if (numClientOutputsProcessed > 1 && ! doBufferAddition)
                     {
                         // more than 1 client active, need to divide buffers
@@ -1112,6 +1505,8 @@ bool CarlaJackAppClient::handleRtData()
                         }
                     }
                 }
+
+                updateCpuLoad(cycleStartTime);
             }
             else
             {
@@ -1313,6 +1708,12 @@ void CarlaJackAppClient::runRealtimeThread()
     return; (void)quitReceived;
 }
 
+void CarlaJackAppClient::runParallelClients()
+{
+    for (uint index; (index = __sync_fetch_and_add(&fParallelClientNext, 1)) < fParallelClientCount;)
+        processClientInParallel(fParallelClients[index]);
+}
+
 void CarlaJackAppClient::runNonRealtimeThread()
 {
     carla_debug("CarlaJackAppClient runNonRealtimeThread START");
@@ -1428,6 +1829,8 @@ void CarlaJackAppClient::runNonRealtimeThread()
 
     fRealtimeThread.stopThread(5000);
 
+    stopParallelThreads();
+
     carla_debug("CarlaJackAppClient runNonRealtimeThread FINISHED");
 }
 
@@ -219,6 +219,11 @@ struct JackClientState {
     JackThreadInitCallback threadInitCb;
     void* threadInitCbPtr;
 
+    // private audio outputs plus scratch buffer, used when processing clients in parallel
+    float* parallelBuffer;
+    // true while this client is being processed in a parallel thread
+    bool processInParallel;
+
     JackClientState(const JackServerState& s, const char* const n)
         : server(s),
           mutex(),
@@ -247,7 +252,9 @@ struct JackClientState {
           syncCb(nullptr),
           syncCbPtr(nullptr),
           threadInitCb(nullptr),
-          threadInitCbPtr(nullptr) {}
+          threadInitCbPtr(nullptr),
+          parallelBuffer(nullptr),
+          processInParallel(false) {}
 
     ~JackClientState()
     {
@@ -287,6 +294,9 @@ struct JackClientState {
 
         portIdMapping.clear();
         portNameMapping.clear();
+
+        delete[] parallelBuffer;
+        parallelBuffer = nullptr;
     }
 
     CARLA_DECLARE_NON_COPY_STRUCT(JackClientState)
@@ -309,6 +319,9 @@ struct JackServerState {
     jack_position_t position;
     jack_nframes_t monotonic_frame;
 
+    // DSP load of our process cycle, in percent
+    float cpuLoad;
+
     JackServerState(CarlaJackAppClient* const app)
         : jackAppPtr(app),
           bufferSize(0),
@@ -320,7 +333,8 @@ struct JackServerState {
           numMidiOuts(0),
           playing(false),
           position(),
-          monotonic_frame(0)
+          monotonic_frame(0),
+          cpuLoad(0.0f)
     {
         carla_zeroStruct(position);
     }
@@ -64,10 +64,14 @@ jack_nframes_t jack_get_buffer_size(jack_client_t* client)
 }
 
 CARLA_EXPORT
-float jack_cpu_load(jack_client_t*)
+float jack_cpu_load(jack_client_t* client)
 {
-    // TODO
-    return 0.0f;
+    carla_debug("%s(%p)", __FUNCTION__, client);
+
+    JackClientState* const jclient = (JackClientState*)client;
+    CARLA_SAFE_ASSERT_RETURN(jclient != nullptr, 0.0f);
+
+    return jclient->server.cpuLoad;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
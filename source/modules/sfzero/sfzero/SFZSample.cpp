@@ -8,6 +8,11 @@
 #include "SFZSample.h"
 #include "SFZDebug.h"
 
+#include "CarlaMutex.hpp"
+
+#include "water/containers/HashMap.h"
+#include "water/misc/Time.h"
+
 #if 0
 #include "water/audioformat/AudioFormatManager.h"
 #include "water/audioformat/AudioFormatReader.h"
@@ -21,7 +26,81 @@ extern "C" {
 namespace sfzero
 {
 
-bool Sample::load()
+// Decoded sample data, shared by all samples loaded from the same file
+struct SampleData
+{
+  water::String cacheKey; // empty if not in the cache
+  int refCount;
+  CarlaScopedPointer<water::AudioSampleBuffer> buffer;
+  double sampleRate;
+  water::uint64 sampleLength, loopStart, loopEnd;
+
+  SampleData() : cacheKey(), refCount(1), buffer(), sampleRate(0), sampleLength(0), loopStart(0), loopEnd(0) {}
+
+  CARLA_DECLARE_NON_COPY_STRUCT(SampleData)
+};
+
+// Process-wide cache of decoded files, so that instances loading the same instrument share their samples
+struct SampleCache
+{
+  CarlaMutex mutex;
+  water::HashMap<water::String, SampleData *> files;
+
+  static SampleCache &getInstance()
+  {
+    static SampleCache cache;
+    return cache;
+  }
+
+  // Returns a new reference to the data cached for 'key', or null if there is none
+  SampleData *acquire(const water::String &key)
+  {
+    const CarlaMutexLocker cml(mutex);
+
+    SampleData *const data = files[key];
+    if (data != nullptr)
+    {
+      ++data->refCount;
+    }
+    return data;
+  }
+
+  // Adds freshly decoded data to the cache.
+  // If another thread added the same file meanwhile, 'data' is discarded and the cached data is returned instead.
+  SampleData *add(SampleData *data)
+  {
+    const CarlaMutexLocker cml(mutex);
+
+    if (SampleData *const cached = files[data->cacheKey])
+    {
+      ++cached->refCount;
+      delete data;
+      return cached;
+    }
+
+    files.set(data->cacheKey, data);
+    return data;
+  }
+
+  void release(SampleData *data)
+  {
+    const CarlaMutexLocker cml(mutex);
+
+    if (--data->refCount > 0)
+    {
+      return;
+    }
+
+    if (data->cacheKey.isNotEmpty())
+    {
+      files.remove(data->cacheKey);
+    }
+
+    delete data;
+  }
+};
+
+static bool decodeSampleFile(const water::File &file, SampleData &data)
 {
 #if 0
     static water::AudioFormatManager afm;
@@ -32,30 +111,30 @@ bool Sample::load()
         afm.registerBasicFormats();
     }
 
-    water::AudioFormatReader* reader = afm.createReaderFor(file_);
+    water::AudioFormatReader* reader = afm.createReaderFor(file);
     CARLA_SAFE_ASSERT_RETURN(reader != nullptr, false);
 
-    sampleRate_ = reader->sampleRate;
-    sampleLength_ = (water::uint64) reader->lengthInSamples;
+    data.sampleRate = reader->sampleRate;
+    data.sampleLength = (water::uint64) reader->lengthInSamples;
 
     // Read some extra samples, which will be filled with zeros, so interpolation
     // can be done without having to check for the edge all the time.
-    CARLA_SAFE_ASSERT_RETURN(sampleLength_ < std::numeric_limits<int>::max(), false);
+    CARLA_SAFE_ASSERT_RETURN(data.sampleLength < std::numeric_limits<int>::max(), false);
 
-    water::AudioSampleBuffer* buf = new water::AudioSampleBuffer((int) reader->numChannels, static_cast<int>(sampleLength_ + 4), true);
-    reader->read(buf, 0, static_cast<int>(sampleLength_ + 4), 0, true, true);
-    buffer_ = buf;
+    water::AudioSampleBuffer* buf = new water::AudioSampleBuffer((int) reader->numChannels, static_cast<int>(data.sampleLength + 4), true);
+    reader->read(buf, 0, static_cast<int>(data.sampleLength + 4), 0, true, true);
+    data.buffer = buf;
 
     water::StringPairArray *metadata = &reader->metadataValues;
     int numLoops = metadata->getValue("NumSampleLoops", "0").getIntValue();
     if (numLoops > 0)
     {
-        loopStart_ = (water::uint64) metadata->getValue("Loop0Start", "0").getLargeIntValue();
-        loopEnd_ = (water::uint64) metadata->getValue("Loop0End", "0").getLargeIntValue();
+        data.loopStart = (water::uint64) metadata->getValue("Loop0Start", "0").getLargeIntValue();
+        data.loopEnd = (water::uint64) metadata->getValue("Loop0End", "0").getLargeIntValue();
     }
     delete reader;
 #else
-    const water::String filename(file_.getFullPathName());
+    const water::String filename(file.getFullPathName());
 
     struct adinfo info;
     carla_zeroStruct(info);
@@ -70,9 +149,9 @@ bool Sample::load()
         return false;
     }
 
-    sampleRate_ = info.sample_rate;
-    sampleLength_ = info.frames/info.channels;
-    // TODO loopStart_, loopEnd_
+    data.sampleRate = info.sample_rate;
+    data.sampleLength = info.frames/info.channels;
+    // TODO loopStart, loopEnd
 
     // read interleaved buffer
     float* const rbuffer = (float*)std::calloc(1, sizeof(float)*info.frames);
@@ -100,31 +179,91 @@ bool Sample::load()
     // NOTE: We add some extra samples, which will be filled with zeros,
     // so interpolation can be done without having to check for the edge all the time.
 
-    buffer_ = new water::AudioSampleBuffer(info.channels, sampleLength_ + 4, true);
+    data.buffer = new water::AudioSampleBuffer(info.channels, data.sampleLength + 4, true);
 
     for (int i=info.channels; --i >= 0;)
-        buffer_->copyFromInterleavedSource(i, rbuffer, r);
+        data.buffer->copyFromInterleavedSource(i, rbuffer, r);
 
     std::free(rbuffer);
     ad_close(handle);
 #endif
 
+
     return true;
 }
 
-Sample::~Sample() { }
+bool Sample::load()
+{
+  const water::String cacheKey(file_.getFullPathName() + "@" +
+                               water::String(file_.getLastModificationTime().toMilliseconds()));
+
+  SampleCache &cache(SampleCache::getInstance());
+
+  if (SampleData *const cached = cache.acquire(cacheKey))
+  {
+    carla_debug("Sample '%s' already loaded, sharing it", getShortName().toRawUTF8());
+    setData(cached);
+    return true;
+  }
+
+  // decoding is done without holding the cache lock, so that other files can be loaded in parallel
+  SampleData *const data = new SampleData();
+
+  if (! decodeSampleFile(file_, *data))
+  {
+    delete data;
+    return false;
+  }
+
+  data->cacheKey = cacheKey;
+  setData(cache.add(data));
+  return true;
+}
+
+Sample::~Sample() { setData(nullptr); }
 
 water::String Sample::getShortName() { return (file_.getFileName()); }
 
-void Sample::setBuffer(water::AudioSampleBuffer *newBuffer)
+void Sample::setBuffer(water::AudioSampleBuffer *newBuffer, double sampleRate)
 {
-  buffer_ = newBuffer;
-  sampleLength_ = buffer_->getNumSamples();
+  SampleData *const data = new SampleData();
+  data->buffer = newBuffer;
+  data->sampleRate = sampleRate;
+  data->sampleLength = newBuffer->getNumSamples();
+  setData(data);
 }
 
-water::AudioSampleBuffer *Sample::detachBuffer()
+void Sample::setData(SampleData *data)
 {
-  return buffer_.release();
+  if (data_ != nullptr)
+  {
+    SampleCache::getInstance().release(data_);
+  }
+
+  data_ = data;
+
+  if (data != nullptr)
+  {
+    buffer_ = data->buffer.get();
+    sampleRate_ = data->sampleRate;
+    sampleLength_ = data->sampleLength;
+    loopStart_ = data->loopStart;
+    loopEnd_ = data->loopEnd;
+  }
+  else
+  {
+    buffer_ = nullptr;
+    sampleRate_ = 0;
+    sampleLength_ = loopStart_ = loopEnd_ = 0;
+  }
+}
+
+int Sample::getNumCachedFiles()
+{
+  SampleCache &cache(SampleCache::getInstance());
+  const CarlaMutexLocker cml(cache.mutex);
+
+  return cache.files.size();
 }
 
 water::String Sample::dump() { return file_.getFullPathName() + "\n"; }
@@ -17,35 +17,44 @@
 namespace sfzero
 {
 
+struct SampleData;
+
 class Sample
 {
 public:
-  explicit Sample(const water::File &fileIn) : file_(fileIn), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
+  explicit Sample(const water::File &fileIn) : file_(fileIn), data_(nullptr), buffer_(nullptr), sampleRate_(0), sampleLength_(0), loopStart_(0), loopEnd_(0) {}
   virtual ~Sample();
 
+  // Decoded data is shared through a process-wide cache, keyed by file path and modification time.
+  // This can be called from any thread.
   bool load();
 
   water::File getFile() { return (file_); }
   water::AudioSampleBuffer *getBuffer() { return (buffer_); }
   double getSampleRate() { return (sampleRate_); }
   water::String getShortName();
-  void setBuffer(water::AudioSampleBuffer *newBuffer);
-  water::AudioSampleBuffer *detachBuffer();
+  void setBuffer(water::AudioSampleBuffer *newBuffer, double sampleRate);
   water::String dump();
   water::uint64 getSampleLength() const { return sampleLength_; }
   water::uint64 getLoopStart() const { return loopStart_; }
   water::uint64 getLoopEnd() const { return loopEnd_; }
 
+  // Number of decoded files currently in the cache.
+  static int getNumCachedFiles();
+
 #ifdef DEBUG
   void checkIfZeroed(const char *where);
 #endif
 
 private:
   water::File file_;
-  CarlaScopedPointer<water::AudioSampleBuffer> buffer_;
+  SampleData *data_;
+  water::AudioSampleBuffer *buffer_;
   double sampleRate_;
   water::uint64 sampleLength_, loopStart_, loopEnd_;
 
+  void setData(SampleData *data);
+
   CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Sample)
 };
 }
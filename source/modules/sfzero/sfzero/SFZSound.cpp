@@ -82,22 +82,158 @@ void Sound::loadRegions()
   reader.read(file_);
 }
 
-void Sound::loadSamples(const LoadingIdleCallback& cb)
+// Samples to be loaded, shared between the loader threads
+struct SampleLoadQueue
 {
+  water::Array<Sample *> samples;
+  water::Array<int> results; // 0 = not loaded yet, 1 = ok, -1 = failed
+  volatile int nextIndex;
+  volatile int numDone;
+  volatile bool canceled;
+
+  SampleLoadQueue() : samples(), results(), nextIndex(0), numDone(0), canceled(false) {}
+
+  // Loads the next sample in the queue, returns false if there are none left
+  bool loadNext()
+  {
+    if (canceled)
+    {
+      return false;
+    }
+
+    const int index = __sync_fetch_and_add(&nextIndex, 1);
+    if (index >= samples.size())
+    {
+      return false;
+    }
+
+    results.getRawDataPointer()[index] = samples.getUnchecked(index)->load() ? 1 : -1;
+    __sync_add_and_fetch(&numDone, 1);
+    return true;
+  }
+
+  CARLA_DECLARE_NON_COPY_STRUCT(SampleLoadQueue)
+};
+
+class SampleLoaderThread : public CarlaThread
+{
+public:
+  explicit SampleLoaderThread(SampleLoadQueue &queue) : CarlaThread("SFZSampleLoader"), queue_(queue) {}
+
+protected:
+  void run() override
+  {
+    while (queue_.loadNext()) {}
+  }
+
+private:
+  SampleLoadQueue &queue_;
+
+  CARLA_DECLARE_NON_COPY_CLASS(SampleLoaderThread)
+};
+
+static const int kMaxSampleLoaderThreads = 16;
+
+static int getNumCPUs()
+{
+#ifdef CARLA_OS_WIN
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return static_cast<int>(info.dwNumberOfProcessors);
+#else
+  return static_cast<int>(::sysconf(_SC_NPROCESSORS_ONLN));
+#endif
+}
+
+bool Sound::loadSamples(const LoadingIdleCallback& cb)
+{
+    SampleLoadQueue queue;
+
     for (water::HashMap<water::String, Sample *>::Iterator i(samples_); i.next();)
     {
-        Sample* const sample = i.getValue();
+        queue.samples.add(i.getValue());
+        queue.results.add(0);
+    }
+
+    const int numTotal = queue.samples.size();
 
-        if (sample->load())
+    // The first sample is always loaded here, which takes care of any one-time decoder initialization
+    // before other threads get to use it.
+    queue.loadNext();
+
+    SampleLoaderThread* threads[kMaxSampleLoaderThreads];
+    int numThreads = numTotal > 1 ? std::min(getNumCPUs(), std::min(numTotal - 1, kMaxSampleLoaderThreads)) : 0;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads[i] = new SampleLoaderThread(queue);
+
+        if (! threads[i]->startThread())
         {
-            carla_debug("Loaded sample '%s'", sample->getShortName().toRawUTF8());
-            cb.callback(cb.callbackPtr);
+            delete threads[i];
+            numThreads = i;
+            break;
+        }
+    }
+
+    carla_debug("Loading %i samples using %i threads", numTotal, numThreads);
+
+    for (;;)
+    {
+        // no threads available, load everything here
+        if (numThreads == 0 && ! queue.loadNext())
+        {
+            break;
+        }
+
+        // also synchronizes with the loader threads, so their results are visible
+        const int numDone = __sync_fetch_and_add(&queue.numDone, 0);
+
+        if (numDone == numTotal)
+        {
+            break;
+        }
+
+        if (! cb.callback(cb.callbackPtr, numDone, numTotal))
+        {
+            queue.canceled = true;
+            break;
         }
-        else
+
+        if (numThreads > 0)
         {
+            carla_msleep(5);
+        }
+    }
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        threads[i]->stopThread(-1);
+        delete threads[i];
+    }
+
+    for (int i = 0; i < numTotal; ++i)
+    {
+        Sample* const sample = queue.samples.getUnchecked(i);
+
+        switch (queue.results.getUnchecked(i))
+        {
+        case 1:
+            carla_debug("Loaded sample '%s'", sample->getShortName().toRawUTF8());
+            break;
+        case -1:
             addError("Couldn't load sample \"" + sample->getShortName() + "\"");
+            break;
         }
     }
+
+    if (queue.canceled)
+    {
+        addError("Loading samples was canceled");
+        return false;
+    }
+
+    return true;
 }
 
 Region *Sound::getRegionFor(int note, int velocity, Region::Trigger trigger)
@@ -23,8 +23,10 @@ class Sample;
 class Sound : public water::SynthesiserSound
 {
 public:
+  // Called regularly from the thread running loadSamples(), while samples load in the background.
+  // Returning false cancels loading.
   struct LoadingIdleCallback {
-      void (*callback)(void*);
+      bool (*callback)(void* ptr, int numLoaded, int numTotal);
       void* callbackPtr;
   };
 
@@ -42,7 +44,7 @@ public:
   void addUnsupportedOpcode(const water::String &opcode);
 
   virtual void loadRegions();
-  virtual void loadSamples(const LoadingIdleCallback& cb);
+  virtual bool loadSamples(const LoadingIdleCallback& cb); // returns false if canceled
 
   Region *getRegionFor(int note, int velocity, Region::Trigger trigger = Region::attack);
   int getNumRegions();
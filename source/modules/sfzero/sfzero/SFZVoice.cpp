@@ -20,6 +20,9 @@ namespace sfzero
 
 static const float globalGain = -1.0;
 
+// Maximum number of samples rendered in one go, sized for the temporary buffers on the stack
+static const int kRenderBlockSize = 64;
+
 Voice::Voice()
     : region_(nullptr), curMidiNote_(0), curPitchWheel_(0), pitchRatio_(0), noteGainLeft_(0), noteGainRight_(0),
       sourceSamplePosition_(0), sampleEnd_(0), loopStart_(0), loopEnd_(0), numLoops_(0), curVelocity_(0)
@@ -177,76 +180,165 @@ void Voice::renderNextBlock(water::AudioSampleBuffer &outputBuffer, int startSam
   float *outL = outputBuffer.getWritePointer(0, startSample);
   float *outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer(1, startSample) : nullptr;
 
-  int bufferNumSamples = buffer->getNumSamples(); // leoo
+  const int bufferNumSamples = buffer->getNumSamples(); // leoo
 
   // Cache some values, to give them at least some chance of ending up in
   // registers.
+  const double pitchRatio = pitchRatio_;
   double sourceSamplePosition = this->sourceSamplePosition_;
   float ampegGain = ampeg_.getLevel();
   float ampegSlope = ampeg_.getSlope();
   int samplesUntilNextAmpSegment = ampeg_.getSamplesUntilNextSegment();
   bool ampSegmentIsExponential = ampeg_.getSegmentIsExponential();
-  float loopStart = static_cast<float>(this->loopStart_);
-  float loopEnd = static_cast<float>(this->loopEnd_);
-  float sampleEnd = static_cast<float>(this->sampleEnd_);
+  const bool isLooping = loopStart_ < loopEnd_;
+  const double loopStart = static_cast<double>(this->loopStart_);
+  const double loopEnd = static_cast<double>(this->loopEnd_);
+  const double sampleEnd = static_cast<double>(this->sampleEnd_);
+
+  // Positions below this can be interpolated without any wrap or bounds check.
+  double safeEnd = static_cast<double>(bufferNumSamples - 1);
+  if (isLooping && loopEnd < safeEnd)
+  {
+    safeEnd = loopEnd;
+  }
+  if (sampleEnd < safeEnd)
+  {
+    safeEnd = sampleEnd;
+  }
+
+  // Render in runs that end at the next loop point, envelope segment or sample end,
+  // so the inner loops below don't need to check for any of those.
+  float tmpL[kRenderBlockSize];
+  float tmpR[kRenderBlockSize];
+  float gains[kRenderBlockSize];
 
-  while (--numSamples >= 0)
+  while (numSamples > 0)
   {
-    const int pos = static_cast<int>(sourceSamplePosition);
-    CARLA_SAFE_ASSERT_CONTINUE(pos >= 0 && pos < bufferNumSamples); // leoo
+    const int startPos = static_cast<int>(sourceSamplePosition);
+    CARLA_SAFE_ASSERT_BREAK(startPos >= 0 && startPos < bufferNumSamples); // leoo
 
-    float alpha = static_cast<float>(sourceSamplePosition - pos);
-    float invAlpha = 1.0f - alpha;
-    int nextPos = pos + 1;
-    if ((loopStart < loopEnd) && (nextPos > loopEnd))
+    // The envelope moves to its next segment after the last sample of a run
+    int runSize = numSamples < kRenderBlockSize ? numSamples : kRenderBlockSize;
+    if (samplesUntilNextAmpSegment < runSize)
     {
-      nextPos = static_cast<int>(loopStart);
+      runSize = samplesUntilNextAmpSegment < 0 ? 1 : samplesUntilNextAmpSegment + 1;
     }
 
-    // Simple linear interpolation with buffer overrun check
-    float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[pos];
-    float nextR = inR ? (nextPos < bufferNumSamples ? inR[nextPos] : inR[pos]) : nextL;
-    float l = (inL[pos] * invAlpha + nextL * alpha);
-    float r = inR ? (inR[pos] * invAlpha + nextR * alpha) : l;
-
-    //// Simple linear interpolation, old version (possible buffer overrun with non-loop??)
-    // float l = (inL[pos] * invAlpha + inL[nextPos] * alpha);
-    // float r = inR ? (inR[pos] * invAlpha + inR[nextPos] * alpha) : l;
-
-    float gainLeft = noteGainLeft_ * ampegGain;
-    float gainRight = noteGainRight_ * ampegGain;
-    l *= gainLeft;
-    r *= gainRight;
-    // Shouldn't we dither here?
+    // number of samples we can step through while staying below safeEnd
+    const double safeSteps = (safeEnd - sourceSamplePosition) / pitchRatio;
+    if (safeSteps < static_cast<double>(runSize))
+    {
+      runSize = safeSteps > 1.0 ? static_cast<int>(safeSteps) : 0;
+    }
 
-    if (outR)
+    if (runSize > 0)
     {
-      *outL++ += l;
-      *outR++ += r;
+      // Linear interpolation, no wrap needed
+      double position = sourceSamplePosition;
+      if (inR != nullptr)
+      {
+        for (int i = 0; i < runSize; ++i)
+        {
+          const int pos = static_cast<int>(position);
+          const float alpha = static_cast<float>(position - pos);
+          const float invAlpha = 1.0f - alpha;
+          tmpL[i] = inL[pos] * invAlpha + inL[pos + 1] * alpha;
+          tmpR[i] = inR[pos] * invAlpha + inR[pos + 1] * alpha;
+          position += pitchRatio;
+        }
+      }
+      else
+      {
+        for (int i = 0; i < runSize; ++i)
+        {
+          const int pos = static_cast<int>(position);
+          const float alpha = static_cast<float>(position - pos);
+          tmpL[i] = inL[pos] * (1.0f - alpha) + inL[pos + 1] * alpha;
+          position += pitchRatio;
+        }
+      }
+      sourceSamplePosition = position;
     }
     else
     {
-      *outL++ += (l + r) * 0.5f;
+      // Close to a loop point or buffer end, do a single sample the careful way
+      runSize = 1;
+
+      const float alpha = static_cast<float>(sourceSamplePosition - startPos);
+      const float invAlpha = 1.0f - alpha;
+      int nextPos = startPos + 1;
+      if (isLooping && (nextPos > loopEnd))
+      {
+        nextPos = static_cast<int>(loopStart);
+      }
+
+      // Simple linear interpolation with buffer overrun check
+      const float nextL = nextPos < bufferNumSamples ? inL[nextPos] : inL[startPos];
+      tmpL[0] = inL[startPos] * invAlpha + nextL * alpha;
+
+      if (inR != nullptr)
+      {
+        const float nextR = nextPos < bufferNumSamples ? inR[nextPos] : inR[startPos];
+        tmpR[0] = inR[startPos] * invAlpha + nextR * alpha;
+      }
+
+      sourceSamplePosition += pitchRatio;
     }
 
-    // Next sample.
-    sourceSamplePosition += pitchRatio_;
-    if ((loopStart < loopEnd) && (sourceSamplePosition > loopEnd))
+    // Envelope gain ramp
+    if (ampSegmentIsExponential)
     {
-      sourceSamplePosition = loopStart;
-      numLoops_ += 1;
+      for (int i = 0; i < runSize; ++i)
+      {
+        gains[i] = ampegGain;
+        ampegGain *= ampegSlope;
+      }
+    }
+    else
+    {
+      for (int i = 0; i < runSize; ++i)
+      {
+        gains[i] = ampegGain;
+        ampegGain += ampegSlope;
+      }
     }
 
-    // Update EG.
-    if (ampSegmentIsExponential)
+    // Apply gain and accumulate into output
+    // Shouldn't we dither here?
+    const float *const srcR = inR != nullptr ? tmpR : tmpL;
+    if (outR != nullptr)
     {
-      ampegGain *= ampegSlope;
+      const float gainLeft = noteGainLeft_;
+      const float gainRight = noteGainRight_;
+      for (int i = 0; i < runSize; ++i)
+      {
+        outL[i] += tmpL[i] * gains[i] * gainLeft;
+        outR[i] += srcR[i] * gains[i] * gainRight;
+      }
+      outR += runSize;
     }
     else
     {
-      ampegGain += ampegSlope;
+      const float gainLeft = noteGainLeft_ * 0.5f;
+      const float gainRight = noteGainRight_ * 0.5f;
+      for (int i = 0; i < runSize; ++i)
+      {
+        outL[i] += (tmpL[i] * gainLeft + srcR[i] * gainRight) * gains[i];
+      }
     }
-    if (--samplesUntilNextAmpSegment < 0)
+    outL += runSize;
+    numSamples -= runSize;
+
+    // Loop point
+    if (isLooping && (sourceSamplePosition > loopEnd))
+    {
+      sourceSamplePosition = loopStart;
+      numLoops_ += 1;
+    }
+
+    // Update EG.
+    samplesUntilNextAmpSegment -= runSize;
+    if (samplesUntilNextAmpSegment < 0)
     {
       ampeg_.setLevel(ampegGain);
       ampeg_.nextSegment();
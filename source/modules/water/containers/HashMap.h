@@ -30,6 +30,7 @@
 #include "../containers/Variant.h"
 #include "../text/String.h"
 
+#include "CarlaJuceUtils.hpp"
 #include "CarlaScopeUtils.hpp"
 
 namespace water {
@@ -1062,6 +1062,16 @@ int64 File::getSize() const
     return 0;
 }
 
+Time File::getLastModificationTime() const
+{
+    WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+    if (GetFileAttributesEx (fullPath.toUTF8(), GetFileExInfoStandard, &attributes))
+        return Time (WindowsFileHelpers::fileTimeToTime (&attributes.ftLastWriteTime));
+
+    return Time();
+}
+
 bool File::deleteFile() const
 {
     if (! exists())
@@ -1291,6 +1301,12 @@ int64 File::getSize() const
     return water_stat (fullPath, info) ? info.st_size : 0;
 }
 
+Time File::getLastModificationTime() const
+{
+    water_statStruct info;
+    return Time (water_stat (fullPath, info) ? (int64) info.st_mtime * 1000 : 0);
+}
+
 bool File::deleteFile() const
 {
     if (! exists() && ! isSymbolicLink())
@@ -132,6 +132,12 @@ public:
     */
     int64 getSize() const;
 
+    /** Returns the last modification time of this file.
+
+        @returns    the time, or the Unix epoch if the file doesn't exist.
+    */
+    Time getLastModificationTime() const;
+
     /** Utility function to convert a file size in bytes to a neat string description.
 
         So for example 100 would return "100 bytes", 2000 would return "2 KB",
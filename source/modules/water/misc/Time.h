@@ -82,6 +82,13 @@ public:
     */
     static Time getCurrentTime() noexcept;
 
+    /** Returns the time as a number of milliseconds.
+
+        @returns    the number of milliseconds this Time object represents, since
+                    midnight Jan 1st 1970 UTC.
+    */
+    int64 toMilliseconds() const noexcept                           { return millisSinceEpoch; }
+
     //==============================================================================
     // Static methods for getting system timers directly..
 
@@ -37,6 +37,9 @@ AudioProcessor::AudioProcessor()
 
     suspended = false;
     nonRealtime = false;
+
+    inputsSilent = false;
+    outputsSilent = false;
 }
 
 AudioProcessor::~AudioProcessor()
@@ -295,6 +295,33 @@ public:
     */
     virtual void setNonRealtime (bool isNonRealtime) noexcept;
 
+    //==============================================================================
+    /** Returns true if the host knows all audio inputs of the current block are silent.
+
+        This is only valid during processBlock(), and is just a hint: when false, the
+        inputs might still be silent.
+
+        @see setInputsSilent
+    */
+    bool areInputsSilent() const noexcept                               { return inputsSilent; }
+
+    /** Called by the host before processBlock() to tell this processor its audio inputs
+        are known to be silent.
+    */
+    void setInputsSilent (bool silent) noexcept                         { inputsSilent = silent; }
+
+    /** Returns true if the processor reported its audio outputs as silent for the
+        current block.
+
+        @see setOutputsSilent
+    */
+    bool areOutputsSilent() const noexcept                              { return outputsSilent; }
+
+    /** The host resets this before processBlock(), a processor can then call it during
+        processBlock() to tell the host all of its audio outputs contain exact zeros.
+    */
+    void setOutputsSilent (bool silent) noexcept                        { outputsSilent = silent; }
+
     //==============================================================================
     /** This is called by the processor to specify its details before being played. Use this
         version of the function if you are not interested in any sidechain and/or aux buses
@@ -317,6 +344,7 @@ private:
     double currentSampleRate;
     int blockSize, latencySamples;
     bool suspended, nonRealtime;
+    bool inputsSilent, outputsSilent;
     CarlaRecursiveMutex callbackLock;
 
     uint numAudioIns, numAudioOuts;
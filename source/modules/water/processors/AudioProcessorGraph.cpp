@@ -33,6 +33,7 @@ struct AudioGraphRenderingOpBase
     virtual ~AudioGraphRenderingOpBase() {}
 
     virtual void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                          bool* const sharedAudioChansSilent,
                           AudioSampleBuffer& sharedCVBufferChans,
                           const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                           const int numSamples) = 0;
@@ -43,11 +44,13 @@ template <class Child>
 struct AudioGraphRenderingOp  : public AudioGraphRenderingOpBase
 {
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                   const int numSamples) override
     {
         static_cast<Child*> (this)->perform (sharedAudioBufferChans,
+                                             sharedAudioChansSilent,
                                              sharedCVBufferChans,
                                              sharedMidiBuffers,
                                              numSamples);
@@ -61,14 +64,20 @@ struct ClearChannelOp  : public AudioGraphRenderingOp<ClearChannelOp>
         : channelNum (channel), isCV (cv) {}
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.clear (channelNum, 0, numSamples);
+        }
         else
+        {
             sharedAudioBufferChans.clear (channelNum, 0, numSamples);
+            sharedAudioChansSilent[channelNum] = true;
+        }
     }
 
     const int channelNum;
@@ -84,14 +93,20 @@ struct CopyChannelOp  : public AudioGraphRenderingOp<CopyChannelOp>
         : srcChannelNum (srcChan), dstChannelNum (dstChan), isCV (cv) {}
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.copyFrom (dstChannelNum, 0, sharedCVBufferChans, srcChannelNum, 0, numSamples);
+        }
         else
+        {
             sharedAudioBufferChans.copyFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
+            sharedAudioChansSilent[dstChannelNum] = sharedAudioChansSilent[srcChannelNum];
+        }
     }
 
     const int srcChannelNum, dstChannelNum;
@@ -107,14 +122,20 @@ struct AddChannelOp  : public AudioGraphRenderingOp<AddChannelOp>
         : srcChannelNum (srcChan), dstChannelNum (dstChan), isCV (cv) {}
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
                   const int numSamples)
     {
         if (isCV)
+        {
             sharedCVBufferChans.addFrom (dstChannelNum, 0, sharedCVBufferChans, srcChannelNum, 0, numSamples);
-        else
+        }
+        else if (! sharedAudioChansSilent[srcChannelNum])
+        {
             sharedAudioBufferChans.addFrom (dstChannelNum, 0, sharedAudioBufferChans, srcChannelNum, 0, numSamples);
+            sharedAudioChansSilent[dstChannelNum] = false;
+        }
     }
 
     const int srcChannelNum, dstChannelNum;
@@ -128,7 +149,7 @@ struct ClearMidiBufferOp  : public AudioGraphRenderingOp<ClearMidiBufferOp>
 {
     ClearMidiBufferOp (const int buffer) noexcept  : bufferNum (buffer)  {}
 
-    void perform (AudioSampleBuffer&, AudioSampleBuffer&,
+    void perform (AudioSampleBuffer&, bool* const, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                   const int)
     {
@@ -147,7 +168,7 @@ struct CopyMidiBufferOp  : public AudioGraphRenderingOp<CopyMidiBufferOp>
         : srcBufferNum (srcBuffer), dstBufferNum (dstBuffer)
     {}
 
-    void perform (AudioSampleBuffer&, AudioSampleBuffer&,
+    void perform (AudioSampleBuffer&, bool* const, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                   const int)
     {
@@ -166,7 +187,7 @@ struct AddMidiBufferOp  : public AudioGraphRenderingOp<AddMidiBufferOp>
         : srcBufferNum (srcBuffer), dstBufferNum (dstBuffer)
     {}
 
-    void perform (AudioSampleBuffer&, AudioSampleBuffer&,
+    void perform (AudioSampleBuffer&, bool* const, AudioSampleBuffer&,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                   const int numSamples)
     {
@@ -192,6 +213,7 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
     }
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>&,
                   const int numSamples)
@@ -201,6 +223,10 @@ struct DelayChannelOp  : public AudioGraphRenderingOp<DelayChannelOp>
                     : sharedAudioBufferChans.getWritePointer (channel, 0);
         HeapBlock<float>& block = buffer;
 
+        // the delay line might still hold older non-silent data
+        if (! isCV)
+            sharedAudioChansSilent[channel] = false;
+
         for (int i = numSamples; --i >= 0;)
         {
             block [writeIndex] = *data;
@@ -235,6 +261,7 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
           cvInChannelsToUse (cvInChannelsUsed),
           cvOutChannelsToUse (cvOutChannelsUsed),
           totalAudioChans (jmax (1U, totalNumChans)),
+          numAudioIns (n->getProcessor()->getTotalNumInputChannels (AudioProcessor::ChannelTypeAudio)),
           totalCVIns (cvInChannelsUsed.size()),
           totalCVOuts (cvOutChannelsUsed.size()),
           midiBufferToUse (midiBuffer)
@@ -248,6 +275,7 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
     }
 
     void perform (AudioSampleBuffer& sharedAudioBufferChans,
+                  bool* const sharedAudioChansSilent,
                   AudioSampleBuffer& sharedCVBufferChans,
                   const OwnedArray<MidiBuffer>& sharedMidiBuffers,
                   const int numSamples)
@@ -269,17 +297,40 @@ struct ProcessBufferOp   : public AudioGraphRenderingOp<ProcessBufferOp>
         AudioSampleBuffer cvInBuffer  (cvInChannelsCopy, totalCVIns, numSamples);
         AudioSampleBuffer cvOutBuffer (cvOutChannelsCopy, totalCVOuts, numSamples);
 
+        bool outputsSilent;
+
         if (processor->isSuspended())
         {
             audioBuffer.clear();
             cvOutBuffer.clear();
+            outputsSilent = true;
         }
         else
         {
+            bool inputsSilent = true;
+
+            for (uint i = 0; i < numAudioIns; ++i)
+            {
+                if (! sharedAudioChansSilent[audioChannelsToUse.getUnchecked (i)])
+                {
+                    inputsSilent = false;
+                    break;
+                }
+            }
+
             const CarlaRecursiveMutexLocker cml (processor->getCallbackLock());
 
+            processor->setInputsSilent (inputsSilent);
+            processor->setOutputsSilent (false);
+
             callProcess (audioBuffer, cvInBuffer, cvOutBuffer, *sharedMidiBuffers.getUnchecked (midiBufferToUse));
+
+            outputsSilent = processor->areOutputsSilent();
         }
+
+        // processing happens in-place, so this covers all channels we touched
+        for (uint i = 0; i < totalAudioChans; ++i)
+            sharedAudioChansSilent[audioChannelsToUse.getUnchecked (i)] = outputsSilent;
     }
 
     void callProcess (AudioSampleBuffer& audioBuffer,
@@ -302,6 +353,7 @@ private:
     HeapBlock<float*> cvOutChannels;
     AudioSampleBuffer tempBuffer;
     const uint totalAudioChans;
+    const uint numAudioIns;
     const uint totalCVIns;
     const uint totalCVOuts;
     const int midiBufferToUse;
@@ -1103,7 +1155,7 @@ AudioProcessorGraph::Connection::Connection (ChannelType ct,
 
 //==============================================================================
 AudioProcessorGraph::Node::Node (const uint32 nodeID, AudioProcessor* const p) noexcept
-    : nodeId (nodeID), processor (p), isPrepared (false)
+    : nodeId (nodeID), processor (p), isPrepared (false), pruned (false), alwaysProcessed (false)
 {
     wassert (processor != nullptr);
 }
@@ -1151,6 +1203,12 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
 
         renderingCVBuffers.setSize (newNumCVChannels, newNumSamples);
         renderingCVBuffers.clear();
+
+        // all rendering buffers start cleared, so also silent
+        CARLA_SAFE_ASSERT_RETURN (renderingAudioChansSilent.realloc (static_cast<size_t>(jmax (1, newNumAudioChannels))),);
+
+        for (int i = 0; i < newNumAudioChannels; ++i)
+            renderingAudioChansSilent[i] = true;
     }
 
     void release() noexcept
@@ -1173,6 +1231,7 @@ struct AudioProcessorGraph::AudioProcessorGraphBufferHelpers
     }
 
     AudioSampleBuffer        renderingAudioBuffers;
+    HeapBlock<bool>          renderingAudioChansSilent;
     AudioSampleBuffer        renderingCVBuffers;
     AudioSampleBuffer*       currentAudioInputBuffer;
     const AudioSampleBuffer* currentCVInputBuffer;
@@ -1275,6 +1334,20 @@ bool AudioProcessorGraph::removeNode (Node* node)
     return removeNode (node->nodeId);
 }
 
+void AudioProcessorGraph::setNodeAlwaysProcessed (const uint32 nodeId, const bool alwaysProcessed)
+{
+    Node* const node = getNodeForId (nodeId);
+    CARLA_SAFE_ASSERT_RETURN (node != nullptr,);
+
+    if (node->alwaysProcessed == alwaysProcessed)
+        return;
+
+    node->alwaysProcessed = alwaysProcessed;
+
+    if (isPrepared)
+        needsReorder = true;
+}
+
 //==============================================================================
 const AudioProcessorGraph::Connection* AudioProcessorGraph::getConnectionBetween (const ChannelType ct,
                                                                                   const uint32 sourceNodeId,
@@ -1502,6 +1575,8 @@ void AudioProcessorGraph::buildRenderingSequence()
             }
         }
 
+        pruneUnusedNodes (orderedNodes);
+
         GraphRenderingOps::RenderingOpSequenceCalculator calculator (*this, orderedNodes, newRenderingOps);
 
         numAudioRenderingBuffersNeeded = calculator.getNumAudioBuffersNeeded();
@@ -1530,6 +1605,50 @@ void AudioProcessorGraph::buildRenderingSequence()
     deleteRenderOpArray (newRenderingOps);
 }
 
+void AudioProcessorGraph::pruneUnusedNodes (Array<Node*>& orderedNodes)
+{
+    // nodes without outputs (including the graph outputs) are where rendering ends,
+    // everything that can't reach one of them through connections does not need processing
+    SortedSet<uint32> usedNodes;
+
+    for (int i = 0; i < nodes.size(); ++i)
+    {
+        const Node* const node = nodes.getUnchecked(i);
+        const AudioProcessor* const proc = node->getProcessor();
+
+        if (node->alwaysProcessed
+            || (proc->getTotalNumOutputChannels (AudioProcessor::ChannelTypeAudio) == 0
+                && proc->getTotalNumOutputChannels (AudioProcessor::ChannelTypeCV) == 0
+                && proc->getTotalNumOutputChannels (AudioProcessor::ChannelTypeMIDI) == 0))
+            usedNodes.add (node->nodeId);
+    }
+
+    for (bool changed = true; changed;)
+    {
+        changed = false;
+
+        for (size_t i = 0; i < connections.size(); ++i)
+        {
+            const Connection* const c = connections.getUnchecked(i);
+
+            if (usedNodes.contains (c->destNodeId) && ! usedNodes.contains (c->sourceNodeId))
+            {
+                usedNodes.add (c->sourceNodeId);
+                changed = true;
+            }
+        }
+    }
+
+    for (int i = orderedNodes.size(); --i >= 0;)
+    {
+        Node* const node = orderedNodes.getUnchecked(i);
+        node->pruned = ! usedNodes.contains (node->nodeId);
+
+        if (node->pruned)
+            orderedNodes.remove (i);
+    }
+}
+
 //==============================================================================
 void AudioProcessorGraph::prepareToPlay (double sampleRate, int estimatedSamplesPerBlock)
 {
@@ -1607,7 +1726,7 @@ void AudioProcessorGraph::processAudio (AudioSampleBuffer& audioBuffer, MidiBuff
         GraphRenderingOps::AudioGraphRenderingOpBase* const op
             = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
-        op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
+        op->perform (renderingAudioBuffers, renderingAudioChansSilent, renderingCVBuffers, midiBuffers, numSamples);
     }
 
     for (uint32_t i = 0; i < audioBuffer.getNumChannels(); ++i)
@@ -1628,6 +1747,7 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
     AudioSampleBuffer&        currentAudioOutputBuffer = audioAndCVBuffers->currentAudioOutputBuffer;
     AudioSampleBuffer&        currentCVOutputBuffer    = audioAndCVBuffers->currentCVOutputBuffer;
     AudioSampleBuffer&        renderingAudioBuffers    = audioAndCVBuffers->renderingAudioBuffers;
+    bool* const               renderingAudioChansSilent = audioAndCVBuffers->renderingAudioChansSilent;
     AudioSampleBuffer&        renderingCVBuffers       = audioAndCVBuffers->renderingCVBuffers;
 
     const int numSamples = audioBuffer.getNumSamples();
@@ -1653,7 +1773,7 @@ void AudioProcessorGraph::processAudioAndCV (AudioSampleBuffer& audioBuffer,
         GraphRenderingOps::AudioGraphRenderingOpBase* const op
             = (GraphRenderingOps::AudioGraphRenderingOpBase*) renderingOps.getUnchecked(i);
 
-        op->perform (renderingAudioBuffers, renderingCVBuffers, midiBuffers, numSamples);
+        op->perform (renderingAudioBuffers, renderingAudioChansSilent, renderingCVBuffers, midiBuffers, numSamples);
     }
 
     for (uint32_t i = 0; i < audioBuffer.getNumChannels(); ++i)
@@ -1684,13 +1804,16 @@ void AudioProcessorGraph::processBlockWithCV (AudioSampleBuffer& audioBuffer,
     processAudioAndCV (audioBuffer, cvInBuffer, cvOutBuffer, midiMessages);
 }
 
-void AudioProcessorGraph::reorderNowIfNeeded()
+bool AudioProcessorGraph::reorderNowIfNeeded()
 {
     if (needsReorder)
     {
         needsReorder = false;
         buildRenderingSequence();
+        return true;
     }
+
+    return false;
 }
 
 const CarlaRecursiveMutex& AudioProcessorGraph::getReorderMutex() const
@@ -80,6 +80,15 @@ public:
         */
         NamedValueSet properties;
 
+        /** Returns true if this node was left out of the current rendering sequence,
+            because none of its outputs can reach the graph outputs.
+            @see AudioProcessorGraph::setNodeAlwaysProcessed
+        */
+        bool isPruned() const noexcept                          { return pruned; }
+
+        /** Returns true if this node is processed even when its outputs are not used. */
+        bool isAlwaysProcessed() const noexcept                 { return alwaysProcessed; }
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         typedef ReferenceCountedObjectPtr<Node> Ptr;
@@ -89,7 +98,7 @@ public:
         friend class AudioProcessorGraph;
 
         const CarlaScopedPointer<AudioProcessor> processor;
-        bool isPrepared;
+        bool isPrepared, pruned, alwaysProcessed;
 
         Node (uint32 nodeId, AudioProcessor*) noexcept;
 
@@ -192,6 +201,14 @@ public:
      */
     bool removeNode (Node* node);
 
+    /** Makes a node always part of the rendering sequence.
+
+        By default, nodes whose outputs do not (directly or indirectly) reach any of the
+        graph outputs are skipped while rendering. Use this for nodes that need to run
+        regardless, like recorders or analysers with unused outputs.
+    */
+    void setNodeAlwaysProcessed (uint32 nodeId, bool alwaysProcessed);
+
     //==============================================================================
     /** Returns the number of connections in the graph. */
     size_t getNumConnections() const                                    { return connections.size(); }
@@ -361,7 +378,7 @@ public:
     bool acceptsMidi() const override;
     bool producesMidi() const override;
 
-    void reorderNowIfNeeded();
+    bool reorderNowIfNeeded();
     const CarlaRecursiveMutex& getReorderMutex() const;
 
 private:
@@ -392,6 +409,7 @@ private:
 public:
     void clearRenderingSequence();
     void buildRenderingSequence();
+    void pruneUnusedNodes (Array<Node*>& orderedNodes);
     bool isAnInputTo (uint32 possibleInputId, uint32 possibleDestinationId, int recursionCheck) const;
 
     CARLA_DECLARE_NON_COPY_CLASS (AudioProcessorGraph)
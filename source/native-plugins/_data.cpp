@@ -28,7 +28,7 @@
     nullptr, nullptr, nullptr, nullptr, nullptr, \
     nullptr, nullptr
 #define DESCFUNCS_WITHOUTCV \
-    DESCFUNCS_WITHCV, 0, 0, nullptr, nullptr, 0, 0
+    DESCFUNCS_WITHCV, 0, 0, nullptr, nullptr, 0, 0, nullptr
 
 static const NativePluginDescriptor sNativePluginDescriptors[] = {
 
@@ -37,7 +37,9 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
     /* audioIns  */ 1,
     /* audioOuts */ 1,
@@ -53,7 +55,9 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
     /* audioIns  */ 2,
     /* audioOuts */ 2,
@@ -104,11 +108,13 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
     /* bufnamefn  */ nullptr,
     /* bufrangefn */ nullptr,
     /* ui_width   */ 0,
-    /* ui_height  */ 0
+    /* ui_height  */ 0,
+    /* paramevfn  */ nullptr
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_NOTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -124,7 +130,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -140,7 +147,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -156,7 +164,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -223,7 +232,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
     /* bufnamefn  */ nullptr,
     /* bufrangefn */ nullptr,
     /* ui_width   */ 0,
-    /* ui_height  */ 0
+    /* ui_height  */ 0,
+    /* paramevfn  */ nullptr
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
@@ -243,7 +253,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -259,7 +270,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
 },
 {
     /* category  */ NATIVE_PLUGIN_CATEGORY_UTILITY,
-    /* hints     */ NATIVE_PLUGIN_IS_RTSAFE,
+    /* hints     */ static_cast<NativePluginHints>(NATIVE_PLUGIN_IS_RTSAFE
+                                                  |NATIVE_PLUGIN_USES_PARAM_EVENTS),
     /* supports  */ NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     /* audioIns  */ 0,
     /* audioOuts */ 0,
@@ -514,7 +526,8 @@ static const NativePluginDescriptor sNativePluginDescriptors[] = {
     /* bufnamefn  */ nullptr,
     /* bufrangefn */ nullptr,
     /* ui_width   */ 0,
-    /* ui_height  */ 0
+    /* ui_height  */ 0,
+    /* paramevfn  */ nullptr
 },
 #endif
 
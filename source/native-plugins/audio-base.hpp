@@ -18,8 +18,11 @@
 #ifndef AUDIO_BASE_HPP_INCLUDED
 #define AUDIO_BASE_HPP_INCLUDED
 
+#include "CarlaCacheUtils.hpp"
+#include "CarlaHashUtils.hpp"
 #include "CarlaThread.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaString.hpp"
 
 extern "C" {
 #include "audio_decoder/ad.h"
@@ -43,7 +46,13 @@ extern "C" {
 # include <windows.h>
 # define CARLA_MLOCK(ptr, size) VirtualLock((ptr), (size))
 #else
+# include <algorithm>
+# include <vector>
+# include <dirent.h>
+# include <fcntl.h>
 # include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/time.h>
 # define CARLA_MLOCK(ptr, size) mlock((ptr), (size))
 #endif
 
@@ -51,109 +60,691 @@ extern "C" {
 
 typedef struct adinfo ADInfo;
 
+// -----------------------------------------------------------------------
+// Persistent on-disk cache of decoded and resampled audio files.
+//
+// Each cache entry is a raw file with a small header followed by planar float data,
+// one contiguous block per channel, already at the target sample rate.
+// Entries are keyed by source file path, size, modification time and target sample rate,
+// and are memory-mapped read-only so memory usage is governed by the OS page cache.
+// Entries are created in the background (see AudioFileCacheWriter) while the file keeps streaming normally.
+//
+// The cache lives in $XDG_CACHE_HOME/carla/audio-file (or ~/.cache/carla/audio-file).
+// The location can be changed with the CARLA_AUDIO_FILE_CACHE_DIR environment variable,
+// setting it to an empty string disables the cache.
+// The total cache size is limited to 2GiB by default, least recently used entries are removed first.
+// The limit can be changed with the CARLA_AUDIO_FILE_CACHE_SIZE environment variable, in MiB.
+
+class AudioFileCache
+{
+public:
+    AudioFileCache() noexcept
+        : fData(nullptr),
+          fDataSize(0),
+          fNumChannels(0),
+          fNumFrames(0),
+          fHeaderSize(0),
+          fFileNfo()
+    {
+        ad_clear_nfo(&fFileNfo);
+    }
+
+    ~AudioFileCache() noexcept
+    {
+        close();
+    }
+
+    bool isValid() const noexcept
+    {
+        return fData != nullptr;
+    }
+
+    uint32_t getNumChannels() const noexcept
+    {
+        return fNumChannels;
+    }
+
+    uint32_t getNumFrames() const noexcept
+    {
+        return fNumFrames;
+    }
+
+    ADInfo getFileInfo() const noexcept
+    {
+        return fFileNfo;
+    }
+
+    const float* getChannelData(const uint32_t channel) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fData != nullptr, nullptr);
+        CARLA_SAFE_ASSERT_RETURN(channel < fNumChannels, nullptr);
+
+        return reinterpret_cast<const float*>(static_cast<const uint8_t*>(fData) + fHeaderSize)
+            + static_cast<std::size_t>(channel) * fNumFrames;
+    }
+
+    void close() noexcept
+    {
+        if (fData == nullptr)
+            return;
+
+#ifndef CARLA_OS_WIN
+        ::munmap(fData, fDataSize);
+#endif
+        fData = nullptr;
+        fDataSize = 0;
+        fNumChannels = 0;
+        fNumFrames = 0;
+        fHeaderSize = 0;
+        ad_clear_nfo(&fFileNfo);
+    }
+
+    // map an existing cache entry, returns false if there is none or if it is outdated
+    bool open(const char* const filename, const uint32_t sampleRate)
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+        close();
+
+#ifdef CARLA_OS_WIN
+        return false;
+        // unused
+        (void)sampleRate;
+#else
+        struct stat fileStat;
+        if (::stat(filename, &fileStat) != 0)
+            return false;
+
+        const CarlaString cachePath(getCachePath(filename, sampleRate));
+        if (cachePath.isEmpty())
+            return false;
+
+        const int fd = ::open(cachePath, O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat cacheStat;
+        if (::fstat(fd, &cacheStat) != 0 || cacheStat.st_size < static_cast<off_t>(sizeof(Header)))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        const std::size_t dataSize = static_cast<std::size_t>(cacheStat.st_size);
+        void* const data = ::mmap(nullptr, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            return false;
+
+        const Header* const header = static_cast<const Header*>(data);
+        const char* const headerPath = static_cast<const char*>(data) + sizeof(Header);
+        const std::size_t filenameSize = std::strlen(filename) + 1;
+
+        if (std::memcmp(header->magic, getMagic(), sizeof(header->magic)) != 0
+            || header->version != kVersion
+            || header->sampleRate != sampleRate
+            || header->numChannels == 0
+            || header->numFrames == 0
+            || header->fileSize != static_cast<uint64_t>(fileStat.st_size)
+            || header->fileModTime != static_cast<int64_t>(fileStat.st_mtime)
+            || header->pathSize != filenameSize
+            || sizeof(Header) + filenameSize > header->headerSize
+            || static_cast<uint64_t>(header->headerSize)
+               + static_cast<uint64_t>(header->numChannels) * header->numFrames * sizeof(float) > dataSize
+            || std::memcmp(headerPath, filename, filenameSize) != 0)
+        {
+            carla_stdout("AudioFileCache: ignoring outdated cache for \"%s\"", filename);
+            ::munmap(data, dataSize);
+            return false;
+        }
+
+        // mark as recently used, the modification time of cache entries is only used for eviction
+        ::utimes(cachePath, nullptr);
+
+        fData = data;
+        fDataSize = dataSize;
+        fNumChannels = header->numChannels;
+        fNumFrames = header->numFrames;
+        fHeaderSize = header->headerSize;
+
+        fFileNfo.sample_rate = header->fileSampleRate;
+        fFileNfo.channels    = header->numChannels;
+        fFileNfo.length      = header->fileLength;
+        fFileNfo.frames      = header->fileFrames;
+        fFileNfo.bit_rate    = header->fileBitRate;
+        fFileNfo.bit_depth   = header->fileBitDepth;
+        fFileNfo.can_seek    = 1;
+        return true;
+#endif
+    }
+
+    // decode (and resample if needed) an entire opened file into a new cache entry, then map it
+    // decoding is aborted early if `thread` is not null and is asked to stop
+    bool create(const char* const filename, const uint32_t sampleRate,
+                void* const filePtr, const ADInfo& nfo, Resampler* const resampler, const uint32_t numFrames,
+                const CarlaThread* const thread = nullptr)
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+        CARLA_SAFE_ASSERT_RETURN(filePtr != nullptr, false);
+        CARLA_SAFE_ASSERT_RETURN(nfo.channels != 0, false);
+        CARLA_SAFE_ASSERT_RETURN(numFrames != 0, false);
+
+        close();
+
+#ifdef CARLA_OS_WIN
+        return false;
+        // unused
+        (void)sampleRate;
+        (void)resampler;
+        (void)thread;
+#else
+        struct stat fileStat;
+        if (::stat(filename, &fileStat) != 0)
+            return false;
+
+        const CarlaString cachePath(getCachePath(filename, sampleRate));
+        if (cachePath.isEmpty() || ! carla_create_dir_path(getCacheDir()))
+            return false;
+
+        const CarlaString tmpPath(cachePath + ".tmp");
+        const int fd = ::open(tmpPath, O_RDWR|O_CREAT|O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            carla_stderr2("AudioFileCache: failed to create \"%s\"", tmpPath.buffer());
+            return false;
+        }
+
+        const uint numChannels = nfo.channels;
+        const std::size_t filenameSize = std::strlen(filename) + 1;
+        const std::size_t headerSize = (sizeof(Header) + filenameSize + kPageSize - 1) & ~(kPageSize - 1);
+        const std::size_t dataSize = headerSize + sizeof(float) * numChannels * static_cast<std::size_t>(numFrames);
+
+        void* data = MAP_FAILED;
+
+        if (::ftruncate(fd, static_cast<off_t>(dataSize)) == 0)
+            data = ::mmap(nullptr, dataSize, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+        {
+            carla_stderr2("AudioFileCache: failed to map \"%s\", not enough disk space?", tmpPath.buffer());
+            ::unlink(tmpPath);
+            return false;
+        }
+
+        float* const planar = reinterpret_cast<float*>(static_cast<uint8_t*>(data) + headerSize);
+
+        if (! decodeInto(planar, numChannels, numFrames, filePtr, resampler, thread))
+        {
+            if (thread == nullptr || ! thread->shouldThreadExit())
+                carla_stderr2("AudioFileCache: failed to decode \"%s\"", filename);
+            ::munmap(data, dataSize);
+            ::unlink(tmpPath);
+            return false;
+        }
+
+        // write header last, so that incomplete files are never valid
+        Header* const header = static_cast<Header*>(data);
+        std::memcpy(header->magic, getMagic(), sizeof(header->magic));
+        header->version        = kVersion;
+        header->headerSize     = static_cast<uint32_t>(headerSize);
+        header->pathSize       = static_cast<uint32_t>(filenameSize);
+        header->sampleRate     = sampleRate;
+        header->numChannels    = numChannels;
+        header->numFrames      = numFrames;
+        header->fileSize       = static_cast<uint64_t>(fileStat.st_size);
+        header->fileModTime    = static_cast<int64_t>(fileStat.st_mtime);
+        header->fileSampleRate = nfo.sample_rate;
+        header->fileBitRate    = nfo.bit_rate;
+        header->fileBitDepth   = nfo.bit_depth;
+        header->fileFrames     = nfo.frames;
+        header->fileLength     = nfo.length;
+        std::memcpy(static_cast<char*>(data) + sizeof(Header), filename, filenameSize);
+
+        ::munmap(data, dataSize);
+
+        if (::rename(tmpPath, cachePath) != 0)
+        {
+            ::unlink(tmpPath);
+            return false;
+        }
+
+        trimCacheDir(cachePath);
+
+        return open(filename, sampleRate);
+#endif
+    }
+
+    static bool isEnabled() noexcept
+    {
+#ifdef CARLA_OS_WIN
+        return false;
+#else
+        const char* const cacheDir = std::getenv("CARLA_AUDIO_FILE_CACHE_DIR");
+        return cacheDir == nullptr || cacheDir[0] != '\0';
+#endif
+    }
+
+private:
+    struct Header {
+        char     magic[8];
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t pathSize;
+        uint32_t sampleRate;
+        uint32_t numChannels;
+        uint32_t numFrames;
+        uint64_t fileSize;
+        int64_t  fileModTime;
+        uint32_t fileSampleRate;
+        int32_t  fileBitRate;
+        int32_t  fileBitDepth;
+        int32_t  reserved;
+        int64_t  fileFrames;
+        int64_t  fileLength;
+    };
+
+    static const uint32_t kVersion = 1;
+    static const std::size_t kPageSize = 4096;
+    static const uint kDecodeChunkFrames = 8192;
+    static const uint64_t kDefaultMaxCacheSize = 2048ULL * 1024 * 1024;
+
+    void*       fData;
+    std::size_t fDataSize;
+    uint32_t    fNumChannels;
+    uint32_t    fNumFrames;
+    uint32_t    fHeaderSize;
+    ADInfo      fFileNfo;
+
+    static const char* getMagic() noexcept
+    {
+        return "CarlaAFC";
+    }
+
+    static bool decodeInto(float* const planar, const uint numChannels, const uint32_t numFrames,
+                           void* const filePtr, Resampler* const resampler, const CarlaThread* const thread)
+    {
+        const uint inpSize = kDecodeChunkFrames * numChannels;
+        const uint outFrames = resampler != nullptr ? kDecodeChunkFrames * 2 : 0;
+
+        float* const inp = new float[inpSize];
+        float* const out = resampler != nullptr ? new float[outFrames * numChannels] : nullptr;
+
+        uint32_t written = 0;
+        bool ok = true;
+
+        ad_seek(filePtr, 0);
+
+        for (;;)
+        {
+            if (thread != nullptr && thread->shouldThreadExit())
+            {
+                ok = false;
+                break;
+            }
+
+            const ssize_t rv = ad_read(filePtr, inp, inpSize);
+
+            if (rv < 0)
+            {
+                ok = false;
+                break;
+            }
+            if (rv == 0)
+                break;
+
+            const uint readFrames = static_cast<uint>(rv) / numChannels;
+
+            if (resampler == nullptr)
+            {
+                written += deinterleave(planar, numChannels, numFrames, written, inp, readFrames);
+                continue;
+            }
+
+            resampler->inp_count = readFrames;
+            resampler->inp_data = inp;
+
+            while (resampler->inp_count != 0 && written < numFrames)
+            {
+                resampler->out_count = outFrames;
+                resampler->out_data = out;
+                resampler->process();
+                written += deinterleave(planar, numChannels, numFrames, written,
+                                        out, outFrames - resampler->out_count);
+            }
+        }
+
+        // flush resampler tail
+        if (resampler != nullptr && ok)
+        {
+            for (uint i = 0; i < 4 && written < numFrames; ++i)
+            {
+                resampler->inp_count = resampler->inpsize();
+                resampler->inp_data = nullptr;
+                resampler->out_count = outFrames;
+                resampler->out_data = out;
+                resampler->process();
+                written += deinterleave(planar, numChannels, numFrames, written,
+                                        out, outFrames - resampler->out_count);
+            }
+        }
+
+        delete[] inp;
+        delete[] out;
+
+        // remaining frames (if any) are left as silence, as the file was zero-filled on creation
+        return ok && written != 0;
+    }
+
+    static uint32_t deinterleave(float* const planar, const uint numChannels, const uint32_t numFrames,
+                                 const uint32_t offset, const float* const interleaved, const uint frames) noexcept
+    {
+        const uint32_t framesToWrite = std::min(numFrames - offset, static_cast<uint32_t>(frames));
+
+        for (uint c = 0; c < numChannels; ++c)
+        {
+            float* const dst = planar + static_cast<std::size_t>(c) * numFrames + offset;
+
+            for (uint32_t i = 0; i < framesToWrite; ++i)
+                dst[i] = interleaved[i * numChannels + c];
+        }
+
+        return framesToWrite;
+    }
+
+#ifndef CARLA_OS_WIN
+    static CarlaString getCacheDir()
+    {
+        return carla_get_cache_dir("CARLA_AUDIO_FILE_CACHE_DIR", "audio-file");
+    }
+
+    static uint64_t getMaxCacheSize() noexcept
+    {
+        if (const char* const maxSize = std::getenv("CARLA_AUDIO_FILE_CACHE_SIZE"))
+            return static_cast<uint64_t>(std::max(0LL, std::atoll(maxSize))) * 1024 * 1024;
+
+        return kDefaultMaxCacheSize;
+    }
+
+    // remove least recently used entries until the cache fits its size limit, keeping `keepPath`
+    static void trimCacheDir(const char* const keepPath)
+    {
+        const CarlaString cacheDir(getCacheDir());
+        CARLA_SAFE_ASSERT_RETURN(cacheDir.isNotEmpty(),);
+
+        DIR* const dir = ::opendir(cacheDir);
+
+        if (dir == nullptr)
+            return;
+
+        struct Entry {
+            CarlaString path;
+            uint64_t size;
+            int64_t modTime;
+
+            bool operator<(const Entry& other) const noexcept
+            {
+                return modTime < other.modTime;
+            }
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalSize = 0;
+
+        while (const struct dirent* const ent = ::readdir(dir))
+        {
+            const std::size_t nameLen = std::strlen(ent->d_name);
+
+            if (nameLen < 5 || std::strcmp(ent->d_name + nameLen - 4, ".raw") != 0)
+                continue;
+
+            Entry entry;
+            entry.path = cacheDir + "/" + ent->d_name;
+
+            struct stat st;
+            if (::stat(entry.path, &st) != 0 || ! S_ISREG(st.st_mode))
+                continue;
+
+            entry.size = static_cast<uint64_t>(st.st_size);
+            entry.modTime = static_cast<int64_t>(st.st_mtime);
+            totalSize += entry.size;
+
+            if (entry.path != keepPath)
+                entries.push_back(entry);
+        }
+
+        ::closedir(dir);
+
+        const uint64_t maxSize = getMaxCacheSize();
+
+        if (totalSize <= maxSize)
+            return;
+
+        std::sort(entries.begin(), entries.end());
+
+        // unlinking is safe even if other instances have an entry mapped
+        for (std::size_t i = 0; i < entries.size() && totalSize > maxSize; ++i)
+        {
+            if (::unlink(entries[i].path) == 0)
+                totalSize -= entries[i].size;
+        }
+    }
+
+    static CarlaString getCachePath(const char* const filename, const uint32_t sampleRate)
+    {
+        if (! isEnabled())
+            return CarlaString();
+
+        const CarlaString cacheDir(getCacheDir());
+
+        if (cacheDir.isEmpty())
+            return CarlaString();
+
+        // the full path is also stored and verified in the header
+        const uint64_t hash = carla_fnv1a_64_str(filename);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "/%016llx-%u.raw", static_cast<unsigned long long>(hash), sampleRate);
+        name[sizeof(name)-1] = '\0';
+
+        return cacheDir + name;
+    }
+#endif
+
+    CARLA_DECLARE_NON_COPY_CLASS(AudioFileCache)
+};
+
+// -----------------------------------------------------------------------
+// Creates a cache entry in the background, using its own decoder and resampler instances.
+
+class AudioFileCacheWriter : public CarlaThread
+{
+public:
+    AudioFileCacheWriter()
+        : CarlaThread("AudioFileCacheWriter"),
+          fFilename(),
+          fSampleRate(0),
+          fNumFrames(0),
+          fFinished(false),
+          fSucceeded(false) {}
+
+    ~AudioFileCacheWriter() override
+    {
+        stop();
+    }
+
+    void start(const char* const filename, const uint32_t sampleRate, const uint32_t numFrames)
+    {
+        stop();
+
+        fFilename = filename;
+        fSampleRate = sampleRate;
+        fNumFrames = numFrames;
+        fFinished = false;
+        fSucceeded = false;
+
+        startThread();
+    }
+
+    void stop()
+    {
+        stopThread(-1);
+    }
+
+    const char* getFilename() const noexcept
+    {
+        return fFilename;
+    }
+
+    uint32_t getSampleRate() const noexcept
+    {
+        return fSampleRate;
+    }
+
+    // true once the cache entry has been successfully written and can be opened
+    bool isReady() const noexcept
+    {
+        return fFinished && fSucceeded;
+    }
+
+    // clear the ready state, so the entry is only picked up once
+    void reset() noexcept
+    {
+        fFinished = false;
+        fSucceeded = false;
+    }
+
+protected:
+    void run() override
+    {
+        ADInfo nfo;
+        ad_clear_nfo(&nfo);
+
+        if (void* const filePtr = ad_open(fFilename, &nfo))
+        {
+            if (nfo.channels != 0 && nfo.frames > 0)
+            {
+                const bool needsResample = nfo.sample_rate != fSampleRate;
+                Resampler resampler;
+
+                if (! needsResample || resampler.setup(nfo.sample_rate, fSampleRate, nfo.channels, 32))
+                {
+                    AudioFileCache cache;
+                    fSucceeded = cache.create(fFilename, fSampleRate, filePtr, nfo,
+                                              needsResample ? &resampler : nullptr, fNumFrames, this);
+                }
+            }
+
+            ad_close(filePtr);
+        }
+
+        fFinished = true;
+    }
+
+private:
+    CarlaString fFilename;
+    uint32_t fSampleRate;
+    uint32_t fNumFrames;
+    volatile bool fFinished;
+    volatile bool fSucceeded;
+
+    CARLA_DECLARE_NON_COPY_CLASS(AudioFileCacheWriter)
+};
+
+// -----------------------------------------------------------------------
+
 struct AudioFilePool {
-    float*   buffer[2];
-    float*   tmpbuf[2];
+    float**  buffer;
+    float**  tmpbuf;
+    uint32_t numChannels;
     uint32_t numFrames;
     uint32_t maxFrame;
     volatile uint64_t startFrame;
     water::SpinLock mutex;
 
-#ifdef CARLA_PROPER_CPP11_SUPPORT
     AudioFilePool() noexcept
-        : buffer{nullptr},
-          tmpbuf{nullptr},
+        : buffer(nullptr),
+          tmpbuf(nullptr),
+          numChannels(0),
           numFrames(0),
           maxFrame(0),
           startFrame(0),
           mutex() {}
-#else
-    AudioFilePool() noexcept
-        : numFrames(0),
-          startFrame(0),
-          mutex()
-    {
-        buffer[0] = buffer[1] = nullptr;
-        tmpbuf[0] = tmpbuf[1] = nullptr;
-    }
-#endif
 
     ~AudioFilePool()
     {
         destroy();
     }
 
-    void create(const uint32_t desiredNumFrames, const uint32_t fileNumFrames, const bool withTempBuffers)
+    void create(const uint32_t desiredNumChannels, const uint32_t desiredNumFrames,
+                const uint32_t fileNumFrames, const bool withTempBuffers)
     {
-        CARLA_ASSERT(buffer[0] == nullptr);
-        CARLA_ASSERT(buffer[1] == nullptr);
-        CARLA_ASSERT(tmpbuf[0] == nullptr);
-        CARLA_ASSERT(tmpbuf[1] == nullptr);
+        CARLA_ASSERT(buffer == nullptr);
+        CARLA_ASSERT(tmpbuf == nullptr);
         CARLA_ASSERT(startFrame == 0);
         CARLA_ASSERT(numFrames == 0);
         CARLA_ASSERT(maxFrame == 0);
+        CARLA_SAFE_ASSERT_RETURN(desiredNumChannels != 0,);
 
-        buffer[0] = new float[desiredNumFrames];
-        buffer[1] = new float[desiredNumFrames];
-        carla_zeroFloats(buffer[0], desiredNumFrames);
-        carla_zeroFloats(buffer[1], desiredNumFrames);
-        CARLA_MLOCK(buffer[0], sizeof(float)*desiredNumFrames);
-        CARLA_MLOCK(buffer[1], sizeof(float)*desiredNumFrames);
+        buffer = createBuffers(desiredNumChannels, desiredNumFrames);
 
         if (withTempBuffers)
-        {
-            tmpbuf[0] = new float[desiredNumFrames];
-            tmpbuf[1] = new float[desiredNumFrames];
-            carla_zeroFloats(tmpbuf[0], desiredNumFrames);
-            carla_zeroFloats(tmpbuf[1], desiredNumFrames);
-            CARLA_MLOCK(tmpbuf[0], sizeof(float)*desiredNumFrames);
-            CARLA_MLOCK(tmpbuf[1], sizeof(float)*desiredNumFrames);
-        }
+            tmpbuf = createBuffers(desiredNumChannels, desiredNumFrames);
 
         const water::GenericScopedLock<water::SpinLock> gsl(mutex);
 
         startFrame = 0;
+        numChannels = desiredNumChannels;
         numFrames = desiredNumFrames;
         maxFrame = fileNumFrames;
     }
 
     void destroy() noexcept
     {
+        uint32_t oldNumChannels;
+
         {
             const water::GenericScopedLock<water::SpinLock> gsl(mutex);
+            oldNumChannels = numChannels;
             startFrame = 0;
+            numChannels = 0;
             numFrames = 0;
             maxFrame = 0;
         }
 
-        if (buffer[0] != nullptr)
-        {
-            delete[] buffer[0];
-            buffer[0] = nullptr;
-        }
+        destroyBuffers(buffer, oldNumChannels);
+        destroyBuffers(tmpbuf, oldNumChannels);
+    }
 
-        if (buffer[1] != nullptr)
+    // copy pool data into the outputs, mono files go to all outputs and
+    // files with more channels than outputs are folded into the available ones
+    void copyToOutputs(float* const* const outs, const uint32_t numOuts, const uint32_t outOffset,
+                       const uint32_t poolOffset, const uint32_t frames) const noexcept
+    {
+        if (numChannels == 1)
         {
-            delete[] buffer[1];
-            buffer[1] = nullptr;
+            for (uint32_t i=0; i < numOuts; ++i)
+                carla_copyFloats(outs[i] + outOffset, buffer[0] + poolOffset, frames);
+            return;
         }
 
-        if (tmpbuf[0] != nullptr)
+        for (uint32_t i=0; i < numOuts; ++i)
         {
-            delete[] tmpbuf[0];
-            tmpbuf[0] = nullptr;
+            if (i < numChannels)
+                carla_copyFloats(outs[i] + outOffset, buffer[i] + poolOffset, frames);
+            else
+                carla_zeroFloats(outs[i] + outOffset, frames);
         }
 
-        if (tmpbuf[1] != nullptr)
-        {
-            delete[] tmpbuf[1];
-            tmpbuf[1] = nullptr;
-        }
+        for (uint32_t i=numOuts; i < numChannels; ++i)
+            carla_addFloats(outs[i % numOuts] + outOffset, buffer[i] + poolOffset, frames);
     }
 
     // NOTE it is assumed that mutex is locked
-    bool tryPutData(float* const out1,
-                    float* const out2,
+    bool tryPutData(float* const* const outs,
+                    const uint32_t numOuts,
                     uint64_t framePos,
                     const uint32_t frames,
                     const bool loopingMode,
@@ -193,8 +784,7 @@ struct AudioFilePool {
                 return false;
             }
 
-            carla_copyFloats(out1, buffer[0] + frameDiff, frames);
-            carla_copyFloats(out2, buffer[1] + frameDiff, frames);
+            copyToOutputs(outs, numOuts, 0, static_cast<uint32_t>(frameDiff), frames);
         }
         else
         {
@@ -207,8 +797,7 @@ struct AudioFilePool {
                 return false;
             }
 
-            carla_copyFloats(out1, buffer[0] + frameDiff, frames);
-            carla_copyFloats(out2, buffer[1] + frameDiff, frames);
+            copyToOutputs(outs, numOuts, 0, static_cast<uint32_t>(frameDiff), frames);
         }
 
         if (frameDiff > numFramesNearEnd)
@@ -220,6 +809,32 @@ struct AudioFilePool {
         return true;
     }
 
+    static float** createBuffers(const uint32_t channels, const uint32_t frames)
+    {
+        float** const buffers = new float*[channels];
+
+        for (uint32_t i=0; i < channels; ++i)
+        {
+            buffers[i] = new float[frames];
+            carla_zeroFloats(buffers[i], frames);
+            CARLA_MLOCK(buffers[i], sizeof(float)*frames);
+        }
+
+        return buffers;
+    }
+
+    static void destroyBuffers(float**& buffers, const uint32_t channels) noexcept
+    {
+        if (buffers == nullptr)
+            return;
+
+        for (uint32_t i=0; i < channels; ++i)
+            delete[] buffers[i];
+
+        delete[] buffers;
+        buffers = nullptr;
+    }
+
     CARLA_DECLARE_NON_COPY_STRUCT(AudioFilePool)
 };
 
@@ -239,6 +854,8 @@ public:
           fResampleRatio(0.0),
           fResampleTempData(nullptr),
           fResampleTempSize(0),
+          fCache(),
+          fCacheWriter(),
           fPool(),
           fPoolMutex(),
           fPoolReadyToSwap(false),
@@ -255,7 +872,10 @@ public:
 
     void cleanup()
     {
+        fCacheWriter.stop();
+        fCacheWriter.reset();
         fPool.destroy();
+        fCache.close();
         fCurrentBitRate = 0;
         fEntireFileLoaded = false;
 
@@ -333,6 +953,10 @@ public:
         cleanup();
         ad_clear_nfo(&fFileNfo);
 
+        // try decoded cache first
+        if (fCache.open(filename, sampleRate))
+            return loadFromCache(sampleRate, previewDataSize, previewData);
+
         // open new
         fFilePtr = ad_open(filename, &fFileNfo);
 
@@ -348,7 +972,7 @@ public:
         if (fFileNfo.frames <= 0)
             carla_stderr("L: filename \"%s\" has 0 frames", filename);
 
-        if ((fFileNfo.channels == 1 || fFileNfo.channels == 2) && fFileNfo.frames > 0)
+        if (fFileNfo.channels != 0 && fFileNfo.frames > 0)
         {
             // valid
             const uint32_t fileNumFrames = static_cast<uint32_t>(fFileNfo.frames);
@@ -377,25 +1001,23 @@ public:
                 maxFrame = fileNumFrames;
             }
 
+            // decode and resample once into the persistent cache in the background,
+            // regular streaming is used until the cache entry is ready
+            if (AudioFileCache::isEnabled())
+                fCacheWriter.start(filename, sampleRate, maxFrame);
+
             if (fileNumFrames <= maxPoolNumFrames || fFileNfo.can_seek == 0)
             {
                 // entire file fits in a small pool, lets read it now
                 const uint32_t poolNumFrames = needsResample
                                              ? static_cast<uint32_t>(static_cast<double>(fileNumFrames) * fResampleRatio + 0.5)
                                              : fileNumFrames;
-                fPool.create(poolNumFrames, maxFrame, false);
+                fPool.create(fFileNfo.channels, poolNumFrames, maxFrame, false);
                 readEntireFileIntoPool(needsResample);
                 ad_close(fFilePtr);
                 fFilePtr = nullptr;
 
-                const float fileNumFramesF = static_cast<float>(fileNumFrames);
-                const float previewDataSizeF = static_cast<float>(previewDataSize);
-                for (uint i=0; i<previewDataSize; ++i)
-                {
-                    const float stepF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
-                    const uint step = carla_fixedValue(0U, fileNumFrames-1U, static_cast<uint>(stepF + 0.5f));
-                    previewData[i] = std::max(std::fabs(fPool.buffer[0][step]), std::fabs(fPool.buffer[1][step]));
-                }
+                fillPreviewFromPool(previewDataSize, previewData);
             }
             else
             {
@@ -406,7 +1028,7 @@ public:
 
                 readFilePreview(previewDataSize, previewData);
 
-                fPool.create(poolNumFrames, maxFrame, true);
+                fPool.create(fFileNfo.channels, poolNumFrames, maxFrame, true);
 
                 try {
                     fPollTempData = new float[pollTempSize];
@@ -459,7 +1081,7 @@ public:
 
     void createSwapablePool(AudioFilePool& pool)
     {
-        pool.create(fPool.numFrames, fPool.maxFrame, false);
+        pool.create(fPool.numChannels, fPool.numFrames, fPool.maxFrame, false);
     }
 
     void putAndSwapAllData(AudioFilePool& pool)
@@ -467,26 +1089,26 @@ public:
         const water::GenericScopedLock<water::SpinLock> gsl1(fPool.mutex);
         const water::GenericScopedLock<water::SpinLock> gsl2(pool.mutex);
         CARLA_SAFE_ASSERT_RETURN(fPool.numFrames != 0,);
-        CARLA_SAFE_ASSERT_RETURN(fPool.buffer[0] != nullptr,);
-        CARLA_SAFE_ASSERT_RETURN(fPool.tmpbuf[0] == nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fPool.buffer != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(fPool.tmpbuf == nullptr,);
         CARLA_SAFE_ASSERT_RETURN(pool.numFrames == 0,);
-        CARLA_SAFE_ASSERT_RETURN(pool.buffer[0] == nullptr,);
-        CARLA_SAFE_ASSERT_RETURN(pool.tmpbuf[0] == nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(pool.buffer == nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(pool.tmpbuf == nullptr,);
 
         pool.startFrame = fPool.startFrame;
+        pool.numChannels = fPool.numChannels;
         pool.numFrames = fPool.numFrames;
-        pool.buffer[0] = fPool.buffer[0];
-        pool.buffer[1] = fPool.buffer[1];
+        pool.buffer = fPool.buffer;
 
         fPool.startFrame = 0;
+        fPool.numChannels = 0;
         fPool.numFrames = 0;
-        fPool.buffer[0] = nullptr;
-        fPool.buffer[1] = nullptr;
+        fPool.buffer = nullptr;
     }
 
     bool tryPutData(AudioFilePool& pool,
-                    float* const out1,
-                    float* const out2,
+                    float* const* const outs,
+                    const uint32_t numOuts,
                     uint64_t framePos,
                     const uint32_t frames,
                     const bool loopMode,
@@ -497,7 +1119,7 @@ public:
 
         bool needsRead = false;
         uint64_t needsReadFrame;
-        const bool ret = pool.tryPutData(out1, out2, framePos, frames, loopMode, isOffline, needsRead, needsReadFrame);
+        const bool ret = pool.tryPutData(outs, numOuts, framePos, frames, loopMode, isOffline, needsRead, needsReadFrame);
 
         if (needsRead)
         {
@@ -522,10 +1144,10 @@ public:
         const float previewDataSizeF = static_cast<float>(previewDataSize);
         const uint samplesPerRun = fFileNfo.channels;
         const uint maxSampleToRead = fileNumFrames - samplesPerRun;
-        CARLA_SAFE_ASSERT_INT_RETURN(samplesPerRun == 1 || samplesPerRun == 2, samplesPerRun,);
-        float tmp[2] = { 0.0f, 0.0f };
+        CARLA_SAFE_ASSERT_RETURN(samplesPerRun != 0,);
+        float* const tmp = new float[samplesPerRun];
 
-        if (samplesPerRun == 2)
+        if (samplesPerRun > 1)
             previewDataSize -= 1;
 
         for (uint i=0; i<previewDataSize; ++i)
@@ -533,10 +1155,15 @@ public:
             const float posF = static_cast<float>(i)/previewDataSizeF * fileNumFramesF;
             const uint pos = carla_fixedValue(0U, maxSampleToRead, static_cast<uint>(posF));
 
+            carla_zeroFloats(tmp, samplesPerRun);
             ad_seek(fFilePtr, pos);
             ad_read(fFilePtr, tmp, samplesPerRun);
-            previewData[i] = std::max(std::fabs(tmp[0]), std::fabs(tmp[1]));
+
+            for (uint c=0; c<samplesPerRun; ++c)
+                previewData[i] = std::max(previewData[i], std::fabs(tmp[c]));
         }
+
+        delete[] tmp;
     }
 
     void readEntireFileIntoPool(const bool needsResample)
@@ -585,26 +1212,11 @@ public:
             // lock, and put data asap
             const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
-            if (numChannels == 1)
-            {
-                for (ssize_t i=0, j=0; j < rv; ++i, ++j)
-                    fPool.buffer[0][i] = fPool.buffer[1][i] = rbuffer[j];
-            }
-            else
-            {
-                for (ssize_t i=0, j=0; j < rv; ++j)
-                {
-                    if (j % 2 == 0)
-                    {
-                        fPool.buffer[0][i] = rbuffer[j];
-                    }
-                    else
-                    {
-                        fPool.buffer[1][i] = rbuffer[j];
-                        ++i;
-                    }
-                }
-            }
+            const ssize_t numFrames = rv / static_cast<ssize_t>(numChannels);
+
+            for (ssize_t i=0, j=0; i < numFrames; ++i)
+                for (uint c=0; c < numChannels; ++c, ++j)
+                    fPool.buffer[c][i] = rbuffer[j];
         }
 
         if (rbuffer != buffer)
@@ -619,14 +1231,14 @@ public:
     {
         const CarlaMutexLocker cml(fReaderMutex);
 
-        if (fFileNfo.channels == 0 || fFilePtr == nullptr)
+        if (fFileNfo.channels == 0 || (fFilePtr == nullptr && ! fCache.isValid()))
         {
             carla_debug("R: no song loaded");
             fNeedsFrame = 0;
             fNeedsRead = false;
             return;
         }
-        if (fPollTempData == nullptr)
+        if (fPollTempData == nullptr && ! fCache.isValid())
         {
             carla_debug("R: nothing to poll");
             fNeedsFrame = 0;
@@ -664,6 +1276,16 @@ public:
 
         const int64_t readFrame = readFrameCheck;
 
+        if (fCacheWriter.isReady())
+            switchToCache();
+
+        if (fCache.isValid())
+        {
+            readPollFromCache(static_cast<uint32_t>(readFrame));
+            fNeedsRead = false;
+            return;
+        }
+
         // temp data buffer
         carla_zeroFloats(fPollTempData, fPollTempSize);
 
@@ -719,17 +1341,17 @@ public:
             fCurrentBitRate = ad_get_bitrate(fFilePtr);
 
             // local copy
+            const uint numChannels = fFileNfo.channels;
             const uint32_t poolNumFrames = fPool.numFrames;
-            float* const pbuffer0 = fPool.tmpbuf[0];
-            float* const pbuffer1 = fPool.tmpbuf[1];
+            float* const* const pbuffer = fPool.tmpbuf;
             const float* tmpbuf = fPollTempData;
 
             // resample as needed
             if (fResampleTempSize != 0)
             {
                 tmpbuf = fResampleTempData;
-                fResampler.inp_count = static_cast<uint>(rv / fFileNfo.channels);
-                fResampler.out_count = fResampleTempSize / fFileNfo.channels;
+                fResampler.inp_count = static_cast<uint>(rv / numChannels);
+                fResampler.out_count = fResampleTempSize / numChannels;
                 fResampler.inp_data = fPollTempData;
                 fResampler.out_data = fResampleTempData;
                 fResampler.process();
@@ -738,26 +1360,9 @@ public:
 
             j = 0;
             do {
-                if (fFileNfo.channels == 1)
-                {
-                    for (; i < poolNumFrames && j < rv; ++i, ++j)
-                        pbuffer0[i] = pbuffer1[i] = tmpbuf[j];
-                }
-                else
-                {
-                    for (; i < poolNumFrames && j < rv; ++j)
-                    {
-                        if (j % 2 == 0)
-                        {
-                            pbuffer0[i] = tmpbuf[j];
-                        }
-                        else
-                        {
-                            pbuffer1[i] = tmpbuf[j];
-                            ++i;
-                        }
-                    }
-                }
+                for (; i < poolNumFrames && j + static_cast<ssize_t>(numChannels) <= rv; ++i)
+                    for (uint c=0; c < numChannels; ++c, ++j)
+                        pbuffer[c][i] = tmpbuf[j];
 
                 if (i >= poolNumFrames)
                     break;
@@ -775,8 +1380,8 @@ public:
 #ifdef DEBUG_FILE_OPS
                     carla_stdout("read break, not enough space");
 #endif
-                    carla_zeroFloats(pbuffer0, poolNumFrames - i);
-                    carla_zeroFloats(pbuffer1, poolNumFrames - i);
+                    for (uint c=0; c < numChannels; ++c)
+                        carla_zeroFloats(pbuffer[c] + i, poolNumFrames - i);
                     break;
                 }
 
@@ -786,8 +1391,9 @@ public:
             const CarlaMutexLocker cmlp(fPoolMutex);
             const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
 
-            std::memcpy(fPool.buffer[0], pbuffer0, sizeof(float)*poolNumFrames);
-            std::memcpy(fPool.buffer[1], pbuffer1, sizeof(float)*poolNumFrames);
+            for (uint c=0; c < numChannels; ++c)
+                std::memcpy(fPool.buffer[c], pbuffer[c], sizeof(float)*poolNumFrames);
+
             fPool.startFrame = static_cast<uint64_t>(readFrame);
             fPoolReadyToSwap = true;
 #ifdef DEBUG_FILE_OPS
@@ -815,11 +1421,152 @@ private:
     float* fResampleTempData;
     uint fResampleTempSize;
 
-    AudioFilePool fPool;
-    CarlaMutex    fPoolMutex;
-    bool          fPoolReadyToSwap;
-    Resampler     fResampler;
-    CarlaMutex    fReaderMutex;
+    AudioFileCache fCache;
+    AudioFileCacheWriter fCacheWriter;
+    AudioFilePool  fPool;
+    CarlaMutex     fPoolMutex;
+    bool           fPoolReadyToSwap;
+    Resampler      fResampler;
+    CarlaMutex     fReaderMutex;
+
+    // NOTE it is assumed that fReaderMutex is locked
+    bool loadFromCache(const uint32_t sampleRate, const uint32_t previewDataSize, float* previewData)
+    {
+        fFileNfo = fCache.getFileInfo();
+        fCurrentBitRate = fFileNfo.bit_rate;
+
+        const uint32_t numChannels = fCache.getNumChannels();
+        const uint32_t numFrames = fCache.getNumFrames();
+
+        if (numFrames <= sampleRate * 30)
+        {
+            // small enough, copy everything into the pool and release the mapping
+            fPool.create(numChannels, numFrames, numFrames, false);
+
+            {
+                const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
+
+                for (uint32_t c=0; c < numChannels; ++c)
+                    carla_copyFloats(fPool.buffer[c], fCache.getChannelData(c), numFrames);
+            }
+
+            fillPreviewFromPool(previewDataSize, previewData);
+            fCache.close();
+            fEntireFileLoaded = true;
+        }
+        else
+        {
+            // stream from the mapped cache in the idle thread
+            fPool.create(numChannels, sampleRate * 5, numFrames, true);
+            carla_zeroFloats(previewData, previewDataSize);
+
+            const float numFramesF = static_cast<float>(numFrames);
+            const float previewDataSizeF = static_cast<float>(previewDataSize);
+
+            for (uint32_t c=0; c < numChannels; ++c)
+            {
+                const float* const data = fCache.getChannelData(c);
+
+                for (uint i=0; i<previewDataSize; ++i)
+                {
+                    const float stepF = static_cast<float>(i)/previewDataSizeF * numFramesF;
+                    const uint step = carla_fixedValue(0U, numFrames-1U, static_cast<uint>(stepF + 0.5f));
+                    previewData[i] = std::max(previewData[i], std::fabs(data[step]));
+                }
+            }
+        }
+
+        fNeedsRead = true;
+        return true;
+    }
+
+    // switch a streamed file over to its cache entry, once the background writer is done with it
+    // NOTE it is assumed that fReaderMutex is locked
+    void switchToCache()
+    {
+        fCacheWriter.reset();
+
+        // files that fit in the pool are already fully loaded, the entry will be used next time
+        if (fEntireFileLoaded || fFilePtr == nullptr || fPool.tmpbuf == nullptr)
+            return;
+
+        if (! fCache.open(fCacheWriter.getFilename(), fCacheWriter.getSampleRate()))
+            return;
+
+        if (fCache.getNumChannels() != fPool.numChannels || fCache.getNumFrames() != fPool.maxFrame)
+        {
+            fCache.close();
+            return;
+        }
+
+        ad_close(fFilePtr);
+        fFilePtr = nullptr;
+
+        delete[] fPollTempData;
+        fPollTempData = nullptr;
+        fPollTempSize = 0;
+
+        delete[] fResampleTempData;
+        fResampleTempData = nullptr;
+        fResampleTempSize = 0;
+
+        fResampleRatio = 0.0;
+        fResampler.clear();
+    }
+
+    // NOTE it is assumed that fReaderMutex is locked
+    void readPollFromCache(const uint32_t readFrame)
+    {
+        const uint32_t numChannels = fPool.numChannels;
+        const uint32_t poolNumFrames = fPool.numFrames;
+        const uint32_t cacheNumFrames = fCache.getNumFrames();
+        float* const* const pbuffer = fPool.tmpbuf;
+        CARLA_SAFE_ASSERT_RETURN(pbuffer != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(readFrame < cacheNumFrames,);
+
+        // page faults happen here, outside of the pool lock
+        for (uint32_t i = 0, pos = readFrame; i < poolNumFrames;)
+        {
+            const uint32_t framesToCopy = std::min(poolNumFrames - i, cacheNumFrames - pos);
+
+            for (uint32_t c=0; c < numChannels; ++c)
+                carla_copyFloats(pbuffer[c] + i, fCache.getChannelData(c) + pos, framesToCopy);
+
+            i += framesToCopy;
+            pos += framesToCopy;
+
+            if (pos >= cacheNumFrames)
+                pos = 0;
+        }
+
+        // lock, and put data asap
+        const CarlaMutexLocker cmlp(fPoolMutex);
+        const water::GenericScopedLock<water::SpinLock> gsl(fPool.mutex);
+
+        for (uint32_t c=0; c < numChannels; ++c)
+            std::memcpy(fPool.buffer[c], pbuffer[c], sizeof(float)*poolNumFrames);
+
+        fPool.startFrame = readFrame;
+        fPoolReadyToSwap = true;
+    }
+
+    void fillPreviewFromPool(const uint32_t previewDataSize, float* previewData)
+    {
+        const uint32_t poolNumFrames = fPool.numFrames;
+        const float poolNumFramesF = static_cast<float>(poolNumFrames);
+        const float previewDataSizeF = static_cast<float>(previewDataSize);
+
+        for (uint i=0; i<previewDataSize; ++i)
+        {
+            const float stepF = static_cast<float>(i)/previewDataSizeF * poolNumFramesF;
+            const uint step = carla_fixedValue(0U, poolNumFrames-1U, static_cast<uint>(stepF + 0.5f));
+
+            previewData[i] = 0.0f;
+
+            for (uint32_t c=0; c < fPool.numChannels; ++c)
+                previewData[i] = std::max(previewData[i], std::fabs(fPool.buffer[c][step]));
+        }
+    }
 
     // try a pool data swap if possible and relevant
     // NOTE it is assumed that `pool` mutex is locked
@@ -827,7 +1574,7 @@ private:
     {
         uint32_t tmp_u32;
         uint64_t tmp_u64;
-        float* tmp_fp;
+        float** tmp_fpp;
 
         const CarlaMutexTryLocker cmtl(fPoolMutex);
 
@@ -847,13 +1594,9 @@ private:
         pool.numFrames = fPool.numFrames;
         fPool.numFrames = tmp_u32;
 
-        tmp_fp = pool.buffer[0];
-        pool.buffer[0] = fPool.buffer[0];
-        fPool.buffer[0] = tmp_fp;
-
-        tmp_fp = pool.buffer[1];
-        pool.buffer[1] = fPool.buffer[1];
-        fPool.buffer[1] = tmp_fp;
+        tmp_fpp = pool.buffer;
+        pool.buffer = fPool.buffer;
+        fPool.buffer = tmp_fpp;
 
         fPoolReadyToSwap = false;
 
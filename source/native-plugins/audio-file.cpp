@@ -58,6 +58,8 @@ public:
     } PendingInlineDisplay;
 #endif
 
+    static const uint32_t kNumOutputs = 2;
+
     enum Parameters {
         kParameterLooping,
         kParameterHostSync,
@@ -182,7 +184,7 @@ protected:
                                                             NATIVE_PARAMETER_IS_OUTPUT);
             param.ranges.def = 0.0f;
             param.ranges.min = 0.0f;
-            param.ranges.max = 2.0f;
+            param.ranges.max = 64.0f;
             break;
         case kParameterInfoBitRate:
             param.name  = "Bit Rate";
@@ -445,14 +447,12 @@ protected:
                 if (targetStartFrame + framesToDo <= fMaxFrame)
                 {
                     // everything fits together
-                    carla_copyFloats(out1+framesDone, fPool.buffer[0]+targetStartFrame, framesToDo);
-                    carla_copyFloats(out2+framesDone, fPool.buffer[1]+targetStartFrame, framesToDo);
+                    fPool.copyToOutputs(outBuffer, kNumOutputs, framesDone, targetStartFrame, framesToDo);
                     break;
                 }
 
                 remainingFrames = std::min(fMaxFrame - targetStartFrame, framesToDo);
-                carla_copyFloats(out1+framesDone, fPool.buffer[0]+targetStartFrame, remainingFrames);
-                carla_copyFloats(out2+framesDone, fPool.buffer[1]+targetStartFrame, remainingFrames);
+                fPool.copyToOutputs(outBuffer, kNumOutputs, framesDone, targetStartFrame, remainingFrames);
                 framesDone += remainingFrames;
                 framesToDo -= remainingFrames;
 
@@ -477,7 +477,7 @@ protected:
         {
             const bool offline = isOffline();
 
-            if (! fReader.tryPutData(fPool, out1, out2, frame, frames, loopMode, offline, needsIdleRequest))
+            if (! fReader.tryPutData(fPool, outBuffer, kNumOutputs, frame, frames, loopMode, offline, needsIdleRequest))
             {
                 carla_zeroFloats(out1, frames);
                 carla_zeroFloats(out2, frames);
@@ -492,7 +492,7 @@ protected:
                     needsIdleRequest = false;
                     fReader.readPoll();
 
-                    if (! fReader.tryPutData(fPool, out1, out2, frame, frames, loopMode, offline, needsIdleRequest))
+                    if (! fReader.tryPutData(fPool, outBuffer, kNumOutputs, frame, frames, loopMode, offline, needsIdleRequest))
                     {
                         carla_zeroFloats(out1, frames);
                         carla_zeroFloats(out2, frames);
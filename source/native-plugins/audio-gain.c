@@ -201,20 +201,44 @@ void handle_audio_buffers(const float* inBuffer, float* outBuffer, Filter* const
     filter->z1 = z1;
 }
 
-// FIXME for v3.0, use const for the input buffer
-static void audiogain_process(NativePluginHandle handle,
-                             float** inBuffer, float** outBuffer, uint32_t frames,
-                             const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static inline
+void audiogain_run(AudioGainHandle* const handle, float** inBuffer, float** outBuffer, const uint32_t offset, const uint32_t frames)
 {
-    const float gain      = handlePtr->gain;
-    const bool applyLeft  = handlePtr->applyLeft;
-    const bool applyRight = handlePtr->applyRight;
-    const bool isMono     = handlePtr->isMono;
+    const float gain      = handle->gain;
+    const bool applyLeft  = handle->applyLeft;
+    const bool applyRight = handle->applyRight;
+    const bool isMono     = handle->isMono;
 
-    handle_audio_buffers(inBuffer[0], outBuffer[0], &handlePtr->lowpass[0], (isMono || applyLeft) ? gain : 1.0f, frames);
+    handle_audio_buffers(inBuffer[0]+offset, outBuffer[0]+offset, &handle->lowpass[0], (isMono || applyLeft) ? gain : 1.0f, frames);
 
     if (! isMono)
-        handle_audio_buffers(inBuffer[1], outBuffer[1], &handlePtr->lowpass[1], applyRight ? gain : 1.0f, frames);
+        handle_audio_buffers(inBuffer[1]+offset, outBuffer[1]+offset, &handle->lowpass[1], applyRight ? gain : 1.0f, frames);
+}
+
+// FIXME for v3.0, use const for the input buffer
+static void audiogain_process_with_parameter_events(NativePluginHandle handle,
+                                                    float** inBuffer, float** outBuffer, uint32_t frames,
+                                                    const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                                    const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
+{
+    uint32_t offset = 0;
+
+    for (uint32_t i=0; i < paramEventCount; ++i)
+    {
+        const uint32_t time = paramEvents[i].time < frames ? paramEvents[i].time : frames;
+
+        // process up to the parameter change
+        if (time > offset)
+        {
+            audiogain_run(handlePtr, inBuffer, outBuffer, offset, time - offset);
+            offset = time;
+        }
+
+        audiogain_set_parameter_value(handle, paramEvents[i].index, paramEvents[i].value);
+    }
+
+    if (frames > offset)
+        audiogain_run(handlePtr, inBuffer, outBuffer, offset, frames - offset);
 
     return;
 
@@ -223,6 +247,14 @@ static void audiogain_process(NativePluginHandle handle,
     (void)midiEventCount;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void audiogain_process(NativePluginHandle handle,
+                             float** inBuffer, float** outBuffer, uint32_t frames,
+                             const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    audiogain_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 static intptr_t audiogain_dispatcher(NativePluginHandle handle, NativePluginDispatcherOpcode opcode, int32_t index, intptr_t value, void* ptr, float opt)
 {
     switch (opcode)
@@ -247,7 +279,7 @@ static intptr_t audiogain_dispatcher(NativePluginHandle handle, NativePluginDisp
 
 static const NativePluginDescriptor audiogainMonoDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_NOTHING,
     .audioIns  = 1,
     .audioOuts = 1,
@@ -290,12 +322,14 @@ static const NativePluginDescriptor audiogainMonoDesc = {
 
     .dispatcher = audiogain_dispatcher,
 
-    .render_inline_display = NULL
+    .render_inline_display = NULL,
+
+    .process_with_parameter_events = audiogain_process_with_parameter_events
 };
 
 static const NativePluginDescriptor audiogainStereoDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_CAN_PROCESS_IN_PLACE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_NOTHING,
     .audioIns  = 2,
     .audioOuts = 2,
@@ -338,7 +372,9 @@ static const NativePluginDescriptor audiogainStereoDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = audiogain_dispatcher
+    .dispatcher = audiogain_dispatcher,
+
+    .process_with_parameter_events = audiogain_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
@@ -206,10 +206,15 @@ static void lfo_set_parameter_value(NativePluginHandle handle, uint32_t index, f
 }
 
 // FIXME for v3.0, use const for the input buffer
-static void lfo_process(NativePluginHandle handle,
-                        float** inBuffer, float** outBuffer, uint32_t frames,
-                        const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static void lfo_process_with_parameter_events(NativePluginHandle handle,
+                                              float** inBuffer, float** outBuffer, uint32_t frames,
+                                              const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                              const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
 {
+    // output is only computed once per block, so all changes can be applied right away
+    for (uint32_t i=0; i < paramEventCount; ++i)
+        lfo_set_parameter_value(handle, paramEvents[i].index, paramEvents[i].value);
+
     const NativeHostDescriptor* const host     = handlePtr->host;
     const NativeTimeInfo*       const timeInfo = host->get_time_info(host->handle);
 
@@ -263,13 +268,21 @@ static void lfo_process(NativePluginHandle handle,
     (void)midiEventCount;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void lfo_process(NativePluginHandle handle,
+                        float** inBuffer, float** outBuffer, uint32_t frames,
+                        const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    lfo_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 #undef handlePtr
 
 // -----------------------------------------------------------------------
 
 static const NativePluginDescriptor lfoDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_NOTHING,
     .audioIns  = 0,
     .audioOuts = 0,
@@ -312,7 +325,9 @@ static const NativePluginDescriptor lfoDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = NULL
+    .dispatcher = NULL,
+
+    .process_with_parameter_events = lfo_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
@@ -107,18 +107,24 @@ static void midichanab_set_parameter_value(NativePluginHandle handle, uint32_t i
 }
 
 // FIXME for v3.0, use const for the input buffer
-static void midichanab_process(NativePluginHandle handle,
-                               float** inBuffer, float** outBuffer, uint32_t frames,
-                               const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static void midichanab_process_with_parameter_events(NativePluginHandle handle,
+                                                     float** inBuffer, float** outBuffer, uint32_t frames,
+                                                     const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                                     const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
 {
     const NativeHostDescriptor* const host     = handlePtr->host;
     const bool*                 const channels = handlePtr->channels;
     NativeMidiEvent tmpEvent;
+    uint32_t p = 0;
 
     for (uint32_t i=0; i < midiEventCount; ++i)
     {
         const NativeMidiEvent* const midiEvent = &midiEvents[i];
 
+        // apply parameter changes up to this event
+        for (; p < paramEventCount && paramEvents[p].time <= midiEvent->time; ++p)
+            midichanab_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
         const uint8_t status = (uint8_t)MIDI_GET_STATUS_FROM_DATA(midiEvent->data);
 
         if (MIDI_IS_CHANNEL_MESSAGE(status))
@@ -146,6 +152,10 @@ static void midichanab_process(NativePluginHandle handle,
         }
     }
 
+    // and the remaining ones
+    for (; p < paramEventCount; ++p)
+        midichanab_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
     return;
 
     // unused
@@ -154,11 +164,19 @@ static void midichanab_process(NativePluginHandle handle,
     (void)frames;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void midichanab_process(NativePluginHandle handle,
+                               float** inBuffer, float** outBuffer, uint32_t frames,
+                               const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    midichanab_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 // -----------------------------------------------------------------------
 
 static const NativePluginDescriptor midichanabDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     .audioIns  = 0,
     .audioOuts = 0,
@@ -201,7 +219,9 @@ static const NativePluginDescriptor midichanabDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = NULL
+    .dispatcher = NULL,
+
+    .process_with_parameter_events = midichanab_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
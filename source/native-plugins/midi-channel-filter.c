@@ -107,17 +107,23 @@ static void midichanfilter_set_parameter_value(NativePluginHandle handle, uint32
 }
 
 // FIXME for v3.0, use const for the input buffer
-static void midichanfilter_process(NativePluginHandle handle,
-                                   float** inBuffer, float** outBuffer, uint32_t frames,
-                                   const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static void midichanfilter_process_with_parameter_events(NativePluginHandle handle,
+                                                         float** inBuffer, float** outBuffer, uint32_t frames,
+                                                         const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                                         const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
 {
     const NativeHostDescriptor* const host     = handlePtr->host;
     const bool*                 const channels = handlePtr->channels;
+    uint32_t p = 0;
 
     for (uint32_t i=0; i < midiEventCount; ++i)
     {
         const NativeMidiEvent* const midiEvent = &midiEvents[i];
 
+        // apply parameter changes up to this event
+        for (; p < paramEventCount && paramEvents[p].time <= midiEvent->time; ++p)
+            midichanfilter_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
         const uint8_t status = (uint8_t)MIDI_GET_STATUS_FROM_DATA(midiEvent->data);
 
         if (MIDI_IS_CHANNEL_MESSAGE(status))
@@ -137,6 +143,10 @@ static void midichanfilter_process(NativePluginHandle handle,
         }
     }
 
+    // and the remaining ones
+    for (; p < paramEventCount; ++p)
+        midichanfilter_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
     return;
 
     // unused
@@ -145,11 +155,19 @@ static void midichanfilter_process(NativePluginHandle handle,
     (void)frames;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void midichanfilter_process(NativePluginHandle handle,
+                                   float** inBuffer, float** outBuffer, uint32_t frames,
+                                   const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    midichanfilter_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 // -----------------------------------------------------------------------
 
 static const NativePluginDescriptor midichanfilterDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     .audioIns  = 0,
     .audioOuts = 0,
@@ -192,7 +210,9 @@ static const NativePluginDescriptor midichanfilterDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = NULL
+    .dispatcher = NULL,
+
+    .process_with_parameter_events = midichanfilter_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
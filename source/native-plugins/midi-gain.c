@@ -169,21 +169,28 @@ static void midigain_set_parameter_value(NativePluginHandle handle, uint32_t ind
 }
 
 // FIXME for v3.0, use const for the input buffer
-static void midigain_process(NativePluginHandle handle,
-                             float** inBuffer, float** outBuffer, uint32_t frames,
-                             const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static void midigain_process_with_parameter_events(NativePluginHandle handle,
+                                                   float** inBuffer, float** outBuffer, uint32_t frames,
+                                                   const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                                   const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
 {
     const NativeHostDescriptor* const host = handlePtr->host;
-    const float gain           = handlePtr->gain;
-    const bool applyNotes      = handlePtr->applyNotes;
-    const bool applyAftertouch = handlePtr->applyAftertouch;
-    const bool applyCC         = handlePtr->applyCC;
     NativeMidiEvent tmpEvent;
+    uint32_t p = 0;
 
     for (uint32_t i=0; i < midiEventCount; ++i)
     {
         const NativeMidiEvent* const midiEvent = &midiEvents[i];
 
+        // apply parameter changes up to this event
+        for (; p < paramEventCount && paramEvents[p].time <= midiEvent->time; ++p)
+            midigain_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
+        const float gain           = handlePtr->gain;
+        const bool applyNotes      = handlePtr->applyNotes;
+        const bool applyAftertouch = handlePtr->applyAftertouch;
+        const bool applyCC         = handlePtr->applyCC;
+
         const uint8_t status = (uint8_t)MIDI_GET_STATUS_FROM_DATA(midiEvent->data);
 
         if (midiEvent->size == 3 && ((applyNotes      && (status == MIDI_STATUS_NOTE_OFF || status == MIDI_STATUS_NOTE_ON)) ||
@@ -207,6 +214,10 @@ static void midigain_process(NativePluginHandle handle,
             host->write_midi_event(host->handle, midiEvent);
     }
 
+    // and the remaining ones
+    for (; p < paramEventCount; ++p)
+        midigain_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
     return;
 
     // unused
@@ -215,11 +226,19 @@ static void midigain_process(NativePluginHandle handle,
     (void)frames;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void midigain_process(NativePluginHandle handle,
+                             float** inBuffer, float** outBuffer, uint32_t frames,
+                             const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    midigain_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 // -----------------------------------------------------------------------
 
 static const NativePluginDescriptor midigainDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     .audioIns  = 0,
     .audioOuts = 0,
@@ -262,7 +281,9 @@ static const NativePluginDescriptor midigainDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = NULL
+    .dispatcher = NULL,
+
+    .process_with_parameter_events = midigain_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
@@ -131,19 +131,26 @@ static void miditranspose_set_parameter_value(NativePluginHandle handle, uint32_
 }
 
 // FIXME for v3.0, use const for the input buffer
-static void miditranspose_process(NativePluginHandle handle,
-                                  float** inBuffer, float** outBuffer, uint32_t frames,
-                                  const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+static void miditranspose_process_with_parameter_events(NativePluginHandle handle,
+                                                        float** inBuffer, float** outBuffer, uint32_t frames,
+                                                        const NativeMidiEvent* midiEvents, uint32_t midiEventCount,
+                                                        const NativeParameterEvent* paramEvents, uint32_t paramEventCount)
 {
     const NativeHostDescriptor* const host = handlePtr->host;
-    const int octaves = handlePtr->octaves;
-    const int semitones = handlePtr->semitones;
     NativeMidiEvent tmpEvent;
+    uint32_t p = 0;
 
     for (uint32_t i=0; i < midiEventCount; ++i)
     {
         const NativeMidiEvent* const midiEvent = &midiEvents[i];
 
+        // apply parameter changes up to this event
+        for (; p < paramEventCount && paramEvents[p].time <= midiEvent->time; ++p)
+            miditranspose_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
+        const int octaves = handlePtr->octaves;
+        const int semitones = handlePtr->semitones;
+
         const uint8_t status = (uint8_t)MIDI_GET_STATUS_FROM_DATA(midiEvent->data);
 
         if (status == MIDI_STATUS_NOTE_OFF || status == MIDI_STATUS_NOTE_ON)
@@ -168,6 +175,10 @@ static void miditranspose_process(NativePluginHandle handle,
             host->write_midi_event(host->handle, midiEvent);
     }
 
+    // and the remaining ones
+    for (; p < paramEventCount; ++p)
+        miditranspose_set_parameter_value(handle, paramEvents[p].index, paramEvents[p].value);
+
     return;
 
     // unused
@@ -176,13 +187,21 @@ static void miditranspose_process(NativePluginHandle handle,
     (void)frames;
 }
 
+// FIXME for v3.0, use const for the input buffer
+static void miditranspose_process(NativePluginHandle handle,
+                                  float** inBuffer, float** outBuffer, uint32_t frames,
+                                  const NativeMidiEvent* midiEvents, uint32_t midiEventCount)
+{
+    miditranspose_process_with_parameter_events(handle, inBuffer, outBuffer, frames, midiEvents, midiEventCount, NULL, 0);
+}
+
 #undef handlePtr
 
 // -----------------------------------------------------------------------
 
 static const NativePluginDescriptor miditransposeDesc = {
     .category  = NATIVE_PLUGIN_CATEGORY_UTILITY,
-    .hints     = NATIVE_PLUGIN_IS_RTSAFE,
+    .hints     = NATIVE_PLUGIN_IS_RTSAFE|NATIVE_PLUGIN_USES_PARAM_EVENTS,
     .supports  = NATIVE_PLUGIN_SUPPORTS_EVERYTHING,
     .audioIns  = 0,
     .audioOuts = 0,
@@ -225,7 +244,9 @@ static const NativePluginDescriptor miditransposeDesc = {
     .get_state = NULL,
     .set_state = NULL,
 
-    .dispatcher = NULL
+    .dispatcher = NULL,
+
+    .process_with_parameter_events = miditranspose_process_with_parameter_events
 };
 
 // -----------------------------------------------------------------------
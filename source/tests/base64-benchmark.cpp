@@ -0,0 +1,103 @@
+/*
+ * Carla base64 micro-benchmark
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBase64Utils.hpp"
+
+#include <ctime>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const std::size_t kDataSize   = 32*1024*1024 + 1; // odd size, so padding is tested too
+static const uint        kIterations = 4;
+
+static double getSeconds()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+static void printSpeed(const char* const name, const double seconds, const std::size_t bytes)
+{
+    carla_stdout("%-16s %8.1f MiB/s", name, static_cast<double>(bytes * kIterations) / seconds / (1024.0 * 1024.0));
+}
+
+struct NullWriter {
+    std::size_t written;
+
+    bool operator()(const char* const, const std::size_t size) noexcept
+    {
+        written += size;
+        return true;
+    }
+};
+
+int main()
+{
+    std::vector<uint8_t> data(kDataSize);
+
+    uint32_t seed = 1;
+    for (std::size_t i=0; i<kDataSize; ++i)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        data[i] = static_cast<uint8_t>(seed >> 24);
+    }
+
+    const std::size_t base64Size = carla_base64EncodedSize(kDataSize);
+    char* const base64 = new char[base64Size+1];
+    base64[base64Size] = '\0';
+
+    std::vector<uint8_t> decoded;
+    double start;
+
+    // encode into a preallocated buffer
+    start = getSeconds();
+    for (uint i=0; i<kIterations; ++i)
+        carla_base64Encode(data.data(), kDataSize, base64);
+    printSpeed("encode", getSeconds() - start, kDataSize);
+
+    // encode into a string
+    start = getSeconds();
+    for (uint i=0; i<kIterations; ++i)
+        CARLA_SAFE_ASSERT(CarlaString::asBase64(data.data(), kDataSize).length() == base64Size);
+    printSpeed("asBase64", getSeconds() - start, kDataSize);
+
+    // encode in pieces
+    NullWriter writer = { 0 };
+    start = getSeconds();
+    for (uint i=0; i<kIterations; ++i)
+        carla_base64EncodeStream(data.data(), kDataSize, writer);
+    printSpeed("encode stream", getSeconds() - start, kDataSize);
+    CARLA_SAFE_ASSERT(writer.written == base64Size * kIterations);
+
+    // decode
+    start = getSeconds();
+    for (uint i=0; i<kIterations; ++i)
+        carla_getChunkFromBase64String_impl(decoded, base64);
+    printSpeed("decode", getSeconds() - start, kDataSize);
+
+    const bool ok = decoded == data;
+    delete[] base64;
+
+    if (! ok)
+    {
+        carla_stderr2("base64 round-trip failed");
+        return 1;
+    }
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
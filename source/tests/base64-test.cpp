@@ -0,0 +1,174 @@
+/*
+ * Carla base64 tests
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaBase64Utils.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint sFailures = 0;
+
+static void checkDecode(const char* const base64, const char* const expected)
+{
+    const std::vector<uint8_t> decoded(carla_getChunkFromBase64String(base64));
+    const std::size_t expectedSize = std::strlen(expected);
+
+    if (decoded.size() == expectedSize && std::memcmp(decoded.data(), expected, expectedSize) == 0)
+        return;
+
+    carla_stderr2("decode of \"%s\" failed, expected \"%s\"", base64, expected);
+    ++sFailures;
+}
+
+static void checkEncode(const char* const data, const char* const expected)
+{
+    const CarlaString base64(CarlaString::asBase64(data, std::strlen(data)));
+
+    if (base64 == expected)
+        return;
+
+    carla_stderr2("encode of \"%s\" failed, got \"%s\" instead of \"%s\"", data, base64.buffer(), expected);
+    ++sFailures;
+}
+
+struct StringWriter {
+    CarlaString string;
+    uint pieces;
+
+    bool operator()(const char* const buffer, const std::size_t)
+    {
+        string += buffer;
+        ++pieces;
+        return true;
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    // RFC 4648 test vectors, covering all padding cases
+    checkEncode("",       "");
+    checkEncode("f",      "Zg==");
+    checkEncode("fo",     "Zm8=");
+    checkEncode("foo",    "Zm9v");
+    checkEncode("foob",   "Zm9vYg==");
+    checkEncode("fooba",  "Zm9vYmE=");
+    checkEncode("foobar", "Zm9vYmFy");
+
+    checkDecode("",         "");
+    checkDecode("Zg==",     "f");
+    checkDecode("Zm8=",     "fo");
+    checkDecode("Zm9v",     "foo");
+    checkDecode("Zm9vYg==", "foob");
+    checkDecode("Zm9vYmE=", "fooba");
+    checkDecode("Zm9vYmFy", "foobar");
+
+    // missing padding
+    checkDecode("Zg",     "f");
+    checkDecode("Zm8",    "fo");
+    checkDecode("Zm9vYg", "foob");
+
+    // a single leftover char does not make a full byte
+    checkDecode("Zm9vY", "foo");
+
+    // decoding stops at the first padding char
+    checkDecode("Zg==Zm8=", "f");
+    checkDecode("Zm8=Zm9v", "fo");
+
+    // whitespace is skipped, including line wrapping in any style
+    checkDecode(" Zm9v YmFy ",      "foobar");
+    checkDecode("Zm9v\nYmFy\n",     "foobar");
+    checkDecode("Zm9v\r\nYmFy\r\n", "foobar");
+    checkDecode("\tZm9v\tYmE=",     "fooba");
+    checkDecode("Zm\n9v\nYg\n==",   "foob");
+
+    // invalid chars are skipped with a warning
+    carla_stderr("the next 2 assertion failures are expected");
+    checkDecode("Zm9v*YmFy",  "foobar");
+    checkDecode("Zm9v\x80YmE=", "fooba");
+
+    // round-trips of every size around the SIMD block sizes, wrapped like MIME (76 chars per line)
+    for (std::size_t size = 0; size < 200; ++size)
+    {
+        std::vector<uint8_t> data(size);
+
+        for (std::size_t i = 0; i < size; ++i)
+            data[i] = static_cast<uint8_t>(i * 37 + size);
+
+        const CarlaString base64(CarlaString::asBase64(data.data(), size));
+
+        if (base64.length() != carla_base64EncodedSize(size))
+        {
+            carla_stderr2("encoded size of %u bytes is wrong", static_cast<uint>(size));
+            ++sFailures;
+            continue;
+        }
+
+        if (carla_getChunkFromBase64String(base64) != data)
+        {
+            carla_stderr2("round-trip of %u bytes failed", static_cast<uint>(size));
+            ++sFailures;
+        }
+
+        CarlaString wrapped;
+
+        for (std::size_t i = 0; i < base64.length(); i += 76)
+        {
+            char line[78];
+            const std::size_t lineSize = std::min<std::size_t>(76, base64.length() - i);
+            std::memcpy(line, base64.buffer() + i, lineSize);
+            line[lineSize] = '\n';
+            line[lineSize + 1] = '\0';
+            wrapped += line;
+        }
+
+        if (carla_getChunkFromBase64String(wrapped) != data)
+        {
+            carla_stderr2("round-trip of %u bytes with line wrapping failed", static_cast<uint>(size));
+            ++sFailures;
+        }
+    }
+
+    // streaming encoder matches the one-shot one, across piece boundaries
+    {
+        std::vector<uint8_t> data(3 * 4096 * 2 + 5);
+
+        for (std::size_t i = 0; i < data.size(); ++i)
+            data[i] = static_cast<uint8_t>(i ^ (i >> 8));
+
+        StringWriter writer;
+        writer.pieces = 0;
+        carla_base64EncodeStream(data.data(), data.size(), writer);
+
+        if (writer.pieces != 3 || writer.string != CarlaString::asBase64(data.data(), data.size()))
+        {
+            carla_stderr2("streaming encode failed");
+            ++sFailures;
+        }
+    }
+
+    if (sFailures != 0)
+    {
+        carla_stderr2("%u base64 tests failed", sFailures);
+        return 1;
+    }
+
+    carla_stdout("all base64 tests passed");
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,153 @@
+/*
+ * Carla SFZero voice rendering micro-benchmark
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaJuceUtils.hpp"
+
+#include "sfzero/SFZero.h"
+
+#include <cmath>
+#include <ctime>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static const double kHostSampleRate   = 48000.0;
+static const double kSampleSampleRate = 44100.0;
+static const int    kBlockSize        = 256;
+static const int    kNumVoices        = 128;
+static const int    kNumBlocks        = static_cast<int>(4 * kHostSampleRate) / kBlockSize; // 4 seconds of audio
+
+static double getSeconds()
+{
+    return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+}
+
+struct Scenario {
+    const char* name;
+    int sampleChannels;
+    int outputChannels;
+    bool looped;
+    bool released;
+};
+
+static const Scenario kScenarios[] = {
+    { "stereo-loop",    2, 2, true,  false },
+    { "mono-loop",      1, 2, true,  false },
+    { "stereo-release", 2, 2, false, true  },
+    { "mono-out",       2, 1, true,  false },
+};
+
+static void runScenario(const Scenario& scenario)
+{
+    // 12 seconds of noise, enough for one-shot voices pitched up an octave
+    const int sampleLength = static_cast<int>(12 * kSampleSampleRate);
+
+    // extra samples filled with zeros, as done when loading files
+    water::AudioSampleBuffer* const buffer = new water::AudioSampleBuffer(scenario.sampleChannels, sampleLength + 4);
+    buffer->clear();
+
+    uint32_t seed = 1;
+    for (int c=0; c<scenario.sampleChannels; ++c)
+    {
+        float* const data = buffer->getWritePointer(c);
+
+        for (int i=0; i<sampleLength; ++i)
+        {
+            seed = seed * 1664525U + 1013904223U;
+            data[i] = static_cast<float>(seed >> 8) / 8388608.0f - 1.0f;
+        }
+    }
+
+    sfzero::Sample sample((water::File()));
+    sample.setBuffer(buffer, kSampleSampleRate);
+
+    sfzero::Region region;
+    region.sample = &sample;
+    region.pitch_keycenter = 60;
+    region.ampeg.attack = 0.01f;
+    region.ampeg.decay = 1.0f;
+    region.ampeg.sustain = 50.0f;
+    region.ampeg.release = 1.0f;
+
+    if (scenario.looped)
+    {
+        region.loop_mode = sfzero::Region::loop_continuous;
+        region.loop_start = 4410;
+        region.loop_end = 4410 + 22050;
+    }
+    else
+    {
+        region.loop_mode = sfzero::Region::no_loop;
+    }
+
+    sfzero::Sound sound((water::File()));
+    sfzero::Voice* const voices = new sfzero::Voice[kNumVoices];
+
+    for (int i=0; i<kNumVoices; ++i)
+    {
+        voices[i].setCurrentPlaybackSampleRate(kHostSampleRate);
+        voices[i].setRegion(&region);
+        voices[i].startNote(48 + i % 24, 0.8f, &sound, 8192);
+    }
+
+    water::AudioSampleBuffer output(scenario.outputChannels, kBlockSize);
+    double checksum = 0.0;
+
+    const double start = getSeconds();
+
+    for (int b=0; b<kNumBlocks; ++b)
+    {
+        if (scenario.released && b == kNumBlocks / 2)
+        {
+            for (int i=0; i<kNumVoices; ++i)
+                voices[i].stopNote(0.0f, true);
+        }
+
+        output.clear();
+
+        for (int i=0; i<kNumVoices; ++i)
+            voices[i].renderNextBlock(output, 0, kBlockSize);
+
+        for (int c=0; c<scenario.outputChannels; ++c)
+        {
+            const float* const data = output.getReadPointer(c);
+
+            for (int i=0; i<kBlockSize; ++i)
+                checksum += std::fabs(data[i]);
+        }
+    }
+
+    const double seconds = getSeconds() - start;
+    const double voiceSamples = static_cast<double>(kNumVoices) * kNumBlocks * kBlockSize;
+
+    carla_stdout("%-16s %8.1f Mvoice-samples/s, %6.0f realtime voices, checksum %.3f",
+                 scenario.name,
+                 voiceSamples / seconds / 1000000.0,
+                 voiceSamples / seconds / kHostSampleRate,
+                 checksum);
+
+    delete[] voices;
+}
+
+int main()
+{
+    for (std::size_t i=0; i<sizeof(kScenarios)/sizeof(kScenarios[0]); ++i)
+        runScenario(kScenarios[i]);
+
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,223 @@
+/*
+ * Carla XML reader tests
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#include "CarlaString.hpp"
+#include "CarlaXmlUtils.hpp"
+
+#include <vector>
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint sFailures = 0;
+
+// the reader works in-place, so it needs a writable copy
+static std::vector<char> toBuffer(const char* const xml)
+{
+    return std::vector<char>(xml, xml + std::strlen(xml) + 1);
+}
+
+// reads the whole document into a compact string, like "<a><b>text</b></a>", and "!error" on failure
+static CarlaString readAll(const char* const xml)
+{
+    std::vector<char> data(toBuffer(xml));
+    CarlaXmlReader reader(data.data(), data.size() - 1);
+    CarlaString result;
+
+    for (;;)
+    {
+        switch (reader.next())
+        {
+        case CarlaXmlReader::kTokenStartElement:
+            result += "<";
+            result += reader.getName();
+            result += ">";
+            break;
+
+        case CarlaXmlReader::kTokenEndElement:
+            result += reader.getText();
+            result += "</";
+            result += reader.getName();
+            result += ">";
+            break;
+
+        case CarlaXmlReader::kTokenEndOfDocument:
+            return result;
+
+        case CarlaXmlReader::kTokenError:
+            result += "!";
+            result += reader.getError();
+            return result;
+        }
+    }
+}
+
+static void check(const char* const xml, const char* const expected)
+{
+    const CarlaString result(readAll(xml));
+
+    if (result == expected)
+        return;
+
+    carla_stderr2("reading \"%s\" failed, got \"%s\" instead of \"%s\"", xml, result.buffer(), expected);
+    ++sFailures;
+}
+
+static void checkTruncation(const char* const xml, const bool expected)
+{
+    std::vector<char> data(toBuffer(xml));
+    CarlaXmlReader reader(data.data(), data.size() - 1);
+
+    if (reader.next() == CarlaXmlReader::kTokenStartElement && reader.endsWithRootEndTag() == expected)
+        return;
+
+    carla_stderr2("truncation check of \"%s\" failed, expected %s", xml, bool2str(expected));
+    ++sFailures;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main()
+{
+    // plain elements and text, text is trimmed and only kept for leaf elements
+    check("<a><b> text </b><c>1</c></a>", "<a><b>text</b><c>1</c></a>");
+    check("<a>\n <b>x</b>\n</a>\n", "<a><b>x</b></a>");
+
+    // entities and numeric references
+    check("<a>&amp;&lt;&gt;&apos;&quot;</a>", "<a>&<>'\"</a>");
+    check("<a>&#65;&#x42;&#X43;</a>", "<a>ABC</a>");
+    check("<a>&#xE9;&#8364;&#x1F600;</a>", "<a>\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80</a>");
+
+    // unknown or invalid entities are kept as-is
+    check("<a>&unknown; &#0; &#xZZ; & b</a>", "<a>&unknown; &#0; &#xZZ; & b</a>");
+    check("<a>trailing &</a>", "<a>trailing &</a>");
+
+    // CDATA is text, without unescaping
+    check("<a><![CDATA[<b>&amp;</b>]]></a>", "<a><b>&amp;</b></a>");
+    check("<a>x <![CDATA[]]]]>&amp;<![CDATA[>]]> y</a>", "<a>x ]]&> y</a>");
+    check("<a><![CDATA[never closed</a>", "<a>!Unterminated CDATA section");
+
+    // declaration, doctype, comments and processing instructions are skipped
+    check("<?xml version='1.0' encoding='UTF-8'?>\n<!DOCTYPE CARLA-PROJECT>\n<a/>", "<a></a>");
+    check("<!DOCTYPE a [ <!ELEMENT a (#PCDATA)> <!ENTITY e \"x\"> ]><a>1</a>", "<a>1</a>");
+    check("<a><!-- <b>not</b> --><?pi <c> ?>2</a>", "<a>2</a>");
+    check("<!DOCTYPE a [ <!ELEMENT a (#PCDATA)> <a/>", "!Invalid doctype");
+    check("<a><!-- never closed</a>", "<a>!Unterminated comment");
+
+    // empty elements, with and without attributes
+    check("<a><b/><c x='1' y=\"/>\"/><d /></a>", "<a><b></b><c></c><d></d></a>");
+
+    {
+        std::vector<char> data(toBuffer("<a x='1 &amp; 2' y=\"&lt;\"/>"));
+        CarlaXmlReader reader(data.data(), data.size() - 1);
+        water::String x, y, z;
+
+        if (reader.next() != CarlaXmlReader::kTokenStartElement
+            || ! reader.getAttribute("x", x) || x != "1 & 2"
+            || ! reader.getAttribute("y", y) || y != "<"
+            || reader.getAttribute("z", z)
+            || reader.next() != CarlaXmlReader::kTokenEndElement
+            || reader.next() != CarlaXmlReader::kTokenEndOfDocument)
+        {
+            carla_stderr2("attributes of an empty element failed");
+            ++sFailures;
+        }
+    }
+
+    // mismatched tags
+    check("<a><b></a></b>", "<a><b>!Mismatched end tag");
+    check("<a></b>", "<a>!Mismatched end tag");
+    check("</a>", "!Mismatched end tag");
+    check("<a></a >", "<a></a>");
+    check("<a></a x>", "<a>!Invalid end tag");
+
+    // truncated documents
+    check("<a><b>text", "<a><b>!Unexpected end of file");
+    check("<a><b", "<a>!Invalid element name");
+    check("<a><b x='>", "<a>!Unterminated element tag");
+    check("<a></a", "<a>!Invalid end tag");
+    check("<a><", "<a>!Unexpected end of file");
+
+    checkTruncation("<a><b/></a>", true);
+    checkTruncation("<a><b/></a >\r\n", true);
+    checkTruncation("<a/>", true);
+    checkTruncation("<a><b/></", false);
+    checkTruncation("<a><b/>", false);
+    checkTruncation("<a><b/></b>", false);
+    checkTruncation("<ab><b/></b>", false);
+
+    // depth limit
+    {
+        CarlaString ok, tooDeep, expectedOk;
+
+        for (int i = 0; i < 32; ++i)
+            ok += "<a>";
+        for (int i = 0; i < 32; ++i)
+            ok += "</a>";
+
+        expectedOk = ok;
+
+        for (int i = 0; i < 33; ++i)
+            tooDeep += "<a>";
+        for (int i = 0; i < 33; ++i)
+            tooDeep += "</a>";
+
+        CarlaString expectedTooDeep;
+        for (int i = 0; i < 32; ++i)
+            expectedTooDeep += "<a>";
+        expectedTooDeep += "!Elements nested too deep";
+
+        check(ok, expectedOk);
+        check(tooDeep, expectedTooDeep);
+    }
+
+    // skipping and tree building
+    {
+        std::vector<char> data(toBuffer("<a><skip><x>1</x><y/></skip><keep n='2'><z>3</z></keep></a>"));
+        CarlaXmlReader reader(data.data(), data.size() - 1);
+
+        bool ok = reader.next() == CarlaXmlReader::kTokenStartElement
+               && reader.next() == CarlaXmlReader::kTokenStartElement
+               && reader.skipElement()
+               && reader.next() == CarlaXmlReader::kTokenStartElement;
+
+        water::XmlElement* const elem = ok ? reader.readElementAsXml() : nullptr;
+
+        if (elem == nullptr
+            || elem->getTagName() != "keep"
+            || elem->getIntAttribute("n") != 2
+            || elem->getChildElementAllSubText("z", "") != "3"
+            || reader.next() != CarlaXmlReader::kTokenEndElement
+            || reader.next() != CarlaXmlReader::kTokenEndOfDocument)
+        {
+            carla_stderr2("skipping or reading elements as XML failed");
+            ++sFailures;
+        }
+
+        delete elem;
+    }
+
+    if (sFailures != 0)
+    {
+        carla_stderr2("%u XML tests failed", sFailures);
+        return 1;
+    }
+
+    carla_stdout("all XML tests passed");
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
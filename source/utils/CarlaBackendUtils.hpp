@@ -319,6 +319,10 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED";
     case ENGINE_CALLBACK_EMBED_UI_RESIZED:
         return "ENGINE_CALLBACK_EMBED_UI_RESIZED";
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED:
+        return "ENGINE_CALLBACK_PATCHBAY_CLIENT_PRUNED";
+    case ENGINE_CALLBACK_PLUGIN_ASYNC_DONE:
+        return "ENGINE_CALLBACK_PLUGIN_ASYNC_DONE";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -402,6 +406,12 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_DEBUG_CONSOLE_OUTPUT";
     case ENGINE_OPTION_CLIENT_NAME_PREFIX:
         return "ENGINE_OPTION_CLIENT_NAME_PREFIX";
+    case ENGINE_OPTION_PROJECT_CHUNK_FILES:
+        return "ENGINE_OPTION_PROJECT_CHUNK_FILES";
+    case ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+        return "ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT";
+    case ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE:
+        return "ENGINE_OPTION_BRIDGE_PROCESS_POOL_SIZE";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
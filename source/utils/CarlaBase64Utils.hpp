@@ -19,11 +19,15 @@
 #ifndef CARLA_BASE64_UTILS_HPP_INCLUDED
 #define CARLA_BASE64_UTILS_HPP_INCLUDED
 
-#include "CarlaUtils.hpp"
+#include "CarlaString.hpp"
 
-#include <cctype>
 #include <vector>
 
+#if (defined(__i386__) || defined(__x86_64__)) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__) >= 409))
+# include <tmmintrin.h>
+# define CARLA_BASE64_USE_SSSE3
+#endif
+
 // -----------------------------------------------------------------------
 // Helpers
 
@@ -34,87 +38,323 @@ static const char* const kBase64Chars =
     "abcdefghijklmnopqrstuvwxyz"
     "0123456789+/";
 
+// special values in the decoding table
+enum {
+    kE = 0xfd, // end of data, '=' or '\0'
+    kS = 0xfe, // whitespace (space, tab, CR or LF), skipped
+    kX = 0xff  // invalid
+};
+
+static const uint8_t kBase64DecodeTable[256] = {
+    kE, kX, kX, kX, kX, kX, kX, kX, kX, kS, kS, kX, kX, kS, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kS, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, 62, kX, kX, kX, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, kX, kX, kX, kE, kX, kX,
+    kX,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, kX, kX, kX, kX, kX,
+    kX, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX,
+    kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX, kX
+};
+
+#ifdef CARLA_BASE64_USE_SSSE3
+/*
+ * SSSE3 codecs, processing 12 bytes <-> 16 chars at a time.
+ * See http://0x80.pl/articles/index.html#base64-algorithm-new for details.
+ * These are compiled for SSSE3 regardless of build flags and only used when the CPU supports it.
+ */
+
+// encodes while at least 16 bytes are readable, returns number of bytes consumed
+__attribute__((target("ssse3")))
+static inline
+std::size_t encodeBlocksSSSE3(const uint8_t* const src, const std::size_t size, char* const dst) noexcept
+{
+    const __m128i shuffle  = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const __m128i shiftLUT = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+    std::size_t s = 0, d = 0;
+
+    for (; s + 16 <= size; s += 12, d += 16)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s));
+        in = _mm_shuffle_epi8(in, shuffle);
+
+        // split 3 bytes into 4 indices of 6 bits each
+        const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(t1, t3);
+
+        // map indices to ascii
+        __m128i result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+        result = _mm_add_epi8(_mm_shuffle_epi8(shiftLUT, result), indices);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + d), result);
+    }
+
+    return s;
+}
+
+// decodes while there are 16 valid chars available, returns number of chars consumed
+__attribute__((target("ssse3")))
 static inline
-uint8_t findBase64CharIndex(const char c)
+std::size_t decodeBlocksSSSE3(const char* const src, const std::size_t len, uint8_t* const dst) noexcept
 {
-    static const uint8_t kBase64CharsLen(static_cast<uint8_t>(std::strlen(kBase64Chars)));
+    const __m128i lutLo   = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                          0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lutHi   = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                          0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i pack    = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m128i mask0F  = _mm_set1_epi8(0x0f);
+    const __m128i mask2F  = _mm_set1_epi8(0x2f);
+    const __m128i zero    = _mm_setzero_si128();
+    std::size_t s = 0, d = 0;
 
-    for (uint8_t i=0; i<kBase64CharsLen; ++i)
+    for (; s + 16 <= len; s += 16, d += 12)
     {
-        if (kBase64Chars[i] == c)
-            return i;
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + s));
+
+        // validate, anything not in the base64 alphabet is left for the scalar code
+        const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask0F);
+        const __m128i loNibbles = _mm_and_si128(in, mask0F);
+        const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), zero)) != 0xffff)
+            break;
+
+        // map ascii to 6-bit values
+        const __m128i eq2F = _mm_cmpeq_epi8(in, mask2F);
+        const __m128i roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+        const __m128i values = _mm_add_epi8(in, roll);
+
+        // join 4 values into 3 bytes
+        const __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i joined = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+        const __m128i out = _mm_shuffle_epi8(joined, pack);
+
+        uint8_t tmp[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(tmp), out);
+        std::memcpy(dst + d, tmp, 12);
     }
 
-    carla_stderr2("findBase64CharIndex('%c') - failed", c);
-    return 0;
+    return s;
 }
 
 static inline
-bool isBase64Char(const char c)
+bool checkSSSE3() noexcept
 {
-    return (std::isalnum(c) || (c == '+') || (c == '/'));
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3");
 }
 
+static inline
+bool canUseSSSE3() noexcept
+{
+    static const bool ssse3 = checkSSSE3();
+    return ssse3;
+}
+#endif
+
 } // namespace CarlaBase64Helpers
 
 // -----------------------------------------------------------------------
 
+/*
+ * Size of the base64 representation of @a size bytes, without null terminator.
+ */
 static inline
-void carla_getChunkFromBase64String_impl(std::vector<uint8_t>& vector, const char* const base64string)
+std::size_t carla_base64EncodedSize(const std::size_t size) noexcept
 {
-    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr,);
+    return ((size + 2) / 3) * 4;
+}
 
-    uint i=0, j=0;
-    uint charArray3[3], charArray4[4];
+/*
+ * Maximum number of bytes @a len base64 chars can decode to.
+ */
+static inline
+std::size_t carla_base64DecodedMaxSize(const std::size_t len) noexcept
+{
+    return ((len + 3) / 4) * 3;
+}
 
-    vector.clear();
-    vector.reserve(std::strlen(base64string)*3/4 + 4);
+/*
+ * Encode @a size bytes of @a data into @a out, padding included.
+ * @a out must have room for carla_base64EncodedSize(size) chars, no null terminator is written.
+ */
+static inline
+void carla_base64Encode(const void* const data, const std::size_t size, char* out) noexcept
+{
+    const char* const chars = CarlaBase64Helpers::kBase64Chars;
+    const uint8_t* in = static_cast<const uint8_t*>(data);
+    std::size_t s = 0;
 
-    for (std::size_t l=0, len=std::strlen(base64string); l<len; ++l)
+#ifdef CARLA_BASE64_USE_SSSE3
+    if (size >= 16 && CarlaBase64Helpers::canUseSSSE3())
     {
-        const char c = base64string[l];
+        s = CarlaBase64Helpers::encodeBlocksSSSE3(in, size, out);
+        out += s / 3 * 4;
+    }
+#endif
 
-        if (c == '\0' || c == '=')
-            break;
-        if (c == ' ' || c == '\n')
-            continue;
+    for (; s + 3 <= size; s += 3, out += 4)
+    {
+        const uint32_t v = (static_cast<uint32_t>(in[s]) << 16) | (static_cast<uint32_t>(in[s+1]) << 8) | in[s+2];
 
-         CARLA_SAFE_ASSERT_CONTINUE(CarlaBase64Helpers::isBase64Char(c));
+        out[0] = chars[(v >> 18) & 0x3f];
+        out[1] = chars[(v >> 12) & 0x3f];
+        out[2] = chars[(v >>  6) & 0x3f];
+        out[3] = chars[v & 0x3f];
+    }
 
-        charArray4[i++] = static_cast<uint>(c);
+    switch (size - s)
+    {
+    case 1: {
+        const uint32_t v = static_cast<uint32_t>(in[s]) << 16;
+        out[0] = chars[(v >> 18) & 0x3f];
+        out[1] = chars[(v >> 12) & 0x3f];
+        out[2] = '=';
+        out[3] = '=';
+        break;
+    }
+    case 2: {
+        const uint32_t v = (static_cast<uint32_t>(in[s]) << 16) | (static_cast<uint32_t>(in[s+1]) << 8);
+        out[0] = chars[(v >> 18) & 0x3f];
+        out[1] = chars[(v >> 12) & 0x3f];
+        out[2] = chars[(v >>  6) & 0x3f];
+        out[3] = '=';
+        break;
+    }
+    }
+}
+
+/*
+ * Decode @a len base64 chars into @a out, stopping at padding or a null char.
+ * Whitespace (space, tab, CR and LF) is ignored, other invalid chars are skipped with a warning.
+ * @a out must have room for carla_base64DecodedMaxSize(len) bytes.
+ * Returns the number of bytes written.
+ */
+static inline
+std::size_t carla_base64Decode(const char* const base64string, const std::size_t len, uint8_t* const out) noexcept
+{
+    using namespace CarlaBase64Helpers;
+
+#ifdef CARLA_BASE64_USE_SSSE3
+    const bool useSSSE3 = len >= 16 && canUseSSSE3();
+#endif
+    std::size_t l = 0, o = 0;
+    uint32_t acc = 0, count = 0;
 
-        if (i == 4)
+    while (l < len)
+    {
+#ifdef CARLA_BASE64_USE_SSSE3
+        if (useSSSE3 && count == 0 && len - l >= 16)
         {
-            for (i=0; i<4; ++i)
-                charArray4[i] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[i]));
+            const std::size_t used = decodeBlocksSSSE3(base64string + l, len - l, out + o);
+            l += used;
+            o += used / 4 * 3;
 
-            charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-            charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-            charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+            if (l >= len)
+                break;
+        }
+#endif
+        const uint8_t v = kBase64DecodeTable[static_cast<uint8_t>(base64string[l++])];
 
-            for (i=0; i<3; ++i)
-                vector.push_back(static_cast<uint8_t>(charArray3[i]));
+        if (v < 64)
+        {
+            acc = (acc << 6) | v;
 
-            i = 0;
+            if (++count == 4)
+            {
+                out[o++] = static_cast<uint8_t>(acc >> 16);
+                out[o++] = static_cast<uint8_t>(acc >> 8);
+                out[o++] = static_cast<uint8_t>(acc);
+                acc = count = 0;
+            }
+            continue;
         }
+
+        if (v == kE)
+            break;
+
+        CARLA_SAFE_ASSERT_CONTINUE(v == kS);
     }
 
-    if (i != 0)
+    // leftover chars, each one after the first gives an extra byte
+    if (count >= 2)
     {
-        for (j=0; j<i && j<4; ++j)
-            charArray4[j] = CarlaBase64Helpers::findBase64CharIndex(static_cast<char>(charArray4[j]));
+        acc <<= 6 * (4 - count);
+        out[o++] = static_cast<uint8_t>(acc >> 16);
+
+        if (count == 3)
+            out[o++] = static_cast<uint8_t>(acc >> 8);
+    }
+
+    return o;
+}
+
+/*
+ * Encode @a size bytes of @a data in pieces, calling @a writer(const char* buffer, std::size_t length)
+ * for each one, buffer is null-terminated. This avoids holding the whole base64 string in memory.
+ * Stops and returns false as soon as the writer does.
+ */
+template<typename Writer>
+static inline
+bool carla_base64EncodeStream(const void* const data, const std::size_t size, Writer& writer)
+{
+    // must be a multiple of 3, so only the last piece gets padding
+    static const std::size_t kPieceSize = 3 * 4096;
+
+    const uint8_t* const in = static_cast<const uint8_t*>(data);
+    char buffer[kPieceSize / 3 * 4 + 1];
 
-        for (j=i; j<4; ++j)
-            charArray4[j] = 0;
+    for (std::size_t s = 0; s < size; s += kPieceSize)
+    {
+        const std::size_t pieceSize = size - s < kPieceSize ? size - s : kPieceSize;
+        const std::size_t base64Size = carla_base64EncodedSize(pieceSize);
 
-        charArray3[0] =  (charArray4[0] << 2)        + ((charArray4[1] & 0x30) >> 4);
-        charArray3[1] = ((charArray4[1] & 0xf) << 4) + ((charArray4[2] & 0x3c) >> 2);
-        charArray3[2] = ((charArray4[2] & 0x3) << 6) +   charArray4[3];
+        carla_base64Encode(in + s, pieceSize, buffer);
+        buffer[base64Size] = '\0';
 
-        for (j=0; i>0 && j<i-1; j++)
-            vector.push_back(static_cast<uint8_t>(charArray3[j]));
+        if (! writer(static_cast<const char*>(buffer), base64Size))
+            return false;
     }
 
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+static inline
+void carla_getChunkFromBase64String_impl(std::vector<uint8_t>& vector, const char* const base64string)
+{
+    CARLA_SAFE_ASSERT_RETURN(base64string != nullptr,);
+
+    const std::size_t len = std::strlen(base64string);
+
+    vector.clear();
+
+    if (len == 0)
+        return;
+
+    vector.resize(carla_base64DecodedMaxSize(len));
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+    vector.resize(carla_base64Decode(base64string, len, vector.data()));
+#else
+    vector.resize(carla_base64Decode(base64string, len, &vector.front()));
+#endif
 }
 
 static inline
@@ -127,4 +367,30 @@ std::vector<uint8_t> carla_getChunkFromBase64String(const char* const base64stri
 
 // -----------------------------------------------------------------------
 
+inline
+CarlaString CarlaString::asBase64(const void* const data, const std::size_t dataSize)
+{
+    CarlaString ret;
+
+    if (dataSize == 0)
+        return ret;
+
+    const std::size_t base64Size = carla_base64EncodedSize(dataSize);
+
+    // encode directly into our own buffer
+    char* const base64Buf = (char*)std::malloc(base64Size+1);
+    CARLA_SAFE_ASSERT_RETURN(base64Buf != nullptr, ret);
+
+    carla_base64Encode(data, dataSize, base64Buf);
+    base64Buf[base64Size] = '\0';
+
+    ret.fBuffer      = base64Buf;
+    ret.fBufferLen   = base64Size;
+    ret.fBufferAlloc = true;
+
+    return ret;
+}
+
+// -----------------------------------------------------------------------
+
 #endif // CARLA_BASE64_UTILS_HPP_INCLUDED
@@ -117,6 +117,16 @@ enum PluginBridgeNonRtServerOpcode {
     kPluginBridgeNonRtServerVersion             // uint
 };
 
+// Server sends these to a bridge process pool during non-RT
+enum PluginBridgePoolOpcode {
+    kPluginBridgePoolNull = 0,
+    kPluginBridgePoolAddPlugin, // uint/size, str[] (shm ids), uint/type, uint/size, str[] (filename), uint/size, str[] (label), long/uniqueId
+    kPluginBridgePoolQuit
+};
+
+// maximum number of plugins a single pooled bridge process can host
+static const uint kPluginBridgePoolMaxSize = 32;
+
 // used for kPluginBridgeNonRtServerPortName
 enum PluginBridgePortType {
     kPluginBridgePortNull = 0,
@@ -206,6 +206,23 @@ const char* PluginBridgeNonRtServerOpcode2str(const PluginBridgeNonRtServerOpcod
     return nullptr;
 }
 
+static inline
+const char* PluginBridgePoolOpcode2str(const PluginBridgePoolOpcode opcode) noexcept
+{
+    switch (opcode)
+    {
+    case kPluginBridgePoolNull:
+        return "kPluginBridgePoolNull";
+    case kPluginBridgePoolAddPlugin:
+        return "kPluginBridgePoolAddPlugin";
+    case kPluginBridgePoolQuit:
+        return "kPluginBridgePoolQuit";
+    }
+
+    carla_stderr("CarlaBackend::PluginBridgePoolOpcode2str%i) - invalid opcode", opcode);
+    return nullptr;
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 static const std::size_t kBridgeRtClientDataMidiOutSize = 511*4;
@@ -0,0 +1,105 @@
+/*
+ * Carla cache utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_CACHE_UTILS_HPP_INCLUDED
+#define CARLA_CACHE_UTILS_HPP_INCLUDED
+
+#include "CarlaString.hpp"
+
+#ifndef CARLA_OS_WIN
+# include <cerrno>
+# include <climits>
+# include <sys/stat.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Get the directory used for Carla's on-disk caches.
+// Returns $XDG_CACHE_HOME/carla (or ~/.cache/carla), with `subdir` appended if not null.
+// If `envVar` is set in the environment its value is used as-is instead, an empty value meaning caching is disabled.
+// Returns an empty string if caching is disabled or no suitable location exists.
+
+static inline
+CarlaString carla_get_cache_dir(const char* const envVar, const char* const subdir = nullptr)
+{
+#ifdef CARLA_OS_WIN
+    return CarlaString();
+    // unused
+    (void)envVar;
+    (void)subdir;
+#else
+    if (envVar != nullptr)
+    {
+        if (const char* const cacheDir = std::getenv(envVar))
+            return CarlaString(cacheDir);
+    }
+
+    CarlaString cacheDir;
+
+    if (const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME"))
+        cacheDir = CarlaString(xdgCacheHome) + "/carla";
+    else if (const char* const homeDir = std::getenv("HOME"))
+        cacheDir = CarlaString(homeDir) + "/.cache/carla";
+    else
+        return CarlaString();
+
+    if (subdir != nullptr && subdir[0] != '\0')
+        cacheDir += CarlaString("/") + subdir;
+
+    return cacheDir;
+#endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Create a directory including all its missing parents, like `mkdir -p`.
+// Returns true if the directory exists afterwards.
+
+static inline
+bool carla_create_dir_path(const char* const dirPath)
+{
+    CARLA_SAFE_ASSERT_RETURN(dirPath != nullptr && dirPath[0] != '\0', false);
+
+#ifdef CARLA_OS_WIN
+    return false;
+#else
+    char path[PATH_MAX];
+    std::strncpy(path, dirPath, PATH_MAX-1);
+    path[PATH_MAX-1] = '\0';
+
+    for (char* sep = std::strchr(path + 1, '/');; sep = std::strchr(sep + 1, '/'))
+    {
+        if (sep != nullptr)
+            *sep = '\0';
+
+        if (path[0] != '\0' && ::mkdir(path, 0755) != 0 && errno != EEXIST)
+        {
+            carla_stderr2("carla_create_dir_path: failed to create directory \"%s\"", path);
+            return false;
+        }
+
+        if (sep == nullptr)
+            break;
+
+        *sep = '/';
+    }
+
+    return true;
+#endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_CACHE_UTILS_HPP_INCLUDED
@@ -0,0 +1,169 @@
+/*
+ * Carla hash utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_HASH_UTILS_HPP_INCLUDED
+#define CARLA_HASH_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+// --------------------------------------------------------------------------------------------------------------------
+// FNV-1a hashes, not suitable for anything security related.
+// Pass a previous result as `hash` to continue hashing more data.
+
+static const uint32_t kCarlaHashInit32 = 2166136261U;
+static const uint64_t kCarlaHashInit64 = 14695981039346656037ULL;
+
+static inline
+uint32_t carla_fnv1a_32(const void* const data, const std::size_t size, uint32_t hash = kCarlaHashInit32) noexcept
+{
+    const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static inline
+uint32_t carla_fnv1a_32_str(const char* str, uint32_t hash = kCarlaHashInit32) noexcept
+{
+    for (; *str != '\0'; ++str)
+    {
+        hash ^= static_cast<uint8_t>(*str);
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static inline
+uint64_t carla_fnv1a_64(const void* const data, const std::size_t size, uint64_t hash = kCarlaHashInit64) noexcept
+{
+    const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+static inline
+uint64_t carla_fnv1a_64_str(const char* str, uint64_t hash = kCarlaHashInit64) noexcept
+{
+    for (; *str != '\0'; ++str)
+    {
+        hash ^= static_cast<uint8_t>(*str);
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// MurmurHash3, x64 128-bit variant with seed 0, for content-addressed file names.
+// Not suitable for anything security related either.
+
+static inline
+uint64_t carla_murmur3_rotl64(const uint64_t x, const int r) noexcept
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline
+uint64_t carla_murmur3_fmix64(uint64_t k) noexcept
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static inline
+void carla_murmur3_128(const void* const data, const std::size_t dataSize, uint64_t hash[2]) noexcept
+{
+    const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+    const std::size_t nblocks = dataSize / 16;
+
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+    uint64_t h1 = 0, h2 = 0, k1, k2;
+
+    for (std::size_t i=0; i<nblocks; ++i)
+    {
+        std::memcpy(&k1, bytes + i*16, sizeof(uint64_t));
+        std::memcpy(&k2, bytes + i*16 + 8, sizeof(uint64_t));
+
+        k1 *= c1; k1 = carla_murmur3_rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = carla_murmur3_rotl64(h1, 27); h1 += h2; h1 = h1*5 + 0x52dce729;
+
+        k2 *= c2; k2 = carla_murmur3_rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = carla_murmur3_rotl64(h2, 31); h2 += h1; h2 = h2*5 + 0x38495ab5;
+    }
+
+    const uint8_t* const tail = bytes + nblocks*16;
+    k1 = k2 = 0;
+
+    switch (dataSize & 15)
+    {
+    case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; // fall through
+    case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; // fall through
+    case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; // fall through
+    case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; // fall through
+    case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; // fall through
+    case 10: k2 ^= static_cast<uint64_t>(tail[ 9]) << 8;  // fall through
+    case  9: k2 ^= static_cast<uint64_t>(tail[ 8]);
+             k2 *= c2; k2 = carla_murmur3_rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+             // fall through
+    case  8: k1 ^= static_cast<uint64_t>(tail[ 7]) << 56; // fall through
+    case  7: k1 ^= static_cast<uint64_t>(tail[ 6]) << 48; // fall through
+    case  6: k1 ^= static_cast<uint64_t>(tail[ 5]) << 40; // fall through
+    case  5: k1 ^= static_cast<uint64_t>(tail[ 4]) << 32; // fall through
+    case  4: k1 ^= static_cast<uint64_t>(tail[ 3]) << 24; // fall through
+    case  3: k1 ^= static_cast<uint64_t>(tail[ 2]) << 16; // fall through
+    case  2: k1 ^= static_cast<uint64_t>(tail[ 1]) << 8;  // fall through
+    case  1: k1 ^= static_cast<uint64_t>(tail[ 0]);
+             k1 *= c1; k1 = carla_murmur3_rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= static_cast<uint64_t>(dataSize);
+    h2 ^= static_cast<uint64_t>(dataSize);
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = carla_murmur3_fmix64(h1);
+    h2 = carla_murmur3_fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    hash[0] = h1;
+    hash[1] = h2;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_HASH_UTILS_HPP_INCLUDED
@@ -0,0 +1,1317 @@
+/*
+ * Carla LV2 cache utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
+#define CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
+
+#include "CarlaCacheUtils.hpp"
+#include "CarlaHashUtils.hpp"
+#include "CarlaLv2Utils.hpp"
+#include "CarlaMutex.hpp"
+#include "CarlaString.hpp"
+
+#include "water/containers/HashMap.h"
+#include "water/files/File.h"
+#include "water/text/String.h"
+
+#include <vector>
+
+#ifndef CARLA_OS_WIN
+# include <cerrno>
+# include <climits>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Binary cache of LV2_RDF_Descriptor data
+//
+// Parsing every bundle in LV2_PATH through lilv is slow, while a project usually only needs a few plugins.
+// This cache keeps previously parsed descriptors in a single append-only file, which is memory-mapped as a whole.
+// Lookups only deserialize the requested plugin, and are validated against a signature of its bundle,
+// made from the modification time and size of the bundle dir, its manifest and the ttl files the manifest references.
+// Once the file gets too big it is compacted into a new file which replaces the old one,
+// so other processes can keep using their mapping of the old file.
+//
+// It also keeps the plugin list of each bundle, which is what carla_get_cached_plugin_count/info and carla-discovery
+// report for LV2, so listing plugins does not need lilv either as long as no bundle changed.
+// Bundle records are keyed by the full bundle path and validated with the same signature,
+// the bundles of each LV2 path are kept too, so added or removed bundles are noticed.
+//
+// The file lives in $XDG_CACHE_HOME/carla/lv2-rdf.bin (or ~/.cache/carla/lv2-rdf.bin).
+// The CARLA_LV2_CACHE_DIR environment variable changes its location, setting it to an empty string disables the cache.
+
+// Plugin summary as reported by carla_get_cached_plugin_info, plus the data carla-discovery needs
+struct Lv2CachedPluginInfo {
+    bool valid;
+    uint32_t category;
+    uint32_t hints;
+    uint32_t audioIns, audioOuts;
+    uint32_t cvIns, cvOuts;
+    uint32_t midiIns, midiOuts;
+    uint32_t parameterIns, parameterOuts;
+    CarlaString uri;
+    CarlaString label;
+    CarlaString name;
+    CarlaString maker;
+    CarlaString copyright;
+    CarlaString binary;
+
+    Lv2CachedPluginInfo() noexcept
+        : valid(false),
+          category(0),
+          hints(0x0),
+          audioIns(0),
+          audioOuts(0),
+          cvIns(0),
+          cvOuts(0),
+          midiIns(0),
+          midiOuts(0),
+          parameterIns(0),
+          parameterOuts(0),
+          uri(),
+          label(),
+          name(),
+          maker(),
+          copyright(),
+          binary() {}
+};
+
+struct Lv2CachedBundle {
+    CarlaString bundle;
+    std::vector<Lv2CachedPluginInfo> plugins;
+
+    Lv2CachedBundle() noexcept
+        : bundle(),
+          plugins() {}
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class Lv2RdfCache
+{
+public:
+    Lv2RdfCache()
+        : fData(nullptr),
+          fDataSize(0),
+          fTriedOpen(false),
+          fMutex(),
+          fIndex() {}
+
+    ~Lv2RdfCache() noexcept
+    {
+        close();
+    }
+
+    static Lv2RdfCache& getInstance()
+    {
+        static Lv2RdfCache lv2RdfCache;
+        return lv2RdfCache;
+    }
+
+    // returns a new descriptor (to be deleted by the caller), or null if not cached or outdated
+    const LV2_RDF_Descriptor* lookup(const LV2_URI uri, const bool loadPresets)
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', nullptr);
+
+        const CarlaMutexLocker cml(fMutex);
+
+        if (! fTriedOpen)
+        {
+            fTriedOpen = true;
+            open();
+        }
+
+        if (fData == nullptr)
+            return nullptr;
+
+        const RecordHeader* const record = findRecord(uri);
+
+        if (record == nullptr || (record->flags & (kRecordIsBundle|kRecordIsPath)) != 0)
+            return nullptr;
+        if (loadPresets && (record->flags & kRecordHasPresets) == 0)
+            return nullptr;
+
+        const char* const bundle = reinterpret_cast<const char*>(record + 1) + record->uriSize;
+
+        if (getBundleSignature(bundle) != record->bundleSignature)
+            return nullptr;
+
+        Reader reader(reinterpret_cast<const uint8_t*>(bundle) + record->bundleSize, record->blobSize);
+        LV2_RDF_Descriptor* const rdfDescriptor(new LV2_RDF_Descriptor());
+
+        if (! reader.readDescriptor(*rdfDescriptor, loadPresets))
+        {
+            carla_stderr("Lv2RdfCache: corrupted entry for '%s'", uri);
+            delete rdfDescriptor;
+            return nullptr;
+        }
+
+        return rdfDescriptor;
+    }
+
+    // append a descriptor, as created by lv2_rdf_new
+    void store(const LV2_RDF_Descriptor* const rdfDescriptor, const bool hasPresets)
+    {
+        CARLA_SAFE_ASSERT_RETURN(rdfDescriptor != nullptr,);
+        CARLA_SAFE_ASSERT_RETURN(rdfDescriptor->URI != nullptr && rdfDescriptor->Bundle != nullptr,);
+
+        if (! isEnabled())
+            return;
+
+        std::vector<uint8_t> blob;
+        Writer writer(blob);
+        writer.writeDescriptor(*rdfDescriptor, hasPresets);
+
+        std::vector<uint8_t> data;
+        water::HashMap<water::String, bool> keys;
+
+        if (! appendRecord(data, rdfDescriptor->URI, rdfDescriptor->Bundle,
+                           hasPresets ? kRecordHasPresets : 0x0, blob, getBundleSignature(rdfDescriptor->Bundle)))
+            return;
+
+        keys.set(water::String(rdfDescriptor->URI), true);
+        writeRecords(data, keys);
+    }
+
+    // get the plugins of all bundles in an LV2 path, as listed by lilv after loading the whole path.
+    // `bundles` are the bundles currently in the path, in lilv load order, their plugins get filled in.
+    // returns false if any bundle is not cached or outdated, or if bundles were added or removed since
+    bool lookupPath(const char* const lv2Path, std::vector<Lv2CachedBundle>& bundles)
+    {
+        CARLA_SAFE_ASSERT_RETURN(lv2Path != nullptr, false);
+
+        const CarlaMutexLocker cml(fMutex);
+
+        if (! fTriedOpen)
+        {
+            fTriedOpen = true;
+            open();
+        }
+
+        if (fData == nullptr)
+            return false;
+
+        // lilv only lists a plugin in the bundle with its newest version,
+        // so the other bundles are only valid as long as that one is still around
+        const RecordHeader* const record = findRecord(getPathKey(lv2Path));
+
+        if (record == nullptr || (record->flags & kRecordIsPath) == 0)
+            return false;
+
+        Reader reader(getRecordBlob(record), record->blobSize);
+
+        if (reader.readCount() != bundles.size())
+            return false;
+
+        CarlaString bundlePath;
+
+        for (std::size_t i=0; i < bundles.size(); ++i)
+        {
+            reader.readString(bundlePath);
+
+            if (! reader.ok || bundlePath != getBundleKey(bundles[i].bundle))
+                return false;
+        }
+
+        for (std::size_t i=0; i < bundles.size(); ++i)
+        {
+            const CarlaString key(getBundleKey(bundles[i].bundle));
+
+            bundles[i].plugins.clear();
+
+            if (! readBundleRecord(key, key, kRecordIsBundle, bundles[i].plugins))
+                return false;
+        }
+
+        return true;
+    }
+
+    // store the plugins of all bundles in an LV2 path, as listed by lilv after loading the whole path
+    void storePath(const char* const lv2Path, const std::vector<Lv2CachedBundle>& bundles)
+    {
+        CARLA_SAFE_ASSERT_RETURN(lv2Path != nullptr,);
+
+        if (! isEnabled())
+            return;
+
+        std::vector<uint8_t> data;
+        water::HashMap<water::String, bool> keys;
+
+        std::vector<uint8_t> pathBlob;
+        Writer pathWriter(pathBlob);
+        pathWriter.writeU32(static_cast<uint32_t>(bundles.size()));
+
+        for (std::size_t i=0; i < bundles.size(); ++i)
+        {
+            // the bundle path is both key and bundle, so compaction validates these records like the others
+            const CarlaString key(getBundleKey(bundles[i].bundle));
+
+            pathWriter.writeString(key);
+            appendBundleRecord(data, keys, key, key, kRecordIsBundle, bundles[i].plugins);
+        }
+
+        // not tied to a single bundle, lookupPath checks the bundle list instead
+        const CarlaString pathKey(getPathKey(lv2Path));
+
+        if (appendRecord(data, pathKey, "", kRecordIsPath, pathBlob, 1))
+            keys.set(water::String(pathKey.buffer()), true);
+
+        writeRecords(data, keys);
+    }
+
+    // get the plugins of a single bundle loaded on its own, as carla-discovery does.
+    // returns false if not cached or outdated
+    bool lookupBundle(const char* const bundle, std::vector<Lv2CachedPluginInfo>& plugins)
+    {
+        CARLA_SAFE_ASSERT_RETURN(bundle != nullptr && bundle[0] != '\0', false);
+
+        const CarlaString bundlePath(getBundleKey(bundle));
+
+        const CarlaMutexLocker cml(fMutex);
+
+        if (! fTriedOpen)
+        {
+            fTriedOpen = true;
+            open();
+        }
+
+        if (fData == nullptr)
+            return false;
+
+        plugins.clear();
+        return readBundleRecord(getStandaloneKey(bundlePath), bundlePath, kRecordIsBundle|kRecordIsStandalone, plugins);
+    }
+
+    // store the plugins of a single bundle loaded on its own, bundles without plugins are valid entries too
+    void storeBundle(const Lv2CachedBundle& bundle)
+    {
+        CARLA_SAFE_ASSERT_RETURN(bundle.bundle.isNotEmpty(),);
+
+        if (! isEnabled())
+            return;
+
+        std::vector<uint8_t> data;
+        water::HashMap<water::String, bool> keys;
+
+        const CarlaString bundlePath(getBundleKey(bundle.bundle));
+        appendBundleRecord(data, keys, getStandaloneKey(bundlePath), bundlePath,
+                           kRecordIsBundle|kRecordIsStandalone, bundle.plugins);
+
+        if (! data.empty())
+            writeRecords(data, keys);
+    }
+
+private:
+    struct FileHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t recordSize;
+        uint32_t flags;
+        uint32_t uriSize;
+        uint32_t bundleSize;
+        uint32_t blobSize;
+        uint64_t bundleSignature;
+    };
+
+    // bump this when any LV2_RDF struct changes
+    static const uint32_t kVersion = 3;
+    static const uint32_t kRecordMagic = 0x46445243; // "CRDF"
+    static const uint32_t kRecordHasPresets = 0x1;
+    static const uint32_t kRecordIsBundle = 0x2;
+    static const uint32_t kRecordIsStandalone = 0x4;
+    static const uint32_t kRecordIsPath = 0x8;
+    static const off_t kMaxFileSize = 64 * 1024 * 1024;
+    static const std::size_t kMaxManifestSize = 1024 * 1024;
+
+    void*       fData;
+    std::size_t fDataSize;
+    bool        fTriedOpen;
+    CarlaMutex  fMutex;
+
+    // URI (or bundle path) to offset of its latest record
+    water::HashMap<water::String, water::int64> fIndex;
+
+    static const char* getMagic() noexcept
+    {
+        return "CarlaRDF";
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    void open()
+    {
+#ifndef CARLA_OS_WIN
+        const CarlaString cachePath(getCachePath());
+
+        if (cachePath.isEmpty())
+            return;
+
+        const int fd = ::open(cachePath, O_RDONLY);
+
+        if (fd < 0)
+            return;
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader)))
+        {
+            ::close(fd);
+            return;
+        }
+
+        const std::size_t dataSize = static_cast<std::size_t>(st.st_size);
+        void* const data = ::mmap(nullptr, dataSize, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+
+        if (data == MAP_FAILED)
+            return;
+
+        const FileHeader* const header = static_cast<const FileHeader*>(data);
+
+        if (std::memcmp(header->magic, getMagic(), sizeof(header->magic)) != 0 || header->version != kVersion)
+        {
+            carla_stdout("Lv2RdfCache: ignoring cache from an older version");
+            ::munmap(data, dataSize);
+            return;
+        }
+
+        fData = data;
+        fDataSize = dataSize;
+        buildIndex();
+#endif
+    }
+
+    void close() noexcept
+    {
+        if (fData == nullptr)
+            return;
+
+#ifndef CARLA_OS_WIN
+        ::munmap(fData, fDataSize);
+#endif
+        fData = nullptr;
+        fDataSize = 0;
+        fIndex.clear();
+    }
+
+    // iterate over all valid records, stopping at incomplete or corrupted ones
+    const RecordHeader* nextRecord(std::size_t& pos) const noexcept
+    {
+        if (pos + sizeof(RecordHeader) > fDataSize)
+            return nullptr;
+
+        const RecordHeader* const record = reinterpret_cast<const RecordHeader*>(static_cast<const uint8_t*>(fData) + pos);
+
+        if (record->magic != kRecordMagic
+            || record->recordSize < sizeof(RecordHeader)
+            || pos + record->recordSize > fDataSize
+            || record->uriSize == 0
+            || sizeof(RecordHeader) + static_cast<uint64_t>(record->uriSize)
+               + record->bundleSize + record->blobSize > record->recordSize
+            || reinterpret_cast<const char*>(record + 1)[record->uriSize - 1] != '\0')
+            return nullptr;
+
+        pos += record->recordSize;
+        return record;
+    }
+
+    // newer records of the same URI are appended later, so the last match wins
+    void buildIndex()
+    {
+        fIndex.clear();
+
+        std::size_t pos = sizeof(FileHeader);
+
+        for (std::size_t recordPos = pos; const RecordHeader* const record = nextRecord(pos); recordPos = pos)
+            fIndex.set(water::String(reinterpret_cast<const char*>(record + 1)), static_cast<water::int64>(recordPos));
+    }
+
+    const RecordHeader* findRecord(const LV2_URI uri) const
+    {
+        // offsets are never 0, as the file header comes first
+        const water::int64 pos = fIndex[water::String(uri)];
+
+        if (pos == 0)
+            return nullptr;
+
+        return reinterpret_cast<const RecordHeader*>(static_cast<const uint8_t*>(fData) + pos);
+    }
+
+    static const uint8_t* getRecordBlob(const RecordHeader* const record) noexcept
+    {
+        return reinterpret_cast<const uint8_t*>(record + 1) + record->uriSize + record->bundleSize;
+    }
+
+    // read the plugin list of a bundle record, must be called with the mutex locked
+    bool readBundleRecord(const char* const key, const char* const bundlePath, const uint32_t flags,
+                          std::vector<Lv2CachedPluginInfo>& plugins) const
+    {
+        const RecordHeader* const record = findRecord(key);
+
+        if (record == nullptr || (record->flags & (kRecordIsBundle|kRecordIsStandalone)) != flags)
+            return false;
+        if (getBundleSignature(bundlePath) != record->bundleSignature)
+            return false;
+
+        Reader reader(getRecordBlob(record), record->blobSize);
+
+        const uint32_t count = reader.readCount();
+        const std::size_t offset = plugins.size();
+        plugins.resize(offset + count);
+
+        for (uint32_t i=0; i < count && reader.ok; ++i)
+            reader.readPluginInfo(plugins[offset + i]);
+
+        if (! reader.ok)
+        {
+            carla_stderr("Lv2RdfCache: corrupted entry for '%s'", key);
+            plugins.resize(offset);
+            return false;
+        }
+
+        return true;
+    }
+
+    static void appendBundleRecord(std::vector<uint8_t>& data, water::HashMap<water::String, bool>& keys,
+                                   const char* const key, const char* const bundlePath, const uint32_t flags,
+                                   const std::vector<Lv2CachedPluginInfo>& plugins)
+    {
+        std::vector<uint8_t> blob;
+        Writer writer(blob);
+        writer.writeU32(static_cast<uint32_t>(plugins.size()));
+
+        for (std::size_t i=0; i < plugins.size(); ++i)
+            writer.writePluginInfo(plugins[i]);
+
+        if (appendRecord(data, key, bundlePath, flags, blob, getBundleSignature(bundlePath)))
+            keys.set(water::String(key), true);
+    }
+
+    // serialize a record at the end of `data`, returns false if its bundle does not exist
+    static bool appendRecord(std::vector<uint8_t>& data, const char* const key, const char* const bundle,
+                             const uint32_t flags, const std::vector<uint8_t>& blob, const uint64_t bundleSignature)
+    {
+        if (bundleSignature == 0)
+            return false;
+
+        const uint32_t uriSize = static_cast<uint32_t>(std::strlen(key) + 1);
+        const uint32_t bundleSize = static_cast<uint32_t>(std::strlen(bundle) + 1);
+        const std::size_t unpaddedSize = sizeof(RecordHeader) + uriSize + bundleSize + blob.size();
+        const std::size_t recordSize = (unpaddedSize + 7) & ~static_cast<std::size_t>(7);
+
+        const std::size_t offset = data.size();
+        data.resize(offset + recordSize, 0);
+
+        RecordHeader* const record = reinterpret_cast<RecordHeader*>(data.data() + offset);
+        record->magic = kRecordMagic;
+        record->recordSize = static_cast<uint32_t>(recordSize);
+        record->flags = flags;
+        record->uriSize = uriSize;
+        record->bundleSize = bundleSize;
+        record->blobSize = static_cast<uint32_t>(blob.size());
+        record->bundleSignature = bundleSignature;
+
+        uint8_t* ptr = data.data() + offset + sizeof(RecordHeader);
+        std::memcpy(ptr, key, uriSize);
+        ptr += uriSize;
+        std::memcpy(ptr, bundle, bundleSize);
+        ptr += bundleSize;
+
+        if (! blob.empty())
+            std::memcpy(ptr, blob.data(), blob.size());
+
+        return true;
+    }
+
+    // append serialized records to the cache file, `keys` are the URIs or bundle paths they replace
+    void writeRecords(const std::vector<uint8_t>& data, const water::HashMap<water::String, bool>& keys)
+    {
+#ifndef CARLA_OS_WIN
+        const CarlaString cachePath(getCachePath());
+
+        if (cachePath.isEmpty() || ! createCacheDir())
+            return;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        const int fd = ::open(cachePath, O_WRONLY|O_CREAT|O_APPEND, 0644);
+        CARLA_SAFE_ASSERT_RETURN(fd >= 0,);
+
+        struct stat st;
+        bool ok = ::fstat(fd, &st) == 0;
+
+        if (ok && (st.st_size < static_cast<off_t>(sizeof(FileHeader)) || st.st_size > kMaxFileSize))
+        {
+            // new file, or too big with outdated entries.
+            // never truncate in-place, as other processes might have the file mapped
+            ::close(fd);
+            ok = rewrite(cachePath, data, keys);
+        }
+        else
+        {
+            // records are written in one go, so concurrent appends from other processes do not interleave
+            ok = ok && ::write(fd, data.data(), data.size()) == static_cast<ssize_t>(data.size());
+            ::close(fd);
+        }
+        if (! ok)
+            carla_stderr2("Lv2RdfCache: failed to write to \"%s\"", cachePath.buffer());
+
+        // remap on next lookup
+        close();
+        fTriedOpen = false;
+#else
+        // unused
+        (void)data;
+        (void)keys;
+#endif
+    }
+
+    // write a new file with the latest valid record of each URI not in `newKeys`, plus `newRecords`,
+    // then replace the old file with it
+    bool rewrite(const CarlaString& cachePath, const std::vector<uint8_t>& newRecords,
+                 const water::HashMap<water::String, bool>& newKeys)
+    {
+#ifdef CARLA_OS_WIN
+        return false;
+        // unused
+        (void)cachePath;
+        (void)newRecords;
+        (void)newKeys;
+#else
+        close();
+        open();
+
+        char tmpPath[PATH_MAX];
+        std::snprintf(tmpPath, PATH_MAX, "%s.XXXXXX", cachePath.buffer());
+        tmpPath[PATH_MAX-1] = '\0';
+
+        const int fd = ::mkstemp(tmpPath);
+        CARLA_SAFE_ASSERT_RETURN(fd >= 0, false);
+
+        // mkstemp creates files only readable by the owner
+        ::fchmod(fd, 0644);
+
+        FileHeader header;
+        std::memcpy(header.magic, getMagic(), sizeof(header.magic));
+        header.version = kVersion;
+        header.reserved = 0;
+
+        bool ok = ::write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+        std::size_t written = sizeof(header);
+
+        // keep at most half of the maximum size, so compaction does not happen again right away
+        std::size_t pos = sizeof(FileHeader);
+
+        for (std::size_t recordPos = pos; ok && fData != nullptr; recordPos = pos)
+        {
+            const RecordHeader* const record = nextRecord(pos);
+
+            if (record == nullptr)
+                break;
+            if (written + record->recordSize + newRecords.size() > static_cast<std::size_t>(kMaxFileSize / 2))
+                break;
+
+            const char* const uri = reinterpret_cast<const char*>(record + 1);
+            const char* const bundle = uri + record->uriSize;
+
+            const water::String key(uri);
+
+            if (fIndex[key] != static_cast<water::int64>(recordPos))
+                continue;
+            if (newKeys.contains(key))
+                continue;
+            if (record->bundleSize == 0 || bundle[record->bundleSize - 1] != '\0')
+                continue;
+            if ((record->flags & kRecordIsPath) == 0 && getBundleSignature(bundle) != record->bundleSignature)
+                continue;
+
+            ok = ::write(fd, record, record->recordSize) == static_cast<ssize_t>(record->recordSize);
+            written += record->recordSize;
+        }
+
+        ok = ok && ::write(fd, newRecords.data(), newRecords.size()) == static_cast<ssize_t>(newRecords.size());
+        ok = ::close(fd) == 0 && ok;
+
+        close();
+
+        if (ok && ::rename(tmpPath, cachePath) == 0)
+            return true;
+
+        ::unlink(tmpPath);
+        return false;
+#endif
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    static void mixSignature(uint64_t& signature, const int64_t value) noexcept
+    {
+        signature = carla_fnv1a_64(&value, sizeof(value), signature);
+    }
+
+    static void mixFileSignature(uint64_t& signature, const char* const filename)
+    {
+#ifndef CARLA_OS_WIN
+        struct stat st;
+
+        if (::stat(filename, &st) == 0)
+        {
+            mixSignature(signature, static_cast<int64_t>(st.st_mtime));
+            mixSignature(signature, static_cast<int64_t>(st.st_size));
+        }
+        else
+        {
+            mixSignature(signature, -1);
+        }
+#else
+        // unused
+        (void)signature;
+        (void)filename;
+#endif
+    }
+
+    // returns 0 if the bundle does not exist
+    static uint64_t getBundleSignature(const char* const bundle)
+    {
+#ifdef CARLA_OS_WIN
+        return 0;
+        // unused
+        (void)bundle;
+#else
+        struct stat st;
+
+        if (::stat(bundle, &st) != 0)
+            return 0;
+
+        uint64_t signature = kCarlaHashInit64;
+        mixSignature(signature, static_cast<int64_t>(st.st_mtime));
+
+        // ttl files are usually edited in-place, which does not change the bundle dir
+        CarlaString bundlePath(bundle);
+
+        if (! bundlePath.endsWith(CARLA_OS_SEP))
+            bundlePath += CARLA_OS_SEP_STR;
+
+        const CarlaString manifestPath(bundlePath + "manifest.ttl");
+        mixFileSignature(signature, manifestPath);
+
+        // check all local ttl files referenced by the manifest, typically via rdfs:seeAlso
+        if (FILE* const file = std::fopen(manifestPath, "rb"))
+        {
+            std::vector<char> manifest(kMaxManifestSize + 1);
+            const std::size_t size = std::fread(manifest.data(), 1, kMaxManifestSize, file);
+            std::fclose(file);
+            manifest[size] = '\0';
+
+            for (char* iri = std::strchr(manifest.data(), '<'); iri != nullptr; iri = std::strchr(iri, '<'))
+            {
+                ++iri;
+
+                char* const end = std::strchr(iri, '>');
+
+                if (end == nullptr)
+                    break;
+
+                *end = '\0';
+
+                const std::size_t len = static_cast<std::size_t>(end - iri);
+
+                // relative references to ttl files only, absolute ones are not part of this bundle
+                if (len >= 5 && std::strcmp(end - 4, ".ttl") == 0 && std::strchr(iri, ':') == nullptr)
+                    mixFileSignature(signature, bundlePath + iri);
+
+                iri = end + 1;
+            }
+        }
+
+        return signature != 0 ? signature : 1;
+#endif
+    }
+
+    // absolute bundle path with a trailing separator, as lilv reports bundles
+    static CarlaString getBundleKey(const char* const bundle)
+    {
+        CarlaString key(water::File(bundle).getFullPathName().toRawUTF8());
+
+        if (! key.endsWith(CARLA_OS_SEP))
+            key += CARLA_OS_SEP_STR;
+
+        return key;
+    }
+
+    // keys of bundle and path records, which never match plugin URIs
+    static CarlaString getStandaloneKey(const char* const bundlePath)
+    {
+        return CarlaString("standalone:") + bundlePath;
+    }
+
+    static CarlaString getPathKey(const char* const lv2Path)
+    {
+        return CarlaString("lv2path:") + lv2Path;
+    }
+
+    static bool isEnabled()
+    {
+        const CarlaString cacheDir(getCacheDir());
+        return cacheDir.isNotEmpty();
+    }
+
+    static CarlaString getCacheDir()
+    {
+        return carla_get_cache_dir("CARLA_LV2_CACHE_DIR");
+    }
+
+    static CarlaString getCachePath()
+    {
+        const CarlaString cacheDir(getCacheDir());
+
+        if (cacheDir.isEmpty())
+            return CarlaString();
+
+        return cacheDir + "/lv2-rdf.bin";
+    }
+
+    static bool createCacheDir()
+    {
+        const CarlaString cacheDir(getCacheDir());
+        CARLA_SAFE_ASSERT_RETURN(cacheDir.isNotEmpty(), false);
+
+        return carla_create_dir_path(cacheDir);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Serialization
+
+    struct Writer {
+        std::vector<uint8_t>& buf;
+
+        Writer(std::vector<uint8_t>& b) noexcept
+            : buf(b) {}
+
+        void writeBytes(const void* const data, const std::size_t size)
+        {
+            const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+            buf.insert(buf.end(), bytes, bytes + size);
+        }
+
+        void writeU32(const uint32_t value) { writeBytes(&value, sizeof(value)); }
+        void writeU64(const uint64_t value) { writeBytes(&value, sizeof(value)); }
+        void writeFloat(const float value)  { writeBytes(&value, sizeof(value)); }
+
+        // size includes null terminator, 0 means null string
+        void writeString(const char* const str)
+        {
+            if (str == nullptr)
+                return writeU32(0);
+
+            const uint32_t size = static_cast<uint32_t>(std::strlen(str) + 1);
+            writeU32(size);
+            writeBytes(str, size);
+        }
+
+        void writeMidiMap(const LV2_RDF_PortMidiMap& midiMap)
+        {
+            writeU32(midiMap.Type);
+            writeU32(midiMap.Number);
+        }
+
+        void writePoints(const LV2_RDF_PortPoints& points)
+        {
+            writeU32(points.Hints);
+            writeFloat(points.Default);
+            writeFloat(points.Minimum);
+            writeFloat(points.Maximum);
+        }
+
+        void writeUnit(const LV2_RDF_PortUnit& unit)
+        {
+            writeU32(unit.Hints);
+            writeString(unit.Name);
+            writeString(unit.Render);
+            writeString(unit.Symbol);
+            writeU32(unit.Unit);
+        }
+
+        void writeFeatures(const uint32_t count, const LV2_RDF_Feature* const features)
+        {
+            writeU32(count);
+
+            for (uint32_t i=0; i < count; ++i)
+            {
+                writeU32(features[i].Required ? 1 : 0);
+                writeString(features[i].URI);
+            }
+        }
+
+        void writeExtensions(const uint32_t count, const LV2_URI* const extensions)
+        {
+            writeU32(count);
+
+            for (uint32_t i=0; i < count; ++i)
+                writeString(extensions[i]);
+        }
+
+        void writeDescriptor(const LV2_RDF_Descriptor& desc, const bool withPresets)
+        {
+            writeU32(desc.Type[0]);
+            writeU32(desc.Type[1]);
+            writeString(desc.URI);
+            writeString(desc.Name);
+            writeString(desc.Author);
+            writeString(desc.License);
+            writeString(desc.Binary);
+            writeString(desc.Bundle);
+            writeU64(desc.UniqueID);
+
+            writeU32(desc.PortCount);
+            for (uint32_t i=0; i < desc.PortCount; ++i)
+            {
+                const LV2_RDF_Port& port(desc.Ports[i]);
+                writeU32(port.Types);
+                writeU32(port.Properties);
+                writeU32(port.Designation);
+                writeString(port.Name);
+                writeString(port.Symbol);
+                writeString(port.Comment);
+                writeString(port.GroupURI);
+                writeMidiMap(port.MidiMap);
+                writePoints(port.Points);
+                writeUnit(port.Unit);
+                writeU32(port.MinimumSize);
+
+                writeU32(port.ScalePointCount);
+                for (uint32_t j=0; j < port.ScalePointCount; ++j)
+                {
+                    writeString(port.ScalePoints[j].Label);
+                    writeFloat(port.ScalePoints[j].Value);
+                }
+            }
+
+            writeU32(desc.ParameterCount);
+            for (uint32_t i=0; i < desc.ParameterCount; ++i)
+            {
+                const LV2_RDF_Parameter& param(desc.Parameters[i]);
+                writeString(param.URI);
+                writeU32(param.Type);
+                writeU32(param.Flags);
+                writeString(param.Label);
+                writeString(param.Comment);
+                writeString(param.GroupURI);
+                writeMidiMap(param.MidiMap);
+                writePoints(param.Points);
+                writeUnit(param.Unit);
+            }
+
+            // group URIs are shared with ports and parameters
+            writeU32(desc.PortGroupCount);
+            for (uint32_t i=0; i < desc.PortGroupCount; ++i)
+            {
+                writeString(desc.PortGroups[i].URI);
+                writeString(desc.PortGroups[i].Name);
+                writeString(desc.PortGroups[i].Symbol);
+            }
+
+            const uint32_t presetCount = withPresets ? desc.PresetCount : 0;
+            writeU32(presetCount);
+            for (uint32_t i=0; i < presetCount; ++i)
+            {
+                writeString(desc.Presets[i].URI);
+                writeString(desc.Presets[i].Label);
+            }
+
+            writeFeatures(desc.FeatureCount, desc.Features);
+            writeExtensions(desc.ExtensionCount, desc.Extensions);
+
+            writeU32(desc.UICount);
+            for (uint32_t i=0; i < desc.UICount; ++i)
+            {
+                const LV2_RDF_UI& ui(desc.UIs[i]);
+                writeU32(ui.Type);
+                writeString(ui.URI);
+                writeString(ui.Binary);
+                writeString(ui.Bundle);
+                writeFeatures(ui.FeatureCount, ui.Features);
+                writeExtensions(ui.ExtensionCount, ui.Extensions);
+
+                writeU32(ui.PortNotificationCount);
+                for (uint32_t j=0; j < ui.PortNotificationCount; ++j)
+                {
+                    writeString(ui.PortNotifications[j].Symbol);
+                    writeU32(ui.PortNotifications[j].Index);
+                    writeU32(ui.PortNotifications[j].Protocol);
+                }
+            }
+        }
+
+        void writePluginInfo(const Lv2CachedPluginInfo& info)
+        {
+            writeU32(info.valid ? 1 : 0);
+            writeU32(info.category);
+            writeU32(info.hints);
+            writeU32(info.audioIns);
+            writeU32(info.audioOuts);
+            writeU32(info.cvIns);
+            writeU32(info.cvOuts);
+            writeU32(info.midiIns);
+            writeU32(info.midiOuts);
+            writeU32(info.parameterIns);
+            writeU32(info.parameterOuts);
+            writeString(info.uri);
+            writeString(info.label);
+            writeString(info.name);
+            writeString(info.maker);
+            writeString(info.copyright);
+            writeString(info.binary);
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Writer)
+    };
+
+    struct Reader {
+        const uint8_t* const data;
+        const std::size_t size;
+        std::size_t pos;
+        bool ok;
+
+        Reader(const uint8_t* const d, const std::size_t s) noexcept
+            : data(d),
+              size(s),
+              pos(0),
+              ok(true) {}
+
+        bool readBytes(void* const dst, const std::size_t count) noexcept
+        {
+            if (! ok || pos + count > size)
+                return ok = false;
+
+            std::memcpy(dst, data + pos, count);
+            pos += count;
+            return true;
+        }
+
+        uint32_t readU32() noexcept
+        {
+            uint32_t value = 0;
+            readBytes(&value, sizeof(value));
+            return value;
+        }
+
+        uint64_t readU64() noexcept
+        {
+            uint64_t value = 0;
+            readBytes(&value, sizeof(value));
+            return value;
+        }
+
+        float readFloat() noexcept
+        {
+            float value = 0.0f;
+            readBytes(&value, sizeof(value));
+            return value;
+        }
+
+        const char* readString()
+        {
+            const uint32_t strSize = readU32();
+
+            if (strSize == 0 || ! ok)
+                return nullptr;
+
+            if (pos + strSize > size || data[pos + strSize - 1] != '\0')
+            {
+                ok = false;
+                return nullptr;
+            }
+
+            char* const str = new char[strSize];
+            std::memcpy(str, data + pos, strSize);
+            pos += strSize;
+            return str;
+        }
+
+        // guard against allocating huge arrays from corrupted data
+        uint32_t readCount() noexcept
+        {
+            const uint32_t count = readU32();
+
+            if (count > size - pos)
+            {
+                ok = false;
+                return 0;
+            }
+
+            return count;
+        }
+
+        void readMidiMap(LV2_RDF_PortMidiMap& midiMap) noexcept
+        {
+            midiMap.Type = readU32();
+            midiMap.Number = readU32();
+        }
+
+        void readPoints(LV2_RDF_PortPoints& points) noexcept
+        {
+            points.Hints = readU32();
+            points.Default = readFloat();
+            points.Minimum = readFloat();
+            points.Maximum = readFloat();
+        }
+
+        void readUnit(LV2_RDF_PortUnit& unit)
+        {
+            unit.Hints = readU32();
+            unit.Name = readString();
+            unit.Render = readString();
+            unit.Symbol = readString();
+            unit.Unit = readU32();
+        }
+
+        void readFeatures(uint32_t& count, LV2_RDF_Feature*& features)
+        {
+            if ((count = readCount()) == 0)
+                return;
+
+            features = new LV2_RDF_Feature[count];
+
+            for (uint32_t i=0; i < count; ++i)
+            {
+                features[i].Required = readU32() != 0;
+                features[i].URI = readString();
+            }
+        }
+
+        void readExtensions(uint32_t& count, LV2_URI*& extensions)
+        {
+            if ((count = readCount()) == 0)
+                return;
+
+            extensions = new LV2_URI[count];
+            carla_zeroPointers(extensions, count);
+
+            for (uint32_t i=0; i < count; ++i)
+                extensions[i] = readString();
+        }
+
+        // find the port or parameter string a group URI is shared with
+        static LV2_URI findSharedGroupURI(const LV2_RDF_Descriptor& desc, const char* const groupURI) noexcept
+        {
+            for (uint32_t i=0; i < desc.PortCount; ++i)
+                if (desc.Ports[i].GroupURI != nullptr && std::strcmp(desc.Ports[i].GroupURI, groupURI) == 0)
+                    return desc.Ports[i].GroupURI;
+
+            for (uint32_t i=0; i < desc.ParameterCount; ++i)
+                if (desc.Parameters[i].GroupURI != nullptr && std::strcmp(desc.Parameters[i].GroupURI, groupURI) == 0)
+                    return desc.Parameters[i].GroupURI;
+
+            return nullptr;
+        }
+
+        bool readDescriptor(LV2_RDF_Descriptor& desc, const bool withPresets)
+        {
+            desc.Type[0] = readU32();
+            desc.Type[1] = readU32();
+            desc.URI = readString();
+            desc.Name = readString();
+            desc.Author = readString();
+            desc.License = readString();
+            desc.Binary = readString();
+            desc.Bundle = readString();
+            desc.UniqueID = static_cast<ulong>(readU64());
+
+            if ((desc.PortCount = readCount()) != 0)
+            {
+                desc.Ports = new LV2_RDF_Port[desc.PortCount];
+
+                for (uint32_t i=0; i < desc.PortCount && ok; ++i)
+                {
+                    LV2_RDF_Port& port(desc.Ports[i]);
+                    port.Types = readU32();
+                    port.Properties = readU32();
+                    port.Designation = readU32();
+                    port.Name = readString();
+                    port.Symbol = readString();
+                    port.Comment = readString();
+                    port.GroupURI = readString();
+                    readMidiMap(port.MidiMap);
+                    readPoints(port.Points);
+                    readUnit(port.Unit);
+                    port.MinimumSize = readU32();
+
+                    if ((port.ScalePointCount = readCount()) != 0)
+                    {
+                        port.ScalePoints = new LV2_RDF_PortScalePoint[port.ScalePointCount];
+
+                        for (uint32_t j=0; j < port.ScalePointCount; ++j)
+                        {
+                            port.ScalePoints[j].Label = readString();
+                            port.ScalePoints[j].Value = readFloat();
+                        }
+                    }
+                }
+            }
+
+            if ((desc.ParameterCount = readCount()) != 0)
+            {
+                desc.Parameters = new LV2_RDF_Parameter[desc.ParameterCount];
+
+                for (uint32_t i=0; i < desc.ParameterCount && ok; ++i)
+                {
+                    LV2_RDF_Parameter& param(desc.Parameters[i]);
+                    param.URI = readString();
+                    param.Type = readU32();
+                    param.Flags = readU32();
+                    param.Label = readString();
+                    param.Comment = readString();
+                    param.GroupURI = readString();
+                    readMidiMap(param.MidiMap);
+                    readPoints(param.Points);
+                    readUnit(param.Unit);
+                }
+            }
+
+            if (const uint32_t portGroupCount = readCount())
+            {
+                desc.PortGroups = new LV2_RDF_PortGroup[portGroupCount];
+
+                for (uint32_t i=0; i < portGroupCount && ok; ++i)
+                {
+                    const char* const groupURI = readString();
+                    LV2_RDF_PortGroup& portGroup(desc.PortGroups[desc.PortGroupCount]);
+
+                    portGroup.Name = readString();
+                    portGroup.Symbol = readString();
+
+                    // group URIs are never deallocated by the descriptor
+                    if (groupURI != nullptr)
+                        portGroup.URI = findSharedGroupURI(desc, groupURI);
+
+                    delete[] groupURI;
+
+                    if (portGroup.URI != nullptr)
+                        ++desc.PortGroupCount;
+                }
+            }
+
+            if (const uint32_t presetCount = readCount())
+            {
+                if (withPresets)
+                {
+                    desc.Presets = new LV2_RDF_Preset[presetCount];
+                    desc.PresetCount = presetCount;
+                }
+
+                for (uint32_t i=0; i < presetCount && ok; ++i)
+                {
+                    const char* const presetURI = readString();
+                    const char* const presetLabel = readString();
+
+                    if (withPresets)
+                    {
+                        desc.Presets[i].URI = presetURI;
+                        desc.Presets[i].Label = presetLabel;
+                    }
+                    else
+                    {
+                        delete[] presetURI;
+                        delete[] presetLabel;
+                    }
+                }
+            }
+
+            readFeatures(desc.FeatureCount, desc.Features);
+            readExtensions(desc.ExtensionCount, desc.Extensions);
+
+            if ((desc.UICount = readCount()) != 0)
+            {
+                desc.UIs = new LV2_RDF_UI[desc.UICount];
+
+                for (uint32_t i=0; i < desc.UICount && ok; ++i)
+                {
+                    LV2_RDF_UI& ui(desc.UIs[i]);
+                    ui.Type = readU32();
+                    ui.URI = readString();
+                    ui.Binary = readString();
+                    ui.Bundle = readString();
+                    readFeatures(ui.FeatureCount, ui.Features);
+                    readExtensions(ui.ExtensionCount, ui.Extensions);
+
+                    if ((ui.PortNotificationCount = readCount()) != 0)
+                    {
+                        ui.PortNotifications = new LV2_RDF_UI_PortNotification[ui.PortNotificationCount];
+
+                        for (uint32_t j=0; j < ui.PortNotificationCount; ++j)
+                        {
+                            ui.PortNotifications[j].Symbol = readString();
+                            ui.PortNotifications[j].Index = readU32();
+                            ui.PortNotifications[j].Protocol = readU32();
+                        }
+                    }
+                }
+            }
+
+            return ok && desc.URI != nullptr && desc.Binary != nullptr && desc.Bundle != nullptr;
+        }
+
+        void readString(CarlaString& str)
+        {
+            if (const char* const value = readString())
+            {
+                str = value;
+                delete[] value;
+            }
+            else
+            {
+                str.clear();
+            }
+        }
+
+        void readPluginInfo(Lv2CachedPluginInfo& info)
+        {
+            info.valid = readU32() != 0;
+            info.category = readU32();
+            info.hints = readU32();
+            info.audioIns = readU32();
+            info.audioOuts = readU32();
+            info.cvIns = readU32();
+            info.cvOuts = readU32();
+            info.midiIns = readU32();
+            info.midiOuts = readU32();
+            info.parameterIns = readU32();
+            info.parameterOuts = readU32();
+            readString(info.uri);
+            readString(info.label);
+            readString(info.name);
+            readString(info.maker);
+            readString(info.copyright);
+            readString(info.binary);
+        }
+
+        CARLA_DECLARE_NON_COPY_STRUCT(Reader)
+    };
+
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2RdfCache)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
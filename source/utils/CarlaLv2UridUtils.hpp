@@ -0,0 +1,240 @@
+/*
+ * Carla LV2 URID utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_LV2_URID_UTILS_HPP_INCLUDED
+#define CARLA_LV2_URID_UTILS_HPP_INCLUDED
+
+#include "CarlaHashUtils.hpp"
+#include "CarlaMutex.hpp"
+
+#include "lv2/urid.h"
+
+// -----------------------------------------------------------------------
+// Shared URID registry
+
+/*
+   Maps URIs to URIDs, shared between all plugin instances.
+   URIDs are consecutive numbers starting at 1, and never go away.
+
+   Looking up an existing URI or URID never locks and never allocates,
+   only mapping a new URI takes a lock (and memory).
+
+   URI records live in fixed-size chunks so their addresses never change.
+   The hash table uses open-addressing with linear probing, new entries only ever fill empty slots.
+   When it gets too full a bigger table replaces it, old tables are kept until the registry is destroyed.
+   A reader might miss an entry added meanwhile, which map() then finds again under the lock.
+*/
+
+class Lv2UridRegistry
+{
+public:
+    Lv2UridRegistry() noexcept
+        : fChunks(),
+          fCount(1),
+          fTable(nullptr),
+          fMutex()
+    {
+        fTable = _createTable(kInitialTableSize, nullptr);
+        CARLA_SAFE_ASSERT(fTable != nullptr);
+    }
+
+    ~Lv2UridRegistry() noexcept
+    {
+        for (Table* table = fTable, *prev; table != nullptr; table = prev)
+        {
+            prev = table->prev;
+            std::free(table);
+        }
+
+        for (uint32_t i=0; i<kMaxChunks; ++i)
+        {
+            Record* const chunk = fChunks[i];
+
+            if (chunk == nullptr)
+                break;
+
+            for (uint32_t j=0; j<kChunkSize; ++j)
+                delete[] chunk[j].uri;
+
+            std::free(chunk);
+        }
+    }
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Get the URID for an URI, creating a new one if needed.
+     * Returns 0 on failure.
+     */
+    LV2_URID map(const char* const uri) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', 0);
+
+        const uint32_t hash = carla_fnv1a_32_str(uri);
+
+        if (const LV2_URID urid = _lookup(uri, hash))
+            return urid;
+
+        const CarlaMutexLocker cml(fMutex);
+
+        // check again, might have been added while we waited for the lock
+        if (const LV2_URID urid = _lookup(uri, hash))
+            return urid;
+
+        CARLA_SAFE_ASSERT_RETURN(fTable != nullptr, 0);
+
+        const LV2_URID urid = fCount;
+        const uint32_t chunkIndex = urid / kChunkSize;
+        CARLA_SAFE_ASSERT_RETURN(chunkIndex < kMaxChunks, 0);
+
+        if (fChunks[chunkIndex] == nullptr)
+        {
+            Record* const chunk = static_cast<Record*>(std::calloc(kChunkSize, sizeof(Record)));
+            CARLA_SAFE_ASSERT_RETURN(chunk != nullptr, 0);
+
+            fChunks[chunkIndex] = chunk;
+        }
+
+        Record& record(fChunks[chunkIndex][urid % kChunkSize]);
+        record.uri  = carla_strdup_safe(uri);
+        record.hash = hash;
+        CARLA_SAFE_ASSERT_RETURN(record.uri != nullptr, 0);
+
+        // record must be complete before anyone can reach it
+        __sync_synchronize();
+        fCount = urid + 1;
+
+        // keep load factor under 50%
+        if (fCount * 2 > fTable->size)
+        {
+            if (Table* const table = _createTable(fTable->size * 2, fTable))
+            {
+                __sync_synchronize();
+                fTable = table;
+                return urid;
+            }
+        }
+
+        _insert(fTable, urid, hash);
+        return urid;
+    }
+
+    /*
+     * Get the URI for an URID.
+     * Returns null if the URID is not mapped.
+     */
+    const char* unmap(const LV2_URID urid) const noexcept
+    {
+        if (urid == 0 || urid >= fCount)
+            return nullptr;
+
+        return fChunks[urid / kChunkSize][urid % kChunkSize].uri;
+    }
+
+    /*
+     * Get the number of URIDs, including the invalid 0 one.
+     * All URIDs below this number are valid.
+     */
+    uint32_t getCount() const noexcept
+    {
+        return fCount;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    struct Record {
+        uint32_t hash;
+        const char* uri;
+    };
+
+    struct Table {
+        uint32_t size; // power of 2
+        Table* prev;
+        volatile LV2_URID slots[1];
+    };
+
+    enum {
+        kChunkSize        = 512,
+        kMaxChunks        = 512,
+        kInitialTableSize = 1024
+    };
+
+    Record* fChunks[kMaxChunks];
+    volatile uint32_t fCount;
+
+    Table* volatile fTable;
+
+    CarlaMutex fMutex;
+
+    // -------------------------------------------------------------------
+
+    LV2_URID _lookup(const char* const uri, const uint32_t hash) const noexcept
+    {
+        const Table* const table = fTable;
+
+        if (table == nullptr)
+            return 0;
+
+        const uint32_t mask = table->size - 1;
+
+        for (uint32_t i = hash & mask;; i = (i + 1) & mask)
+        {
+            const LV2_URID urid = table->slots[i];
+
+            if (urid == 0)
+                return 0;
+
+            const Record& record(fChunks[urid / kChunkSize][urid % kChunkSize]);
+
+            if (record.hash == hash && std::strcmp(record.uri, uri) == 0)
+                return urid;
+        }
+    }
+
+    void _insert(Table* const table, const LV2_URID urid, const uint32_t hash) const noexcept
+    {
+        const uint32_t mask = table->size - 1;
+        uint32_t i = hash & mask;
+
+        for (; table->slots[i] != 0; i = (i + 1) & mask) {}
+
+        table->slots[i] = urid;
+    }
+
+    // creates a new table with all current URIDs
+    Table* _createTable(const uint32_t size, Table* const prev) const noexcept
+    {
+        Table* const table = static_cast<Table*>(std::calloc(1, sizeof(Table) + sizeof(LV2_URID) * (size - 1)));
+        CARLA_SAFE_ASSERT_RETURN(table != nullptr, nullptr);
+
+        table->size = size;
+        table->prev = prev;
+
+        for (LV2_URID urid = 1; urid < fCount; ++urid)
+            _insert(table, urid, fChunks[urid / kChunkSize][urid % kChunkSize].hash);
+
+        return table;
+    }
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPY_CLASS(Lv2UridRegistry)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_LV2_URID_UTILS_HPP_INCLUDED
@@ -262,6 +262,23 @@ float carla_findMaxNormalizedFloat(const float floats[], const std::size_t count
     return maxf2;
 }
 
+/*
+ * Check if a float array is silent, that is, all its values are below -120dB.
+ */
+static inline
+bool carla_isSilentFloats(const float floats[], const std::size_t count) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(floats != nullptr, true);
+
+    for (std::size_t i=0; i<count; ++i)
+    {
+        if (std::abs(floats[i]) > 1e-6f)
+            return false;
+    }
+
+    return true;
+}
+
 /*
  * Multiply an array with a fixed value, float-specific version.
  */
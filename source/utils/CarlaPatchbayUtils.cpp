@@ -17,21 +17,85 @@
 
 #include "CarlaPatchbayUtils.hpp"
 
-static const GroupNameToId kGroupNameToIdFallback = { 0, { '\0' } };
-static const PortNameToId  kPortNameToIdFallback  = { 0, 0, { '\0' }, { '\0' } };
+static const GroupNameToId  kGroupNameToIdFallback  = { 0, { '\0' } };
+static /* */ GroupNameToId  kGroupNameToIdFallbackNC = { 0, { '\0' } };
+static const PortNameToId   kPortNameToIdFallback   = { 0, 0, { '\0' }, { '\0' } };
+static /* */ PortNameToId   kPortNameToIdFallbackNC = { 0, 0, { '\0' }, { '\0' } };
+static const ConnectionToId kConnectionToIdFallback = { 0, 0, 0, 0, 0 };
+static /* */ ConnectionToId kConnectionToIdFallbackNC = { 0, 0, 0, 0, 0 };
+
+// -----------------------------------------------------------------------
+
+static inline
+uint64_t getPortKey(const uint groupId, const uint portId) noexcept
+{
+    return static_cast<uint64_t>(groupId) << 32 | portId;
+}
+
+static inline
+PatchbayConnectionPorts getConnectionPorts(const ConnectionToId& connectionToId) noexcept
+{
+    const PatchbayConnectionPorts ports = {
+        connectionToId.groupA, connectionToId.portA,
+        connectionToId.groupB, connectionToId.portB
+    };
+    return ports;
+}
+
+// -----------------------------------------------------------------------
+
+bool PatchbayGroupList::add(const GroupNameToId& groupNameToId) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(groupNameToId.group != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(list.append(groupNameToId), false);
+
+    GroupNameToId& entry(list.getLast(kGroupNameToIdFallbackNC));
+
+    bool indexed = false;
+
+    try {
+        byId.set(entry.group, &entry);
+        byName.set(water::String(entry.name), &entry);
+        indexed = true;
+    } CARLA_SAFE_EXCEPTION("PatchbayGroupList::add");
+
+    if (indexed)
+        return true;
+
+    byId.removeValue(&entry);
+    byName.removeValue(&entry);
+    list.removeRef(entry);
+    return false;
+}
+
+bool PatchbayGroupList::remove(const uint groupId) noexcept
+{
+    GroupNameToId* const entry(byId[groupId]);
+
+    if (entry == nullptr)
+        return false;
+
+    byId.remove(groupId);
+
+    try {
+        const water::String name(entry->name);
+
+        if (byName[name] == entry)
+            byName.remove(name);
+    } CARLA_SAFE_EXCEPTION("PatchbayGroupList::remove");
+
+    list.removeRef(*entry);
+    return true;
+}
 
 uint PatchbayGroupList::getGroupId(const char* const groupName) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(groupName != nullptr && groupName[0] != '\0', 0);
 
-    for (LinkedList<GroupNameToId>::Itenerator it = list.begin2(); it.valid(); it.next())
-    {
-        const GroupNameToId& groupNameToId(it.getValue(kGroupNameToIdFallback));
-        CARLA_SAFE_ASSERT_CONTINUE(groupNameToId.group != 0);
-
-        if (std::strncmp(groupNameToId.name, groupName, STR_MAX) == 0)
-            return groupNameToId.group;
-    }
+    try {
+        if (const GroupNameToId* const entry = byName[water::String(groupName)])
+            return entry->group;
+    } CARLA_SAFE_EXCEPTION("PatchbayGroupList::getGroupId");
 
     return 0;
 }
@@ -40,30 +104,108 @@ const char* PatchbayGroupList::getGroupName(const uint groupId) const noexcept
 {
     static const char fallback[] = { '\0' };
 
-    for (LinkedList<GroupNameToId>::Itenerator it = list.begin2(); it.valid(); it.next())
-    {
-        const GroupNameToId& groupNameToId(it.getValue(kGroupNameToIdFallback));
-        CARLA_SAFE_ASSERT_CONTINUE(groupNameToId.group != 0);
-
-        if (groupNameToId.group == groupId)
-            return groupNameToId.name;
-    }
+    if (const GroupNameToId* const entry = byId[groupId])
+        return entry->name;
 
     return fallback;
 }
 
-const char* PatchbayPortList::getFullPortName(const uint groupId, const uint portId) const noexcept
+// -----------------------------------------------------------------------
+
+bool PatchbayPortList::add(const PortNameToId& portNameToId) noexcept
 {
-    static const char fallback[] = { '\0' };
+    CARLA_SAFE_ASSERT_RETURN(portNameToId.group != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(list.append(portNameToId), false);
+
+    PortNameToId& entry(list.getLast(kPortNameToIdFallbackNC));
+
+    bool indexed = false;
+
+    try {
+        byId.set(getPortKey(entry.group, entry.port), &entry);
+        byFullName.set(water::String(entry.fullName), &entry);
+        indexed = true;
+    } CARLA_SAFE_EXCEPTION("PatchbayPortList::add");
+
+    if (indexed)
+        return true;
+
+    byId.removeValue(&entry);
+    byFullName.removeValue(&entry);
+    list.removeRef(entry);
+    return false;
+}
+
+void PatchbayPortList::_remove(PortNameToId* const entry) noexcept
+{
+    const uint64_t key = getPortKey(entry->group, entry->port);
+
+    if (byId[key] == entry)
+        byId.remove(key);
+
+    try {
+        const water::String fullName(entry->fullName);
+
+        if (byFullName[fullName] == entry)
+            byFullName.remove(fullName);
+    } CARLA_SAFE_EXCEPTION("PatchbayPortList::remove");
+
+    list.removeRef(*entry);
+}
+
+bool PatchbayPortList::remove(const uint groupId, const uint portId) noexcept
+{
+    PortNameToId* const entry(byId[getPortKey(groupId, portId)]);
+
+    if (entry == nullptr)
+        return false;
+
+    _remove(entry);
+    return true;
+}
+
+bool PatchbayPortList::rename(const char* const oldFullPortName, const char* const newName, const char* const newFullName) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(oldFullPortName != nullptr && oldFullPortName[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(newName != nullptr && newName[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(newFullName != nullptr && newFullName[0] != '\0', false);
 
+    try {
+        const water::String oldFullName(oldFullPortName);
+        PortNameToId* const entry(byFullName[oldFullName]);
+
+        if (entry == nullptr)
+            return false;
+
+        byFullName.remove(oldFullName);
+        entry->rename(newName, newFullName);
+        byFullName.set(water::String(entry->fullName), entry);
+        return true;
+    } CARLA_SAFE_EXCEPTION_RETURN("PatchbayPortList::rename", false);
+}
+
+void PatchbayPortList::removeGroup(const uint groupId, LinkedList<PortNameToId>* const removed) noexcept
+{
     for (LinkedList<PortNameToId>::Itenerator it = list.begin2(); it.valid(); it.next())
     {
-        const PortNameToId& portNameToId(it.getValue(kPortNameToIdFallback));
-        CARLA_SAFE_ASSERT_CONTINUE(portNameToId.group != 0);
+        PortNameToId& entry(it.getValue(kPortNameToIdFallbackNC));
+
+        if (entry.group != groupId)
+            continue;
+
+        if (removed != nullptr)
+            removed->append(entry);
 
-        if (portNameToId.group == groupId && portNameToId.port == portId)
-            return portNameToId.fullName;
+        _remove(&entry);
     }
+}
+
+const char* PatchbayPortList::getFullPortName(const uint groupId, const uint portId) const noexcept
+{
+    static const char fallback[] = { '\0' };
+
+    if (const PortNameToId* const entry = byId[getPortKey(groupId, portId)])
+        return entry->fullName;
 
     return fallback;
 }
@@ -72,14 +214,97 @@ const PortNameToId& PatchbayPortList::getPortNameToId(const char* const fullPort
 {
     CARLA_SAFE_ASSERT_RETURN(fullPortName != nullptr && fullPortName[0] != '\0', kPortNameToIdFallback);
 
-    for (LinkedList<PortNameToId>::Itenerator it = list.begin2(); it.valid(); it.next())
+    try {
+        if (const PortNameToId* const entry = byFullName[water::String(fullPortName)])
+            return *entry;
+    } CARLA_SAFE_EXCEPTION("PatchbayPortList::getPortNameToId");
+
+    return kPortNameToIdFallback;
+}
+
+// -----------------------------------------------------------------------
+
+bool PatchbayConnectionList::add(const ConnectionToId& connectionToId) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(connectionToId.id != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(list.append(connectionToId), false);
+
+    ConnectionToId& entry(list.getLast(kConnectionToIdFallbackNC));
+
+    bool indexed = false;
+
+    try {
+        byId.set(entry.id, &entry);
+        byPorts.set(getConnectionPorts(entry), &entry);
+        indexed = true;
+    } CARLA_SAFE_EXCEPTION("PatchbayConnectionList::add");
+
+    if (indexed)
+        return true;
+
+    byId.removeValue(&entry);
+    byPorts.removeValue(&entry);
+    list.removeRef(entry);
+    return false;
+}
+
+void PatchbayConnectionList::_remove(ConnectionToId* const entry) noexcept
+{
+    const PatchbayConnectionPorts ports(getConnectionPorts(*entry));
+
+    if (byId[entry->id] == entry)
+        byId.remove(entry->id);
+
+    if (byPorts[ports] == entry)
+        byPorts.remove(ports);
+
+    list.removeRef(*entry);
+}
+
+bool PatchbayConnectionList::remove(const uint connectionId) noexcept
+{
+    ConnectionToId* const entry(byId[connectionId]);
+
+    if (entry == nullptr)
+        return false;
+
+    _remove(entry);
+    return true;
+}
+
+void PatchbayConnectionList::removeGroup(const uint groupId, LinkedList<ConnectionToId>* const removed) noexcept
+{
+    for (LinkedList<ConnectionToId>::Itenerator it = list.begin2(); it.valid(); it.next())
     {
-        const PortNameToId& portNameToId(it.getValue(kPortNameToIdFallback));
-        CARLA_SAFE_ASSERT_CONTINUE(portNameToId.group != 0);
+        ConnectionToId& entry(it.getValue(kConnectionToIdFallbackNC));
+
+        if (entry.groupA != groupId && entry.groupB != groupId)
+            continue;
 
-        if (std::strncmp(portNameToId.fullName, fullPortName, STR_MAX) == 0)
-            return portNameToId;
+        if (removed != nullptr)
+            removed->append(entry);
+
+        _remove(&entry);
     }
+}
 
-    return kPortNameToIdFallback;
-}
\ No newline at end of file
+const ConnectionToId& PatchbayConnectionList::getConnection(const uint connectionId) const noexcept
+{
+    if (const ConnectionToId* const entry = byId[connectionId])
+        return *entry;
+
+    return kConnectionToIdFallback;
+}
+
+uint PatchbayConnectionList::getConnectionId(const uint groupA, const uint portA,
+                                             const uint groupB, const uint portB) const noexcept
+{
+    const PatchbayConnectionPorts ports = { groupA, portA, groupB, portB };
+
+    if (const ConnectionToId* const entry = byPorts[ports])
+        return entry->id;
+
+    return 0;
+}
+
+// -----------------------------------------------------------------------
@@ -18,11 +18,50 @@
 #ifndef CARLA_PATCHBAY_UTILS_HPP_INCLUDED
 #define CARLA_PATCHBAY_UTILS_HPP_INCLUDED
 
+#include "CarlaHashUtils.hpp"
 #include "CarlaMutex.hpp"
 #include "LinkedList.hpp"
 
+#include "water/text/String.h"
+#include "water/containers/HashMap.h"
+
 #define STR_MAX 0xFF
 
+// -----------------------------------------------------------------------
+// Hash map keys and functions for patchbay names and ids
+
+struct PatchbayConnectionPorts {
+    uint groupA, portA;
+    uint groupB, portB;
+
+    bool operator==(const PatchbayConnectionPorts& ports) const noexcept
+    {
+        return ports.groupA == groupA && ports.portA == portA && ports.groupB == groupB && ports.portB == portB;
+    }
+};
+
+struct PatchbayHashFunctions {
+    int generateHash(const uint key, const int upperLimit) const noexcept
+    {
+        return static_cast<int>(carla_fnv1a_32(&key, sizeof(key)) % static_cast<uint32_t>(upperLimit));
+    }
+
+    int generateHash(const uint64_t key, const int upperLimit) const noexcept
+    {
+        return static_cast<int>(carla_fnv1a_32(&key, sizeof(key)) % static_cast<uint32_t>(upperLimit));
+    }
+
+    int generateHash(const water::String& key, const int upperLimit) const noexcept
+    {
+        return static_cast<int>(carla_fnv1a_32_str(key.toRawUTF8()) % static_cast<uint32_t>(upperLimit));
+    }
+
+    int generateHash(const PatchbayConnectionPorts& key, const int upperLimit) const noexcept
+    {
+        return static_cast<int>(carla_fnv1a_32(&key, sizeof(key)) % static_cast<uint32_t>(upperLimit));
+    }
+};
+
 // -----------------------------------------------------------------------
 
 struct GroupNameToId {
@@ -64,24 +103,37 @@ struct GroupNameToId {
 
 struct PatchbayGroupList {
     uint lastId;
-    LinkedList<GroupNameToId> list;
+    LinkedList<GroupNameToId> list; // do not modify directly, use the functions below
     CarlaMutex mutex;
 
     PatchbayGroupList() noexcept
         : lastId(0),
           list(),
-          mutex() {}
+          mutex(),
+          byId(),
+          byName() {}
 
     void clear() noexcept
     {
         lastId = 0;
+        byId.clear();
+        byName.clear();
         list.clear();
     }
 
+    bool add(const GroupNameToId& groupNameToId) noexcept;
+    bool remove(const uint groupId) noexcept;
+
     uint getGroupId(const char* const groupName) const noexcept;
 
     // always returns valid pointer (non-null)
     const char* getGroupName(const uint groupId) const noexcept;
+
+private:
+    water::HashMap<uint, GroupNameToId*, PatchbayHashFunctions> byId;
+    water::HashMap<water::String, GroupNameToId*, PatchbayHashFunctions> byName;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(PatchbayGroupList)
 };
 
 // -----------------------------------------------------------------------
@@ -141,24 +193,43 @@ struct PortNameToId {
 
 struct PatchbayPortList {
     uint lastId;
-    LinkedList<PortNameToId> list;
+    LinkedList<PortNameToId> list; // do not modify directly, use the functions below
     CarlaMutex mutex;
 
     PatchbayPortList() noexcept
         : lastId(0),
           list(),
-          mutex() {}
+          mutex(),
+          byId(),
+          byFullName() {}
 
     void clear() noexcept
     {
         lastId = 0;
+        byId.clear();
+        byFullName.clear();
         list.clear();
     }
 
+    bool add(const PortNameToId& portNameToId) noexcept;
+    bool remove(const uint groupId, const uint portId) noexcept;
+    bool rename(const char* const oldFullPortName, const char* const newName, const char* const newFullName) noexcept;
+
+    // removes all ports of a group, optionally keeping a copy of them in 'removed'
+    void removeGroup(const uint groupId, LinkedList<PortNameToId>* const removed) noexcept;
+
     // always returns valid pointer (non-null)
     const char* getFullPortName(const uint groupId, const uint portId) const noexcept;
 
     const PortNameToId& getPortNameToId(const char* const fullPortName) const noexcept;
+
+private:
+    void _remove(PortNameToId* const entry) noexcept;
+
+    water::HashMap<uint64_t, PortNameToId*, PatchbayHashFunctions> byId; // group << 32 | port
+    water::HashMap<water::String, PortNameToId*, PatchbayHashFunctions> byFullName;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(PatchbayPortList)
 };
 
 // -----------------------------------------------------------------------
@@ -209,19 +280,43 @@ struct ConnectionToId {
 
 struct PatchbayConnectionList {
     uint lastId;
-    LinkedList<ConnectionToId> list;
+    LinkedList<ConnectionToId> list; // do not modify directly, use the functions below
     CarlaMutex mutex;
 
     PatchbayConnectionList() noexcept
         : lastId(0),
           list(),
-          mutex() {}
+          mutex(),
+          byId(),
+          byPorts() {}
 
     void clear() noexcept
     {
         lastId = 0;
+        byId.clear();
+        byPorts.clear();
         list.clear();
     }
+
+    bool add(const ConnectionToId& connectionToId) noexcept;
+    bool remove(const uint connectionId) noexcept;
+
+    // removes all connections to or from a group, optionally keeping a copy of them in 'removed'
+    void removeGroup(const uint groupId, LinkedList<ConnectionToId>* const removed) noexcept;
+
+    // returns a connection with id 0 if not found
+    const ConnectionToId& getConnection(const uint connectionId) const noexcept;
+
+    // returns 0 if not found
+    uint getConnectionId(const uint groupA, const uint portA, const uint groupB, const uint portB) const noexcept;
+
+private:
+    void _remove(ConnectionToId* const entry) noexcept;
+
+    water::HashMap<uint, ConnectionToId*, PatchbayHashFunctions> byId;
+    water::HashMap<PatchbayConnectionPorts, ConnectionToId*, PatchbayHashFunctions> byPorts;
+
+    CARLA_DECLARE_NON_COPY_STRUCT(PatchbayConnectionList)
 };
 
 // -----------------------------------------------------------------------
@@ -15,6 +15,7 @@
  * For a full copy of the GNU General Public License see the doc/GPL.txt file.
  */
 
+#include "CarlaBase64Utils.hpp"
 #include "CarlaPipeUtils.hpp"
 #include "CarlaProcessUtils.hpp"
 #include "CarlaString.hpp"
@@ -1148,11 +1149,21 @@ bool CarlaPipeCommon::writeLv2AtomMessage(const uint32_t index, const LV2_Atom*
 {
     CARLA_SAFE_ASSERT_RETURN(atom != nullptr, false);
 
+    // base64 data never contains newlines, so it can go straight into the pipe
+    struct Base64Writer {
+        const CarlaPipeCommon& pipe;
+
+        bool operator()(const char* const buf, const std::size_t size) const noexcept
+        {
+            return pipe._writeMsgBuffer(buf, size);
+        }
+    } base64Writer = { *this };
+
     char tmpBuf[0xff];
     tmpBuf[0xfe] = '\0';
 
     const uint32_t atomTotalSize(lv2_atom_total_size(atom));
-    CarlaString base64atom(CarlaString::asBase64(atom, atomTotalSize));
+    const std::size_t base64Size(carla_base64EncodedSize(atomTotalSize));
 
     const CarlaMutexLocker cml(pData->writeLock);
 
@@ -1167,11 +1178,14 @@ bool CarlaPipeCommon::writeLv2AtomMessage(const uint32_t index, const LV2_Atom*
     if (! _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
         return false;
 
-    std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(base64atom.length()));
+    std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(base64Size));
     if (! _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
         return false;
 
-    if (! writeAndFixMessage(base64atom.buffer()))
+    if (! carla_base64EncodeStream(atom, atomTotalSize, base64Writer))
+        return false;
+
+    if (! _writeMsgBuffer("\n", 1))
         return false;
 
     flushMessages();
@@ -1235,6 +1249,46 @@ bool CarlaPipeCommon::writeLv2UridMessage(const uint32_t urid, const char* const
     return true;
 }
 
+bool CarlaPipeCommon::writeLv2UridsMessage(const uint32_t firstUrid, const uint32_t count, const char* const* const uris,
+                                           const bool withWriteLock) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(firstUrid != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(count != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(uris != nullptr, false);
+
+    if (withWriteLock)
+    {
+        const CarlaMutexLocker cml(pData->writeLock);
+        return writeLv2UridsMessage(firstUrid, count, uris, false);
+    }
+
+    char tmpBuf[0xff];
+    tmpBuf[0xfe] = '\0';
+
+    if (! _writeMsgBuffer("urids\n", 6))
+        return false;
+
+    std::snprintf(tmpBuf, 0xfe, "%u\n%u\n", firstUrid, count);
+    if (! _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
+        return false;
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        const char* const uri = uris[i];
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', false);
+
+        std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(std::strlen(uri)));
+        if (! _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
+            return false;
+
+        if (! writeAndFixMessage(uri))
+            return false;
+    }
+
+    flushMessages();
+    return true;
+}
+
 // -------------------------------------------------------------------
 
 // internal
@@ -232,6 +232,12 @@ public:
      */
     bool writeLv2UridMessage(uint32_t urid, const char* uri) const noexcept;
 
+    /*!
+     * Write an lv2 "urids" message, with @a count consecutive URIDs starting at @a firstUrid.
+     */
+    bool writeLv2UridsMessage(uint32_t firstUrid, uint32_t count, const char* const* uris,
+                              bool withWriteLock = true) const noexcept;
+
     // -------------------------------------------------------------------
 
 protected:
@@ -0,0 +1,262 @@
+/*
+ * Carla lock-free real-time memory pool
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_RT_MEM_POOL_HPP_INCLUDED
+#define CARLA_RT_MEM_POOL_HPP_INCLUDED
+
+#include "CarlaMutex.hpp"
+
+// -----------------------------------------------------------------------
+// Fixed-size block allocator, lock-free on the real-time side
+
+/*
+   Memory is preallocated in slabs of equally sized blocks.
+   Every block keeps a small header with its own index and the index of the next free block,
+   free blocks form a single lock-free stack (tagged head index, to avoid ABA issues).
+
+   allocate_atomic() and deallocate() never lock nor allocate, and can be called from any thread.
+   allocate_sleepy() is the only call that may grow the pool (by adding a new slab),
+   so it must never be used in the audio thread.
+
+   Slabs are only released when the pool is destroyed.
+*/
+
+class CarlaRtMemPool
+{
+public:
+    CarlaRtMemPool(const std::size_t dataSize, const std::size_t minPreallocated, const std::size_t maxPreallocated) noexcept
+        : kBlockSize(kHeaderSize + ((dataSize + kHeaderSize - 1) / kHeaderSize) * kHeaderSize),
+          kSlabCount(static_cast<uint32_t>(minPreallocated > kMinSlabCount ? minPreallocated : static_cast<std::size_t>(kMinSlabCount))),
+          fSlabs(),
+          fNumSlabs(0),
+          fFreeHead(0),
+          fUsed(0),
+          fHighWatermark(0),
+          fGrowMutex()
+    {
+        CARLA_SAFE_ASSERT_RETURN(dataSize > 0,);
+
+        // slabs hold minPreallocated blocks each, keep at least maxPreallocated ready for the audio thread
+        for (std::size_t count = 0; count < maxPreallocated || count == 0; count += kSlabCount)
+        {
+            if (! _grow())
+                break;
+        }
+    }
+
+    ~CarlaRtMemPool() noexcept
+    {
+        CARLA_SAFE_ASSERT_UINT(fUsed == 0, fUsed);
+
+        for (uint32_t i=0; i<fNumSlabs; ++i)
+        {
+            std::free(fSlabs[i]);
+            fSlabs[i] = nullptr;
+        }
+
+        fNumSlabs = 0;
+        fFreeHead = 0;
+    }
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Get a block from the preallocated memory.
+     * Real-time safe, returns null if the pool is exhausted.
+     */
+    void* allocate_atomic() noexcept
+    {
+        for (;;)
+        {
+            const uint64_t head  = fFreeHead;
+            const uint32_t index = static_cast<uint32_t>(head & 0xffffffff);
+
+            if (index == 0)
+                return nullptr;
+
+            BlockHeader* const header = _getHeader(index - 1);
+
+            // may be stale if another thread got to it first, the tag check below takes care of that
+            const uint64_t next = header != nullptr ? header->next : 0;
+
+            if (__sync_bool_compare_and_swap(&fFreeHead, head, _nextTag(head) | next))
+            {
+                CARLA_SAFE_ASSERT_RETURN(header != nullptr, nullptr);
+
+                const uint32_t used = __sync_add_and_fetch(&fUsed, 1);
+
+                for (uint32_t high = fHighWatermark; used > high; high = fHighWatermark)
+                {
+                    if (__sync_bool_compare_and_swap(&fHighWatermark, high, used))
+                        break;
+                }
+
+                return reinterpret_cast<uint8_t*>(header) + kHeaderSize;
+            }
+        }
+    }
+
+    /*
+     * Get a block from the preallocated memory, adding a new slab if needed.
+     * NOT real-time safe.
+     */
+    void* allocate_sleepy() noexcept
+    {
+        for (;;)
+        {
+            if (void* const data = allocate_atomic())
+                return data;
+
+            const CarlaMutexLocker cml(fGrowMutex);
+
+            // someone else might have grown the pool meanwhile
+            if ((fFreeHead & 0xffffffff) != 0)
+                continue;
+
+            if (! _grow())
+                return nullptr;
+        }
+    }
+
+    /*
+     * Give a block back to the pool.
+     * Real-time safe.
+     */
+    void deallocate(void* const dataPtr) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(dataPtr != nullptr,);
+
+        BlockHeader* const header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(dataPtr) - kHeaderSize);
+        CARLA_SAFE_ASSERT_RETURN(_getHeader(header->index) == header,);
+
+        _push(header, header->index + 1);
+
+        __sync_sub_and_fetch(&fUsed, 1);
+    }
+
+    // -------------------------------------------------------------------
+    // statistics
+
+    uint32_t getUsedCount() const noexcept
+    {
+        return fUsed;
+    }
+
+    uint32_t getHighWatermark() const noexcept
+    {
+        return fHighWatermark;
+    }
+
+    uint32_t getCapacity() const noexcept
+    {
+        return fNumSlabs * kSlabCount;
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    struct BlockHeader {
+        uint32_t index;
+        uint32_t next; // index+1 of the next free block, 0 for none
+    };
+
+    enum {
+        kHeaderSize   = 16, // keeps data aligned for any type
+        kMinSlabCount = 16,
+        kMaxSlabs     = 64
+    };
+
+    const std::size_t kBlockSize;
+    const uint32_t    kSlabCount;
+
+    uint8_t* fSlabs[kMaxSlabs];
+    volatile uint32_t fNumSlabs;
+
+    // low 32 bits are index+1 of the first free block, high 32 bits a change counter
+    volatile uint64_t fFreeHead;
+
+    volatile uint32_t fUsed;
+    volatile uint32_t fHighWatermark;
+
+    CarlaMutex fGrowMutex;
+
+    // -------------------------------------------------------------------
+
+    static uint64_t _nextTag(const uint64_t head) noexcept
+    {
+        return ((head >> 32) + 1) << 32;
+    }
+
+    BlockHeader* _getHeader(const uint32_t index) const noexcept
+    {
+        const uint32_t slab = index / kSlabCount;
+        CARLA_SAFE_ASSERT_RETURN(slab < fNumSlabs, nullptr);
+
+        return reinterpret_cast<BlockHeader*>(fSlabs[slab] + (index % kSlabCount) * kBlockSize);
+    }
+
+    // push a chain of blocks, 'last' being the tail of the chain
+    void _push(BlockHeader* const last, const uint32_t firstIndexPlus1) noexcept
+    {
+        for (;;)
+        {
+            const uint64_t head = fFreeHead;
+
+            last->next = static_cast<uint32_t>(head & 0xffffffff);
+
+            if (__sync_bool_compare_and_swap(&fFreeHead, head, _nextTag(head) | firstIndexPlus1))
+                break;
+        }
+    }
+
+    // called from constructor or under fGrowMutex
+    bool _grow() noexcept
+    {
+        const uint32_t slab = fNumSlabs;
+        CARLA_SAFE_ASSERT_RETURN(slab < kMaxSlabs, false);
+
+        uint8_t* const memory = static_cast<uint8_t*>(std::malloc(kBlockSize * kSlabCount));
+        CARLA_SAFE_ASSERT_RETURN(memory != nullptr, false);
+
+        const uint32_t firstIndex = slab * kSlabCount;
+
+        // chain all blocks of the new slab together
+        for (uint32_t i=0; i<kSlabCount; ++i)
+        {
+            BlockHeader* const header = reinterpret_cast<BlockHeader*>(memory + i * kBlockSize);
+            header->index = firstIndex + i;
+            header->next  = firstIndex + i + 2;
+        }
+
+        fSlabs[slab] = memory;
+
+        // slab must be visible before any of its blocks can be reached
+        __sync_synchronize();
+        fNumSlabs = slab + 1;
+        __sync_synchronize();
+
+        _push(reinterpret_cast<BlockHeader*>(memory + (kSlabCount - 1) * kBlockSize), firstIndex + 1);
+        return true;
+    }
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaRtMemPool)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_RT_MEM_POOL_HPP_INCLUDED
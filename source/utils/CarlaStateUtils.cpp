@@ -18,16 +18,24 @@
 #include "CarlaStateUtils.hpp"
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaHashUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
+#include "CarlaXmlUtils.hpp"
 
+#include "water/files/File.h"
+#include "water/files/FileInputStream.h"
 #include "water/streams/MemoryOutputStream.h"
 #include "water/xml/XmlElement.h"
 
 #include <string>
 
+using water::CharPointer_UTF8;
+using water::File;
+using water::FileInputStream;
 using water::MemoryOutputStream;
 using water::String;
+using water::StringArray;
 using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
@@ -99,21 +107,6 @@ static std::string xmlSafeStringFast(const char* const cstring, const bool toXml
     return string;
 }
 
-// -----------------------------------------------------------------------
-// xmlSafeStringCharDup
-
-/*
-static const char* xmlSafeStringCharDup(const char* const cstring, const bool toXml)
-{
-    return carla_strdup(xmlSafeString(cstring, toXml).toRawUTF8());
-}
-*/
-
-static const char* xmlSafeStringCharDup(const String& string, const bool toXml)
-{
-    return carla_strdup(xmlSafeString(string, toXml).toRawUTF8());
-}
-
 // -----------------------------------------------------------------------
 // StateParameter
 
@@ -207,6 +200,7 @@ CarlaStateSave::CarlaStateSave() noexcept
       currentMidiBank(-1),
       currentMidiProgram(-1),
       chunk(nullptr),
+      chunkFile(nullptr),
       parameters(),
       customData() {}
 
@@ -247,6 +241,11 @@ void CarlaStateSave::clear() noexcept
         delete[] chunk;
         chunk = nullptr;
     }
+    if (chunkFile != nullptr)
+    {
+        delete[] chunkFile;
+        chunkFile = nullptr;
+    }
 
     uniqueId = 0;
     options  = 0x0;
@@ -282,243 +281,446 @@ void CarlaStateSave::clear() noexcept
 }
 
 // -----------------------------------------------------------------------
-// fillFromXmlElement
+// StateXmlFiller
 
-bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
+/*
+   Fills a CarlaStateSave one element at a time, as they are read.
+   Shared by the water::XmlElement and the streaming code paths, so both read the same way.
+   Depth is relative to the plugin element, 1 for Info and Data.
+   Text must already be unescaped and trimmed.
+*/
+class CarlaStateSaveXmlFiller
 {
-    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
+public:
+    CarlaStateSaveXmlFiller(CarlaStateSave& stateSave) noexcept
+        : fState(stateSave),
+          fDepth(0),
+          fSection(kSectionNone),
+          fParameter(nullptr),
+          fCustomData(nullptr)
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        , fHasMappedMinimum(false),
+          fHasMappedMaximum(false)
+#endif
+    {
+        fState.clear();
+    }
 
-    clear();
+    ~CarlaStateSaveXmlFiller() noexcept
+    {
+        // only if reading stopped halfway
+        delete fParameter;
+        delete fCustomData;
+    }
 
-    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    void elementStart(const char* const tag)
     {
-        const String& tagName(elem->getTagName());
+        switch (++fDepth)
+        {
+        case 1:
+            /**/ if (std::strcmp(tag, "Info") == 0)
+                fSection = kSectionInfo;
+            else if (std::strcmp(tag, "Data") == 0)
+                fSection = kSectionData;
+            else
+                fSection = kSectionNone;
+            break;
 
-        // ---------------------------------------------------------------
-        // Info
+        case 2:
+            if (fSection != kSectionData)
+                break;
 
-        if (tagName == "Info")
-        {
-            for (XmlElement* xmlInfo = elem->getFirstChildElement(); xmlInfo != nullptr; xmlInfo = xmlInfo->getNextElement())
+            /**/ if (std::strcmp(tag, "Parameter") == 0 && fParameter == nullptr)
+            {
+                fParameter = new CarlaStateSave::Parameter();
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+                fHasMappedMinimum = fHasMappedMaximum = false;
+#endif
+            }
+            else if (std::strcmp(tag, "CustomData") == 0 && fCustomData == nullptr)
             {
-                const String& tag(xmlInfo->getTagName());
-                const String  text(xmlInfo->getAllSubText().trim());
-
-                /**/ if (tag == "Type")
-                    type = xmlSafeStringCharDup(text, false);
-                else if (tag == "Name")
-                    name = xmlSafeStringCharDup(text, false);
-                else if (tag == "Label" || tag == "URI" || tag == "Identifier" || tag == "Setup")
-                    label = xmlSafeStringCharDup(text, false);
-                else if (tag == "Binary" || tag == "Filename")
-                    binary = xmlSafeStringCharDup(text, false);
-                else if (tag == "UniqueID")
-                    uniqueId = text.getLargeIntValue();
+                fCustomData = new CarlaStateSave::CustomData();
             }
+            break;
         }
+    }
 
-        // ---------------------------------------------------------------
-        // Data
-
-        else if (tagName == "Data")
+    void elementEnd(const char* const tag, const char* const text)
+    {
+        switch (fDepth--)
         {
-            for (XmlElement* xmlData = elem->getFirstChildElement(); xmlData != nullptr; xmlData = xmlData->getNextElement())
-            {
-                const String& tag(xmlData->getTagName());
-                const String  text(xmlData->getAllSubText().trim());
+        case 1:
+            fSection = kSectionNone;
+            break;
+
+        case 2:
+            /**/ if (fSection == kSectionInfo)
+                _readInfo(tag, text);
+            else if (fSection != kSectionData)
+                break;
+            else if (fParameter != nullptr && std::strcmp(tag, "Parameter") == 0)
+                _finishParameter();
+            else if (fCustomData != nullptr && std::strcmp(tag, "CustomData") == 0)
+                _finishCustomData();
+            else
+                _readData(tag, text);
+            break;
+
+        case 3:
+            /**/ if (fParameter != nullptr)
+                _readParameter(tag, text);
+            else if (fCustomData != nullptr)
+                _readCustomData(tag, text);
+            break;
+        }
+    }
+
+private:
+    enum Section {
+        kSectionNone,
+        kSectionInfo,
+        kSectionData
+    };
 
+    CarlaStateSave& fState;
+    uint fDepth;
+    Section fSection;
+
+    CarlaStateSave::Parameter* fParameter;
+    CarlaStateSave::CustomData* fCustomData;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                // -------------------------------------------------------
-                // Internal Data
-
-                /**/ if (tag == "Active")
-                {
-                    active = (text == "Yes");
-                }
-                else if (tag == "DryWet")
-                {
-                    dryWet = carla_fixedValue(0.0f, 1.0f, text.getFloatValue());
-                }
-                else if (tag == "Volume")
-                {
-                    volume = carla_fixedValue(0.0f, 1.27f, text.getFloatValue());
-                }
-                else if (tag == "Balance-Left")
-                {
-                    balanceLeft = carla_fixedValue(-1.0f, 1.0f, text.getFloatValue());
-                }
-                else if (tag == "Balance-Right")
-                {
-                    balanceRight = carla_fixedValue(-1.0f, 1.0f, text.getFloatValue());
-                }
-                else if (tag == "Panning")
-                {
-                    panning = carla_fixedValue(-1.0f, 1.0f, text.getFloatValue());
-                }
-                else if (tag == "ControlChannel")
-                {
-                    if (! text.startsWithIgnoreCase("n"))
-                    {
-                        const int value(text.getIntValue());
-                        if (value >= 1 && value <= MAX_MIDI_CHANNELS)
-                            ctrlChannel = static_cast<int8_t>(value-1);
-                    }
-                }
-                else if (tag == "Options")
-                {
-                    const int value(text.getHexValue32());
-                    if (value > 0)
-                        options = static_cast<uint>(value);
-                }
-#else
-                if (false) {}
+    bool fHasMappedMinimum;
+    bool fHasMappedMaximum;
 #endif
 
-                // -------------------------------------------------------
-                // Program (current)
-
-                else if (tag == "CurrentProgramIndex")
-                {
-                    const int value(text.getIntValue());
-                    if (value >= 1)
-                        currentProgramIndex = value-1;
-                }
-                else if (tag == "CurrentProgramName")
-                {
-                    currentProgramName = xmlSafeStringCharDup(text, false);
-                }
-
-                // -------------------------------------------------------
-                // Midi Program (current)
-
-                else if (tag == "CurrentMidiBank")
-                {
-                    const int value(text.getIntValue());
-                    if (value >= 1)
-                        currentMidiBank = value-1;
-                }
-                else if (tag == "CurrentMidiProgram")
-                {
-                    const int value(text.getIntValue());
-                    if (value >= 1)
-                        currentMidiProgram = value-1;
-                }
-
-                // -------------------------------------------------------
-                // Parameters
-
-                else if (tag == "Parameter")
-                {
-                    Parameter* const stateParameter(new Parameter());
+    // older projects have some values escaped twice, only look for that if needed
+    static const char* _dupUnescaped(const char* const text)
+    {
+        char* const ret = const_cast<char*>(carla_strdup(text));
+
+        if (std::strchr(ret, '&') != nullptr)
+            *CarlaXmlReader::unescape(ret, ret, ret + std::strlen(ret)) = '\0';
+
+        return ret;
+    }
+
+    static int _getIntValue(const char* const text) noexcept
+    {
+        return CharPointer_UTF8(text).getIntValue32();
+    }
+
+    static float _getFloatValue(const char* const text) noexcept
+    {
+        return static_cast<float>(CharPointer_UTF8(text).getDoubleValue());
+    }
+
+    void _readInfo(const char* const tag, const char* const text)
+    {
+        /**/ if (std::strcmp(tag, "Type") == 0)
+        {
+            delete[] fState.type;
+            fState.type = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Name") == 0)
+        {
+            delete[] fState.name;
+            fState.name = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Label") == 0 || std::strcmp(tag, "URI") == 0 ||
+                 std::strcmp(tag, "Identifier") == 0 || std::strcmp(tag, "Setup") == 0)
+        {
+            delete[] fState.label;
+            fState.label = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Binary") == 0 || std::strcmp(tag, "Filename") == 0)
+        {
+            delete[] fState.binary;
+            fState.binary = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "UniqueID") == 0)
+        {
+            fState.uniqueId = CharPointer_UTF8(text).getIntValue64();
+        }
+    }
+
+    void _readData(const char* const tag, const char* const text)
+    {
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                    bool hasMappedMinimum = false, hasMappedMaximum = false;
+        // ---------------------------------------------------------------
+        // Internal Data
+
+        /**/ if (std::strcmp(tag, "Active") == 0)
+        {
+            fState.active = std::strcmp(text, "Yes") == 0;
+        }
+        else if (std::strcmp(tag, "DryWet") == 0)
+        {
+            fState.dryWet = carla_fixedValue(0.0f, 1.0f, _getFloatValue(text));
+        }
+        else if (std::strcmp(tag, "Volume") == 0)
+        {
+            fState.volume = carla_fixedValue(0.0f, 1.27f, _getFloatValue(text));
+        }
+        else if (std::strcmp(tag, "Balance-Left") == 0)
+        {
+            fState.balanceLeft = carla_fixedValue(-1.0f, 1.0f, _getFloatValue(text));
+        }
+        else if (std::strcmp(tag, "Balance-Right") == 0)
+        {
+            fState.balanceRight = carla_fixedValue(-1.0f, 1.0f, _getFloatValue(text));
+        }
+        else if (std::strcmp(tag, "Panning") == 0)
+        {
+            fState.panning = carla_fixedValue(-1.0f, 1.0f, _getFloatValue(text));
+        }
+        else if (std::strcmp(tag, "ControlChannel") == 0)
+        {
+            if (text[0] != 'n' && text[0] != 'N')
+            {
+                const int value(_getIntValue(text));
+                if (value >= 1 && value <= MAX_MIDI_CHANNELS)
+                    fState.ctrlChannel = static_cast<int8_t>(value-1);
+            }
+        }
+        else if (std::strcmp(tag, "Options") == 0)
+        {
+            const int value(water::CharacterFunctions::HexParser<int>::parse(CharPointer_UTF8(text)));
+            if (value > 0)
+                fState.options = static_cast<uint>(value);
+        }
+#else
+        if (false) {}
 #endif
 
-                    for (XmlElement* xmlSubData = xmlData->getFirstChildElement(); xmlSubData != nullptr; xmlSubData = xmlSubData->getNextElement())
-                    {
-                        const String& pTag(xmlSubData->getTagName());
-                        const String  pText(xmlSubData->getAllSubText().trim());
-
-                        /**/ if (pTag == "Index")
-                        {
-                            const int index(pText.getIntValue());
-                            if (index >= 0)
-                                stateParameter->index = index;
-                        }
-                        else if (pTag == "Name")
-                        {
-                            stateParameter->name = xmlSafeStringCharDup(pText, false);
-                        }
-                        else if (pTag == "Symbol")
-                        {
-                            stateParameter->symbol = xmlSafeStringCharDup(pText, false);
-                        }
-                        else if (pTag == "Value")
-                        {
-                            stateParameter->dummy = false;
-                            stateParameter->value = pText.getFloatValue();
-                        }
+        // ---------------------------------------------------------------
+        // Program (current)
+
+        else if (std::strcmp(tag, "CurrentProgramIndex") == 0)
+        {
+            const int value(_getIntValue(text));
+            if (value >= 1)
+                fState.currentProgramIndex = value-1;
+        }
+        else if (std::strcmp(tag, "CurrentProgramName") == 0)
+        {
+            delete[] fState.currentProgramName;
+            fState.currentProgramName = _dupUnescaped(text);
+        }
+
+        // ---------------------------------------------------------------
+        // Midi Program (current)
+
+        else if (std::strcmp(tag, "CurrentMidiBank") == 0)
+        {
+            const int value(_getIntValue(text));
+            if (value >= 1)
+                fState.currentMidiBank = value-1;
+        }
+        else if (std::strcmp(tag, "CurrentMidiProgram") == 0)
+        {
+            const int value(_getIntValue(text));
+            if (value >= 1)
+                fState.currentMidiProgram = value-1;
+        }
+
+        // ---------------------------------------------------------------
+        // Chunk
+
+        else if (std::strcmp(tag, "Chunk") == 0)
+        {
+            delete[] fState.chunk;
+            fState.chunk = carla_strdup(text);
+        }
+        else if (std::strcmp(tag, "ChunkFile") == 0)
+        {
+            delete[] fState.chunkFile;
+            fState.chunkFile = _dupUnescaped(text);
+        }
+    }
+
+    void _readParameter(const char* const tag, const char* const text)
+    {
+        CarlaStateSave::Parameter* const stateParameter(fParameter);
+
+        /**/ if (std::strcmp(tag, "Index") == 0)
+        {
+            const int index(_getIntValue(text));
+            if (index >= 0)
+                stateParameter->index = index;
+        }
+        else if (std::strcmp(tag, "Name") == 0)
+        {
+            delete[] stateParameter->name;
+            stateParameter->name = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Symbol") == 0)
+        {
+            delete[] stateParameter->symbol;
+            stateParameter->symbol = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Value") == 0)
+        {
+            stateParameter->dummy = false;
+            stateParameter->value = _getFloatValue(text);
+        }
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                        else if (pTag == "MidiChannel")
-                        {
-                            const int channel(pText.getIntValue());
-                            if (channel >= 1 && channel <= MAX_MIDI_CHANNELS)
-                                stateParameter->midiChannel = static_cast<uint8_t>(channel-1);
-                        }
-                        else if (pTag == "MidiCC")
-                        {
-                            const int cc(pText.getIntValue());
-                            if (cc > 0 && cc < MAX_MIDI_CONTROL)
-                                stateParameter->mappedControlIndex = static_cast<int16_t>(cc);
-                        }
-                        else if (pTag == "MappedControlIndex")
-                        {
-                            const int ctrl(pText.getIntValue());
-                            if (ctrl > CONTROL_INDEX_NONE && ctrl <= CONTROL_INDEX_MAX_ALLOWED)
-                                if (ctrl != CONTROL_INDEX_MIDI_LEARN)
-                                    stateParameter->mappedControlIndex = static_cast<int16_t>(ctrl);
-                        }
-                        else if (pTag == "MappedMinimum")
-                        {
-                            hasMappedMinimum = true;
-                            stateParameter->mappedMinimum = pText.getFloatValue();
-                        }
-                        else if (pTag == "MappedMaximum")
-                        {
-                            hasMappedMaximum = true;
-                            stateParameter->mappedMaximum = pText.getFloatValue();
-                        }
+        else if (std::strcmp(tag, "MidiChannel") == 0)
+        {
+            const int channel(_getIntValue(text));
+            if (channel >= 1 && channel <= MAX_MIDI_CHANNELS)
+                stateParameter->midiChannel = static_cast<uint8_t>(channel-1);
+        }
+        else if (std::strcmp(tag, "MidiCC") == 0)
+        {
+            const int cc(_getIntValue(text));
+            if (cc > 0 && cc < MAX_MIDI_CONTROL)
+                stateParameter->mappedControlIndex = static_cast<int16_t>(cc);
+        }
+        else if (std::strcmp(tag, "MappedControlIndex") == 0)
+        {
+            const int ctrl(_getIntValue(text));
+            if (ctrl > CONTROL_INDEX_NONE && ctrl <= CONTROL_INDEX_MAX_ALLOWED)
+                if (ctrl != CONTROL_INDEX_MIDI_LEARN)
+                    stateParameter->mappedControlIndex = static_cast<int16_t>(ctrl);
+        }
+        else if (std::strcmp(tag, "MappedMinimum") == 0)
+        {
+            fHasMappedMinimum = true;
+            stateParameter->mappedMinimum = _getFloatValue(text);
+        }
+        else if (std::strcmp(tag, "MappedMaximum") == 0)
+        {
+            fHasMappedMaximum = true;
+            stateParameter->mappedMaximum = _getFloatValue(text);
+        }
 #endif
-                    }
+    }
 
+    void _finishParameter()
+    {
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-                    if (hasMappedMinimum && hasMappedMaximum)
-                        stateParameter->mappedRangeValid = true;
+        if (fHasMappedMinimum && fHasMappedMaximum)
+            fParameter->mappedRangeValid = true;
 #endif
 
-                    parameters.append(stateParameter);
-                }
-
-                // -------------------------------------------------------
-                // Custom Data
-
-                else if (tag == "CustomData")
-                {
-                    CustomData* const stateCustomData(new CustomData());
-
-                    for (XmlElement* xmlSubData = xmlData->getFirstChildElement(); xmlSubData != nullptr; xmlSubData = xmlSubData->getNextElement())
-                    {
-                        const String& cTag(xmlSubData->getTagName());
-                        const String  cText(xmlSubData->getAllSubText().trim());
-
-                        /**/ if (cTag == "Type")
-                            stateCustomData->type = xmlSafeStringCharDup(cText, false);
-                        else if (cTag == "Key")
-                            stateCustomData->key = xmlSafeStringCharDup(cText, false);
-                        else if (cTag == "Value")
-                            stateCustomData->value = carla_strdup(cText.toRawUTF8()); //xmlSafeStringCharDup(cText, false);
-                    }
-
-                    if (stateCustomData->isValid())
-                        customData.append(stateCustomData);
-                    else
-                        carla_stderr("Reading CustomData property failed, missing data");
-                }
-
-                // -------------------------------------------------------
-                // Chunk
-
-                else if (tag == "Chunk")
-                {
-                    chunk = carla_strdup(text.toRawUTF8());
-                }
-            }
+        fState.parameters.append(fParameter);
+        fParameter = nullptr;
+    }
+
+    void _readCustomData(const char* const tag, const char* const text)
+    {
+        CarlaStateSave::CustomData* const stateCustomData(fCustomData);
+
+        /**/ if (std::strcmp(tag, "Type") == 0)
+        {
+            delete[] stateCustomData->type;
+            stateCustomData->type = _dupUnescaped(text);
         }
+        else if (std::strcmp(tag, "Key") == 0)
+        {
+            delete[] stateCustomData->key;
+            stateCustomData->key = _dupUnescaped(text);
+        }
+        else if (std::strcmp(tag, "Value") == 0)
+        {
+            delete[] stateCustomData->value;
+            stateCustomData->value = carla_strdup(text);
+        }
+    }
+
+    void _finishCustomData()
+    {
+        if (fCustomData->isValid())
+        {
+            fState.customData.append(fCustomData);
+        }
+        else
+        {
+            carla_stderr("Reading CustomData property failed, missing data");
+            delete fCustomData;
+        }
+
+        fCustomData = nullptr;
     }
 
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaStateSaveXmlFiller)
+};
+
+// -----------------------------------------------------------------------
+// fillFromXmlElement
+
+static bool hasNonTextChildElements(const XmlElement* const xmlElement) noexcept
+{
+    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (! elem->isTextElement())
+            return true;
+    }
+
+    return false;
+}
+
+static void fillFromXmlElementChildren(CarlaStateSaveXmlFiller& filler, const XmlElement* const xmlElement)
+{
+    for (XmlElement* elem = xmlElement->getFirstChildElement(); elem != nullptr; elem = elem->getNextElement())
+    {
+        if (elem->isTextElement())
+            continue;
+
+        const String& tag(elem->getTagName());
+
+        filler.elementStart(tag.toRawUTF8());
+
+        if (hasNonTextChildElements(elem))
+        {
+            fillFromXmlElementChildren(filler, elem);
+            filler.elementEnd(tag.toRawUTF8(), "");
+        }
+        else
+        {
+            const String text(elem->getAllSubText().trim());
+            filler.elementEnd(tag.toRawUTF8(), text.toRawUTF8());
+        }
+    }
+}
+
+bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
+{
+    CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
+
+    CarlaStateSaveXmlFiller filler(*this);
+    fillFromXmlElementChildren(filler, xmlElement);
     return true;
 }
 
+// -----------------------------------------------------------------------
+// fillFromXmlReader
+
+bool CarlaStateSave::fillFromXmlReader(CarlaXmlReader& reader)
+{
+    CarlaStateSaveXmlFiller filler(*this);
+
+    for (const uint depth = reader.getDepth();;)
+    {
+        switch (reader.next())
+        {
+        case CarlaXmlReader::kTokenStartElement:
+            filler.elementStart(reader.getName());
+            break;
+
+        case CarlaXmlReader::kTokenEndElement:
+            if (reader.getDepth() == depth)
+                return true;
+            filler.elementEnd(reader.getName(), reader.getText());
+            break;
+
+        default:
+            carla_stderr2("Failed to read plugin state: %s", reader.getError());
+            return false;
+        }
+    }
+}
+
 // -----------------------------------------------------------------------
 // fillXmlStringFromStateSave
 
@@ -720,10 +922,137 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
 
         content << chunkXml;
     }
+    else if (chunkFile != nullptr && chunkFile[0] != '\0')
+    {
+        content << "\n   <ChunkFile>" << xmlSafeString(chunkFile, true) << "</ChunkFile>\n";
+    }
 
     content << "  </Data>\n";
 }
 
+// -----------------------------------------------------------------------
+// CarlaStateChunkFiles
+
+static bool hasChunkFileContents(const File& file, const void* const data, const std::size_t dataSize)
+{
+    if (! file.existsAsFile() || file.getSize() != static_cast<int64_t>(dataSize))
+        return false;
+
+    FileInputStream stream(file);
+
+    if (stream.failedToOpen())
+        return false;
+
+    const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+    uint8_t buffer[4096];
+
+    for (std::size_t offset = 0; offset < dataSize;)
+    {
+        const int read = stream.read(buffer, static_cast<int>(std::min<std::size_t>(dataSize - offset, sizeof(buffer))));
+
+        if (read <= 0 || std::memcmp(buffer, bytes + offset, static_cast<std::size_t>(read)) != 0)
+            return false;
+
+        offset += static_cast<std::size_t>(read);
+    }
+
+    return true;
+}
+
+CarlaStateChunkFiles::CarlaStateChunkFiles(const char* const projectFilename)
+    : fFolderName(File(projectFilename).getFileName() + ".chunks"),
+      fFolderPath(File(projectFilename).getSiblingFile(fFolderName).getFullPathName()),
+      fUsedFiles() {}
+
+const char* CarlaStateChunkFiles::store(const void* const data, const std::size_t dataSize)
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr && dataSize > 0, nullptr);
+
+    uint64_t hash[2];
+    carla_murmur3_128(data, dataSize, hash);
+
+    char fileName[40];
+    std::snprintf(fileName, 40, "%016llx%016llx.bin",
+                  static_cast<unsigned long long>(hash[0]), static_cast<unsigned long long>(hash[1]));
+
+    const File folder(fFolderPath);
+    const File file(folder.getChildFile(fileName));
+
+    // same name is very likely the same contents, but files can get damaged or edited, so check first
+    if (! hasChunkFileContents(file, data, dataSize))
+    {
+        if (! folder.isDirectory() && ! folder.createDirectory().wasOk())
+        {
+            carla_stderr2("Failed to create chunk folder '%s'", fFolderPath.toRawUTF8());
+            return nullptr;
+        }
+
+        // written straight from the plugin memory, into a temporary file that then replaces the target
+        if (! file.replaceWithData(data, dataSize))
+        {
+            carla_stderr2("Failed to write chunk file '%s'", file.getFullPathName().toRawUTF8());
+            return nullptr;
+        }
+    }
+
+    fUsedFiles.addIfNotAlreadyThere(fileName);
+
+    // always use '/' as separator, so projects can be moved between systems
+    return carla_strdup((fFolderName + "/" + fileName).toRawUTF8());
+}
+
+void CarlaStateChunkFiles::removeUnused()
+{
+    const File folder(fFolderPath);
+
+    if (! folder.isDirectory())
+        return;
+
+    water::Array<File> files;
+    folder.findChildFiles(files, File::findFiles, false, "*.bin");
+
+    for (int i=0, count=files.size(); i<count; ++i)
+    {
+        const File& file(files.getReference(i));
+
+        if (! fUsedFiles.contains(file.getFileName()))
+            file.deleteFile();
+    }
+
+    if (fUsedFiles.size() == 0)
+        folder.deleteFile();
+}
+
+String CarlaStateChunkFiles::getFullPath(const char* const projectFilename, const char* const chunkFile)
+{
+    CARLA_SAFE_ASSERT_RETURN(projectFilename != nullptr && projectFilename[0] != '\0', String());
+    CARLA_SAFE_ASSERT_RETURN(chunkFile != nullptr && chunkFile[0] != '\0', String());
+
+    // chunk files must stay inside the project folder, never trust paths coming from a project file
+    const String relativePath(String(CharPointer_UTF8(chunkFile)).replaceCharacter('\\', '/'));
+
+    if (File::isAbsolutePath(relativePath) || relativePath.startsWithChar('/') || relativePath.containsChar(':'))
+    {
+        carla_stderr2("Ignoring absolute chunk file path '%s'", chunkFile);
+        return String();
+    }
+
+    StringArray parts;
+    parts.addTokens(relativePath, "/", "");
+
+    if (parts.contains("..") || parts.contains("."))
+    {
+        carla_stderr2("Ignoring chunk file path '%s' outside the project folder", chunkFile);
+        return String();
+    }
+
+    const File projectFolder(File(projectFilename).getParentDirectory());
+    const File file(projectFolder.getChildFile(relativePath));
+    CARLA_SAFE_ASSERT_RETURN(file.isAChildOf(projectFolder), String());
+
+    return file.getFullPathName();
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
@@ -21,7 +21,9 @@
 #include "CarlaBackend.h"
 #include "LinkedList.hpp"
 
-#include "water/text/String.h"
+#include "water/text/StringArray.h"
+
+class CarlaXmlReader;
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -92,6 +94,9 @@ struct CarlaStateSave {
     int32_t     currentMidiProgram;
     const char* chunk;
 
+    // binary chunk stored in a separate file, used instead of 'chunk'
+    const char* chunkFile;
+
     ParameterList parameters;
     CustomDataList customData;
 
@@ -100,11 +105,55 @@ struct CarlaStateSave {
     void clear() noexcept;
 
     bool fillFromXmlElement(const water::XmlElement* const xmlElement);
+
+    // streaming alternative to fillFromXmlElement(), for a plugin (or preset) element that was just started
+    // reads until the end of that element
+    bool fillFromXmlReader(CarlaXmlReader& reader);
     void dumpToMemoryStream(water::MemoryOutputStream& stream) const;
 
     CARLA_DECLARE_NON_COPY_STRUCT(CarlaStateSave)
 };
 
+// -----------------------------------------------------------------------
+
+/*
+   Content-addressed storage of plugin chunks, as binary files next to a project.
+   Files are named after the hash of their contents and kept in a "<project-filename>.chunks" folder,
+   so identical chunks are stored only once and unchanged chunks are never written again.
+*/
+class CarlaStateChunkFiles
+{
+public:
+    CarlaStateChunkFiles(const char* projectFilename);
+
+    /*
+     * Store a chunk, writing it only if not stored yet.
+     * Returns the chunk file path relative to the project folder (caller takes ownership),
+     * or null on failure.
+     */
+    const char* store(const void* data, std::size_t dataSize);
+
+    /*
+     * Delete chunk files not stored (or reused) since this object was created,
+     * and the chunks folder itself if nothing was stored.
+     * Call this only after the project file was successfully written.
+     */
+    void removeUnused();
+
+    /*
+     * Get the full path of a chunk file, relative to the project in @a projectFilename.
+     * Returns an empty string for absolute paths or paths leading outside the project folder.
+     */
+    static water::String getFullPath(const char* projectFilename, const char* chunkFile);
+
+private:
+    const water::String fFolderName;
+    const water::String fFolderPath;
+    water::StringArray fUsedFiles;
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaStateChunkFiles)
+};
+
 static inline
 water::String xmlSafeString(const char* const cstring, const bool toXml)
 {
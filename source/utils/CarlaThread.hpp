@@ -146,9 +146,8 @@ public:
         CARLA_SAFE_ASSERT_RETURN(handle != 0, false);
 #endif
         pthread_detach(handle);
-        _copyFrom(handle);
 
-        // wait for thread to start
+        // wait for thread to start, it sets its own handle so that one which finishes quickly is not seen as running
         fSignal.wait();
         return true;
     }
@@ -301,6 +300,8 @@ private:
         if (fName.isNotEmpty())
             setCurrentThreadName(fName);
 
+        _copyFrom(pthread_self());
+
         // report ready
         fSignal.signal();
 
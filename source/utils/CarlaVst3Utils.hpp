@@ -0,0 +1,246 @@
+/*
+ * Carla VST3 utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_VST3_UTILS_HPP_INCLUDED
+#define CARLA_VST3_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+// -----------------------------------------------------------------------
+// Include fixes
+
+// only the interfaces are used, never the SDK base classes.
+// interface IDs are taken from the per-file "_iid" constants, so there is no need for INIT_CLASS_IID
+// and no symbol clashes with other users of the SDK (like JUCE).
+
+#include "pluginterfaces/base/ibstream.h"
+#include "pluginterfaces/base/ipluginbase.h"
+#include "pluginterfaces/gui/iplugview.h"
+#include "pluginterfaces/vst/ivstattributes.h"
+#include "pluginterfaces/vst/ivstaudioprocessor.h"
+#include "pluginterfaces/vst/ivstcomponent.h"
+#include "pluginterfaces/vst/ivsteditcontroller.h"
+#include "pluginterfaces/vst/ivstevents.h"
+#include "pluginterfaces/vst/ivsthostapplication.h"
+#include "pluginterfaces/vst/ivstmessage.h"
+#include "pluginterfaces/vst/ivstmidicontrollers.h"
+#include "pluginterfaces/vst/ivstparameterchanges.h"
+#include "pluginterfaces/vst/ivstprocesscontext.h"
+
+// -----------------------------------------------------------------------
+// Module entry points
+
+#if defined(CARLA_OS_MAC)
+typedef bool (*V3_ModuleEntryFunc)(void* bundleRef);
+typedef bool (*V3_ModuleExitFunc)();
+# define V3_ENTRYFNNAME "bundleEntry"
+# define V3_EXITFNNAME  "bundleExit"
+#elif defined(CARLA_OS_WIN)
+typedef bool (PLUGIN_API *V3_ModuleEntryFunc)();
+typedef bool (PLUGIN_API *V3_ModuleExitFunc)();
+# define V3_ENTRYFNNAME "InitDll"
+# define V3_EXITFNNAME  "ExitDll"
+#else
+typedef bool (*V3_ModuleEntryFunc)(void* sharedLibraryHandle);
+typedef bool (*V3_ModuleExitFunc)();
+# define V3_ENTRYFNNAME "ModuleEntry"
+# define V3_EXITFNNAME  "ModuleExit"
+#endif
+
+typedef Steinberg::IPluginFactory* (PLUGIN_API *V3_GetFactoryFunc)();
+
+// -----------------------------------------------------------------------
+// Get the folder name used for the binaries inside a VST3 bundle
+
+static inline
+const char* getVST3BundleArchitecture() noexcept
+{
+#if defined(CARLA_OS_WIN)
+# ifdef CARLA_OS_64BIT
+    return "x86_64-win";
+# else
+    return "x86-win";
+# endif
+#elif defined(__aarch64__)
+    return "aarch64-linux";
+#elif defined(__arm__)
+    return "armv7l-linux";
+#elif defined(__i386__)
+    return "i386-linux";
+#else
+    return "x86_64-linux";
+#endif
+}
+
+// -----------------------------------------------------------------------
+// Unique id from a class id, same hash as used by JUCE
+
+static inline
+int64_t getVST3UniqueId(const Steinberg::TUID cid) noexcept
+{
+    uint32_t value = 0;
+
+    for (int i=0; i<16; ++i)
+        value = (value * 31) + static_cast<uint32_t>(cid[i]);
+
+    return static_cast<int32_t>(value);
+}
+
+// -----------------------------------------------------------------------
+// Convert between VST3 (UTF-16) and UTF-8 strings
+
+/*
+ * Copy an UTF-16 string into an UTF-8 one, 'dst' must be able to hold 'size' bytes.
+ * The result is always null terminated, and never cut in the middle of a character.
+ */
+static inline
+void carla_v3_strncpy(char* dst, const Steinberg::Vst::TChar* src, const std::size_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dst != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(size > 0,);
+
+    char* const end = dst + size - 1;
+
+    for (uint32_t c; src != nullptr && (c = static_cast<uint16_t>(*src)) != 0; ++src)
+    {
+        // surrogate pair
+        if (c >= 0xd800 && c <= 0xdbff)
+        {
+            const uint32_t c2 = static_cast<uint16_t>(src[1]);
+
+            if (c2 >= 0xdc00 && c2 <= 0xdfff)
+            {
+                c = 0x10000 + ((c - 0xd800) << 10) + (c2 - 0xdc00);
+                ++src;
+            }
+        }
+
+        if (c < 0x80)
+        {
+            if (dst + 1 > end) break;
+            *dst++ = static_cast<char>(c);
+        }
+        else if (c < 0x800)
+        {
+            if (dst + 2 > end) break;
+            *dst++ = static_cast<char>(0xc0 | (c >> 6));
+            *dst++ = static_cast<char>(0x80 | (c & 0x3f));
+        }
+        else if (c < 0x10000)
+        {
+            if (dst + 3 > end) break;
+            *dst++ = static_cast<char>(0xe0 | (c >> 12));
+            *dst++ = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | (c & 0x3f));
+        }
+        else
+        {
+            if (dst + 4 > end) break;
+            *dst++ = static_cast<char>(0xf0 | (c >> 18));
+            *dst++ = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+            *dst++ = static_cast<char>(0x80 | (c & 0x3f));
+        }
+    }
+
+    *dst = '\0';
+}
+
+/*
+ * Copy an UTF-8 string into an UTF-16 one, 'dst' must be able to hold 'size' characters.
+ * The result is always null terminated.
+ */
+static inline
+void carla_v3_strncpy(Steinberg::Vst::TChar* dst, const char* src, const std::size_t size) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(dst != nullptr,);
+    CARLA_SAFE_ASSERT_RETURN(size > 0,);
+
+    Steinberg::Vst::TChar* const end = dst + size - 1;
+
+    for (uint32_t c; src != nullptr && (c = static_cast<uint8_t>(*src)) != 0 && dst < end; ++src)
+    {
+        uint extra = 0;
+
+        if (c >= 0xf0)
+        {
+            c &= 0x07;
+            extra = 3;
+        }
+        else if (c >= 0xe0)
+        {
+            c &= 0x0f;
+            extra = 2;
+        }
+        else if (c >= 0xc0)
+        {
+            c &= 0x1f;
+            extra = 1;
+        }
+
+        for (; extra > 0 && (static_cast<uint8_t>(src[1]) & 0xc0) == 0x80; --extra)
+            c = (c << 6) | (static_cast<uint8_t>(*++src) & 0x3f);
+
+        if (c >= 0x10000)
+        {
+            if (dst + 2 > end) break;
+            c -= 0x10000;
+            *dst++ = static_cast<Steinberg::Vst::TChar>(0xd800 + (c >> 10));
+            *dst++ = static_cast<Steinberg::Vst::TChar>(0xdc00 + (c & 0x3ff));
+        }
+        else
+        {
+            *dst++ = static_cast<Steinberg::Vst::TChar>(c);
+        }
+    }
+
+    *dst = 0;
+}
+
+// -----------------------------------------------------------------------
+// Convert a VST3 result code to string
+
+static inline
+const char* tresult2str(const Steinberg::tresult ret) noexcept
+{
+    switch (ret)
+    {
+    case Steinberg::kResultOk:
+        return "kResultOk";
+    case Steinberg::kResultFalse:
+        return "kResultFalse";
+    case Steinberg::kNoInterface:
+        return "kNoInterface";
+    case Steinberg::kInvalidArgument:
+        return "kInvalidArgument";
+    case Steinberg::kNotImplemented:
+        return "kNotImplemented";
+    case Steinberg::kInternalError:
+        return "kInternalError";
+    case Steinberg::kNotInitialized:
+        return "kNotInitialized";
+    case Steinberg::kOutOfMemory:
+        return "kOutOfMemory";
+    }
+
+    carla_stderr("tresult2str(%i) - unknown result", ret);
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_VST3_UTILS_HPP_INCLUDED
@@ -0,0 +1,657 @@
+/*
+ * Carla XML utils
+ * Copyright (C) 2026 The Carla contributors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * For a full copy of the GNU General Public License see the doc/GPL.txt file.
+ */
+
+#ifndef CARLA_XML_UTILS_HPP_INCLUDED
+#define CARLA_XML_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include "water/xml/XmlElement.h"
+
+// -----------------------------------------------------------------------
+// Streaming XML reader
+
+/*
+   Pull-style XML reader, reads one element at a time without building a document tree.
+   Meant for Carla project and preset files, so only elements, attributes and text are reported.
+   Comments, processing instructions and the doctype are skipped, CDATA is handled as text.
+
+   Parsing is done in-place: names and text are terminated and unescaped inside the given buffer,
+   which gets modified and must stay valid for as long as the reader (and any returned string) is used.
+   This way no string is ever copied, and unescaping happens in a single pass.
+
+   Text is only reported for end elements, trimmed, and only the text after the last child element.
+   This matches what Carla files use, leaf elements with text and container elements without.
+*/
+
+class CarlaXmlReader
+{
+public:
+    enum Token {
+        kTokenError,
+        kTokenEndOfDocument,
+        kTokenStartElement,
+        kTokenEndElement
+    };
+
+    CarlaXmlReader(char* const data, const std::size_t size) noexcept
+        : fPos(data),
+          fEnd(data + size),
+          fName(""),
+          fAttributes(""),
+          fText(""),
+          fDepth(0),
+          fPendingPop(false),
+          fEmptyElement(false),
+          fError(nullptr) {}
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Read the next element start or end.
+     * Empty elements (<Tag/>) are reported as a start followed by an end.
+     */
+    Token next() noexcept
+    {
+        if (fError != nullptr)
+            return kTokenError;
+
+        if (fPendingPop)
+        {
+            fPendingPop = false;
+            --fDepth;
+        }
+
+        if (fEmptyElement)
+        {
+            fEmptyElement = false;
+            fText = "";
+            return _endElement();
+        }
+
+        char* const textStart = fPos;
+        char* textWrite = fPos;
+
+        for (;;)
+        {
+            char* const lt = static_cast<char*>(std::memchr(fPos, '<', static_cast<std::size_t>(fEnd - fPos)));
+
+            if (lt == nullptr)
+            {
+                if (fDepth != 0)
+                    return _setError("Unexpected end of file");
+
+                fName = "";
+                return kTokenEndOfDocument;
+            }
+
+            textWrite = unescape(textWrite, fPos, lt);
+            fPos = lt + 1;
+
+            if (fPos == fEnd)
+                return _setError("Unexpected end of file");
+
+            switch (*fPos)
+            {
+            case '?':
+                if (! _skipPast("?>"))
+                    return _setError("Unterminated processing instruction");
+                continue;
+
+            case '!':
+                if (_startsWith("!--"))
+                {
+                    if (! _skipPast("-->"))
+                        return _setError("Unterminated comment");
+                }
+                else if (_startsWith("![CDATA["))
+                {
+                    char* const cdata = fPos + 8;
+                    if (! _skipPast("]]>"))
+                        return _setError("Unterminated CDATA section");
+
+                    const std::size_t len = static_cast<std::size_t>(fPos - 3 - cdata);
+                    std::memmove(textWrite, cdata, len);
+                    textWrite += len;
+                }
+                else if (! _skipDoctype())
+                {
+                    return _setError("Invalid doctype");
+                }
+                continue;
+
+            case '/':
+                // text ends where the end tag starts
+                fText = _trim(textStart, textWrite);
+                ++fPos;
+                return _readEndTag();
+
+            default:
+                fText = "";
+                return _readStartTag();
+            }
+        }
+    }
+
+    /*
+     * Skip the rest of the element that was just started, including all its children.
+     */
+    bool skipElement() noexcept
+    {
+        const uint depth = fDepth;
+
+        for (;;)
+        {
+            switch (next())
+            {
+            case kTokenStartElement:
+                break;
+            case kTokenEndElement:
+                if (fDepth == depth)
+                    return true;
+                break;
+            default:
+                return false;
+            }
+        }
+    }
+
+    /*
+     * Read the rest of the element that was just started as a water::XmlElement tree.
+     * Caller takes ownership of the returned object.
+     */
+    water::XmlElement* readElementAsXml()
+    {
+        water::XmlElement* const elem = createXmlElement();
+
+        for (;;)
+        {
+            switch (next())
+            {
+            case kTokenStartElement:
+                if (water::XmlElement* const child = readElementAsXml())
+                {
+                    elem->addChildElement(child);
+                    continue;
+                }
+                break;
+
+            case kTokenEndElement:
+                if (fText[0] != '\0' && elem->getFirstChildElement() == nullptr)
+                    elem->addTextElement(water::String(water::CharPointer_UTF8(fText)));
+                return elem;
+
+            default:
+                break;
+            }
+
+            delete elem;
+            return nullptr;
+        }
+    }
+
+    /*
+     * Create a water::XmlElement for the element that was just started, with its attributes but no children.
+     * Caller takes ownership of the returned object.
+     */
+    water::XmlElement* createXmlElement() const
+    {
+        water::XmlElement* const elem = new water::XmlElement(fName);
+
+        water::String attrName, attrValue;
+        for (const char* attrs = fAttributes; getNextAttribute(attrs, attrName, attrValue);)
+            elem->setAttribute(attrName, attrValue);
+
+        return elem;
+    }
+
+    // -------------------------------------------------------------------
+
+    /*
+     * Name of the current element.
+     */
+    const char* getName() const noexcept
+    {
+        return fName;
+    }
+
+    /*
+     * Unescaped and trimmed text of the current element, only valid for end elements.
+     */
+    const char* getText() const noexcept
+    {
+        return fText;
+    }
+
+    /*
+     * Depth of the current element, 1 for the root one.
+     * The same for both start and end of an element.
+     */
+    uint getDepth() const noexcept
+    {
+        return fDepth;
+    }
+
+    /*
+     * Check if the document ends with the end tag of the root element, which must have been started already.
+     * This is a cheap way to detect truncated files before acting on any of their contents,
+     * other errors are only found as the document is read.
+     */
+    bool endsWithRootEndTag() const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(fDepth != 0, false);
+
+        // <Root/>
+        if (fDepth == 1 && fEmptyElement)
+            return true;
+
+        const char* end = fEnd;
+
+        while (end != fPos && (_isSpace(end[-1]) || end[-1] == '\0'))
+            --end;
+
+        if (end == fPos || end[-1] != '>')
+            return false;
+
+        --end;
+
+        while (end != fPos && _isSpace(end[-1]))
+            --end;
+
+        const char* const rootName = fStack[0];
+        const std::size_t rootNameLen = std::strlen(rootName);
+
+        if (static_cast<std::size_t>(end - fPos) < rootNameLen + 2)
+            return false;
+
+        const char* const tag = end - rootNameLen - 2;
+        return tag[0] == '<' && tag[1] == '/' && std::memcmp(tag + 2, rootName, rootNameLen) == 0;
+    }
+
+    /*
+     * Check if reading failed, next() returned kTokenError.
+     */
+    bool hasError() const noexcept
+    {
+        return fError != nullptr;
+    }
+
+    /*
+     * Error message, set after next() returned kTokenError.
+     */
+    const char* getError() const noexcept
+    {
+        return fError != nullptr ? fError : "";
+    }
+
+    /*
+     * Get an attribute of the element that was just started.
+     */
+    bool getAttribute(const char* const name, water::String& value) const
+    {
+        water::String attrName;
+
+        for (const char* attrs = fAttributes; getNextAttribute(attrs, attrName, value);)
+        {
+            if (attrName == name)
+                return true;
+        }
+
+        value.clear();
+        return false;
+    }
+
+    /*
+     * Iterate over attributes, starting from the raw attribute list of an element.
+     * The attribute values are copied and unescaped, as they are only used for small things.
+     */
+    static bool getNextAttribute(const char*& attrs, water::String& name, water::String& value)
+    {
+        while (_isSpace(*attrs))
+            ++attrs;
+
+        const char* const nameStart = attrs;
+
+        while (*attrs != '\0' && *attrs != '=' && ! _isSpace(*attrs))
+            ++attrs;
+
+        if (attrs == nameStart)
+            return false;
+
+        name = water::String(water::CharPointer_UTF8(nameStart), water::CharPointer_UTF8(attrs));
+
+        while (_isSpace(*attrs))
+            ++attrs;
+        if (*attrs++ != '=')
+            return false;
+        while (_isSpace(*attrs))
+            ++attrs;
+
+        const char quote = *attrs++;
+        if (quote != '\'' && quote != '"')
+            return false;
+
+        const char* const valueEnd = std::strchr(attrs, quote);
+        if (valueEnd == nullptr)
+            return false;
+
+        const std::size_t len = static_cast<std::size_t>(valueEnd - attrs);
+        char* const tmp = static_cast<char*>(std::malloc(len + 1));
+        CARLA_SAFE_ASSERT_RETURN(tmp != nullptr, false);
+
+        std::memcpy(tmp, attrs, len);
+        *unescape(tmp, tmp, tmp + len) = '\0';
+        value = water::String(water::CharPointer_UTF8(tmp));
+        std::free(tmp);
+
+        attrs = valueEnd + 1;
+        return true;
+    }
+
+    /*
+     * Unescape XML entities in [start, end) into 'write', which can be the same as 'start'.
+     * Returns the new write position, the result is not null-terminated.
+     */
+    static char* unescape(char* write, const char* start, const char* const end) noexcept
+    {
+        for (;;)
+        {
+            const char* const amp = static_cast<const char*>(std::memchr(start, '&', static_cast<std::size_t>(end - start)));
+            const char* const runEnd = amp != nullptr ? amp : end;
+            const std::size_t runLen = static_cast<std::size_t>(runEnd - start);
+
+            if (write != start)
+                std::memmove(write, start, runLen);
+
+            write += runLen;
+
+            if (amp == nullptr)
+                return write;
+
+            start = amp + 1;
+
+            // entities are short, no need to look further
+            const std::size_t maxEntityLen = static_cast<std::size_t>(end - start) < 10 ? static_cast<std::size_t>(end - start) : 10;
+            const char* const semicolon = static_cast<const char*>(std::memchr(start, ';', maxEntityLen));
+            const std::size_t entityLen = semicolon != nullptr ? static_cast<std::size_t>(semicolon - start) : 0;
+
+            char c = '\0';
+
+            /**/ if (entityLen == 3 && std::memcmp(start, "amp", 3) == 0)
+                c = '&';
+            else if (entityLen == 2 && std::memcmp(start, "lt", 2) == 0)
+                c = '<';
+            else if (entityLen == 2 && std::memcmp(start, "gt", 2) == 0)
+                c = '>';
+            else if (entityLen == 4 && std::memcmp(start, "apos", 4) == 0)
+                c = '\'';
+            else if (entityLen == 4 && std::memcmp(start, "quot", 4) == 0)
+                c = '"';
+            else if (entityLen >= 2 && start[0] == '#')
+            {
+                const bool hex = start[1] == 'x' || start[1] == 'X';
+                char* numEnd = nullptr;
+                const unsigned long code = std::strtoul(start + (hex ? 2 : 1), &numEnd, hex ? 16 : 10);
+
+                if (numEnd == semicolon && code > 0 && code <= 0x10ffff)
+                {
+                    write = _writeUTF8(write, static_cast<uint32_t>(code));
+                    start = semicolon + 1;
+                    continue;
+                }
+            }
+
+            if (c != '\0')
+            {
+                *write++ = c;
+                start = semicolon + 1;
+            }
+            else
+            {
+                // unknown entity, keep as-is
+                *write++ = '&';
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------
+
+private:
+    enum {
+        kMaxDepth = 32
+    };
+
+    char* fPos;
+    char* const fEnd;
+
+    const char* fName;
+    const char* fAttributes;
+    const char* fText;
+
+    const char* fStack[kMaxDepth];
+    uint fDepth;
+    bool fPendingPop;
+    bool fEmptyElement;
+
+    const char* fError;
+
+    // -------------------------------------------------------------------
+
+    Token _setError(const char* const error) noexcept
+    {
+        fError = error;
+        return kTokenError;
+    }
+
+    static bool _isSpace(const char c) noexcept
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool _isNameEnd(const char c) noexcept
+    {
+        return _isSpace(c) || c == '>' || c == '/';
+    }
+
+    bool _startsWith(const char* const str) const noexcept
+    {
+        const std::size_t len = std::strlen(str);
+        return static_cast<std::size_t>(fEnd - fPos) >= len && std::memcmp(fPos, str, len) == 0;
+    }
+
+    // moves position to right after the next occurrence of 'str'
+    bool _skipPast(const char* const str) noexcept
+    {
+        const std::size_t len = std::strlen(str);
+
+        for (char* p = fPos; static_cast<std::size_t>(fEnd - p) >= len; ++p)
+        {
+            p = static_cast<char*>(std::memchr(p, str[0], static_cast<std::size_t>(fEnd - p)));
+
+            if (p == nullptr || static_cast<std::size_t>(fEnd - p) < len)
+                break;
+
+            if (std::memcmp(p, str, len) == 0)
+            {
+                fPos = p + len;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool _skipDoctype() noexcept
+    {
+        for (int brackets = 0; fPos != fEnd; ++fPos)
+        {
+            switch (*fPos)
+            {
+            case '[':
+                ++brackets;
+                break;
+            case ']':
+                --brackets;
+                break;
+            case '>':
+                if (brackets <= 0)
+                {
+                    ++fPos;
+                    return true;
+                }
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    static const char* _trim(char* start, char* end) noexcept
+    {
+        while (start != end && _isSpace(*start))
+            ++start;
+        while (end != start && _isSpace(end[-1]))
+            --end;
+
+        *end = '\0';
+        return start;
+    }
+
+    static char* _writeUTF8(char* write, const uint32_t code) noexcept
+    {
+        if (code < 0x80)
+        {
+            *write++ = static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            *write++ = static_cast<char>(0xc0 | (code >> 6));
+            *write++ = static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            *write++ = static_cast<char>(0xe0 | (code >> 12));
+            *write++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            *write++ = static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            *write++ = static_cast<char>(0xf0 | (code >> 18));
+            *write++ = static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+            *write++ = static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+            *write++ = static_cast<char>(0x80 | (code & 0x3f));
+        }
+
+        return write;
+    }
+
+    // position is right after '<'
+    Token _readStartTag() noexcept
+    {
+        char* const name = fPos;
+
+        while (fPos != fEnd && ! _isNameEnd(*fPos))
+            ++fPos;
+
+        if (fPos == fEnd || fPos == name)
+            return _setError("Invalid element name");
+        if (fDepth == kMaxDepth)
+            return _setError("Elements nested too deep");
+
+        char* attrs = fPos;
+
+        // find the end of the tag, skipping quoted attribute values
+        for (char quote = '\0'; fPos != fEnd; ++fPos)
+        {
+            if (quote != '\0')
+            {
+                if (*fPos == quote)
+                    quote = '\0';
+            }
+            else if (*fPos == '\'' || *fPos == '"')
+            {
+                quote = *fPos;
+            }
+            else if (*fPos == '>')
+            {
+                break;
+            }
+        }
+
+        if (fPos == fEnd)
+            return _setError("Unterminated element tag");
+
+        fEmptyElement = fPos[-1] == '/';
+
+        if (fEmptyElement)
+            fPos[-1] = '\0';
+
+        *fPos++ = '\0';
+
+        // terminate name, attributes (if any) start after it
+        if (*attrs != '\0')
+        {
+            *attrs = '\0';
+            ++attrs;
+        }
+
+        fName = name;
+        fAttributes = attrs;
+        fStack[fDepth++] = name;
+        return kTokenStartElement;
+    }
+
+    // position is right after '</'
+    Token _readEndTag() noexcept
+    {
+        char* const name = fPos;
+
+        while (fPos != fEnd && ! _isNameEnd(*fPos))
+            ++fPos;
+
+        char* const nameEnd = fPos;
+
+        while (fPos != fEnd && _isSpace(*fPos))
+            ++fPos;
+
+        if (fPos == fEnd || *fPos != '>')
+            return _setError("Invalid end tag");
+
+        *nameEnd = '\0';
+        ++fPos;
+
+        if (fDepth == 0 || std::strcmp(fStack[fDepth-1], name) != 0)
+            return _setError("Mismatched end tag");
+
+        return _endElement();
+    }
+
+    // depth is only decreased on the next read, so it matches the start of this element
+    Token _endElement() noexcept
+    {
+        fName = fStack[fDepth-1];
+        fAttributes = "";
+        fPendingPop = true;
+        return kTokenEndElement;
+    }
+
+    CARLA_DECLARE_NON_COPY_CLASS(CarlaXmlReader)
+};
+
+// -----------------------------------------------------------------------
+
+#endif // CARLA_XML_UTILS_HPP_INCLUDED
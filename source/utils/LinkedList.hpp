@@ -324,6 +324,15 @@ public:
         _delete(it.fEntry, data);
     }
 
+    // remove the element holding 'value', which must be a reference to a value stored in this list
+    void removeRef(T& value) noexcept
+    {
+        Data* const data(list_entry(&value, Data, value));
+        CARLA_SAFE_ASSERT_RETURN(data != nullptr,);
+
+        _delete(&data->siblings, data);
+    }
+
     bool removeOne(const T& value) noexcept
     {
         for (ListHead *entry = fQueue.next, *entry2 = entry->next; entry != &fQueue; entry = entry2, entry2 = entry->next)
@@ -19,11 +19,7 @@
 #define RT_LINKED_LIST_HPP_INCLUDED
 
 #include "LinkedList.hpp"
-
-extern "C" {
-/* full path as IDE Helper */
-#include "../modules/rtmempool/rtmempool.h"
-}
+#include "CarlaRtMemPool.hpp"
 
 // -----------------------------------------------------------------------
 // Realtime safe linkedlist
@@ -33,59 +29,58 @@ class RtLinkedList : public AbstractLinkedList<T>
 {
 public:
     // -------------------------------------------------------------------
-    // RtMemPool C++ class
+    // Memory pool, lock-free for real-time usage
 
     class Pool
     {
     public:
         Pool(const std::size_t minPreallocated, const std::size_t maxPreallocated) noexcept
-            : kDataSize(sizeof(typename AbstractLinkedList<T>::Data)),
-              fHandle(nullptr)
+            : fPool(sizeof(typename AbstractLinkedList<T>::Data), minPreallocated, maxPreallocated) {}
+
+        void* allocate_atomic() const noexcept
         {
-            rtsafe_memory_pool_create(&fHandle, nullptr, kDataSize, minPreallocated, maxPreallocated);
-            CARLA_SAFE_ASSERT(fHandle != nullptr);
+            return fPool.allocate_atomic();
         }
 
-        ~Pool() noexcept
+        void* allocate_sleepy() const noexcept
         {
-            if (fHandle != nullptr)
-            {
-                rtsafe_memory_pool_destroy(fHandle);
-                fHandle = nullptr;
-            }
+            return fPool.allocate_sleepy();
         }
 
-        void* allocate_atomic() const noexcept
+        void deallocate(void* const dataPtr) const noexcept
         {
-            return rtsafe_memory_pool_allocate_atomic(fHandle);
+            CARLA_SAFE_ASSERT_RETURN(dataPtr != nullptr,);
+
+            fPool.deallocate(dataPtr);
         }
 
-        void* allocate_sleepy() const noexcept
+        uint32_t getUsedCount() const noexcept
         {
-            return rtsafe_memory_pool_allocate_sleepy(fHandle);
+            return fPool.getUsedCount();
         }
 
-        void deallocate(void* const dataPtr) const noexcept
+        uint32_t getHighWatermark() const noexcept
         {
-            CARLA_SAFE_ASSERT_RETURN(dataPtr != nullptr,);
+            return fPool.getHighWatermark();
+        }
 
-            rtsafe_memory_pool_deallocate(fHandle, dataPtr);
+        uint32_t getCapacity() const noexcept
+        {
+            return fPool.getCapacity();
         }
 
         bool operator==(const Pool& pool) const noexcept
         {
-            return (fHandle == pool.fHandle && kDataSize == pool.kDataSize);
+            return (this == &pool);
         }
 
         bool operator!=(const Pool& pool) const noexcept
         {
-            return (fHandle != pool.fHandle || kDataSize != pool.kDataSize);
+            return (this != &pool);
         }
 
     private:
-        const std::size_t kDataSize;
-
-        mutable RtMemPool_Handle fHandle;
+        mutable CarlaRtMemPool fPool;
 
         CARLA_PREVENT_HEAP_ALLOCATION
         CARLA_DECLARE_NON_COPY_CLASS(Pool)